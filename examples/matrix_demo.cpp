@@ -1,6 +1,7 @@
 #include <polygon_mesh/polygon_mesh.hpp>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 using namespace polygon_mesh;
 
@@ -192,6 +193,21 @@ void demonstrate_advanced_operations() {
     
     bool not_identity = (test_matrix != identity);
     std::cout << "Test matrix not equals identity: " << (not_identity ? "true" : "false") << "\n";
+    
+    // Inverse (general and affine fast path)
+    auto inverse = test_matrix.inverse();
+    auto affine_inverse = test_matrix.affine_inverse();
+    std::cout << "Matrix inverse (element [0,0]): " << inverse(0,0) << "\n";
+    std::cout << "Affine inverse matches general inverse: " 
+              << ((inverse == affine_inverse) ? "true" : "false") << "\n";
+    std::cout << "M * inverse(M) is identity: " 
+              << ((test_matrix * inverse == identity) ? "true" : "false") << "\n";
+    
+    // Singular matrices are reported instead of silently returning identity
+    Matrix4 singular(0.0f);
+    Matrix4 unused;
+    std::cout << "Singular matrix invertible: " 
+              << (singular.try_inverse(unused) ? "true" : "false") << "\n";
 }
 
 void demonstrate_mesh_transformation() {
@@ -220,15 +236,11 @@ void demonstrate_mesh_transformation() {
     auto transform = translation * rotation * scale;
     
     // Apply transformation to all vertices
-    auto vertices = cube.vertices(); // Get copy of vertices
+    const auto& vertices = cube.vertices();
     std::cout << "\nOriginal vertex 0: (" << vertices[0].position.x << ", " 
               << vertices[0].position.y << ", " << vertices[0].position.z << ")\n";
     
-    Vector3 transformed_pos = transform.transform_point(vertices[0].position);
-    std::cout << "Transformed vertex 0: (" << transformed_pos.x << ", " 
-              << transformed_pos.y << ", " << transformed_pos.z << ")\n";
-    
-    // Calculate original and transformed bounding boxes
+    // Calculate original bounding box
     auto original_bbox = cube.bounding_box();
     std::cout << "\nOriginal bounding box:\n";
     std::cout << "  Min: (" << original_bbox.min_point.x << ", " 
@@ -236,7 +248,25 @@ void demonstrate_mesh_transformation() {
     std::cout << "  Max: (" << original_bbox.max_point.x << ", " 
               << original_bbox.max_point.y << ", " << original_bbox.max_point.z << ")\n";
     
-    // For transformed bbox, we'd need to transform all vertices and recompute
+    // Transform the whole mesh in one batched pass
+    cube.transform(transform);
+    
+    std::cout << "Transformed vertex 0: (" << vertices[0].position.x << ", " 
+              << vertices[0].position.y << ", " << vertices[0].position.z << ")\n";
+    
+    const auto& transformed_bbox = cube.bounding_box();
+    std::cout << "\nTransformed bounding box:\n";
+    std::cout << "  Min: (" << transformed_bbox.min_point.x << ", " 
+              << transformed_bbox.min_point.y << ", " << transformed_bbox.min_point.z << ")\n";
+    std::cout << "  Max: (" << transformed_bbox.max_point.x << ", " 
+              << transformed_bbox.max_point.y << ", " << transformed_bbox.max_point.z << ")\n";
+    
+    // Raw position arrays can be transformed without a mesh
+    std::vector<Vector3> points = {Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)};
+    math::transform_points(transform, points);
+    std::cout << "Transformed point array [0]: (" << points[0].x << ", " 
+              << points[0].y << ", " << points[0].z << ")\n";
+    
     std::cout << "Transformation applied successfully\n";
 }
 
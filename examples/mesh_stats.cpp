@@ -1,9 +1,47 @@
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <polygon_mesh/polygon_mesh.hpp>
 
 using namespace polygon_mesh;
 
-int main() {
+void print_statistics(const algorithms::analysis::MeshStatistics<float>& stats) {
+    std::cout << "  Vertices: " << stats.vertex_count << std::endl;
+    std::cout << "  Edges: " << stats.edge_count << std::endl;
+    std::cout << "  Faces: " << stats.face_count << " (" << stats.triangle_count << " triangles, "
+              << stats.quad_count << " quads, " << stats.ngon_count << " n-gons)" << std::endl;
+    std::cout << "  Edge length: min " << stats.min_edge_length << ", max " << stats.max_edge_length
+              << ", avg " << stats.avg_edge_length << std::endl;
+    std::cout << "  Triangle area: min " << stats.min_triangle_area << ", max " << stats.max_triangle_area
+              << ", avg " << stats.avg_triangle_area << std::endl;
+    std::cout << "  Surface area: " << stats.total_surface_area << std::endl;
+    std::cout << "  Volume: " << stats.volume << std::endl;
+}
+
+// Height field of n x n quads, each split into two triangles
+core::Meshf make_terrain(std::size_t n) {
+    std::vector<core::Vertexf> vertices((n + 1) * (n + 1));
+    for (std::size_t y = 0; y <= n; ++y) {
+        for (std::size_t x = 0; x <= n; ++x) {
+            const float u = float(x) / float(n), v = float(y) / float(n);
+            vertices[y * (n + 1) + x].position = math::Vector3f(u, v, 0.1f * std::sin(20.0f * u) * std::cos(20.0f * v));
+        }
+    }
+    std::vector<core::Facef> faces(2 * n * n);
+    for (std::size_t y = 0; y < n; ++y) {
+        for (std::size_t x = 0; x < n; ++x) {
+            const auto v = core::VertexId(y * (n + 1) + x);
+            const auto up = v + core::VertexId(n + 1);
+            faces[2 * (y * n + x)].vertices = {v, v + 1, up + 1};
+            faces[2 * (y * n + x) + 1].vertices = {v, up + 1, up};
+        }
+    }
+    core::Meshf mesh;
+    mesh.assign(std::move(vertices), std::move(faces));
+    return mesh;
+}
+
+int main(int argc, char** argv) {
     std::cout << "=== Mesh Statistics Example ===" << std::endl;
     
     try {
@@ -43,10 +81,7 @@ int main() {
         
         // Compute statistics
         std::cout << "\nMesh Statistics:" << std::endl;
-        std::cout << "  Vertices: " << mesh.vertex_count() << std::endl;
-        std::cout << "  Edges: " << mesh.edge_count() << std::endl;
-        std::cout << "  Faces: " << mesh.face_count() << std::endl;
-        std::cout << "  Surface area: " << mesh.surface_area() << std::endl;
+        print_statistics(algorithms::analysis::compute_mesh_statistics(mesh));
         
         // Get bounding box
         const auto& bbox = mesh.bounding_box();
@@ -60,6 +95,17 @@ int main() {
         bool is_valid = mesh.validate_topology();
         std::cout << "\nTopology validation: " << (is_valid ? "PASSED" : "FAILED") << std::endl;
         
+        // Optionally time a large mesh: mesh_stats <grid resolution>, e.g. 5000 for 50M faces
+        if (argc > 1) {
+            const std::size_t n = std::strtoul(argv[1], nullptr, 10);
+            const auto terrain = make_terrain(n);
+            utils::Timer timer;
+            const auto stats = algorithms::analysis::compute_mesh_statistics(terrain);
+            const double seconds = timer.elapsed_seconds();
+            std::cout << "\nTerrain " << n << " x " << n << " Statistics (" << seconds << " s):" << std::endl;
+            print_statistics(stats);
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/face_sides.hpp>
+#include <polygon_mesh/core/mesh.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+
+// Vertex one-rings in compressed sparse row form. The neighbors of vertex v are
+// neighbors[offsets[v] .. offsets[v + 1]), sorted by index. Built once per algorithm
+// run and then read by every sweep, so iterative solvers never touch the face list.
+template<typename T>
+struct VertexAdjacency {
+    std::vector<std::size_t> offsets;        // vertex_count + 1 entries
+    std::vector<core::VertexId> neighbors;
+    std::vector<T> weights;                  // parallel to neighbors, each row sums to 1; empty for uniform
+    std::vector<std::uint8_t> boundary;      // 1 for vertices on an edge used by exactly one face
+
+    std::size_t vertex_count() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    std::size_t degree(std::size_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+enum class AdjacencyWeighting {
+    UNIFORM,    // every neighbor counts equally
+    COTANGENT   // (cot alpha + cot beta) / 2, clamped at zero; triangle meshes only
+};
+
+// Minimum vertices per thread while building adjacency
+constexpr std::size_t ADJACENCY_MIN_CHUNK = 16384;
+
+namespace detail {
+
+// Cotangents of the three corner angles of every triangle
+template<typename T>
+std::vector<T> triangle_cotangents(const core::Mesh<T>& mesh) {
+    const auto& faces = mesh.faces();
+    const auto& vertices = mesh.vertices();
+    std::vector<T> cotangents(faces.size() * 3);
+
+    utils::parallel_for_range(0, faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            const auto& ids = faces[f].vertices;
+            for (std::size_t k = 0; k < 3; ++k) {
+                const auto& corner = vertices[ids[k]].position;
+                const auto u = vertices[ids[(k + 1) % 3]].position - corner;
+                const auto v = vertices[ids[(k + 2) % 3]].position - corner;
+                const T sine = u.cross(v).length();
+                cotangents[f * 3 + k] = sine > std::numeric_limits<T>::min() ? u.dot(v) / sine : T(0);
+            }
+        }
+    }, ADJACENCY_MIN_CHUNK);
+    return cotangents;
+}
+
+// Adds w to the weight of the (sorted) row entry for a -> b
+template<typename T>
+void add_row_weight(VertexAdjacency<T>& adjacency, core::VertexId a, core::VertexId b, T w) {
+    const auto first = adjacency.neighbors.begin() + adjacency.offsets[a];
+    const auto last = adjacency.neighbors.begin() + adjacency.offsets[a + 1];
+    const auto it = std::lower_bound(first, last, b);
+    if (it != last && *it == b) {
+        adjacency.weights[static_cast<std::size_t>(it - adjacency.neighbors.begin())] += w;
+    }
+}
+
+} // namespace detail
+
+// Builds one-rings from the face edges (polygon sides; no diagonals). Cotangent
+// weighting requires an all-triangle mesh and falls back to uniform weights otherwise;
+// rows whose clamped cotangent weights sum to zero also use uniform weights.
+template<typename T>
+VertexAdjacency<T> build_vertex_adjacency(const core::Mesh<T>& mesh,
+                                          AdjacencyWeighting weighting = AdjacencyWeighting::UNIFORM) {
+    const auto& faces = mesh.faces();
+    const std::size_t n = mesh.vertex_count();
+
+    VertexAdjacency<T> adjacency;
+    adjacency.offsets.assign(n + 1, 0);
+    adjacency.boundary.assign(n, 0);
+
+    // Directed entries for both sides of every face edge, bucketed by source vertex.
+    // An undirected edge shared by k faces shows up k times in each endpoint's bucket.
+    auto buckets = detail::bucket_sides<core::VertexId>(n, faces.size(), [&](std::size_t f, auto&& emit) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t i = 0, count = ids.size(); i < count; ++i) {
+            const core::VertexId a = ids[i];
+            const core::VertexId b = ids[i + 1 == count ? 0 : i + 1];
+            emit(a, b);
+            emit(b, a);
+        }
+    }, ADJACENCY_MIN_CHUNK);
+    const auto& raw_offsets = buckets.offsets;
+    auto& raw = buckets.entries;
+
+    // Sort and deduplicate each bucket; an entry seen once marks a boundary edge
+    std::vector<std::size_t> unique_counts(n, 0);
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            auto first = raw.begin() + raw_offsets[v];
+            auto last = raw.begin() + raw_offsets[v + 1];
+            std::sort(first, last);
+
+            std::size_t count = 0;
+            for (auto it = first; it != last;) {
+                auto run = it + 1;
+                while (run != last && *run == *it) ++run;
+                if (*it != v) {  // self-loops only come from degenerate faces
+                    if (run - it == 1) adjacency.boundary[v] = 1;
+                    first[count++] = *it;
+                }
+                it = run;
+            }
+            unique_counts[v] = count;
+        }
+    }, ADJACENCY_MIN_CHUNK);
+
+    for (std::size_t v = 0; v < n; ++v) {
+        adjacency.offsets[v + 1] = adjacency.offsets[v] + unique_counts[v];
+    }
+
+    adjacency.neighbors.resize(adjacency.offsets[n]);
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            std::copy_n(raw.begin() + raw_offsets[v], unique_counts[v],
+                        adjacency.neighbors.begin() + adjacency.offsets[v]);
+        }
+    }, ADJACENCY_MIN_CHUNK);
+
+    if (weighting == AdjacencyWeighting::UNIFORM) {
+        return adjacency;
+    }
+
+    const bool triangles = std::all_of(faces.begin(), faces.end(),
+                                       [](const core::Face<T>& face) { return face.vertices.size() == 3; });
+    if (!triangles) {
+        return adjacency;
+    }
+
+    // Each triangle corner contributes half its cotangent to the opposite edge
+    const std::vector<T> cotangents = detail::triangle_cotangents(mesh);
+    adjacency.weights.assign(adjacency.neighbors.size(), T(0));
+    for (std::size_t f = 0; f < faces.size(); ++f) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t k = 0; k < 3; ++k) {
+            const core::VertexId a = ids[(k + 1) % 3];
+            const core::VertexId b = ids[(k + 2) % 3];
+            const T w = T(0.5) * cotangents[f * 3 + k];
+            detail::add_row_weight(adjacency, a, b, w);
+            detail::add_row_weight(adjacency, b, a, w);
+        }
+    }
+
+    // Clamp and normalize rows
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const std::size_t row_begin = adjacency.offsets[v];
+            const std::size_t row_end = adjacency.offsets[v + 1];
+            T sum = T(0);
+            for (std::size_t k = row_begin; k < row_end; ++k) {
+                adjacency.weights[k] = std::max(adjacency.weights[k], T(0));
+                sum += adjacency.weights[k];
+            }
+            const bool uniform = !(sum > std::numeric_limits<T>::min());
+            const T scale = uniform ? T(1) / T(std::max<std::size_t>(row_end - row_begin, 1)) : T(1) / sum;
+            for (std::size_t k = row_begin; k < row_end; ++k) {
+                adjacency.weights[k] = uniform ? scale : adjacency.weights[k] * scale;
+            }
+        }
+    }, ADJACENCY_MIN_CHUNK);
+
+    return adjacency;
+}
+
+// Cotangent Laplacian of a triangle mesh with its mixed Voronoi areas (Meyer et al.),
+// cached against one mesh. Rows hold the raw weights (cot alpha + cot beta) / 2,
+// neither clamped nor normalized, so sum_j w_ij (x_i - x_j) / A_i approximates the
+// mean curvature normal 2 H n. The one-rings are kept while the mesh's topology version stands
+// and the weights, areas, angle defects and normals while its position version does;
+// when either moves, the stale part is rebuilt in the next pass over the vertices.
+// Mesh versions are never reused, so assigning another mesh over the cached one counts as a move.
+template<typename T>
+class CotangentLaplacian {
+public:
+    const VertexAdjacency<T>& adjacency() const { return adjacency_; }
+    const std::vector<T>& areas() const { return areas_; }
+    const std::vector<T>& angle_defects() const { return angle_defects_; }      // 2 pi (pi on boundaries) minus the corner angles
+    const std::vector<math::Vector3<T>>& normals() const { return normals_; }   // area weighted, unit length
+
+    bool is_current(const core::Mesh<T>& mesh) const {
+        return geometry_valid_ && mesh_ == &mesh && topology_version_ == mesh.topology_version() &&
+               position_version_ == mesh.position_version();
+    }
+
+    void update(const core::Mesh<T>& mesh) {
+        visit(mesh, [](std::size_t) {});
+    }
+
+    // Brings the operator up to date for mesh and calls visit(v) for every vertex, in
+    // parallel, once that vertex's row is current. Stale rows are rebuilt in the same
+    // pass, so a caller reading each one-ring only walks the mesh once. Throws
+    // std::invalid_argument unless every face is a triangle.
+    template<typename Visit>
+    void visit(const core::Mesh<T>& mesh, Visit&& visit) {
+        if (mesh_ != &mesh || topology_version_ != mesh.topology_version() ||
+            adjacency_.vertex_count() != mesh.vertex_count()) {
+            build_topology(mesh);
+        }
+        const bool rebuild = !is_current(mesh);
+        const core::Vertex<T>* vertices = mesh.vertices().data();
+
+        utils::parallel_for_range(0, mesh.vertex_count(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                if (rebuild) gather(v, vertices);
+                visit(v);
+            }
+        }, ADJACENCY_MIN_CHUNK);
+
+        position_version_ = mesh.position_version();
+        geometry_valid_ = true;
+    }
+
+private:
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    // Triangle corners around every vertex; corner i of vertex v names the row slots of
+    // the next and previous vertex of its triangle, counted from offsets[v]
+    void build_topology(const core::Mesh<T>& mesh) {
+        const auto& faces = mesh.faces();
+        const std::size_t n = mesh.vertex_count();
+        for (const auto& face : faces) {
+            if (face.vertices.size() != 3) {
+                throw std::invalid_argument("CotangentLaplacian: mesh must contain only triangles");
+            }
+        }
+
+        adjacency_ = build_vertex_adjacency(mesh);
+        adjacency_.weights.assign(adjacency_.neighbors.size(), T(0));
+
+        corner_offsets_.assign(n + 1, 0);
+        for (const auto& face : faces) {
+            for (auto id : face.vertices) ++corner_offsets_[id + 1];
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            corner_offsets_[v + 1] += corner_offsets_[v];
+        }
+
+        corner_slots_.resize(corner_offsets_[n] * 2);
+        std::vector<std::size_t> cursor(corner_offsets_.begin(), corner_offsets_.end() - 1);
+        for (const auto& face : faces) {
+            const auto& ids = face.vertices;
+            for (std::size_t k = 0; k < 3; ++k) {
+                const std::size_t corner = cursor[ids[k]]++;
+                corner_slots_[corner * 2] = ids[(k + 1) % 3];
+                corner_slots_[corner * 2 + 1] = ids[(k + 2) % 3];
+            }
+        }
+
+        // Vertex ids to row slots; degenerate corners keep NO_SLOT and are skipped
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                const auto first = adjacency_.neighbors.begin() + adjacency_.offsets[v];
+                const auto last = adjacency_.neighbors.begin() + adjacency_.offsets[v + 1];
+                for (std::size_t i = corner_offsets_[v] * 2; i < corner_offsets_[v + 1] * 2; ++i) {
+                    const auto it = std::lower_bound(first, last, corner_slots_[i]);
+                    corner_slots_[i] = it != last && *it == corner_slots_[i] && corner_slots_[i] != v
+                                           ? static_cast<std::uint32_t>(it - first)
+                                           : NO_SLOT;
+                }
+            }
+        }, ADJACENCY_MIN_CHUNK);
+
+        areas_.assign(n, T(0));
+        angle_defects_.assign(n, T(0));
+        normals_.assign(n, math::Vector3<T>(0));
+        mesh_ = &mesh;
+        topology_version_ = mesh.topology_version();
+        geometry_valid_ = false;
+    }
+
+    // Rebuilds the row, area, angle defect and normal of vertex v from its corners only,
+    // so vertices never write each other's data
+    void gather(std::size_t v, const core::Vertex<T>* vertices) {
+        const std::size_t row = adjacency_.offsets[v];
+        std::fill(adjacency_.weights.begin() + row, adjacency_.weights.begin() + adjacency_.offsets[v + 1], T(0));
+
+        const math::Vector3<T>& p = vertices[v].position;
+        T area = T(0);
+        T angles = T(0);
+        math::Vector3<T> normal(0);
+        for (std::size_t corner = corner_offsets_[v]; corner < corner_offsets_[v + 1]; ++corner) {
+            const std::uint32_t slot_a = corner_slots_[corner * 2];
+            const std::uint32_t slot_b = corner_slots_[corner * 2 + 1];
+            if (slot_a == NO_SLOT || slot_b == NO_SLOT) continue;
+
+            const math::Vector3<T> to_a = vertices[adjacency_.neighbors[row + slot_a]].position - p;
+            const math::Vector3<T> to_b = vertices[adjacency_.neighbors[row + slot_b]].position - p;
+            const math::Vector3<T> a_to_b = to_b - to_a;
+            const math::Vector3<T> cross = to_a.cross(to_b);
+            const T twice_area = cross.length();
+            if (!(twice_area > std::numeric_limits<T>::min())) continue;
+
+            const T dot_v = to_a.dot(to_b);
+            const T cot_a = -to_a.dot(a_to_b) / twice_area;   // at a, opposite edge v-b
+            const T cot_b = to_b.dot(a_to_b) / twice_area;    // at b, opposite edge v-a
+            adjacency_.weights[row + slot_a] += T(0.5) * cot_b;
+            adjacency_.weights[row + slot_b] += T(0.5) * cot_a;
+
+            // Voronoi share for non-obtuse triangles, else a fixed part of the triangle
+            if (dot_v < T(0)) {
+                area += twice_area / T(4);
+            } else if (cot_a < T(0) || cot_b < T(0)) {
+                area += twice_area / T(8);
+            } else {
+                area += (to_a.length_squared() * cot_b + to_b.length_squared() * cot_a) / T(8);
+            }
+            angles += std::atan2(twice_area, dot_v);
+            normal += cross;
+        }
+
+        const T full = adjacency_.boundary[v] ? math::pi<T>() : math::two_pi<T>();
+        areas_[v] = area;
+        angle_defects_[v] = corner_offsets_[v + 1] > corner_offsets_[v] ? full - angles : T(0);
+        const T length = normal.length();
+        normals_[v] = length > std::numeric_limits<T>::min() ? normal / length : math::Vector3<T>(0);
+    }
+
+    VertexAdjacency<T> adjacency_;
+    std::vector<std::size_t> corner_offsets_;
+    std::vector<std::uint32_t> corner_slots_;
+    std::vector<T> areas_;
+    std::vector<T> angle_defects_;
+    std::vector<math::Vector3<T>> normals_;
+    const core::Mesh<T>* mesh_ = nullptr;
+    std::uint64_t topology_version_ = 0;
+    std::uint64_t position_version_ = 0;
+    bool geometry_valid_ = false;
+};
+
+} // namespace algorithms
+} // namespace polygon_mesh
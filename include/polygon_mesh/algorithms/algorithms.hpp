@@ -2,7 +2,24 @@
 
 // Main algorithms header file - includes all algorithm modules
 
+#include <polygon_mesh/algorithms/config.hpp>
 #include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/algorithms/bvh.hpp>
+#include <polygon_mesh/algorithms/wide_bvh.hpp>
+#include <polygon_mesh/algorithms/closest_point.hpp>
+#include <polygon_mesh/algorithms/clustering.hpp>
+#include <polygon_mesh/algorithms/components.hpp>
+#include <polygon_mesh/algorithms/curvature.hpp>
+#include <polygon_mesh/algorithms/decimation.hpp>
+#include <polygon_mesh/algorithms/normals.hpp>
+#include <polygon_mesh/algorithms/orientation.hpp>
+#include <polygon_mesh/algorithms/quality.hpp>
+#include <polygon_mesh/algorithms/ray_queries.hpp>
+#include <polygon_mesh/algorithms/repair.hpp>
+#include <polygon_mesh/algorithms/smoothing.hpp>
+#include <polygon_mesh/algorithms/statistics.hpp>
+#include <polygon_mesh/algorithms/subdivision.hpp>
+#include <polygon_mesh/algorithms/topology.hpp>
 
 namespace polygon_mesh {
 namespace algorithms {
@@ -36,27 +53,5 @@ void process_mesh_pipeline(core::Mesh<T>& mesh,
     }
 }
 
-// Algorithm configuration structures
-struct SmoothingConfig {
-    enum Type { LAPLACIAN, TAUBIN } type = LAPLACIAN;
-    std::size_t iterations = 1;
-    float lambda = 0.5f;
-    float mu = -0.53f;  // For Taubin smoothing
-};
-
-struct DecimationConfig {
-    enum Type { QUADRIC, EDGE_COLLAPSE } type = QUADRIC;
-    float reduction_ratio = 0.5f;
-    std::size_t target_triangles = 0;
-    bool preserve_boundaries = true;
-    float quadric_threshold = 1e-6f;
-};
-
-struct SubdivisionConfig {
-    enum Type { LOOP, CATMULL_CLARK } type = LOOP;
-    std::size_t levels = 1;
-    bool limit_surface = false;
-};
-
 } // namespace algorithms
 } // namespace polygon_mesh
\ No newline at end of file
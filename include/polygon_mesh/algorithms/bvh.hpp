@@ -0,0 +1,1190 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+#include <polygon_mesh/kernels/kernels.hpp>
+#endif
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace spatial {
+
+// Bounding volume hierarchy over the triangles of a mesh, with polygons fan triangulated.
+// The binned SAH builder sorts triangle centroids into bins along each axis and takes
+// the split with the lowest surface area cost; the Morton builder sorts triangles along
+// a Z-order curve and splits each run on the highest bit its codes differ in, trading
+// tree quality for build time. Large ranges near the root are binned and partitioned by
+// all threads, then the remaining subtrees are built one per thread and stitched into a
+// single depth-first array. Triangles are copied into leaf order, so a leaf's triangles
+// are contiguous and its vertices are read without touching the mesh.
+
+// Minimum triangles per thread
+constexpr std::size_t BVH_MIN_CHUNK = 16384;
+
+// Upper limit of BVHConfig::bins
+constexpr std::size_t BVH_MAX_BINS = 32;
+
+// Entries of the traversal stack; builds keep the tree shallower than this
+constexpr std::size_t BVH_MAX_DEPTH = 128;
+
+// Nodes deeper than this split at the object median, which bounds the depth of trees
+// over adversarial inputs
+constexpr std::size_t BVH_SAH_DEPTH = 64;
+
+namespace detail {
+
+// Triangle reference while building: its bounds, its index and its Morton code
+template<typename T>
+struct BVHPrimitive {
+    math::Vector3<T> min_point;
+    std::uint32_t triangle;
+    math::Vector3<T> max_point;
+    std::uint32_t code;
+
+    math::Vector3<T> centroid() const { return (min_point + max_point) * T(0.5); }
+};
+
+// Primitives begin .. end with their bounds and the bounds of their centroids
+template<typename T>
+struct BVHRange {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t depth = 0;
+    core::BoundingBox<T> bounds;
+    core::BoundingBox<T> centroids;
+
+    std::size_t size() const { return end - begin; }
+};
+
+template<typename T>
+struct BVHBin {
+    core::BoundingBox<T> bounds;
+    std::size_t count = 0;
+
+    void add(const BVHPrimitive<T>& primitive) {
+        grow(primitive.min_point, primitive.max_point);
+        ++count;
+    }
+
+    void merge(const BVHBin& other) {
+        if (other.count == 0) return;
+        grow(other.bounds.min_point, other.bounds.max_point);
+        count += other.count;
+    }
+
+    // Takes values rather than references into bounds so the compiler can keep the
+    // comparisons branch free
+    void grow(math::Vector3<T> low, math::Vector3<T> high) {
+        math::Vector3<T>& min_point = bounds.min_point;
+        math::Vector3<T>& max_point = bounds.max_point;
+        min_point = math::Vector3<T>(low.x < min_point.x ? low.x : min_point.x,
+                                     low.y < min_point.y ? low.y : min_point.y,
+                                     low.z < min_point.z ? low.z : min_point.z);
+        max_point = math::Vector3<T>(high.x > max_point.x ? high.x : max_point.x,
+                                     high.y > max_point.y ? high.y : max_point.y,
+                                     high.z > max_point.z ? high.z : max_point.z);
+    }
+};
+
+// Möller-Trumbore test against the triangle v0, v0 + edge1, v0 + edge2, accepting
+// hits in (0, t_max) from either side
+template<typename T>
+bool intersect_triangle(const math::Vector3<T>& origin, const math::Vector3<T>& direction,
+                        const math::Vector3<T>& v0, const math::Vector3<T>& edge1, const math::Vector3<T>& edge2,
+                        T t_max, T& t, T& u, T& v) {
+    const math::Vector3<T> p = direction.cross(edge2);
+    const T det = edge1.dot(p);
+    if (!(std::abs(det) > std::numeric_limits<T>::min())) return false;
+
+    const T inv_det = T(1) / det;
+    const math::Vector3<T> s = origin - v0;
+    u = s.dot(p) * inv_det;
+    if (u < T(0) || u > T(1)) return false;
+    const math::Vector3<T> q = s.cross(edge1);
+    v = direction.dot(q) * inv_det;
+    if (v < T(0) || u + v > T(1)) return false;
+    t = edge2.dot(q) * inv_det;
+    return t > T(0) && t < t_max;
+}
+
+// One ray against the triangles of BVH leaves (corner, edge1, edge2 each). With the
+// kernels library, float leaves go through its dispatched ray-triangle kernel.
+template<typename T>
+class LeafRay {
+public:
+    LeafRay(const math::Vector3<T>& origin, const math::Vector3<T>& direction)
+        : origin_(origin), direction_(direction) {
+#if defined(POLYGON_MESH_HAS_KERNELS)
+        if constexpr (std::is_same_v<T, float>) table_ = &kernels::active();
+#endif
+    }
+
+    // Closest hit among count triangles before t_max; on success t_max, the index of
+    // the triangle in the leaf and its u, v are updated. Ties go to the first triangle.
+    template<typename Triangle>
+    bool intersect(const Triangle* triangles, std::size_t count, T& t_max, std::size_t& index, T& u, T& v) const {
+#if defined(POLYGON_MESH_HAS_KERNELS)
+        if constexpr (std::is_same_v<T, float>) {
+            static_assert(sizeof(Triangle) == 9 * sizeof(float), "leaf triangles must be nine packed floats");
+            kernels::RayTriangleHit hit;
+            if (!table_->intersect_ray_triangles(&origin_.x, &direction_.x, t_max, &triangles[0].vertex.x,
+                                                 sizeof(Triangle), count, &hit)) {
+                return false;
+            }
+            t_max = hit.t;
+            index = hit.triangle;
+            u = hit.u;
+            v = hit.v;
+            return true;
+        }
+#endif
+        bool found = false;
+        for (std::size_t i = 0; i < count; ++i) {
+            const Triangle& triangle = triangles[i];
+            T t, hit_u, hit_v;
+            if (intersect_triangle(origin_, direction_, triangle.vertex, triangle.edge1, triangle.edge2,
+                                   t_max, t, hit_u, hit_v)) {
+                t_max = t;
+                index = i;
+                u = hit_u;
+                v = hit_v;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+private:
+    const math::Vector3<T>& origin_;
+    const math::Vector3<T>& direction_;
+#if defined(POLYGON_MESH_HAS_KERNELS)
+    const kernels::KernelTable* table_ = nullptr;
+#endif
+};
+
+template<typename T>
+RayHit<T> ray_miss() {
+    RayHit<T> hit;
+    hit.hit = false;
+    hit.point = math::Vector3<T>(0);
+    hit.normal = math::Vector3<T>(0);
+    hit.distance = std::numeric_limits<T>::infinity();
+    hit.face_id = core::INVALID_FACE_ID;
+    hit.barycentric = math::Vector3<T>(0);
+    return hit;
+}
+
+template<typename T>
+RayHit<T> ray_hit(const math::Vector3<T>& origin, const math::Vector3<T>& direction,
+                  const math::Vector3<T>& edge1, const math::Vector3<T>& edge2,
+                  T t, T u, T v, core::FaceId face) {
+    RayHit<T> hit;
+    hit.hit = true;
+    hit.point = origin + direction * t;
+    hit.normal = edge1.cross(edge2).normalize();
+    hit.distance = t;
+    hit.face_id = face;
+    hit.barycentric = math::Vector3<T>(T(1) - u - v, u, v);
+    return hit;
+}
+
+// Calls visit(triangle, face, a, b, c) for the fan triangles of faces begin .. end,
+// numbering them from first_triangle
+template<typename T, typename Visit>
+void for_each_fan_triangle(const core::Mesh<T>& mesh, std::size_t begin, std::size_t end,
+                           std::size_t first_triangle, Visit&& visit) {
+    const auto& faces = mesh.faces();
+    std::size_t triangle = first_triangle;
+    for (std::size_t f = begin; f < end; ++f) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+            visit(triangle++, static_cast<core::FaceId>(f), ids[0], ids[i], ids[i + 1]);
+        }
+    }
+}
+
+template<typename T>
+class BVHBuilder;
+
+} // namespace detail
+
+template<typename T, std::size_t N>
+class WideBVH;
+
+template<typename T>
+class BVH {
+public:
+    // 32 bytes for float. An inner node's left child follows it and offset names its
+    // right child; a leaf holds triangles offset .. offset + count in leaf order.
+    struct Node {
+        math::Vector3<T> min_point;
+        std::uint32_t offset;
+        math::Vector3<T> max_point;
+        std::uint32_t count;  // 0 for inner nodes
+
+        bool is_leaf() const { return count != 0; }
+    };
+
+    // Triangle in leaf order, stored as a corner and its two edges
+    struct Triangle {
+        math::Vector3<T> vertex;
+        math::Vector3<T> edge1;
+        math::Vector3<T> edge2;
+    };
+
+    BVH() : build_cost_(0), position_version_(0), topology_version_(0), mesh_(nullptr) {}
+
+    explicit BVH(const core::Mesh<T>& mesh, const BVHConfig& config = BVHConfig())
+        : build_cost_(0), position_version_(0), topology_version_(0), mesh_(nullptr) {
+        build(mesh, config);
+    }
+
+    // Rebuilds the hierarchy over the current triangles of mesh. The mesh is only read
+    // here and by refit. Throws std::invalid_argument for bins outside [2, BVH_MAX_BINS]
+    // or a zero leaf size, and std::out_of_range past 2^32 - 1 triangles.
+    void build(const core::Mesh<T>& mesh, const BVHConfig& config = BVHConfig());
+
+    // Brings the hierarchy up to date with the mesh it was built from, which must still
+    // exist. Nothing is done while the mesh's position version is unchanged. Moved
+    // vertices keep the tree and refit every bound bottom up; once the SAH cost exceeds
+    // refit_rotation_threshold times the cost at build, subtrees are also rotated where
+    // that shrinks them. Changed connectivity rebuilds with the build's config. Returns
+    // whether the hierarchy changed.
+    bool refit();
+
+    // Closest hit along origin + t * direction for t > 0; distance is t, so it is the
+    // Euclidean distance for a unit direction. The barycentric coordinates weigh the
+    // corners of the hit fan triangle (corner 0, i and i + 1 of a polygon).
+    RayHit<T> ray_intersection(const math::Vector3<T>& ray_origin,
+                               const math::Vector3<T>& ray_direction) const;
+
+    bool empty() const { return nodes_.empty(); }
+    std::size_t triangle_count() const { return triangles_.size(); }
+    const core::Mesh<T>* mesh() const { return mesh_; }
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::vector<Triangle>& triangles() const { return triangles_; }
+    const std::vector<core::FaceId>& triangle_faces() const { return faces_; }
+
+    // Expected cost of a random ray relative to one triangle test: every node weighs its
+    // surface area relative to the root, times traversal_cost for inner nodes and the
+    // triangle count for leaves
+    T sah_cost(T traversal_cost = T(1)) const;
+
+private:
+    template<typename, std::size_t>
+    friend class WideBVH;
+
+    // Disjoint subtrees, as ranges of node indices, and the nodes above them in
+    // depth-first order; each subtree is small enough to leave the others to other threads
+    void partition_subtrees(std::vector<std::uint32_t>& top,
+                            std::vector<std::pair<std::uint32_t, std::uint32_t>>& subtrees) const;
+
+    // Bounds of every node from the current vertex positions; returns sah_cost
+    T refit_nodes(const core::Vertex<T>* vertices);
+
+    // One bottom-up pass of tree rotations, then the tree is laid out depth first again.
+    // Returns false when the rotated tree would be too deep to traverse.
+    bool rotate_nodes();
+
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    std::vector<core::FaceId> faces_;
+    std::vector<std::array<core::VertexId, 3>> corners_;  // in leaf order, for refit
+    BVHConfig config_;
+    T build_cost_;
+    std::uint64_t position_version_;
+    std::uint64_t topology_version_;
+    const core::Mesh<T>* mesh_;
+};
+
+namespace detail {
+
+template<typename T>
+class BVHBuilder {
+public:
+    using Node = typename BVH<T>::Node;
+
+    BVHBuilder(std::vector<BVHPrimitive<T>>& primitives, const BVHConfig& config)
+        : primitives_(primitives), config_(config), bins_(config.bins), max_leaf_size_(config.max_leaf_size),
+          traversal_cost_(T(config.traversal_cost)) {}
+
+    // Flattened nodes; the primitives are left in leaf order
+    std::vector<Node> build() {
+        const std::size_t n = primitives_.size();
+        if (n == 0) return {};
+
+        BVHRange<T> root;
+        root.end = n;
+        measure(root, true);
+        if (config_.build == BVHConfig::MORTON) sort_morton(root);
+
+        // Split the largest ranges on all threads until there are enough subtrees to
+        // keep every thread busy
+        const std::size_t threads = utils::parallel_chunk_count(n, BVH_MIN_CHUNK);
+        const std::size_t task_size = std::max(BVH_MIN_CHUNK, n / (threads * 4));
+        top_.clear();
+        top_.push_back(TopNode{root, 0, 0, false});
+        std::unique_ptr<BinArray> bins(new BinArray());
+        if (threads > 1) scratch_.resize(n);
+        while (threads > 1) {
+            std::size_t largest = top_.size();
+            for (std::size_t i = 0; i < top_.size(); ++i) {
+                if (top_[i].inner || top_[i].range.size() <= task_size) continue;
+                if (largest == top_.size() || top_[i].range.size() > top_[largest].range.size()) largest = i;
+            }
+            if (largest == top_.size()) break;
+
+            BVHRange<T> left, right;
+            if (!split(top_[largest].range, left, right, *bins, true)) break;
+            top_[largest].inner = true;
+            top_[largest].left = top_.size();
+            top_.push_back(TopNode{left, 0, 0, false});
+            top_[largest].right = top_.size();
+            top_.push_back(TopNode{right, 0, 0, false});
+        }
+        std::vector<BVHPrimitive<T>>().swap(scratch_);
+
+        // Remaining subtrees, largest first, built one per thread
+        std::vector<std::size_t> tasks;
+        for (std::size_t i = 0; i < top_.size(); ++i) {
+            if (!top_[i].inner) tasks.push_back(i);
+        }
+        std::sort(tasks.begin(), tasks.end(), [&](std::size_t a, std::size_t b) {
+            return top_[a].range.size() > top_[b].range.size();
+        });
+        std::vector<std::vector<Node>> subtrees(top_.size());
+        std::atomic<std::size_t> next_task(0);
+        utils::parallel_team(std::min(threads, tasks.size()), [&](std::size_t) {
+            BinArray bins;
+            for (std::size_t i = next_task.fetch_add(1); i < tasks.size(); i = next_task.fetch_add(1)) {
+                auto& nodes = subtrees[tasks[i]];
+                nodes.reserve(2 * top_[tasks[i]].range.size() / max_leaf_size_ + 1);
+                build_subtree(top_[tasks[i]].range, nodes, bins);
+            }
+        });
+
+        if (tasks.size() == 1) return std::move(subtrees[0]);
+
+        // Stitch depth first: top nodes in place, subtrees copied with their right
+        // child offsets moved to where they land
+        std::vector<std::size_t> base(top_.size());
+        std::size_t count = 0;
+        place(0, base, subtrees, count);
+        std::vector<Node> nodes(count);
+        finish(0, base, subtrees, nodes);
+
+        next_task.store(0);
+        utils::parallel_team(std::min(threads, tasks.size()), [&](std::size_t) {
+            for (std::size_t i = next_task.fetch_add(1); i < tasks.size(); i = next_task.fetch_add(1)) {
+                const auto& subtree = subtrees[tasks[i]];
+                const std::size_t offset = base[tasks[i]];
+                for (std::size_t k = 0; k < subtree.size(); ++k) {
+                    Node node = subtree[k];
+                    if (!node.is_leaf()) node.offset += static_cast<std::uint32_t>(offset);
+                    nodes[offset + k] = node;
+                }
+            }
+        });
+        return nodes;
+    }
+
+private:
+    struct TopNode {
+        BVHRange<T> range;
+        std::size_t left;
+        std::size_t right;
+        bool inner;
+    };
+
+    using BinArray = std::array<BVHBin<T>, 3 * BVH_MAX_BINS>;
+
+    static Node make_node(const core::BoundingBox<T>& bounds, std::size_t offset, std::size_t count) {
+        Node node;
+        node.min_point = bounds.min_point;
+        node.offset = static_cast<std::uint32_t>(offset);
+        node.max_point = bounds.max_point;
+        node.count = static_cast<std::uint32_t>(count);
+        return node;
+    }
+
+    // Bounds and centroid bounds of the range's primitives
+    void measure(BVHRange<T>& range, bool parallel) const {
+        auto accumulate = [&](std::size_t begin, std::size_t end, BVHBin<T>& bin, core::BoundingBox<T>& centroids) {
+            for (std::size_t i = begin; i < end; ++i) {
+                bin.add(primitives_[i]);
+                centroids.expand(primitives_[i].centroid());
+            }
+        };
+        BVHBin<T> total;
+        range.centroids.reset();
+        if (parallel) {
+            const std::size_t chunks = utils::parallel_chunk_count(range.size(), BVH_MIN_CHUNK);
+            std::vector<BVHBin<T>> partials(chunks);
+            std::vector<core::BoundingBox<T>> centroids(chunks);
+            utils::parallel_for_range(range.begin, range.end, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+                accumulate(begin, end, partials[chunk], centroids[chunk]);
+            }, BVH_MIN_CHUNK);
+            for (std::size_t c = 0; c < chunks; ++c) {
+                total.merge(partials[c]);
+                if (partials[c].count) range.centroids.expand(centroids[c]);
+            }
+        } else {
+            accumulate(range.begin, range.end, total, range.centroids);
+        }
+        range.bounds = total.bounds;
+    }
+
+    // Sorts the primitives by Morton code of their centroids: a counting sort on the top
+    // 12 bits, then each bucket sorted on its own
+    void sort_morton(const BVHRange<T>& root) {
+        const std::size_t n = primitives_.size();
+        const math::Vector3<T> low = root.centroids.min_point;
+        const math::Vector3<T> extent = root.centroids.size();
+        constexpr std::size_t bucket_count = std::size_t(1) << 12;
+
+        std::unique_ptr<std::atomic<std::uint32_t>[]> bucket_sizes(new std::atomic<std::uint32_t>[bucket_count + 1]());
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            auto coordinate = [](T x, T min_x, T size) {
+                const T scaled = size > T(0) ? (x - min_x) / size * T(1024) : T(0);
+                return static_cast<std::uint32_t>(scaled > T(0) ? std::min(scaled, T(1023)) : T(0));
+            };
+            for (std::size_t i = begin; i < end; ++i) {
+                const math::Vector3<T> c = primitives_[i].centroid();
+                const std::uint32_t code = math::morton_encode(coordinate(c.x, low.x, extent.x),
+                                                               coordinate(c.y, low.y, extent.y),
+                                                               coordinate(c.z, low.z, extent.z));
+                primitives_[i].code = code;
+                bucket_sizes[(code >> 18) + 1].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, BVH_MIN_CHUNK);
+
+        std::vector<std::size_t> bucket_offsets(bucket_count + 1, 0);
+        for (std::size_t b = 0; b < bucket_count; ++b) {
+            bucket_offsets[b + 1] = bucket_offsets[b] + bucket_sizes[b + 1].load(std::memory_order_relaxed);
+            bucket_sizes[b + 1].store(0, std::memory_order_relaxed);
+        }
+
+        std::vector<BVHPrimitive<T>> sorted(n);
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::size_t bucket = primitives_[i].code >> 18;
+                sorted[bucket_offsets[bucket] + bucket_sizes[bucket + 1].fetch_add(1, std::memory_order_relaxed)] =
+                    primitives_[i];
+            }
+        }, BVH_MIN_CHUNK);
+
+        // Ties are broken on the triangle so the order does not depend on the scatter
+        utils::parallel_for_range(0, bucket_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::sort(sorted.begin() + bucket_offsets[b], sorted.begin() + bucket_offsets[b + 1],
+                          [](const BVHPrimitive<T>& a, const BVHPrimitive<T>& c) {
+                              return a.code != c.code ? a.code < c.code : a.triangle < c.triangle;
+                          });
+            }
+        }, 64);
+        primitives_.swap(sorted);
+    }
+
+    // Maps centroid coordinates of a range to bins; axes without extent put everything
+    // in bin 0. Coordinates are passed by axis, as Vector3 indexing branches.
+    struct BinMapping {
+        T low[3];
+        T scale[3];
+        T last;
+
+        BinMapping(const BVHRange<T>& range, std::size_t bins) : last(T(bins - 1)) {
+            const math::Vector3<T>& min_point = range.centroids.min_point;
+            const math::Vector3<T> extent = range.centroids.size();
+            low[0] = min_point.x;
+            low[1] = min_point.y;
+            low[2] = min_point.z;
+            scale[0] = extent.x > T(0) ? T(bins) / extent.x : T(0);
+            scale[1] = extent.y > T(0) ? T(bins) / extent.y : T(0);
+            scale[2] = extent.z > T(0) ? T(bins) / extent.z : T(0);
+        }
+
+        std::size_t operator()(T coordinate, std::size_t axis) const {
+            const T k = (coordinate - low[axis]) * scale[axis];
+            return k > T(0) ? static_cast<std::size_t>(std::min(k, last)) : 0;
+        }
+    };
+
+    void fill_bins(const BinMapping& mapping, std::size_t begin, std::size_t end, BinArray& bins) const {
+        for (std::size_t i = begin; i < end; ++i) {
+            const BVHPrimitive<T> primitive = primitives_[i];
+            const math::Vector3<T> centroid = primitive.centroid();
+            bins[mapping(centroid.x, 0)].add(primitive);
+            bins[BVH_MAX_BINS + mapping(centroid.y, 1)].add(primitive);
+            bins[2 * BVH_MAX_BINS + mapping(centroid.z, 2)].add(primitive);
+        }
+    }
+
+    // Splits range into left and right, or returns false to make it a leaf. Small ranges
+    // use fewer bins; bins is scratch space.
+    bool split(const BVHRange<T>& range, BVHRange<T>& left, BVHRange<T>& right, BinArray& bins, bool parallel) {
+        const std::size_t n = range.size();
+        if (n <= 1) return false;
+        left.depth = right.depth = range.depth + 1;
+        left.begin = range.begin;
+        right.end = range.end;
+
+        if (config_.build == BVHConfig::MORTON) {
+            if (n <= max_leaf_size_) return false;
+            const std::uint32_t first = primitives_[range.begin].code;
+            const std::uint32_t last = primitives_[range.end - 1].code;
+            std::size_t middle = range.begin + n / 2;
+            if (first != last) {
+                std::uint32_t bit = 1u << 31;
+                while (!((first ^ last) & bit)) bit >>= 1;
+                middle = static_cast<std::size_t>(
+                    std::partition_point(primitives_.begin() + range.begin, primitives_.begin() + range.end,
+                                         [bit](const BVHPrimitive<T>& p) { return !(p.code & bit); }) -
+                    primitives_.begin());
+            }
+            left.end = right.begin = middle;
+            return true;
+        }
+
+        auto split_median = [&]() {
+            left.end = right.begin = range.begin + n / 2;
+            measure(left, parallel);
+            measure(right, parallel);
+            return true;
+        };
+        if (range.depth >= BVH_SAH_DEPTH) return n > max_leaf_size_ && split_median();
+
+        // Bin centroids along each axis
+        const std::size_t bin_count = std::min(bins_, std::max<std::size_t>(4, n));
+        const BinMapping mapping(range, bin_count);
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            std::fill_n(bins.begin() + axis * BVH_MAX_BINS, bin_count, BVHBin<T>());
+        }
+        if (parallel) {
+            std::vector<BinArray> partials(utils::parallel_chunk_count(n, BVH_MIN_CHUNK));
+            utils::parallel_for_range(range.begin, range.end, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+                fill_bins(mapping, begin, end, partials[chunk]);
+            }, BVH_MIN_CHUNK);
+            for (const auto& partial : partials) {
+                for (std::size_t b = 0; b < bins.size(); ++b) bins[b].merge(partial[b]);
+            }
+        } else {
+            fill_bins(mapping, range.begin, range.end, bins);
+        }
+
+        // Sweep the bins from the right, then from the left, for the cheapest split
+        T best_cost = std::numeric_limits<T>::infinity();
+        std::size_t best_axis = 3;
+        std::size_t best_bin = 0;
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            const BVHBin<T>* axis_bins = &bins[axis * BVH_MAX_BINS];
+            std::array<T, BVH_MAX_BINS> right_cost{};
+            BVHBin<T> accumulated;
+            for (std::size_t b = bin_count - 1; b > 0; --b) {
+                accumulated.merge(axis_bins[b]);
+                right_cost[b] = accumulated.count ? T(accumulated.count) * accumulated.bounds.surface_area() : T(0);
+            }
+            accumulated = BVHBin<T>();
+            for (std::size_t b = 1; b < bin_count; ++b) {
+                accumulated.merge(axis_bins[b - 1]);
+                if (accumulated.count == 0 || accumulated.count == n) continue;
+                const T cost = T(accumulated.count) * accumulated.bounds.surface_area() + right_cost[b];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = b;
+                }
+            }
+        }
+
+        if (best_axis == 3) return n > max_leaf_size_ && split_median();
+        if (n <= max_leaf_size_) {
+            const T area = range.bounds.surface_area();
+            if (!(area > T(0)) || traversal_cost_ + best_cost / area >= T(n)) return false;
+        }
+
+        // The bin sums give the child bounds; partitioning measures their centroids
+        BVHBin<T> left_bin, right_bin;
+        for (std::size_t b = 0; b < bin_count; ++b) {
+            (b < best_bin ? left_bin : right_bin).merge(bins[best_axis * BVH_MAX_BINS + b]);
+        }
+        left.end = right.begin = range.begin + left_bin.count;
+        left.bounds = left_bin.bounds;
+        right.bounds = right_bin.bounds;
+        auto goes_left = [&](const math::Vector3<T>& centroid) {
+            const T coordinate = best_axis == 0 ? centroid.x : best_axis == 1 ? centroid.y : centroid.z;
+            return mapping(coordinate, best_axis) < best_bin;
+        };
+        if (parallel) {
+            partition_parallel(left, right, goes_left);
+        } else {
+            partition(left, right, goes_left);
+        }
+        return true;
+    }
+
+    template<typename Predicate>
+    void partition(BVHRange<T>& left, BVHRange<T>& right, Predicate&& goes_left) {
+        left.centroids.reset();
+        right.centroids.reset();
+        std::size_t i = left.begin;
+        std::size_t j = right.end;
+        while (true) {
+            for (; i < j; ++i) {
+                const math::Vector3<T> centroid = primitives_[i].centroid();
+                if (!goes_left(centroid)) break;
+                left.centroids.expand(centroid);
+            }
+            for (; i < j; --j) {
+                const math::Vector3<T> centroid = primitives_[j - 1].centroid();
+                if (goes_left(centroid)) break;
+                right.centroids.expand(centroid);
+            }
+            if (i == j) return;
+            std::swap(primitives_[i], primitives_[j - 1]);
+        }
+    }
+
+    // Stable partition through the scratch buffer: count and measure per chunk, then
+    // scatter and copy back
+    template<typename Predicate>
+    void partition_parallel(BVHRange<T>& left, BVHRange<T>& right, Predicate&& goes_left) {
+        const std::size_t begin_all = left.begin;
+        const std::size_t middle = right.begin;
+        const std::size_t chunks = utils::parallel_chunk_count(right.end - begin_all, BVH_MIN_CHUNK);
+        std::vector<std::size_t> left_offsets(chunks + 1, 0);
+        std::vector<core::BoundingBox<T>> left_centroids(chunks), right_centroids(chunks);
+        utils::parallel_for_range(begin_all, right.end, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            std::size_t count = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                const math::Vector3<T> centroid = primitives_[i].centroid();
+                if (goes_left(centroid)) {
+                    left_centroids[chunk].expand(centroid);
+                    ++count;
+                } else {
+                    right_centroids[chunk].expand(centroid);
+                }
+            }
+            left_offsets[chunk + 1] = count;
+        }, BVH_MIN_CHUNK);
+
+        left.centroids.reset();
+        right.centroids.reset();
+        for (std::size_t c = 0; c < chunks; ++c) {
+            if (left_centroids[c].is_valid()) left.centroids.expand(left_centroids[c]);
+            if (right_centroids[c].is_valid()) right.centroids.expand(right_centroids[c]);
+            left_offsets[c + 1] += left_offsets[c];
+        }
+
+        utils::parallel_for_range(begin_all, right.end, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            std::size_t to_left = begin_all + left_offsets[chunk];
+            std::size_t to_right = middle + (begin - begin_all) - left_offsets[chunk];
+            for (std::size_t i = begin; i < end; ++i) {
+                scratch_[goes_left(primitives_[i].centroid()) ? to_left++ : to_right++] = primitives_[i];
+            }
+        }, BVH_MIN_CHUNK);
+
+        utils::parallel_for_range(begin_all, right.end, [&](std::size_t begin, std::size_t end, std::size_t) {
+            std::copy(scratch_.begin() + begin, scratch_.begin() + end, primitives_.begin() + begin);
+        }, BVH_MIN_CHUNK);
+    }
+
+    // Depth-first subtree with local node indices; returns its bounds
+    core::BoundingBox<T> build_subtree(const BVHRange<T>& range, std::vector<Node>& nodes, BinArray& bins) {
+        const std::size_t index = nodes.size();
+        nodes.emplace_back();
+
+        BVHRange<T> left, right;
+        core::BoundingBox<T> bounds;
+        if (!split(range, left, right, bins, false)) {
+            for (std::size_t i = range.begin; i < range.end; ++i) {
+                bounds.expand(primitives_[i].min_point);
+                bounds.expand(primitives_[i].max_point);
+            }
+            nodes[index] = make_node(bounds, range.begin, range.size());
+            return bounds;
+        }
+
+        bounds = build_subtree(left, nodes, bins);
+        const std::size_t right_index = nodes.size();
+        bounds.expand(build_subtree(right, nodes, bins));
+        nodes[index] = make_node(bounds, right_index, 0);
+        return bounds;
+    }
+
+    // Final index of every top node and subtree root, in depth-first order
+    void place(std::size_t i, std::vector<std::size_t>& base, const std::vector<std::vector<Node>>& subtrees,
+               std::size_t& count) const {
+        base[i] = count;
+        if (!top_[i].inner) {
+            count += subtrees[i].size();
+            return;
+        }
+        ++count;
+        place(top_[i].left, base, subtrees, count);
+        place(top_[i].right, base, subtrees, count);
+    }
+
+    core::BoundingBox<T> finish(std::size_t i, const std::vector<std::size_t>& base,
+                                const std::vector<std::vector<Node>>& subtrees, std::vector<Node>& nodes) const {
+        if (!top_[i].inner) {
+            const Node& root = subtrees[i].front();
+            return core::BoundingBox<T>(root.min_point, root.max_point);
+        }
+        core::BoundingBox<T> bounds = finish(top_[i].left, base, subtrees, nodes);
+        bounds.expand(finish(top_[i].right, base, subtrees, nodes));
+        nodes[base[i]] = make_node(bounds, base[top_[i].right], 0);
+        return bounds;
+    }
+
+    std::vector<BVHPrimitive<T>>& primitives_;
+    std::vector<BVHPrimitive<T>> scratch_;
+    std::vector<TopNode> top_;
+    const BVHConfig& config_;
+    std::size_t bins_;
+    std::size_t max_leaf_size_;
+    T traversal_cost_;
+};
+
+// Entry distance of the ray into the node's box if it is entered before t_max. A zero
+// direction component makes its inverse infinite; the NaN of a ray on a slab plane then
+// fails both comparisons and leaves the interval alone. The exit distance is padded by
+// the rounding error of the slab computation so rays grazing a box are not lost.
+template<typename T, typename Node>
+bool intersect_node(const Node& node, const math::Vector3<T>& origin, const math::Vector3<T>& inverse_direction,
+                    T t_max, T& t_entry) {
+    T t_near = T(0);
+    T t_far = t_max;
+    auto slab = [&](T low, T high, T start, T inverse) {
+        T t0 = (low - start) * inverse;
+        T t1 = (high - start) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+        t_near = t0 > t_near ? t0 : t_near;
+        t_far = t1 < t_far ? t1 : t_far;
+    };
+    slab(node.min_point.x, node.max_point.x, origin.x, inverse_direction.x);
+    slab(node.min_point.y, node.max_point.y, origin.y, inverse_direction.y);
+    slab(node.min_point.z, node.max_point.z, origin.z, inverse_direction.z);
+    t_entry = t_near;
+    return t_near <= t_far * (T(1) + T(4) * std::numeric_limits<T>::epsilon());
+}
+
+} // namespace detail
+
+template<typename T>
+void BVH<T>::build(const core::Mesh<T>& mesh, const BVHConfig& config) {
+    if (config.bins < 2 || config.bins > BVH_MAX_BINS) {
+        throw std::invalid_argument("BVH: bins must be between 2 and BVH_MAX_BINS");
+    }
+    if (config.max_leaf_size == 0) {
+        throw std::invalid_argument("BVH: max_leaf_size must be positive");
+    }
+
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    std::vector<std::size_t> first_triangle(face_count + 1, 0);
+    for (std::size_t f = 0; f < face_count; ++f) {
+        const std::size_t size = faces[f].vertices.size();
+        first_triangle[f + 1] = first_triangle[f] + (size >= 3 ? size - 2 : 0);
+    }
+    const std::size_t triangle_count = first_triangle[face_count];
+    if (triangle_count >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::out_of_range("BVH: mesh exceeds 32-bit triangle indices");
+    }
+
+    // One primitive per fan triangle, remembering its face and corners
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    std::vector<detail::BVHPrimitive<T>> primitives(triangle_count);
+    std::vector<std::array<core::VertexId, 3>> corners(triangle_count);
+    std::vector<core::FaceId> triangle_faces(triangle_count);
+    auto fan_chunk = [&](std::size_t begin, std::size_t end, std::size_t) {
+        detail::for_each_fan_triangle(mesh, begin, end, first_triangle[begin],
+            [&](std::size_t t, core::FaceId f, core::VertexId a, core::VertexId b, core::VertexId c) {
+                core::BoundingBox<T> box;
+                box.expand(vertices[a].position);
+                box.expand(vertices[b].position);
+                box.expand(vertices[c].position);
+                primitives[t] = detail::BVHPrimitive<T>{box.min_point, static_cast<std::uint32_t>(t), box.max_point, 0};
+                corners[t] = {a, b, c};
+                triangle_faces[t] = f;
+            });
+    };
+    utils::parallel_for_range(0, face_count, fan_chunk, BVH_MIN_CHUNK);
+
+    detail::BVHBuilder<T> builder(primitives, config);
+    nodes_ = builder.build();
+
+    triangles_.resize(triangle_count);
+    faces_.resize(triangle_count);
+    corners_.resize(triangle_count);
+    utils::parallel_for_range(0, triangle_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint32_t t = primitives[i].triangle;
+            const math::Vector3<T>& p0 = vertices[corners[t][0]].position;
+            triangles_[i] = Triangle{p0, vertices[corners[t][1]].position - p0, vertices[corners[t][2]].position - p0};
+            faces_[i] = triangle_faces[t];
+            corners_[i] = corners[t];
+        }
+    }, BVH_MIN_CHUNK);
+    config_ = config;
+    build_cost_ = sah_cost(T(config.traversal_cost));
+    position_version_ = mesh.position_version();
+    topology_version_ = mesh.topology_version();
+    mesh_ = &mesh;
+}
+
+template<typename T>
+RayHit<T> BVH<T>::ray_intersection(const math::Vector3<T>& ray_origin,
+                                   const math::Vector3<T>& ray_direction) const {
+    if (nodes_.empty()) return detail::ray_miss<T>();
+
+    const math::Vector3<T> inverse_direction(T(1) / ray_direction.x, T(1) / ray_direction.y, T(1) / ray_direction.z);
+    T t_max = std::numeric_limits<T>::infinity();
+    T t_entry;
+    if (!detail::intersect_node(nodes_[0], ray_origin, inverse_direction, t_max, t_entry)) {
+        return detail::ray_miss<T>();
+    }
+
+    // Nearer child first; the farther one is stacked with its entry distance and
+    // dropped when a closer hit has been found by the time it is popped
+    std::uint32_t stack[BVH_MAX_DEPTH];
+    T stack_entry[BVH_MAX_DEPTH];
+    std::size_t stack_size = 0;
+    std::uint32_t index = 0;
+    std::size_t hit_triangle = triangles_.size();
+    T hit_u = T(0), hit_v = T(0);
+    const detail::LeafRay<T> ray(ray_origin, ray_direction);
+    while (true) {
+        const Node& node = nodes_[index];
+        if (node.is_leaf()) {
+            std::size_t i;
+            if (ray.intersect(triangles_.data() + node.offset, node.count, t_max, i, hit_u, hit_v)) {
+                hit_triangle = node.offset + i;
+            }
+        } else {
+            std::uint32_t near_child = index + 1;
+            std::uint32_t far_child = node.offset;
+            T t_near, t_far;
+            const bool hit_near = detail::intersect_node(nodes_[near_child], ray_origin, inverse_direction, t_max, t_near);
+            const bool hit_far = detail::intersect_node(nodes_[far_child], ray_origin, inverse_direction, t_max, t_far);
+            if (hit_near && hit_far) {
+                if (t_far < t_near) {
+                    std::swap(near_child, far_child);
+                    std::swap(t_near, t_far);
+                }
+                stack[stack_size] = far_child;
+                stack_entry[stack_size++] = t_far;
+                index = near_child;
+                continue;
+            }
+            if (hit_near || hit_far) {
+                index = hit_near ? near_child : far_child;
+                continue;
+            }
+        }
+
+        while (stack_size > 0 && stack_entry[stack_size - 1] > t_max) --stack_size;
+        if (stack_size == 0) break;
+        index = stack[--stack_size];
+    }
+
+    if (hit_triangle == triangles_.size()) return detail::ray_miss<T>();
+    const Triangle& triangle = triangles_[hit_triangle];
+    return detail::ray_hit(ray_origin, ray_direction, triangle.edge1, triangle.edge2, t_max, hit_u, hit_v,
+                           faces_[hit_triangle]);
+}
+
+template<typename T>
+T BVH<T>::sah_cost(T traversal_cost) const {
+    if (nodes_.empty()) return T(0);
+    const T root_area = core::BoundingBox<T>(nodes_[0].min_point, nodes_[0].max_point).surface_area();
+    if (!(root_area > T(0))) return T(triangles_.size());
+
+    T cost = T(0);
+    for (const Node& node : nodes_) {
+        const T area = core::BoundingBox<T>(node.min_point, node.max_point).surface_area();
+        cost += area * (node.is_leaf() ? T(node.count) : traversal_cost);
+    }
+    return cost / root_area;
+}
+
+template<typename T>
+bool BVH<T>::refit() {
+    if (!mesh_) return false;
+    if (mesh_->topology_version() != topology_version_) {
+        build(*mesh_, config_);
+        return true;
+    }
+    if (mesh_->position_version() == position_version_) return false;
+    position_version_ = mesh_->position_version();
+    if (nodes_.empty()) return false;
+
+    const core::Vertex<T>* vertices = mesh_->vertices().data();
+    utils::parallel_for_range(0, triangles_.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const math::Vector3<T>& p0 = vertices[corners_[i][0]].position;
+            triangles_[i] = Triangle{p0, vertices[corners_[i][1]].position - p0, vertices[corners_[i][2]].position - p0};
+        }
+    }, BVH_MIN_CHUNK);
+
+    const T cost = refit_nodes(vertices);
+    const T threshold = T(config_.refit_rotation_threshold);
+    if (threshold > T(0) && cost > build_cost_ * threshold && !rotate_nodes()) build(*mesh_, config_);
+    return true;
+}
+
+template<typename T>
+void BVH<T>::partition_subtrees(std::vector<std::uint32_t>& top,
+                                std::vector<std::pair<std::uint32_t, std::uint32_t>>& subtrees) const {
+    const std::size_t threads = utils::parallel_chunk_count(nodes_.size(), BVH_MIN_CHUNK);
+    const std::size_t task_size = std::max(BVH_MIN_CHUNK, nodes_.size() / (threads * 4));
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pending;
+    pending.emplace_back(0, static_cast<std::uint32_t>(nodes_.size()));
+    while (!pending.empty()) {
+        const std::pair<std::uint32_t, std::uint32_t> range = pending.back();
+        pending.pop_back();
+        const Node& node = nodes_[range.first];
+        if (threads == 1 || node.is_leaf() || range.second - range.first <= task_size) {
+            subtrees.push_back(range);
+            continue;
+        }
+        top.push_back(range.first);
+        pending.emplace_back(node.offset, range.second);
+        pending.emplace_back(range.first + 1, node.offset);
+    }
+}
+
+template<typename T>
+T BVH<T>::refit_nodes(const core::Vertex<T>* vertices) {
+    const T traversal_cost = T(config_.traversal_cost);
+    auto refit_node = [&](std::uint32_t i) {
+        Node& node = nodes_[i];
+        detail::BVHBin<T> box;
+        if (node.is_leaf()) {
+            for (std::size_t t = node.offset, end = node.offset + node.count; t < end; ++t) {
+                for (const core::VertexId v : corners_[t]) box.grow(vertices[v].position, vertices[v].position);
+            }
+        } else {
+            box.grow(nodes_[i + 1].min_point, nodes_[i + 1].max_point);
+            box.grow(nodes_[node.offset].min_point, nodes_[node.offset].max_point);
+        }
+        node.min_point = box.bounds.min_point;
+        node.max_point = box.bounds.max_point;
+        return box.bounds.surface_area() * (node.is_leaf() ? T(node.count) : traversal_cost);
+    };
+
+    // Children follow their parents, so each subtree is refit backwards; the nodes
+    // above the subtrees go last
+    std::vector<std::uint32_t> top;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> subtrees;
+    partition_subtrees(top, subtrees);
+    std::vector<T> costs(subtrees.size(), T(0));
+    std::atomic<std::size_t> next(0);
+    const std::size_t threads = utils::parallel_chunk_count(nodes_.size(), BVH_MIN_CHUNK);
+    utils::parallel_team(std::min(threads, subtrees.size()), [&](std::size_t) {
+        for (std::size_t s = next.fetch_add(1); s < subtrees.size(); s = next.fetch_add(1)) {
+            for (std::uint32_t i = subtrees[s].second; i-- > subtrees[s].first;) costs[s] += refit_node(i);
+        }
+    });
+    T cost = T(0);
+    for (const T subtree_cost : costs) cost += subtree_cost;
+    for (std::size_t k = top.size(); k-- > 0;) cost += refit_node(top[k]);
+
+    const T root_area = core::BoundingBox<T>(nodes_[0].min_point, nodes_[0].max_point).surface_area();
+    return root_area > T(0) ? cost / root_area : T(triangles_.size());
+}
+
+template<typename T>
+bool BVH<T>::rotate_nodes() {
+    const std::size_t node_count = nodes_.size();
+    std::vector<std::uint32_t> left(node_count), right(node_count);
+    auto merged_area = [&](std::uint32_t a, std::uint32_t b) {
+        detail::BVHBin<T> box;
+        box.grow(nodes_[a].min_point, nodes_[a].max_point);
+        box.grow(nodes_[b].min_point, nodes_[b].max_point);
+        return box.bounds.surface_area();
+    };
+
+    auto area = [&](std::uint32_t a) {
+        return core::BoundingBox<T>(nodes_[a].min_point, nodes_[a].max_point).surface_area();
+    };
+    auto refresh = [&](std::uint32_t a) {
+        detail::BVHBin<T> box;
+        box.grow(nodes_[left[a]].min_point, nodes_[left[a]].max_point);
+        box.grow(nodes_[right[a]].min_point, nodes_[right[a]].max_point);
+        nodes_[a].min_point = box.bounds.min_point;
+        nodes_[a].max_point = box.bounds.max_point;
+    };
+
+    // A rotation swaps a child with a grandchild on the other side, or two grandchildren
+    // across sides. The node's box and the swapped subtrees stay as they are; only the
+    // boxes of the children change, so the swap that shrinks them the most is taken.
+    // Rotations stay within the subtree of the node, and its descendants follow it in
+    // the original order.
+    auto rotate_node = [&](std::uint32_t i) {
+        const Node& node = nodes_[i];
+        if (node.is_leaf()) return;
+        const std::uint32_t l = left[i] = i + 1;
+        const std::uint32_t r = right[i] = node.offset;
+        const bool l_inner = !nodes_[l].is_leaf();
+        const bool r_inner = !nodes_[r].is_leaf();
+
+        T best_gain = T(0);
+        std::uint32_t* best_a = nullptr;
+        std::uint32_t* best_b = nullptr;
+        auto consider = [&](T gain, std::uint32_t* a, std::uint32_t* b) {
+            if (gain > best_gain) {
+                best_gain = gain;
+                best_a = a;
+                best_b = b;
+            }
+        };
+        if (r_inner) {
+            consider(area(r) - merged_area(l, right[r]), &left[i], &left[r]);
+            consider(area(r) - merged_area(left[r], l), &left[i], &right[r]);
+        }
+        if (l_inner) {
+            consider(area(l) - merged_area(r, right[l]), &right[i], &left[l]);
+            consider(area(l) - merged_area(left[l], r), &right[i], &right[l]);
+        }
+        if (l_inner && r_inner) {
+            const T both = area(l) + area(r);
+            consider(both - merged_area(left[r], right[l]) - merged_area(left[l], right[r]), &left[l], &left[r]);
+            consider(both - merged_area(right[r], right[l]) - merged_area(left[r], left[l]), &left[l], &right[r]);
+        }
+        if (!best_a) return;
+
+        // Refresh the boxes of the children that own a swapped slot
+        std::swap(*best_a, *best_b);
+        for (const std::uint32_t* slot : {best_a, best_b}) {
+            const std::uint32_t owner = static_cast<std::uint32_t>(
+                slot >= left.data() && slot < left.data() + node_count ? slot - left.data() : slot - right.data());
+            if (owner != i) refresh(owner);
+        }
+    };
+
+    std::vector<std::uint32_t> top;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> subtrees;
+    partition_subtrees(top, subtrees);
+    std::atomic<std::size_t> next(0);
+    const std::size_t threads = utils::parallel_chunk_count(nodes_.size(), BVH_MIN_CHUNK);
+    utils::parallel_team(std::min(threads, subtrees.size()), [&](std::size_t) {
+        for (std::size_t s = next.fetch_add(1); s < subtrees.size(); s = next.fetch_add(1)) {
+            for (std::uint32_t i = subtrees[s].second; i-- > subtrees[s].first;) rotate_node(i);
+        }
+    });
+    for (std::size_t k = top.size(); k-- > 0;) rotate_node(top[k]);
+
+    // Depth first layout again, with every leaf's triangles moved to where it lands so
+    // subtrees keep contiguous triangles. Entries name the node whose right child they
+    // are, if any.
+    constexpr std::uint32_t no_parent = std::numeric_limits<std::uint32_t>::max();
+    struct Entry {
+        std::uint32_t node;
+        std::uint32_t parent;
+        std::size_t depth;
+    };
+    struct Move {
+        std::uint32_t from;
+        std::uint32_t to;
+        std::uint32_t count;
+    };
+    std::vector<Node> nodes;
+    std::vector<Move> moves;
+    nodes.reserve(node_count);
+    std::vector<Entry> stack(1, Entry{0, no_parent, 0});
+    std::uint32_t next_triangle = 0;
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        if (entry.depth >= BVH_MAX_DEPTH) return false;
+
+        const std::uint32_t index = static_cast<std::uint32_t>(nodes.size());
+        if (entry.parent != no_parent) nodes[entry.parent].offset = index;
+        Node node = nodes_[entry.node];
+        if (node.is_leaf()) {
+            moves.push_back(Move{node.offset, next_triangle, node.count});
+            node.offset = next_triangle;
+            next_triangle += node.count;
+        } else {
+            stack.push_back(Entry{right[entry.node], index, entry.depth + 1});
+            stack.push_back(Entry{left[entry.node], no_parent, entry.depth + 1});
+        }
+        nodes.push_back(node);
+    }
+
+    std::vector<Triangle> triangles(triangles_.size());
+    std::vector<core::FaceId> faces(faces_.size());
+    std::vector<std::array<core::VertexId, 3>> corners(corners_.size());
+    utils::parallel_for_range(0, moves.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t m = begin; m < end; ++m) {
+            const Move& move = moves[m];
+            std::copy_n(triangles_.begin() + move.from, move.count, triangles.begin() + move.to);
+            std::copy_n(faces_.begin() + move.from, move.count, faces.begin() + move.to);
+            std::copy_n(corners_.begin() + move.from, move.count, corners.begin() + move.to);
+        }
+    }, BVH_MIN_CHUNK);
+    nodes_.swap(nodes);
+    triangles_.swap(triangles);
+    faces_.swap(faces);
+    corners_.swap(corners);
+    return true;
+}
+
+// Brute-force closest hit over every fan triangle, split across threads. For more than
+// a handful of rays against the same mesh, build a BVH once instead.
+template<typename T>
+RayHit<T> ray_mesh_intersection(const math::Vector3<T>& ray_origin,
+                                const math::Vector3<T>& ray_direction,
+                                const core::Mesh<T>& mesh) {
+    struct Closest {
+        T t = std::numeric_limits<T>::infinity();
+        T u = T(0), v = T(0);
+        math::Vector3<T> edge1, edge2;
+        core::FaceId face = core::INVALID_FACE_ID;
+    };
+
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    const std::size_t face_count = mesh.face_count();
+    std::vector<Closest> partials(utils::parallel_chunk_count(face_count, BVH_MIN_CHUNK));
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        Closest& closest = partials[chunk];
+        detail::for_each_fan_triangle(mesh, begin, end, 0,
+            [&](std::size_t, core::FaceId f, core::VertexId a, core::VertexId b, core::VertexId c) {
+                const math::Vector3<T>& p0 = vertices[a].position;
+                const math::Vector3<T> edge1 = vertices[b].position - p0;
+                const math::Vector3<T> edge2 = vertices[c].position - p0;
+                T t, u, v;
+                if (detail::intersect_triangle(ray_origin, ray_direction, p0, edge1, edge2, closest.t, t, u, v)) {
+                    closest = Closest{t, u, v, edge1, edge2, f};
+                }
+            });
+    }, BVH_MIN_CHUNK);
+
+    // Ties go to the lowest chunk, which holds the lowest faces
+    const Closest* best = nullptr;
+    for (const auto& partial : partials) {
+        if (partial.face != core::INVALID_FACE_ID && (!best || partial.t < best->t)) best = &partial;
+    }
+    if (!best) return detail::ray_miss<T>();
+    return detail::ray_hit(ray_origin, ray_direction, best->edge1, best->edge2, best->t, best->u, best->v, best->face);
+}
+
+} // namespace spatial
+} // namespace algorithms
+} // namespace polygon_mesh
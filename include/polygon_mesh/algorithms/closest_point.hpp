@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <polygon_mesh/algorithms/bvh.hpp>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/algorithms/ray_queries.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace spatial {
+
+// Closest points on a mesh. A query walks the BVH best first: nodes wait in a heap
+// keyed on the squared distance from the point to their box, each popped node is
+// followed down its nearer children, and the walk stops once the nearest waiting box
+// is no closer than the best triangle found. Leaf triangles are measured a packet at
+// a time, with every region of Ericson's closest point test evaluated per lane.
+// Batches run in blocks of consecutive points, and each point may start from the
+// distance to its predecessor's triangle, which bounds the search from the outset for
+// scan-ordered points.
+
+// Points per block; a block is answered in order on one thread
+constexpr std::size_t CLOSEST_POINT_BLOCK = 64;
+
+// Minimum points per thread
+constexpr std::size_t CLOSEST_POINT_MIN_CHUNK = 1024;
+
+// Closest point on a face. Barycentric coordinates weigh the corners of the fan
+// triangle it lies on (corner 0, i and i + 1 of a polygon). When nothing is found,
+// distance is infinite and face_id is INVALID_FACE_ID.
+template<typename T>
+struct ClosestPoint {
+    math::Vector3<T> point;
+    T distance;
+    core::FaceId face_id;
+    math::Vector3<T> barycentric;
+};
+
+namespace detail {
+
+// Squared distance from p to the triangle a, a + ab, a + ac, and the weights v and w
+// of its closest point a + v * ab + w * ac. Regions are tested in Ericson's order:
+// vertex a, vertex b, edge ab, vertex c, edge ac, edge bc, then the interior. A
+// degenerate triangle can fall through to the interior with weights made of rounding
+// noise; clamping them back into the triangle keeps the distance from coming out
+// shorter than it is, and a distance that is not a number comes out infinite.
+template<typename T>
+T closest_point_on_triangle(const math::Vector3<T>& p, const math::Vector3<T>& a, const math::Vector3<T>& ab,
+                            const math::Vector3<T>& ac, T& v, T& w) {
+    const math::Vector3<T> ap = p - a;
+    const T d1 = ab.dot(ap);
+    const T d2 = ac.dot(ap);
+    const math::Vector3<T> bp = ap - ab;
+    const T d3 = ab.dot(bp);
+    const T d4 = ac.dot(bp);
+    const math::Vector3<T> cp = ap - ac;
+    const T d5 = ab.dot(cp);
+    const T d6 = ac.dot(cp);
+    const T va = d3 * d6 - d5 * d4;
+    const T vb = d5 * d2 - d1 * d6;
+    const T vc = d1 * d4 - d3 * d2;
+
+    if (d1 <= T(0) && d2 <= T(0)) {
+        v = T(0);
+        w = T(0);
+    } else if (d3 >= T(0) && d4 <= d3) {
+        v = T(1);
+        w = T(0);
+    } else if (vc <= T(0) && d1 >= T(0) && d3 <= T(0)) {
+        v = d1 / (d1 - d3);
+        w = T(0);
+    } else if (d6 >= T(0) && d5 <= d6) {
+        v = T(0);
+        w = T(1);
+    } else if (vb <= T(0) && d2 >= T(0) && d6 <= T(0)) {
+        v = T(0);
+        w = d2 / (d2 - d6);
+    } else if (va <= T(0) && d4 - d3 >= T(0) && d5 - d6 >= T(0)) {
+        w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        v = T(1) - w;
+    } else {
+        const T inverse = T(1) / (va + vb + vc);
+        v = vb * inverse > T(0) ? vb * inverse : T(0);
+        w = vc * inverse > T(0) ? vc * inverse : T(0);
+        const T sum = v + w;
+        if (sum > T(1)) {
+            v = v / sum;
+            w = w / sum;
+        }
+    }
+    const math::Vector3<T> offset(ap.x - (ab.x * v + ac.x * w), ap.y - (ab.y * v + ac.y * w),
+                                  ap.z - (ab.z * v + ac.z * w));
+    const T distance = offset.dot(offset);
+    return distance < std::numeric_limits<T>::infinity() ? distance : std::numeric_limits<T>::infinity();
+}
+
+// closest_point_on_triangle for one point against a packet of triangles, with the same
+// operations per lane. Every region is evaluated and the regions are applied last to
+// first, so the first that holds wins.
+template<typename T, std::size_t W>
+math::Packet<T, W> closest_point_packet(const math::Vector3xN<T, W>& p, const math::Vector3xN<T, W>& a,
+                                        const math::Vector3xN<T, W>& ab, const math::Vector3xN<T, W>& ac,
+                                        math::Packet<T, W>& v, math::Packet<T, W>& w) {
+    using P = math::Packet<T, W>;
+    using V = math::Vector3xN<T, W>;
+    const V ap = p - a;
+    const P d1 = dot_in_order(ab, ap);
+    const P d2 = dot_in_order(ac, ap);
+    const V bp = ap - ab;
+    const P d3 = dot_in_order(ab, bp);
+    const P d4 = dot_in_order(ac, bp);
+    const V cp = ap - ac;
+    const P d5 = dot_in_order(ab, cp);
+    const P d6 = dot_in_order(ac, cp);
+    const P va = d3 * d6 - d5 * d4;
+    const P vb = d5 * d2 - d1 * d6;
+    const P vc = d1 * d4 - d3 * d2;
+    const P zero = P::zero();
+    const P one(T(1));
+
+    const P inverse = one / (va + vb + vc);
+    v = vb * inverse;
+    w = vc * inverse;
+    v = select(v > zero, v, zero);
+    w = select(w > zero, w, zero);
+    const P sum = v + w;
+    const auto outside = sum > one;
+    v = select(outside, v / sum, v);
+    w = select(outside, w / sum, w);
+    auto apply = [&](const typename P::mask_type& region, const P& region_v, const P& region_w) {
+        v = select(region, region_v, v);
+        w = select(region, region_w, w);
+    };
+    const P e43 = d4 - d3;
+    const P e56 = d5 - d6;
+    const P w_bc = e43 / (e43 + e56);
+    apply((va <= zero) & (e43 >= zero) & (e56 >= zero), one - w_bc, w_bc);
+    apply((vb <= zero) & (d2 >= zero) & (d6 <= zero), zero, d2 / (d2 - d6));
+    apply((d6 >= zero) & (d5 <= d6), zero, one);
+    apply((vc <= zero) & (d1 >= zero) & (d3 <= zero), d1 / (d1 - d3), zero);
+    apply((d3 >= zero) & (d4 <= d3), one, zero);
+    apply((d1 <= zero) & (d2 <= zero), zero, zero);
+
+    const V offset(ap.x - (ab.x * v + ac.x * w), ap.y - (ab.y * v + ac.y * w), ap.z - (ab.z * v + ac.z * w));
+    const P distance = dot_in_order(offset, offset);
+    const P infinity(std::numeric_limits<T>::infinity());
+    return select(distance < infinity, distance, infinity);
+}
+
+// Squared distance from p to the node's box, zero inside it
+template<typename T, typename Node>
+T box_distance_squared(const Node& node, const math::Vector3<T>& p) {
+    const T dx = std::max(std::max(node.min_point.x - p.x, p.x - node.max_point.x), T(0));
+    const T dy = std::max(std::max(node.min_point.y - p.y, p.y - node.max_point.y), T(0));
+    const T dz = std::max(std::max(node.min_point.z - p.z, p.z - node.max_point.z), T(0));
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Best triangle so far, in leaf order, or the triangle count when there is none
+template<typename T>
+struct ClosestTriangle {
+    T distance_squared;
+    std::uint32_t triangle;
+    T v;
+    T w;
+};
+
+// Waiting node and the squared distance to its box
+template<typename T>
+struct ClosestPointEntry {
+    T distance_squared;
+    std::uint32_t node;
+
+    bool operator>(const ClosestPointEntry& other) const { return distance_squared > other.distance_squared; }
+};
+
+// Improves best with the triangles of bvh closer to p; heap is scratch space
+template<typename T>
+void closest_triangle(const BVH<T>& bvh, const math::Vector3<T>& p, ClosestTriangle<T>& best,
+                      std::vector<ClosestPointEntry<T>>& heap) {
+    constexpr std::size_t W = math::native_width<T>();
+    using P = math::Packet<T, W>;
+    using V = math::Vector3xN<T, W>;
+    const auto& nodes = bvh.nodes();
+    const auto& triangles = bvh.triangles();
+    if (nodes.empty()) return;
+
+    const V point(p);
+    const std::greater<ClosestPointEntry<T>> later;
+    heap.clear();
+    heap.push_back(ClosestPointEntry<T>{box_distance_squared(nodes[0], p), 0});
+    while (!heap.empty() && heap.front().distance_squared < best.distance_squared) {
+        std::uint32_t index = heap.front().node;
+        std::pop_heap(heap.begin(), heap.end(), later);
+        heap.pop_back();
+
+        // Down to a leaf through the nearer children, leaving the farther ones in the
+        // heap, which halves the heap traffic
+        bool pruned = false;
+        while (!pruned && !nodes[index].is_leaf()) {
+            std::uint32_t near_child = index + 1;
+            std::uint32_t far_child = nodes[index].offset;
+            T near_distance = box_distance_squared(nodes[near_child], p);
+            T far_distance = box_distance_squared(nodes[far_child], p);
+            if (far_distance < near_distance) {
+                std::swap(near_child, far_child);
+                std::swap(near_distance, far_distance);
+            }
+            if (far_distance < best.distance_squared) {
+                heap.push_back(ClosestPointEntry<T>{far_distance, far_child});
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+            pruned = !(near_distance < best.distance_squared);
+            index = near_child;
+        }
+        if (pruned) continue;
+        const auto& node = nodes[index];
+
+        // Lanes past the leaf repeat its first triangle, which never beats itself
+        for (std::size_t first = node.offset, end = node.offset + node.count; first < end; first += W) {
+            auto triangle = [&](std::size_t lane) -> const typename BVH<T>::Triangle& {
+                return triangles[first + lane < end ? first + lane : first];
+            };
+            const V a = V::generate([&](std::size_t lane) -> const math::Vector3<T>& { return triangle(lane).vertex; });
+            const V ab = V::generate([&](std::size_t lane) -> const math::Vector3<T>& { return triangle(lane).edge1; });
+            const V ac = V::generate([&](std::size_t lane) -> const math::Vector3<T>& { return triangle(lane).edge2; });
+            P v, w;
+            const P distance = closest_point_packet(point, a, ab, ac, v, w);
+            if ((distance < P(best.distance_squared)).none()) continue;
+
+            alignas(sizeof(T) * W) T distances[W];
+            alignas(sizeof(T) * W) T vs[W];
+            alignas(sizeof(T) * W) T ws[W];
+            distance.store_aligned(distances);
+            v.store_aligned(vs);
+            w.store_aligned(ws);
+            for (std::size_t lane = 0; lane < W && first + lane < end; ++lane) {
+                if (distances[lane] < best.distance_squared) {
+                    best = ClosestTriangle<T>{distances[lane], static_cast<std::uint32_t>(first + lane), vs[lane], ws[lane]};
+                }
+            }
+        }
+    }
+}
+
+// Starts best at triangle, if it is closer than best already
+template<typename T>
+void seed_closest_triangle(const BVH<T>& bvh, const math::Vector3<T>& p, std::uint32_t triangle,
+                           ClosestTriangle<T>& best) {
+    const auto& seed = bvh.triangles()[triangle];
+    T v, w;
+    const T distance = closest_point_on_triangle(p, seed.vertex, seed.edge1, seed.edge2, v, w);
+    if (distance < best.distance_squared) best = ClosestTriangle<T>{distance, triangle, v, w};
+}
+
+template<typename T>
+ClosestPoint<T> closest_point_result(const BVH<T>& bvh, const ClosestTriangle<T>& best) {
+    ClosestPoint<T> result;
+    if (best.triangle == bvh.triangle_count()) {
+        result.point = math::Vector3<T>(0);
+        result.distance = std::numeric_limits<T>::infinity();
+        result.face_id = core::INVALID_FACE_ID;
+        result.barycentric = math::Vector3<T>(0);
+        return result;
+    }
+    const auto& triangle = bvh.triangles()[best.triangle];
+    result.point = triangle.vertex + triangle.edge1 * best.v + triangle.edge2 * best.w;
+    result.distance = std::sqrt(best.distance_squared);
+    result.face_id = bvh.triangle_faces()[best.triangle];
+    result.barycentric = math::Vector3<T>(T(1) - best.v - best.w, best.v, best.w);
+    return result;
+}
+
+template<typename T>
+ClosestTriangle<T> no_closest_triangle(const BVH<T>& bvh, T max_distance) {
+    return ClosestTriangle<T>{max_distance * max_distance, static_cast<std::uint32_t>(bvh.triangle_count()), T(0),
+                              T(0)};
+}
+
+} // namespace detail
+
+// Closest point of the hierarchy's triangles to point, if one is closer than
+// max_distance
+template<typename T>
+ClosestPoint<T> closest_point(const BVH<T>& bvh, const math::Vector3<T>& point,
+                              T max_distance = std::numeric_limits<T>::infinity()) {
+    detail::ClosestTriangle<T> best = detail::no_closest_triangle(bvh, max_distance);
+    std::vector<detail::ClosestPointEntry<T>> heap;
+    detail::closest_triangle(bvh, point, best, heap);
+    return detail::closest_point_result(bvh, best);
+}
+
+// results[i] is the closest point to points[i], as from closest_point. Throws
+// std::invalid_argument when the spans differ in size.
+template<typename T>
+void closest_points(const BVH<T>& bvh, utils::Span<const math::Vector3<T>> points,
+                    utils::Span<ClosestPoint<T>> results, const ClosestPointConfig& config = ClosestPointConfig()) {
+    if (results.size() != points.size()) {
+        throw std::invalid_argument("closest_points: results and points differ in size");
+    }
+    const T max_distance = T(config.max_distance);
+    const std::size_t count = points.size();
+    const std::size_t blocks = (count + CLOSEST_POINT_BLOCK - 1) / CLOSEST_POINT_BLOCK;
+    utils::parallel_for_range(0, blocks, [&](std::size_t begin, std::size_t end, std::size_t) {
+        std::vector<detail::ClosestPointEntry<T>> heap;
+        for (std::size_t block = begin; block < end; ++block) {
+            std::uint32_t previous = static_cast<std::uint32_t>(bvh.triangle_count());
+            for (std::size_t i = block * CLOSEST_POINT_BLOCK, last = std::min(count, i + CLOSEST_POINT_BLOCK); i < last;
+                 ++i) {
+                detail::ClosestTriangle<T> best = detail::no_closest_triangle(bvh, max_distance);
+                if (config.reuse_neighbors && previous != bvh.triangle_count()) {
+                    detail::seed_closest_triangle(bvh, points[i], previous, best);
+                }
+                detail::closest_triangle(bvh, points[i], best, heap);
+                previous = best.triangle;
+                results[i] = detail::closest_point_result(bvh, best);
+            }
+        }
+    }, CLOSEST_POINT_MIN_CHUNK / CLOSEST_POINT_BLOCK);
+}
+
+namespace detail {
+
+// Closest point over every fan triangle of mesh, split across threads; ties go to the
+// lowest face
+template<typename T>
+bool closest_mesh_point(const math::Vector3<T>& point, const core::Mesh<T>& mesh, T& distance_squared,
+                        math::Vector3<T>& closest_point) {
+    struct Closest {
+        T distance_squared = std::numeric_limits<T>::infinity();
+        math::Vector3<T> point;
+        bool found = false;
+    };
+
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    const std::size_t face_count = mesh.face_count();
+    std::vector<Closest> partials(utils::parallel_chunk_count(face_count, BVH_MIN_CHUNK));
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        Closest& closest = partials[chunk];
+        for_each_fan_triangle(mesh, begin, end, 0,
+            [&](std::size_t, core::FaceId, core::VertexId a, core::VertexId b, core::VertexId c) {
+                const math::Vector3<T>& p0 = vertices[a].position;
+                const math::Vector3<T> edge1 = vertices[b].position - p0;
+                const math::Vector3<T> edge2 = vertices[c].position - p0;
+                T v, w;
+                const T distance = closest_point_on_triangle(point, p0, edge1, edge2, v, w);
+                if (distance < closest.distance_squared) {
+                    closest = Closest{distance, p0 + edge1 * v + edge2 * w, true};
+                }
+            });
+    }, BVH_MIN_CHUNK);
+
+    const Closest* best = nullptr;
+    for (const auto& partial : partials) {
+        if (partial.found && (!best || partial.distance_squared < best->distance_squared)) best = &partial;
+    }
+    if (!best) return false;
+    distance_squared = best->distance_squared;
+    closest_point = best->point;
+    return true;
+}
+
+} // namespace detail
+
+// Brute-force distance from point to mesh, infinite for a mesh without triangles. For
+// more than a handful of points against the same mesh, build a BVH once instead.
+template<typename T>
+T point_to_mesh_distance(const math::Vector3<T>& point, const core::Mesh<T>& mesh) {
+    T distance_squared;
+    math::Vector3<T> closest;
+    if (!detail::closest_mesh_point(point, mesh, distance_squared, closest)) return std::numeric_limits<T>::infinity();
+    return std::sqrt(distance_squared);
+}
+
+// Brute-force closest point on mesh, as point_to_mesh_distance. Throws
+// std::invalid_argument for a mesh without triangles.
+template<typename T>
+math::Vector3<T> closest_point_on_mesh(const math::Vector3<T>& point, const core::Mesh<T>& mesh) {
+    T distance_squared;
+    math::Vector3<T> closest;
+    if (!detail::closest_mesh_point(point, mesh, distance_squared, closest)) {
+        throw std::invalid_argument("closest_point_on_mesh: mesh has no triangles");
+    }
+    return closest;
+}
+
+} // namespace spatial
+} // namespace algorithms
+} // namespace polygon_mesh
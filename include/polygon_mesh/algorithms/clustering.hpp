@@ -0,0 +1,587 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/decimation.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/bounds.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Vertex clustering decimation (Rossignac & Borrel, with Lindstrom's quadric
+// representatives). A uniform grid is laid over the mesh and each cell's vertices are
+// merged into one, so the cost per vertex is constant whatever the reduction. Topology
+// is not preserved: thin parts may fuse and small holes close, which is fine for
+// previews but not for meshes that must stay manifold.
+
+// Minimum vertices or faces per thread
+constexpr std::size_t CLUSTER_MIN_CHUNK = 16384;
+
+// Largest grid resolution; three cell coordinates are packed into a 64-bit key
+constexpr std::size_t CLUSTER_MAX_GRID_RESOLUTION = std::size_t(1) << 21;
+
+// Eigenvalues of a cell quadric below this fraction of its largest are treated as zero,
+// so the representative stays at the mean along those directions
+constexpr double CLUSTER_SINGULAR_THRESHOLD = 1e-3;
+
+namespace detail {
+
+// Cubic cells over a box, grid_resolution of them along its longest side and as many
+// as needed along the others. Points outside the box fall into the nearest border cell.
+template<typename T>
+class ClusterGrid {
+public:
+    ClusterGrid(const math::Vector3<T>& min_point, const math::Vector3<T>& max_point,
+                std::size_t grid_resolution) {
+        if (grid_resolution == 0 || grid_resolution > CLUSTER_MAX_GRID_RESOLUTION) {
+            throw std::invalid_argument("cluster_decimation: grid resolution out of range");
+        }
+        origin_ = math::Vector3<double>(min_point.x, min_point.y, min_point.z);
+        const math::Vector3<double> extent = math::Vector3<double>(max_point.x, max_point.y, max_point.z) - origin_;
+        const double size = std::max(extent.x, std::max(extent.y, extent.z));
+        cell_size_ = size > 0.0 && std::isfinite(size) ? size / double(grid_resolution) : 1.0;
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            const double cells = std::ceil(extent[axis] / cell_size_);
+            dims_[axis] = cells >= 1.0 ? std::min(static_cast<std::uint64_t>(cells), std::uint64_t(grid_resolution)) : 1;
+        }
+    }
+
+    std::uint64_t key(const math::Vector3<T>& p) const {
+        return coordinate(p.x, 0) + dims_[0] * (coordinate(p.y, 1) + dims_[1] * coordinate(p.z, 2));
+    }
+
+    // Lowest and highest corner of the cell with the given key
+    std::array<math::Vector3<double>, 2> cell_bounds(std::uint64_t key) const {
+        const double x = double(key % dims_[0]);
+        key /= dims_[0];
+        const double y = double(key % dims_[1]);
+        const double z = double(key / dims_[1]);
+        const math::Vector3<double> low = origin_ + math::Vector3<double>(x, y, z) * cell_size_;
+        return {low, low + math::Vector3<double>(cell_size_)};
+    }
+
+private:
+    // NaN lands in cell 0 along with everything below the box
+    std::uint64_t coordinate(T value, std::size_t axis) const {
+        const double c = (double(value) - origin_[axis]) / cell_size_;
+        if (!(c >= 0.0)) return 0;
+        if (c >= double(dims_[axis])) return dims_[axis] - 1;
+        return static_cast<std::uint64_t>(c);
+    }
+
+    math::Vector3<double> origin_;
+    double cell_size_ = 1.0;
+    std::uint64_t dims_[3] = {1, 1, 1};
+};
+
+// Plane (a, b, c, d) of a polygon scaled by the square root of its area, so that
+// Quadric::plane(a, b, c, d, 1) is its area-weighted quadric. The normal is the sum of
+// the fan triangles' normals; degenerate polygons give zeros. position(i) returns the
+// i-th of the count corners.
+template<typename Position>
+std::array<double, 4> polygon_plane(std::size_t count, Position&& position) {
+    const auto first = position(0);
+    const math::Vector3<double> p0(first.x, first.y, first.z);
+    math::Vector3<double> normal(0);
+    math::Vector3<double> centroid = p0;
+    math::Vector3<double> previous(0);
+    for (std::size_t i = 1; i < count; ++i) {
+        const auto corner = position(i);
+        const math::Vector3<double> p(corner.x, corner.y, corner.z);
+        centroid += p;
+        const math::Vector3<double> edge = p - p0;
+        if (i > 1) normal += previous.cross(edge);
+        previous = edge;
+    }
+
+    const double length = normal.length();
+    if (!(length > 0.0) || !std::isfinite(length)) return {0.0, 0.0, 0.0, 0.0};
+    const math::Vector3<double> unit = normal / length;
+    centroid = centroid / double(count);
+    const double weight = std::sqrt(0.5 * length);
+    return {unit.x * weight, unit.y * weight, unit.z * weight, -unit.dot(centroid) * weight};
+}
+
+// Eigen decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations. On return
+// a is diagonal (the eigenvalues) and the columns of v are the eigenvectors.
+inline void symmetric_eigen3(double a[3][3], double v[3][3]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+    }
+    for (int sweep = 0; sweep < 16; ++sweep) {
+        const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        const double diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+        if (!(off > 1e-30 * diagonal)) return;
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (a[p][q] == 0.0) continue;
+                const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Point of least quadric error nearest to center (Lindstrom): the error is minimized
+// along the eigenvectors whose eigenvalues reach CLUSTER_SINGULAR_THRESHOLD times the
+// largest, and left at center along the others. A cell on a smooth patch moves its
+// mean onto the best-fit plane; one on a crease or corner snaps to the feature.
+inline math::Vector3<double> quadric_point_near(const Quadric<double>& quadric, const math::Vector3<double>& center) {
+    const double* q = quadric.q;
+    double a[3][3] = {{q[0], q[1], q[2]}, {q[1], q[4], q[5]}, {q[2], q[5], q[7]}};
+    const double residual[3] = {-(q[0] * center.x + q[1] * center.y + q[2] * center.z + q[3]),
+                                -(q[1] * center.x + q[4] * center.y + q[5] * center.z + q[6]),
+                                -(q[2] * center.x + q[5] * center.y + q[7] * center.z + q[8])};
+    double v[3][3];
+    symmetric_eigen3(a, v);
+
+    const double largest = std::max(std::abs(a[0][0]), std::max(std::abs(a[1][1]), std::abs(a[2][2])));
+    math::Vector3<double> point = center;
+    for (int i = 0; i < 3; ++i) {
+        const double lambda = a[i][i];
+        if (!(lambda > CLUSTER_SINGULAR_THRESHOLD * largest)) continue;
+        const double step = (v[0][i] * residual[0] + v[1][i] * residual[1] + v[2][i] * residual[2]) / lambda;
+        point += math::Vector3<double>(v[0][i], v[1][i], v[2][i]) * step;
+    }
+    return point;
+}
+
+// The quadric point nearest the mean when there is a quadric and that point lies in
+// the cell; the mean otherwise
+template<typename T>
+math::Vector3<T> cluster_representative(const Quadric<double>* quadric, const math::Vector3<double>& mean,
+                                        const std::array<math::Vector3<double>, 2>& cell) {
+    math::Vector3<double> point = mean;
+    if (quadric) {
+        const math::Vector3<double> optimum = quadric_point_near(*quadric, mean);
+        if (optimum.x >= cell[0].x && optimum.y >= cell[0].y && optimum.z >= cell[0].z &&
+            optimum.x <= cell[1].x && optimum.y <= cell[1].y && optimum.z <= cell[1].z) {
+            point = optimum;
+        }
+    }
+    return math::Vector3<T>(T(point.x), T(point.y), T(point.z));
+}
+
+// Fixed-capacity open-addressing hash table from cell keys to slots, filled by
+// concurrent insert() calls. Each slot also keeps the lowest vertex inserted under its
+// key, which orders the cells the same way however the threads interleave.
+class ConcurrentCellTable {
+public:
+    explicit ConcurrentCellTable(std::size_t max_keys) {
+        while (capacity_ < 2 * max_keys) capacity_ *= 2;
+        keys_.reset(new std::atomic<std::uint64_t>[capacity_]());
+        first_.reset(new std::atomic<std::uint32_t>[capacity_]());
+    }
+
+    // Slot holding key, claimed if the key is new. Keys are stored plus one, so a zero
+    // marks a free slot.
+    std::size_t insert(std::uint64_t key, std::uint32_t vertex) {
+        const std::uint64_t stored = key + 1;
+        std::size_t slot = static_cast<std::size_t>(mix(key)) & (capacity_ - 1);
+        for (;;) {
+            std::uint64_t current = keys_[slot].load(std::memory_order_relaxed);
+            if (current == 0 && keys_[slot].compare_exchange_strong(current, stored, std::memory_order_relaxed)) break;
+            if (current == stored) break;
+            slot = (slot + 1) & (capacity_ - 1);
+        }
+
+        // Complemented so that the zero-initialized value means "none" and lower
+        // vertices compare higher
+        const std::uint32_t rank = ~vertex;
+        std::uint32_t seen = first_[slot].load(std::memory_order_relaxed);
+        while (seen < rank && !first_[slot].compare_exchange_weak(seen, rank, std::memory_order_relaxed)) {
+        }
+        return slot;
+    }
+
+    std::uint32_t first_vertex(std::size_t slot) const { return ~first_[slot].load(std::memory_order_relaxed); }
+
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    // splitmix64 finalizer; neighboring cells must not land in neighboring slots
+    static std::uint64_t mix(std::uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    std::size_t capacity_ = 16;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> keys_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> first_;
+};
+
+// Items grouped by cell in compressed sparse row form: cell c holds
+// items[offsets[c] .. offsets[c + 1]), in increasing order
+struct CellGroups {
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> items;
+};
+
+// entries(i, emit) calls emit(cell, item) for every entry that source i contributes
+template<typename Entries>
+CellGroups group_by_cell(std::size_t source_count, std::size_t cell_count, Entries&& entries) {
+    std::unique_ptr<std::atomic<std::size_t>[]> cursor(new std::atomic<std::size_t>[cell_count + 1]());
+    utils::parallel_for_range(0, source_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            entries(i, [&](std::uint32_t cell, std::uint32_t) {
+                cursor[cell + 1].fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    CellGroups groups;
+    groups.offsets.resize(cell_count + 1);
+    groups.offsets[0] = 0;
+    for (std::size_t c = 0; c < cell_count; ++c) {
+        groups.offsets[c + 1] = groups.offsets[c] + cursor[c + 1].load(std::memory_order_relaxed);
+        cursor[c].store(groups.offsets[c], std::memory_order_relaxed);
+    }
+
+    groups.items.resize(groups.offsets[cell_count]);
+    utils::parallel_for_range(0, source_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            entries(i, [&](std::uint32_t cell, std::uint32_t item) {
+                groups.items[cursor[cell].fetch_add(1, std::memory_order_relaxed)] = item;
+            });
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    // Fill order depends on thread timing; sorting makes the sums below reproducible
+    utils::parallel_for_range(0, cell_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t c = begin; c < end; ++c) {
+            std::sort(groups.items.begin() + groups.offsets[c], groups.items.begin() + groups.offsets[c + 1]);
+        }
+    }, CLUSTER_MIN_CHUNK);
+    return groups;
+}
+
+} // namespace detail
+
+// Clusters the vertices on a grid with grid_resolution cells along the longest side of
+// the bounding box. Each occupied cell becomes one vertex, carrying the attributes of
+// the cell's lowest-indexed vertex and the position chosen by representative. Faces are
+// re-indexed, dropping repeated corners; those left with fewer than three are removed,
+// as are vertices no face uses. Faces that end up on the same cells are all kept.
+// Throws std::invalid_argument for a resolution of zero or above
+// CLUSTER_MAX_GRID_RESOLUTION.
+template<typename T>
+void cluster_decimation(core::Mesh<T>& mesh, std::size_t grid_resolution, ClusterRepresentative representative) {
+    const auto& vertices = mesh.vertices();
+    const std::size_t vertex_count = vertices.size();
+    const auto bounds = vertex_count > 0
+        ? math::compute_bounds(&vertices[0].position, vertex_count, sizeof(core::Vertex<T>))
+        : std::array<math::Vector3<T>, 2>{math::Vector3<T>(0), math::Vector3<T>(0)};
+    const detail::ClusterGrid<T> grid(bounds[0], bounds[1], grid_resolution);
+    if (mesh.face_count() == 0) return;
+
+    // Bin the vertices into the concurrent table
+    detail::ConcurrentCellTable table(vertex_count);
+    std::vector<std::size_t> slot_of(vertex_count);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        // Neighboring vertices tend to share a cell; a repeat of the previous key is
+        // already in the table with a lower vertex
+        std::uint64_t previous_key = std::numeric_limits<std::uint64_t>::max();
+        std::size_t previous_slot = 0;
+        for (std::size_t v = begin; v < end; ++v) {
+            const std::uint64_t key = grid.key(vertices[v].position);
+            if (key != previous_key) {
+                previous_key = key;
+                previous_slot = table.insert(key, static_cast<std::uint32_t>(v));
+            }
+            slot_of[v] = previous_slot;
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    // Number the cells in order of their lowest vertex
+    std::vector<std::uint32_t> cell_of_slot(table.capacity());
+    std::vector<core::VertexId> cell_first(vertex_count);
+    auto leads_cell = [&](std::size_t v) { return table.first_vertex(slot_of[v]) == v; };
+    const std::size_t cell_count = utils::parallel_compact(vertex_count, leads_cell, [&](std::size_t v, std::size_t position) {
+        cell_of_slot[slot_of[v]] = static_cast<std::uint32_t>(position);
+        cell_first[position] = static_cast<core::VertexId>(v);
+    }, CLUSTER_MIN_CHUNK);
+    cell_first.resize(cell_count);
+
+    std::vector<std::uint32_t> cell_of(vertex_count);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) cell_of[v] = cell_of_slot[slot_of[v]];
+    }, CLUSTER_MIN_CHUNK);
+    slot_of = std::vector<std::size_t>();
+    cell_of_slot = std::vector<std::uint32_t>();
+
+    // Representatives: the mean of the cell's vertices, and the minimizer of the summed
+    // face quadrics when asked for and usable
+    const auto& faces = mesh.faces();
+    const detail::CellGroups members = detail::group_by_cell(vertex_count, cell_count, [&](std::size_t v, auto&& emit) {
+        emit(cell_of[v], static_cast<std::uint32_t>(v));
+    });
+    // Face planes in one sequential pass, so the per-cell sums below read one compact
+    // record per face instead of chasing its corners
+    std::vector<std::array<T, 4>> planes;
+    detail::CellGroups incident;
+    if (representative == ClusterRepresentative::QUADRIC) {
+        planes.resize(faces.size());
+        utils::parallel_for_range(0, faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                const auto& ids = faces[f].vertices;
+                const auto plane = detail::polygon_plane(ids.size(), [&](std::size_t i) { return vertices[ids[i]].position; });
+                planes[f] = {T(plane[0]), T(plane[1]), T(plane[2]), T(plane[3])};
+            }
+        }, CLUSTER_MIN_CHUNK);
+
+        // Each face counts once for every distinct cell it touches
+        incident = detail::group_by_cell(faces.size(), cell_count, [&](std::size_t f, auto&& emit) {
+            const auto& ids = faces[f].vertices;
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                const std::uint32_t cell = cell_of[ids[i]];
+                bool seen = false;
+                for (std::size_t j = 0; j < i && !seen; ++j) seen = cell_of[ids[j]] == cell;
+                if (!seen) emit(cell, static_cast<std::uint32_t>(f));
+            }
+        });
+    }
+
+    std::vector<core::Vertex<T>> cell_vertices(cell_count);
+    utils::parallel_for_range(0, cell_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t c = begin; c < end; ++c) {
+            math::Vector3<double> sum(0);
+            for (std::size_t k = members.offsets[c]; k < members.offsets[c + 1]; ++k) {
+                const auto& p = vertices[members.items[k]].position;
+                sum += math::Vector3<double>(p.x, p.y, p.z);
+            }
+            const math::Vector3<double> mean = sum / double(members.offsets[c + 1] - members.offsets[c]);
+
+            Quadric<double> quadric = Quadric<double>::zero();
+            const bool use_quadric = representative == ClusterRepresentative::QUADRIC;
+            if (use_quadric) {
+                for (std::size_t k = incident.offsets[c]; k < incident.offsets[c + 1]; ++k) {
+                    const auto& plane = planes[incident.items[k]];
+                    quadric += Quadric<double>::plane(plane[0], plane[1], plane[2], plane[3], 1.0);
+                }
+            }
+
+            const core::VertexId first = cell_first[c];
+            cell_vertices[c] = vertices[first];
+            cell_vertices[c].position = detail::cluster_representative<T>(
+                use_quadric ? &quadric : nullptr, mean, grid.cell_bounds(grid.key(vertices[first].position)));
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    // Re-index the faces in place, dropping repeated corners, then compact
+    std::vector<std::uint8_t> keep(faces.size());
+    std::vector<std::size_t> kept_counts(utils::parallel_chunk_count(faces.size(), CLUSTER_MIN_CHUNK), 0);
+    std::vector<core::Face<T>> kept_faces;
+    mesh.update_faces([&](core::Face<T>* mesh_faces, std::size_t face_count) {
+        utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            for (std::size_t f = begin; f < end; ++f) {
+                auto& ids = mesh_faces[f].vertices;
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < ids.size(); ++i) {
+                    const core::VertexId cell = cell_of[ids[i]];
+                    if (count == 0 || ids[count - 1] != cell) ids[count++] = cell;
+                }
+                while (count > 1 && ids[count - 1] == ids[0]) --count;
+                ids.resize(count);
+                keep[f] = count >= 3;
+                kept_counts[chunk] += keep[f];
+            }
+        }, CLUSTER_MIN_CHUNK);
+
+        std::size_t kept_face_count = 0;
+        for (std::size_t c : kept_counts) kept_face_count += c;
+        auto keep_face = [&](std::size_t f) { return keep[f] != 0; };
+        kept_faces.resize(kept_face_count);
+        utils::parallel_compact(face_count, keep_face, [&](std::size_t f, std::size_t position) {
+            kept_faces[position] = std::move(mesh_faces[f]);
+        }, CLUSTER_MIN_CHUNK);
+    });
+
+    // Drop the cells whose faces all collapsed
+    std::unique_ptr<std::atomic<std::uint8_t>[]> used(new std::atomic<std::uint8_t>[cell_count]());
+    utils::parallel_for_range(0, kept_faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            for (auto id : kept_faces[f].vertices) used[id].store(1, std::memory_order_relaxed);
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    auto keep_cell = [&](std::size_t c) { return used[c].load(std::memory_order_relaxed) != 0; };
+    std::vector<core::VertexId> remap(cell_count);
+    std::vector<core::Vertex<T>> kept_vertices(cell_count);
+    kept_vertices.resize(utils::parallel_compact(cell_count, keep_cell, [&](std::size_t c, std::size_t position) {
+        remap[c] = static_cast<core::VertexId>(position);
+        kept_vertices[position] = cell_vertices[c];
+    }, CLUSTER_MIN_CHUNK));
+
+    utils::parallel_for_range(0, kept_faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            for (auto& id : kept_faces[f].vertices) id = remap[id];
+        }
+    }, CLUSTER_MIN_CHUNK);
+
+    mesh.assign(std::move(kept_vertices), std::move(kept_faces));
+    mesh.compute_face_normals();
+}
+
+// Out-of-core vertex clustering. Triangles arrive as corner positions over any number
+// of calls, so a reader can stream a mesh that never fits in memory: only the occupied
+// cells and the distinct triangles between them are stored. The grid needs the bounds
+// of the whole input up front, e.g. from a file header or a first pass over the file.
+// Unlike cluster_decimation, triangles landing on the same three cells are merged.
+template<typename T>
+class ClusterDecimator {
+public:
+    ClusterDecimator(const math::Vector3<T>& min_point, const math::Vector3<T>& max_point,
+                     std::size_t grid_resolution,
+                     ClusterRepresentative representative = ClusterRepresentative::QUADRIC)
+        : grid_(min_point, max_point, grid_resolution), representative_(representative) {}
+
+    void add_triangle(const math::Vector3<T>& a, const math::Vector3<T>& b, const math::Vector3<T>& c) {
+        const math::Vector3<T> corners[3] = {a, b, c};
+        Quadric<double> quadric = Quadric<double>::zero();
+        if (representative_ == ClusterRepresentative::QUADRIC) {
+            const auto plane = detail::polygon_plane(3, [&](std::size_t i) { return corners[i]; });
+            quadric = Quadric<double>::plane(plane[0], plane[1], plane[2], plane[3], 1.0);
+        }
+
+        std::array<std::uint32_t, 3> tri;
+        for (std::size_t i = 0; i < 3; ++i) {
+            tri[i] = add_corner(corners[i], quadric);
+        }
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) return;
+
+        // Rotate the lowest cell first so each oriented triangle has one spelling
+        std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+        triangles_.insert(tri);
+    }
+
+    // Triangle soup: corners[3 t .. 3 t + 2] are the corners of triangle t
+    void add_triangles(utils::Span<const math::Vector3<T>> corners) {
+        if (corners.size() % 3 != 0) {
+            throw std::invalid_argument("ClusterDecimator: corner count is not a multiple of 3");
+        }
+        for (std::size_t i = 0; i < corners.size(); i += 3) {
+            add_triangle(corners[i], corners[i + 1], corners[i + 2]);
+        }
+    }
+
+    // Fan-triangulates the faces of a mesh, e.g. one chunk of a larger file
+    void add_mesh(const core::Mesh<T>& chunk) {
+        const auto& vertices = chunk.vertices();
+        for (const auto& face : chunk.faces()) {
+            const auto& ids = face.vertices;
+            for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+                add_triangle(vertices[ids[0]].position, vertices[ids[i]].position, vertices[ids[i + 1]].position);
+            }
+        }
+    }
+
+    std::size_t cell_count() const { return cells_.size(); }
+    std::size_t triangle_count() const { return triangles_.size(); }
+
+    // The decimated mesh so far, with vertices in order of first use. Cells touched
+    // only by collapsed triangles are left out.
+    core::Mesh<T> extract() const {
+        std::vector<std::array<std::uint32_t, 3>> triangles(triangles_.begin(), triangles_.end());
+        std::sort(triangles.begin(), triangles.end());
+
+        const core::VertexId unused = std::numeric_limits<core::VertexId>::max();
+        std::vector<core::VertexId> remap(cells_.size(), unused);
+        for (const auto& tri : triangles) {
+            for (auto c : tri) remap[c] = 0;
+        }
+
+        std::vector<core::Vertex<T>> vertices;
+        for (std::size_t c = 0; c < cells_.size(); ++c) {
+            if (remap[c] == unused) continue;
+            const Cell& cell = cells_[c];
+            remap[c] = static_cast<core::VertexId>(vertices.size());
+            const bool use_quadric = representative_ == ClusterRepresentative::QUADRIC;
+            vertices.emplace_back(detail::cluster_representative<T>(use_quadric ? &cell.quadric : nullptr,
+                                                                    cell.sum / double(cell.count),
+                                                                    grid_.cell_bounds(cell.key)));
+        }
+
+        std::vector<core::Face<T>> faces;
+        faces.reserve(triangles.size());
+        for (const auto& tri : triangles) {
+            faces.emplace_back(std::vector<core::VertexId>{remap[tri[0]], remap[tri[1]], remap[tri[2]]});
+        }
+
+        core::Mesh<T> mesh;
+        mesh.assign(std::move(vertices), std::move(faces));
+        mesh.compute_face_normals();
+        return mesh;
+    }
+
+private:
+    struct Cell {
+        std::uint64_t key;
+        Quadric<double> quadric;
+        math::Vector3<double> sum;
+        std::size_t count;
+    };
+
+    struct TriangleHash {
+        std::size_t operator()(const std::array<std::uint32_t, 3>& tri) const {
+            std::uint64_t h = (std::uint64_t(tri[0]) << 32 | tri[1]) * 0x9E3779B97F4A7C15ull;
+            h ^= (h >> 29) + tri[2] * 0xBF58476D1CE4E5B9ull;
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        }
+    };
+
+    // Accumulates one triangle corner into its cell, returning the cell's index
+    std::uint32_t add_corner(const math::Vector3<T>& p, const Quadric<double>& quadric) {
+        const std::uint64_t key = grid_.key(p);
+        const auto inserted = cell_index_.emplace(key, static_cast<std::uint32_t>(cells_.size()));
+        if (inserted.second) {
+            cells_.push_back(Cell{key, Quadric<double>::zero(), math::Vector3<double>(0), 0});
+        }
+        Cell& cell = cells_[inserted.first->second];
+        cell.quadric += quadric;
+        cell.sum += math::Vector3<double>(p.x, p.y, p.z);
+        ++cell.count;
+        return inserted.first->second;
+    }
+
+    detail::ClusterGrid<T> grid_;
+    ClusterRepresentative representative_;
+    std::unordered_map<std::uint64_t, std::uint32_t> cell_index_;
+    std::vector<Cell> cells_;
+    std::unordered_set<std::array<std::uint32_t, 3>, TriangleHash> triangles_;
+};
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <polygon_mesh/algorithms/face_sides.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/algorithms/union_find.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace analysis {
+
+// Connected components. Faces are joined in a concurrent union-find, either through
+// their vertices or through the edges they share, by all threads at once; labels,
+// face counts and bounds then come out of a single pass over the faces.
+
+// Minimum faces (or vertices) per thread
+constexpr std::size_t COMPONENTS_MIN_CHUNK = 65536;
+
+namespace detail {
+
+// Joins faces that share an edge, including non-manifold edges. Sides are bucketed by
+// their lower vertex as (higher vertex << 32 | face) so each bucket can be sorted and
+// scanned on its own.
+template<typename T>
+void unite_edge_neighbors(const core::Mesh<T>& mesh, ConcurrentUnionFind& sets) {
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    const std::size_t vertex_count = mesh.vertex_count();
+
+    auto buckets = algorithms::detail::bucket_sides<std::uint64_t>(vertex_count, face_count, [&](std::size_t f, auto&& emit) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t i = 0, n = ids.size(); i < n; ++i) {
+            const core::VertexId a = ids[i];
+            const core::VertexId b = ids[i + 1 == n ? 0 : i + 1];
+            if (a != b) emit(std::min(a, b), (std::uint64_t(std::max(a, b)) << 32) | f);
+        }
+    }, COMPONENTS_MIN_CHUNK);
+    const auto& bucket_offsets = buckets.offsets;
+    auto& sides = buckets.entries;
+
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const auto first = sides.begin() + bucket_offsets[v];
+            const auto last = sides.begin() + bucket_offsets[v + 1];
+            std::sort(first, last);
+            for (auto it = first; it != last && it + 1 != last; ++it) {
+                if ((it[0] >> 32) == (it[1] >> 32)) {
+                    sets.unite(static_cast<std::uint32_t>(it[0]), static_cast<std::uint32_t>(it[1]));
+                }
+            }
+        }
+    }, COMPONENTS_MIN_CHUNK);
+}
+
+} // namespace detail
+
+template<typename T>
+ConnectedComponents<T> connected_components(const core::Mesh<T>& mesh, ComponentAdjacency adjacency) {
+    ConnectedComponents<T> result;
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    const std::size_t vertex_count = mesh.vertex_count();
+    if (face_count == 0) return result;
+    if (face_count + vertex_count > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::out_of_range("connected_components: mesh exceeds 32-bit element indices");
+    }
+
+    // With vertex adjacency the sets hold the faces followed by the vertices, and every
+    // face is united with its own vertices. Faces come first either way, so the root of
+    // each component is its first face, and vertices used by no face are never counted.
+    const bool by_vertex = adjacency == ComponentAdjacency::VERTEX;
+    ConcurrentUnionFind sets(by_vertex ? face_count + vertex_count : face_count);
+    if (by_vertex) {
+        utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                for (core::VertexId id : faces[f].vertices) {
+                    sets.unite(static_cast<std::uint32_t>(f), static_cast<std::uint32_t>(face_count + id));
+                }
+            }
+        }, COMPONENTS_MIN_CHUNK);
+    } else {
+        detail::unite_edge_neighbors(mesh, sets);
+    }
+
+    // Roots are labelled in face order first, then every other face takes its root's
+    // label while counting runs of equal labels along the chunk
+    auto& labels = result.face_labels;
+    labels.resize(face_count);
+    auto is_root = [&](std::size_t f) { return sets.find(static_cast<std::uint32_t>(f)) == f; };
+    const std::size_t count = utils::parallel_compact(face_count, is_root, [&](std::size_t f, std::size_t position) {
+        labels[f] = static_cast<std::uint32_t>(position);
+    }, COMPONENTS_MIN_CHUNK);
+
+    struct Run {
+        std::uint32_t label;
+        std::size_t faces;
+        core::BoundingBox<T> bounds;
+    };
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    std::vector<std::vector<Run>> runs(utils::parallel_chunk_count(face_count, COMPONENTS_MIN_CHUNK));
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        auto& chunk_runs = runs[chunk];
+        for (std::size_t f = begin; f < end; ++f) {
+            const std::uint32_t root = sets.find(static_cast<std::uint32_t>(f));
+            if (root != f) labels[f] = labels[root];
+            const std::uint32_t label = labels[f];
+            if (chunk_runs.empty() || chunk_runs.back().label != label) {
+                chunk_runs.push_back(Run{label, 0, core::BoundingBox<T>()});
+            }
+            Run& run = chunk_runs.back();
+            run.faces += 1;
+            for (core::VertexId id : faces[f].vertices) {
+                run.bounds.expand(vertices[id].position);
+            }
+        }
+    }, COMPONENTS_MIN_CHUNK);
+
+    result.face_counts.assign(count, 0);
+    result.bounding_boxes.assign(count, core::BoundingBox<T>());
+    for (const auto& chunk_runs : runs) {
+        for (const Run& run : chunk_runs) {
+            result.face_counts[run.label] += run.faces;
+            if (run.bounds.is_valid()) result.bounding_boxes[run.label].expand(run.bounds);
+        }
+    }
+    return result;
+}
+
+} // namespace analysis
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace polygon_mesh {
+namespace algorithms {
+
+// Algorithm configuration structures
+struct SmoothingConfig {
+    enum Type { LAPLACIAN, TAUBIN } type = LAPLACIAN;
+    std::size_t iterations = 1;
+    float lambda = 0.5f;
+    float mu = -0.53f;  // For Taubin smoothing
+    enum Weighting { UNIFORM, COTANGENT } weighting = UNIFORM;
+    bool pin_boundaries = true;  // Boundary vertices keep their positions
+};
+
+struct DecimationConfig {
+    enum Type { QUADRIC, EDGE_COLLAPSE } type = QUADRIC;
+    float reduction_ratio = 0.5f;
+    std::size_t target_triangles = 0;
+    bool preserve_boundaries = true;
+    float quadric_threshold = 1e-6f;
+    std::size_t partitions = 0;  // QUADRIC: > 1 decimates that many spatial clusters in parallel first
+};
+
+struct SubdivisionConfig {
+    enum Type { LOOP, CATMULL_CLARK } type = LOOP;
+    std::size_t levels = 1;
+    bool limit_surface = false;
+    float crease_angle = 0.0f;  // degrees; > 0 makes edges whose faces meet at a larger angle creases
+};
+
+struct QualityConfig {
+    std::size_t bins = 32;
+    float max_area = 0.0f;           // upper end of the area bins; 0 uses the largest triangle area
+    float max_aspect_ratio = 10.0f;  // aspect ratio bins cover [1, max_aspect_ratio)
+};
+
+struct BVHConfig {
+    enum Build { BINNED_SAH, MORTON } build = BINNED_SAH;
+    std::size_t bins = 16;           // BINNED_SAH: centroid bins per axis, at most 32
+    std::size_t max_leaf_size = 4;   // triangles per leaf
+    float traversal_cost = 1.0f;     // BINNED_SAH: cost of visiting a node relative to a triangle test
+    float refit_rotation_threshold = 1.25f;  // refit rotates subtrees once the SAH cost grows past this factor of
+                                             // the cost at build; 0 disables rotations
+};
+
+struct RayQueryConfig {
+    enum Order { COHERENT, INCOHERENT } order = COHERENT;  // INCOHERENT sorts rays into packets first
+    std::size_t packet_size = 8;                           // rays traced together, 8 or 16
+};
+
+struct ClosestPointConfig {
+    float max_distance = std::numeric_limits<float>::infinity();  // points this far from the mesh find nothing
+    bool reuse_neighbors = true;  // start each query from the previous point's triangle
+};
+
+} // namespace algorithms
+} // namespace polygon_mesh
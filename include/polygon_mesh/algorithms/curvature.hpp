@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/adjacency.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/utils/span.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace analysis {
+
+// Discrete curvature of triangle meshes. Every quantity comes out of one parallel pass
+// over the vertex one-rings of a CotangentLaplacian: mean curvature from the length of
+// the mean curvature normal (signed against the vertex normal, so convex regions of an
+// outward facing surface are positive), Gaussian curvature from the angle defect over
+// the mixed Voronoi area, principal curvatures from both, and principal directions
+// from the eigenvectors of Taubin's curvature tensor. Boundary vertices use their
+// partial one-rings as they are.
+
+namespace detail {
+
+// Unit tangent of the largest normal curvature at vertex v, or zero where the normal
+// is undefined. Edges are weighted by their clamped cotangent weights.
+template<typename T>
+math::Vector3<T> max_curvature_direction(const CotangentLaplacian<T>& laplacian, const core::Vertex<T>* vertices,
+                                         std::size_t v) {
+    const math::Vector3<T>& normal = laplacian.normals()[v];
+    if (normal.length_squared() == T(0)) return math::Vector3<T>(0);
+
+    const math::Vector3<T> axis = std::abs(normal.x) < T(0.9) ? math::Vector3<T>(1, 0, 0) : math::Vector3<T>(0, 1, 0);
+    const math::Vector3<T> e1 = normal.cross(axis).normalize();
+    const math::Vector3<T> e2 = normal.cross(e1);
+
+    const auto& adjacency = laplacian.adjacency();
+    const std::size_t begin = adjacency.offsets[v];
+    const std::size_t end = adjacency.offsets[v + 1];
+    T total = T(0);
+    for (std::size_t k = begin; k < end; ++k) total += std::max(adjacency.weights[k], T(0));
+    const bool uniform = !(total > std::numeric_limits<T>::min());
+
+    // Tensor sum_j w_j k_j t_j t_j^T in the (e1, e2) basis, with k_j the normal
+    // curvature along edge j and t_j its unit tangent projection
+    const math::Vector3<T>& p = vertices[v].position;
+    T a = T(0), b = T(0), c = T(0);
+    for (std::size_t k = begin; k < end; ++k) {
+        const math::Vector3<T> edge = vertices[adjacency.neighbors[k]].position - p;
+        const T length_squared = edge.length_squared();
+        const T u = edge.dot(e1);
+        const T w = edge.dot(e2);
+        const T tangent_squared = u * u + w * w;
+        if (!(tangent_squared > std::numeric_limits<T>::min())) continue;
+
+        const T weight = uniform ? T(1) : std::max(adjacency.weights[k], T(0));
+        const T kappa = T(-2) * normal.dot(edge) / length_squared;
+        const T scale = weight * kappa / tangent_squared;
+        a += scale * u * u;
+        b += scale * u * w;
+        c += scale * w * w;
+    }
+
+    const T angle = T(0.5) * std::atan2(T(2) * b, a - c);
+    return e1 * std::cos(angle) + e2 * std::sin(angle);
+}
+
+} // namespace detail
+
+template<typename T>
+void compute_curvature(const core::Mesh<T>& mesh, CotangentLaplacian<T>& laplacian,
+                       const CurvatureOutput<T>& output) {
+    const std::size_t n = mesh.vertex_count();
+    auto check = [n](std::size_t size) {
+        if (size != 0 && size != n) {
+            throw std::invalid_argument("compute_curvature: output size does not match the vertex count");
+        }
+    };
+    check(output.mean.size());
+    check(output.gaussian.size());
+    check(output.max_curvature.size());
+    check(output.min_curvature.size());
+    check(output.max_direction.size());
+    check(output.min_direction.size());
+    const bool directions = !output.max_direction.empty() || !output.min_direction.empty();
+
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    laplacian.visit(mesh, [&](std::size_t v) {
+        const auto& adjacency = laplacian.adjacency();
+        const T area = laplacian.areas()[v];
+        T mean = T(0);
+        T gaussian = T(0);
+        if (area > std::numeric_limits<T>::min()) {
+            const math::Vector3<T>& p = vertices[v].position;
+            math::Vector3<T> laplace(0);
+            for (std::size_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; ++k) {
+                laplace += (p - vertices[adjacency.neighbors[k]].position) * adjacency.weights[k];
+            }
+            mean = laplace.length() / (T(2) * area);
+            if (laplace.dot(laplacian.normals()[v]) < T(0)) mean = -mean;
+            gaussian = laplacian.angle_defects()[v] / area;
+        }
+
+        if (!output.mean.empty()) output.mean[v] = mean;
+        if (!output.gaussian.empty()) output.gaussian[v] = gaussian;
+        const T spread = std::sqrt(std::max(mean * mean - gaussian, T(0)));
+        if (!output.max_curvature.empty()) output.max_curvature[v] = mean + spread;
+        if (!output.min_curvature.empty()) output.min_curvature[v] = mean - spread;
+
+        if (directions) {
+            const math::Vector3<T> max_direction = detail::max_curvature_direction(laplacian, vertices, v);
+            if (!output.max_direction.empty()) output.max_direction[v] = max_direction;
+            if (!output.min_direction.empty()) output.min_direction[v] = laplacian.normals()[v].cross(max_direction);
+        }
+    });
+}
+
+template<typename T>
+void compute_curvature(const core::Mesh<T>& mesh, const CurvatureOutput<T>& output) {
+    CotangentLaplacian<T> laplacian;
+    compute_curvature(mesh, laplacian, output);
+}
+
+template<typename T>
+std::vector<T> compute_mean_curvature(const core::Mesh<T>& mesh) {
+    std::vector<T> mean(mesh.vertex_count());
+    CurvatureOutput<T> output;
+    output.mean = mean;
+    compute_curvature(mesh, output);
+    return mean;
+}
+
+template<typename T>
+std::vector<T> compute_gaussian_curvature(const core::Mesh<T>& mesh) {
+    std::vector<T> gaussian(mesh.vertex_count());
+    CurvatureOutput<T> output;
+    output.gaussian = gaussian;
+    compute_curvature(mesh, output);
+    return gaussian;
+}
+
+} // namespace analysis
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,1131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/bounds.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Quadric error decimation (Garland & Heckbert). Polygons are fan-triangulated and
+// faces with repeated vertex indices are dropped on input; the result is a triangle
+// mesh whose vertices keep the attributes of the original vertex they came from.
+
+// Minimum vertices per thread while setting up
+constexpr std::size_t DECIMATION_MIN_CHUNK = 16384;
+
+// Weight of the constraint planes along free boundaries, relative to edge length squared
+constexpr double DECIMATION_BOUNDARY_WEIGHT = 1000.0;
+
+// A collapse is rejected when it turns a neighboring triangle's normal by more than
+// acos(DECIMATION_MIN_NORMAL_COSINE)
+constexpr double DECIMATION_MIN_NORMAL_COSINE = 0.2;
+
+// Mantissa bits kept when bucketing candidate costs; candidates whose costs agree to
+// within 2^-DECIMATION_QUEUE_MANTISSA_BITS relative may be collapsed in either order
+constexpr unsigned DECIMATION_QUEUE_MANTISSA_BITS = 5;
+
+// Cells per axis of the grid whose Morton order forms the clusters of partitioned
+// decimation (at most 1024)
+constexpr std::uint32_t DECIMATION_CLUSTER_GRID = 64;
+
+// Symmetric 4x4 error quadric, packed as the 10 coefficients of its upper triangle:
+// a2 ab ac ad | b2 bc bd | c2 cd | d2
+template<typename T>
+struct Quadric {
+    T q[10];
+
+    static Quadric zero() {
+        Quadric result;
+        std::fill(result.q, result.q + 10, T(0));
+        return result;
+    }
+
+    // weight * p p^T for the plane p = (a, b, c, d), ax + by + cz + d = 0
+    static Quadric plane(T a, T b, T c, T d, T weight) {
+        Quadric result;
+        result.q[0] = weight * a * a; result.q[1] = weight * a * b; result.q[2] = weight * a * c; result.q[3] = weight * a * d;
+        result.q[4] = weight * b * b; result.q[5] = weight * b * c; result.q[6] = weight * b * d;
+        result.q[7] = weight * c * c; result.q[8] = weight * c * d;
+        result.q[9] = weight * d * d;
+        return result;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        for (int i = 0; i < 10; ++i) q[i] += other.q[i];
+        return *this;
+    }
+
+    friend Quadric operator+(Quadric a, const Quadric& b) { return a += b; }
+
+    // v^T Q v for v = (p, 1), evaluated in double
+    double error(const math::Vector3<T>& p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        return x * (q[0] * x + 2.0 * (q[1] * y + q[2] * z + q[3])) +
+               y * (q[4] * y + 2.0 * (q[5] * z + q[6])) +
+               z * (q[7] * z + 2.0 * q[8]) + q[9];
+    }
+
+    // Point of minimum error. Returns false when the 3x3 system is singular relative to
+    // its scale (|det| <= singular_threshold * (trace / 3)^3).
+    bool minimizer(math::Vector3<T>& out, double singular_threshold) const {
+        const double a00 = q[0], a01 = q[1], a02 = q[2];
+        const double a11 = q[4], a12 = q[5], a22 = q[7];
+        const double b0 = -double(q[3]), b1 = -double(q[6]), b2 = -double(q[8]);
+
+        const double c00 = a11 * a22 - a12 * a12;
+        const double c01 = a02 * a12 - a01 * a22;
+        const double c02 = a01 * a12 - a02 * a11;
+        const double det = a00 * c00 + a01 * c01 + a02 * c02;
+
+        const double scale = (a00 + a11 + a22) / 3.0;
+        if (!(scale > 0.0) || !(std::abs(det) > singular_threshold * scale * scale * scale)) {
+            return false;
+        }
+
+        const double c11 = a00 * a22 - a02 * a02;
+        const double c12 = a01 * a02 - a00 * a12;
+        const double c22 = a00 * a11 - a01 * a01;
+        const double inv_det = 1.0 / det;
+        out = math::Vector3<T>(static_cast<T>((c00 * b0 + c01 * b1 + c02 * b2) * inv_det),
+                               static_cast<T>((c01 * b0 + c11 * b1 + c12 * b2) * inv_det),
+                               static_cast<T>((c02 * b0 + c12 * b1 + c22 * b2) * inv_det));
+        return true;
+    }
+};
+
+namespace detail {
+
+enum DecimationVertexFlags : std::uint8_t {
+    DECIMATION_REMOVED = 1,
+    DECIMATION_BOUNDARY = 2,   // on an edge used by one triangle
+    DECIMATION_LOCKED = 4,     // never moves: non-manifold, or locked by the caller
+    DECIMATION_MOVED = 8
+};
+
+template<typename T>
+struct CollapseCandidate {
+    float cost;
+    core::VertexId u;              // removed
+    core::VertexId v;              // kept, moved to target
+    std::uint32_t version_u;
+    std::uint32_t version_v;
+    math::Vector3<T> target;
+};
+
+// Priority queue for non-negative costs with O(1) push and pop. Candidates are
+// bucketed by the high bits of their cost's IEEE representation, which order the same
+// way as the costs. Within a bucket candidates come out in push order, which spreads
+// collapses evenly over regions of similar cost instead of piling them onto the vertex
+// that was just merged. Costs mostly grow as decimation proceeds, so the scan for the
+// lowest non-empty bucket stays short.
+template<typename T>
+class CollapseQueue {
+public:
+    CollapseQueue() : buckets_((0x7FFFFFFFu >> SHIFT) + 1), lowest_(buckets_.size()) {}
+
+    void push(const CollapseCandidate<T>& candidate) {
+        const std::size_t b = bucket(candidate.cost);
+        buckets_[b].items.push_back(candidate);
+        lowest_ = std::min(lowest_, b);
+        ++size_;
+    }
+
+    // Takes the next candidate unless the queue is empty or its lowest bucket lies
+    // above the one max_cost falls into
+    bool pop(CollapseCandidate<T>& out, float max_cost = std::numeric_limits<float>::infinity()) {
+        if (!seek() || lowest_ > bucket(max_cost)) return false;
+        Bucket& bucket = buckets_[lowest_];
+        out = bucket.items[bucket.head++];
+        if (bucket.head == bucket.items.size()) {
+            bucket.items.clear();
+            bucket.head = 0;
+        }
+        --size_;
+        return true;
+    }
+
+    // Cost of the candidate pop() would return next; infinity when empty
+    float lowest_cost() {
+        return seek() ? buckets_[lowest_].items[buckets_[lowest_].head].cost
+                      : std::numeric_limits<float>::infinity();
+    }
+
+private:
+    static constexpr unsigned SHIFT = 23 - DECIMATION_QUEUE_MANTISSA_BITS;
+
+    // Advances lowest_ to the first non-empty bucket
+    bool seek() {
+        if (size_ == 0) return false;
+        while (buckets_[lowest_].head == buckets_[lowest_].items.size()) ++lowest_;
+        return true;
+    }
+
+    // Sign dropped so -0 joins 0; NaN sorts after infinity
+    static std::size_t bucket(float cost) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &cost, sizeof(bits));
+        return (bits & 0x7FFFFFFFu) >> SHIFT;
+    }
+
+    // First in, first out: read from head, reset once drained
+    struct Bucket {
+        std::vector<CollapseCandidate<T>> items;
+        std::size_t head = 0;
+    };
+
+    std::vector<Bucket> buckets_;
+    std::size_t lowest_;
+    std::size_t size_ = 0;
+};
+
+// Triangles and per-vertex decimation data in the normalized frame: positions are
+// shifted by -center and scaled by 1 / inverse_scale into the unit box, so float
+// quadrics stay accurate. Vertex indices are those of the source mesh.
+template<typename T>
+struct DecimationData {
+    using Triangle = std::array<core::VertexId, 3>;
+
+    std::vector<Triangle> triangles;
+    std::vector<std::uint32_t> source_face;   // face each triangle was cut from
+    std::vector<math::Vector3<T>> normals;    // unit normal of each triangle as loaded
+    std::vector<math::Vector3<T>> positions;
+    std::vector<Quadric<T>> quadrics;
+    std::vector<std::uint8_t> flags;          // DecimationVertexFlags
+    math::Vector3<T> center = math::Vector3<T>(0);
+    T inverse_scale = T(1);
+};
+
+// Fan-triangulates the faces, dropping triangles with repeated vertex indices, and
+// normalizes the positions. Quadrics are left for QuadricDecimator to fill in.
+template<typename T>
+void load_decimation_data(const core::Mesh<T>& mesh, DecimationData<T>& data) {
+    const auto& faces = mesh.faces();
+    data.triangles.clear();
+    data.source_face.clear();
+    data.triangles.reserve(faces.size());
+    data.source_face.reserve(faces.size());
+    for (std::size_t f = 0; f < faces.size(); ++f) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+            const typename DecimationData<T>::Triangle tri = {ids[0], ids[i], ids[i + 1]};
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) continue;
+            data.triangles.push_back(tri);
+            data.source_face.push_back(static_cast<std::uint32_t>(f));
+        }
+    }
+
+    const auto& vertices = mesh.vertices();
+    const std::size_t n = vertices.size();
+    data.positions.resize(n);
+    data.quadrics.clear();
+    data.flags.assign(n, 0);
+    if (n == 0) return;
+
+    const auto bounds = math::compute_bounds(&vertices[0].position, n, sizeof(core::Vertex<T>));
+    data.center = (bounds[0] + bounds[1]) * T(0.5);
+    const math::Vector3<T> extent = bounds[1] - bounds[0];
+    const T size = std::max(extent.x, std::max(extent.y, extent.z));
+    data.inverse_scale = size > T(0) ? size : T(1);
+    const T scale = T(1) / data.inverse_scale;
+
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            data.positions[v] = (vertices[v].position - data.center) * scale;
+        }
+    }, DECIMATION_MIN_CHUNK);
+
+    data.normals.resize(data.triangles.size());
+    utils::parallel_for_range(0, data.triangles.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t t = begin; t < end; ++t) {
+            const auto& tri = data.triangles[t];
+            const math::Vector3<T>& p0 = data.positions[tri[0]];
+            const math::Vector3<T> normal = (data.positions[tri[1]] - p0).cross(data.positions[tri[2]] - p0);
+            const T length = normal.length();
+            data.normals[t] = length > T(0) ? normal / length : math::Vector3<T>(0);
+        }
+    }, DECIMATION_MIN_CHUNK);
+}
+
+// Surviving vertices (in original order, with their source attributes) and triangles.
+// Every triangle in data must be live, as QuadricDecimator::finish leaves it.
+template<typename T>
+void extract_decimation_data(const DecimationData<T>& data, const core::Mesh<T>& source,
+                             std::vector<core::Vertex<T>>& vertices, std::vector<core::Face<T>>& faces) {
+    const auto& source_vertices = source.vertices();
+    const auto& source_faces = source.faces();
+    const core::VertexId unused = std::numeric_limits<core::VertexId>::max();
+
+    std::vector<core::VertexId> remap(data.positions.size(), unused);
+    for (const auto& tri : data.triangles) {
+        for (auto x : tri) remap[x] = 0;
+    }
+
+    vertices.clear();
+    for (std::size_t x = 0; x < remap.size(); ++x) {
+        if (remap[x] == unused) continue;
+        remap[x] = static_cast<core::VertexId>(vertices.size());
+        vertices.push_back(source_vertices[x]);
+        if (data.flags[x] & DECIMATION_MOVED) {
+            vertices.back().position = data.positions[x] * data.inverse_scale + data.center;
+        }
+    }
+
+    faces.clear();
+    faces.reserve(data.triangles.size());
+    for (std::size_t t = 0; t < data.triangles.size(); ++t) {
+        const auto& tri = data.triangles[t];
+        faces.emplace_back(std::vector<core::VertexId>{remap[tri[0]], remap[tri[1]], remap[tri[2]]},
+                           source_faces[data.source_face[t]].material_id);
+    }
+}
+
+// A neighbor w of the vertex being classified, how many of the vertex's triangles use
+// edge (vertex, w), and one of those triangles
+struct EdgeUse {
+    core::VertexId w;
+    std::uint32_t count;
+    std::uint32_t triangle;
+};
+
+// Cost policy of quadric error decimation: per-vertex quadrics that add up on collapse,
+// with the merged vertex at the quadric minimizer when that is well posed.
+// A cost policy provides:
+//   begin_classify()                       before classification
+//   classify_vertex(u, first, last, uses)  u's triangle ids [first, last) and edge uses;
+//                                          called concurrently for distinct vertices
+//   evaluate(a, b, free, target)           cost of merging a into b; target starts at b
+//                                          and may only be moved when free; called
+//                                          concurrently while seeding
+//   merge(kept, removed)                   after a collapse
+template<typename T>
+class QuadricCollapseCost {
+public:
+    using Triangle = typename DecimationData<T>::Triangle;
+
+    QuadricCollapseCost(DecimationData<T>& data, bool preserve_boundaries, double singular_threshold)
+        : triangles_(data.triangles), positions_(data.positions), quadrics_(data.quadrics),
+          preserve_boundaries_(preserve_boundaries), singular_threshold_(singular_threshold) {}
+
+    void begin_classify() { quadrics_.assign(positions_.size(), Quadric<T>::zero()); }
+
+    // Face quadrics plus, when boundaries may move, constraint planes along boundary edges
+    void classify_vertex(core::VertexId u, const std::uint32_t* first, const std::uint32_t* last,
+                         const std::vector<EdgeUse>& uses) {
+        Quadric<T> quadric = Quadric<T>::zero();
+        for (const std::uint32_t* t = first; t != last; ++t) quadric += triangle_quadric(*t);
+        if (!preserve_boundaries_) {
+            for (const EdgeUse& use : uses) {
+                if (use.count == 1) quadric += boundary_quadric(u, use.w, use.triangle);
+            }
+        }
+        quadrics_[u] = quadric;
+    }
+
+    double evaluate(core::VertexId a, core::VertexId b, bool free, math::Vector3<T>& target) const {
+        const Quadric<T> quadric = quadrics_[a] + quadrics_[b];
+        double cost = quadric.error(target);
+        if (!free) return cost;
+
+        // An optimum far from the edge comes from a nearly singular quadric
+        const math::Vector3<T> middle = (positions_[a] + positions_[b]) * T(0.5);
+        const T reach = (positions_[a] - positions_[b]).length_squared();
+        math::Vector3<T> optimum;
+        if (quadric.minimizer(optimum, singular_threshold_) && (optimum - middle).length_squared() <= reach) {
+            target = optimum;
+            return quadric.error(target);
+        }
+        for (const math::Vector3<T>& option : {positions_[a], middle}) {
+            const double option_cost = quadric.error(option);
+            if (option_cost < cost) {
+                cost = option_cost;
+                target = option;
+            }
+        }
+        return cost;
+    }
+
+    void merge(core::VertexId kept, core::VertexId removed) { quadrics_[kept] += quadrics_[removed]; }
+
+private:
+    // Plane quadric of triangle t weighted by its area
+    Quadric<T> triangle_quadric(std::size_t t) const {
+        const Triangle& tri = triangles_[t];
+        const math::Vector3<T>& p0 = positions_[tri[0]];
+        const math::Vector3<T> n = (positions_[tri[1]] - p0).cross(positions_[tri[2]] - p0);
+        const T length = n.length();
+        if (!(length > T(0))) return Quadric<T>::zero();
+        const math::Vector3<T> unit = n / length;
+        return Quadric<T>::plane(unit.x, unit.y, unit.z, -unit.dot(p0), T(0.5) * length);
+    }
+
+    // Plane through boundary edge (a, b) perpendicular to triangle t
+    Quadric<T> boundary_quadric(core::VertexId a, core::VertexId b, std::uint32_t t) const {
+        const Triangle& tri = triangles_[t];
+        const math::Vector3<T> face_normal =
+            (positions_[tri[1]] - positions_[tri[0]]).cross(positions_[tri[2]] - positions_[tri[0]]);
+        const math::Vector3<T> edge = positions_[b] - positions_[a];
+        const math::Vector3<T> n = edge.cross(face_normal);
+        const T length = n.length();
+        if (!(length > T(0))) return Quadric<T>::zero();
+        const math::Vector3<T> unit = n / length;
+        return Quadric<T>::plane(unit.x, unit.y, unit.z, -unit.dot(positions_[a]),
+                                 static_cast<T>(DECIMATION_BOUNDARY_WEIGHT) * edge.length_squared());
+    }
+
+    const std::vector<Triangle>& triangles_;
+    const std::vector<math::Vector3<T>>& positions_;
+    std::vector<Quadric<T>>& quadrics_;
+    const bool preserve_boundaries_;
+    const double singular_threshold_;
+};
+
+// Cost policy around a functor cost(a, b, target) of the two end positions, which
+// returns the cost and sets target to where the merged vertex goes. The functor sees
+// source coordinates rather than the normalized frame. When one end is fixed the
+// merged vertex stays there whatever the functor picks.
+template<typename T, typename Functor>
+class FunctorCollapseCost {
+public:
+    FunctorCollapseCost(const DecimationData<T>& data, Functor functor)
+        : positions_(data.positions), center_(data.center), inverse_scale_(data.inverse_scale),
+          functor_(std::move(functor)) {}
+
+    void begin_classify() {}
+    void classify_vertex(core::VertexId, const std::uint32_t*, const std::uint32_t*, const std::vector<EdgeUse>&) {}
+
+    double evaluate(core::VertexId a, core::VertexId b, bool free, math::Vector3<T>& target) const {
+        const math::Vector3<T> pa = positions_[a] * inverse_scale_ + center_;
+        const math::Vector3<T> pb = positions_[b] * inverse_scale_ + center_;
+        math::Vector3<T> chosen = pb;
+        const double cost = static_cast<double>(functor_(pa, pb, chosen));
+        if (free) target = (chosen - center_) / inverse_scale_;
+        return cost;
+    }
+
+    void merge(core::VertexId, core::VertexId) {}
+
+private:
+    const std::vector<math::Vector3<T>>& positions_;
+    const math::Vector3<T> center_;
+    const T inverse_scale_;
+    const Functor functor_;
+};
+
+// Edge collapse engine over a DecimationData, which it updates in place. Topology is
+// the triangle list plus, per vertex, a range in a shared pool of incident triangle
+// ids. A collapse appends the merged list of the kept vertex to the pool (stale ids of
+// removed triangles are filtered when read), and the pool is compacted once it
+// outgrows the live references, so memory stays linear and each collapse costs time
+// proportional to the valence of its ends.
+// Candidates sit in a CollapseQueue with lazy deletion: each entry records the
+// versions of its endpoints and is skipped on pop when either has changed. What a
+// collapse costs and where the merged vertex goes is up to the Cost policy.
+template<typename T, typename Cost>
+class EdgeCollapser {
+public:
+    using Triangle = typename DecimationData<T>::Triangle;
+
+    // With classify, the boundary / non-manifold flags and the cost's per-vertex data
+    // are computed from the triangles; otherwise those in data are used as they are,
+    // e.g. when carried over from an earlier pass.
+    EdgeCollapser(DecimationData<T>& data, bool preserve_boundaries, Cost cost, bool classify = true)
+        : data_(data), triangles_(data.triangles), positions_(data.positions), flags_(data.flags),
+          preserve_boundaries_(preserve_boundaries), cost_(std::move(cost)) {
+        triangle_removed_.assign(triangles_.size(), 0);
+        live_triangles_ = triangles_.size();
+        versions_.assign(positions_.size(), 0);
+        marks_.assign(positions_.size(), 0);
+        build_references();
+        if (classify) classify_vertices();
+    }
+
+    std::size_t live_triangles() const { return live_triangles_; }
+    std::size_t collapses() const { return collapses_; }
+
+    // Keeps v in place; call before the first decimate()
+    void lock_vertex(core::VertexId v) { flags_[v] |= DECIMATION_LOCKED; }
+
+    // Never undershoot the target: collapses that would remove more triangles than are
+    // left to it are put back, so it is met exactly unless every valid collapse removes
+    // two triangles one short of it (a closed surface always has an even count).
+    // Otherwise a final collapse may remove one more.
+    void set_exact_target(bool exact) { exact_ = exact; }
+
+    // Lower bound (up to queue resolution) on the cost of the next collapse; infinity
+    // when no candidates are left
+    float next_cost() {
+        if (!seeded_) seed_candidates();
+        return queue_.lowest_cost();
+    }
+
+    // Collapses the cheapest valid edges until target_triangles remain, no valid
+    // collapse is left, the next one would cost more than max_cost, or *cancel is set.
+    // Can be called again with other limits.
+    void decimate(std::size_t target_triangles, float max_cost = std::numeric_limits<float>::infinity(),
+                  const std::atomic<bool>* cancel = nullptr) {
+        if (!seeded_) seed_candidates();
+
+        std::vector<CollapseCandidate<T>> deferred;
+        CollapseCandidate<T> candidate;
+        while (live_triangles_ > target_triangles && !(cancel && cancel->load(std::memory_order_relaxed)) &&
+               queue_.pop(candidate, max_cost)) {
+            if ((flags_[candidate.u] | flags_[candidate.v]) & DECIMATION_REMOVED) continue;
+            if (versions_[candidate.u] != candidate.version_u || versions_[candidate.v] != candidate.version_v) continue;
+
+            const std::size_t budget = exact_ ? live_triangles_ - target_triangles : std::numeric_limits<std::size_t>::max();
+            if (collapse(candidate, budget) == Outcome::OVER_BUDGET) {
+                deferred.push_back(candidate);
+            }
+        }
+        for (const auto& c : deferred) queue_.push(c);
+    }
+
+    // Drops the removed triangles from data, keeping the order of the rest. The
+    // decimator must not be used afterwards.
+    void finish() {
+        std::size_t kept = 0;
+        for (std::size_t t = 0; t < triangles_.size(); ++t) {
+            if (triangle_removed_[t]) continue;
+            triangles_[kept] = triangles_[t];
+            data_.source_face[kept] = data_.source_face[t];
+            data_.normals[kept] = data_.normals[t];
+            ++kept;
+        }
+        triangles_.resize(kept);
+        data_.source_face.resize(kept);
+        data_.normals.resize(kept);
+    }
+
+private:
+    enum class Outcome { DONE, REJECTED, OVER_BUDGET };
+
+    void build_references() {
+        const std::size_t n = positions_.size();
+        ref_start_.assign(n, 0);
+        ref_count_.assign(n, 0);
+        for (const Triangle& tri : triangles_) {
+            for (auto x : tri) ++ref_count_[x];
+        }
+        std::size_t offset = 0;
+        for (std::size_t v = 0; v < n; ++v) {
+            ref_start_[v] = offset;
+            offset += ref_count_[v];
+        }
+        pool_.resize(offset);
+        std::vector<std::size_t> cursor(ref_start_);
+        for (std::size_t t = 0; t < triangles_.size(); ++t) {
+            for (auto x : triangles_[t]) pool_[cursor[x]++] = static_cast<std::uint32_t>(t);
+        }
+    }
+
+    // Per vertex: find boundary and non-manifold edges (an edge's use count is how often
+    // the neighbor shows up in the vertex's triangles) and hand them to the cost. Each
+    // vertex only writes its own data.
+    void classify_vertices() {
+        const std::size_t n = positions_.size();
+        cost_.begin_classify();
+
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            std::vector<EdgeUse> uses;
+
+            for (std::size_t u = begin; u < end; ++u) {
+                uses.clear();
+                const std::uint32_t* first = pool_.data() + ref_start_[u];
+                const std::uint32_t* last = first + ref_count_[u];
+                for (const std::uint32_t* t = first; t != last; ++t) {
+                    for (auto w : triangles_[*t]) {
+                        if (w == u) continue;
+                        auto it = std::find_if(uses.begin(), uses.end(), [w](const EdgeUse& use) { return use.w == w; });
+                        if (it == uses.end()) uses.push_back({w, 1, *t});
+                        else ++it->count;
+                    }
+                }
+
+                std::uint8_t flags = 0;
+                for (const EdgeUse& use : uses) {
+                    if (use.count > 2) flags |= DECIMATION_LOCKED;
+                    if (use.count == 1) flags |= DECIMATION_BOUNDARY;
+                }
+                cost_.classify_vertex(static_cast<core::VertexId>(u), first, last, uses);
+                flags_[u] |= flags;
+            }
+        }, DECIMATION_MIN_CHUNK);
+    }
+
+    bool fixed(core::VertexId v) const {
+        const std::uint8_t mask = preserve_boundaries_ ? (DECIMATION_LOCKED | DECIMATION_BOUNDARY) : DECIMATION_LOCKED;
+        return (flags_[v] & mask) != 0;
+    }
+
+    // Candidate for collapsing edge (a, b); false when both ends are fixed
+    bool evaluate(core::VertexId a, core::VertexId b, CollapseCandidate<T>& out) const {
+        const bool fixed_a = fixed(a);
+        const bool fixed_b = fixed(b);
+        if (fixed_a && fixed_b) return false;
+
+        // The fixed end (if any) is kept
+        if (fixed_a) std::swap(a, b);
+        math::Vector3<T> target = positions_[b];
+        const double cost = cost_.evaluate(a, b, !fixed_a && !fixed_b, target);
+
+        out.cost = std::isnan(cost) ? std::numeric_limits<float>::infinity()
+                                    : static_cast<float>(std::max(cost, 0.0));
+        out.u = a;
+        out.v = b;
+        out.version_u = versions_[a];
+        out.version_v = versions_[b];
+        out.target = target;
+        return true;
+    }
+
+    void seed_candidates() {
+        seeded_ = true;
+        const std::size_t n = positions_.size();
+        const std::size_t chunks = utils::parallel_chunk_count(n, DECIMATION_MIN_CHUNK);
+        std::vector<std::vector<CollapseCandidate<T>>> partial(chunks);
+
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            std::vector<core::VertexId> neighbors;
+            auto& out = partial[chunk];
+            for (std::size_t u = begin; u < end; ++u) {
+                neighbors.clear();
+                for (std::size_t k = ref_start_[u]; k < ref_start_[u] + ref_count_[u]; ++k) {
+                    for (auto w : triangles_[pool_[k]]) {
+                        if (w > u && std::find(neighbors.begin(), neighbors.end(), w) == neighbors.end()) {
+                            neighbors.push_back(w);
+                        }
+                    }
+                }
+                CollapseCandidate<T> candidate;
+                for (auto w : neighbors) {
+                    if (evaluate(static_cast<core::VertexId>(u), w, candidate)) out.push_back(candidate);
+                }
+            }
+        }, DECIMATION_MIN_CHUNK);
+
+        for (auto& p : partial) {
+            for (const auto& candidate : p) queue_.push(candidate);
+            std::vector<CollapseCandidate<T>>().swap(p);
+        }
+    }
+
+    bool contains(const Triangle& tri, core::VertexId x) const {
+        return tri[0] == x || tri[1] == x || tri[2] == x;
+    }
+
+    // Is there a live triangle on x, a and b?
+    bool spans(core::VertexId x, core::VertexId a, core::VertexId b) const {
+        for (std::size_t k = ref_start_[x]; k < ref_start_[x] + ref_count_[x]; ++k) {
+            const std::uint32_t t = pool_[k];
+            if (!triangle_removed_[t] && contains(triangles_[t], a) && contains(triangles_[t], b)) return true;
+        }
+        return false;
+    }
+
+    // Would moving `moving` to target flip or collapse triangle t? Checked against
+    // both its current normal and its normal as loaded, so small turns over many
+    // collapses, or over the cluster and seam passes of partitioned decimation,
+    // cannot add up to a fold.
+    bool flips(std::uint32_t t, core::VertexId moving, const math::Vector3<T>& target) const {
+        const Triangle& tri = triangles_[t];
+        math::Vector3<T> p[3] = {positions_[tri[0]], positions_[tri[1]], positions_[tri[2]]};
+        const math::Vector3<T> before = (p[1] - p[0]).cross(p[2] - p[0]);
+        for (int k = 0; k < 3; ++k) {
+            if (tri[k] == moving) p[k] = target;
+        }
+        const math::Vector3<T> after = (p[1] - p[0]).cross(p[2] - p[0]);
+
+        const double cosine2 = DECIMATION_MIN_NORMAL_COSINE * DECIMATION_MIN_NORMAL_COSINE;
+        const double after2 = double(after.length_squared());
+        const double d = double(before.dot(after));
+        const double o = double(data_.normals[t].dot(after));
+        return !(d > 0.0) || d * d <= cosine2 * double(before.length_squared()) * after2 ||
+               !(o > 0.0) || o * o <= cosine2 * after2;
+    }
+
+    // Collapses u into v unless that would break the manifold, fold a triangle, or
+    // remove more than max_removed triangles
+    Outcome collapse(const CollapseCandidate<T>& candidate, std::size_t max_removed) {
+        const core::VertexId u = candidate.u;
+        const core::VertexId v = candidate.v;
+
+        // Link condition: the common neighbors of u and v are exactly the apexes of the
+        // triangles on edge (u, v)
+        marks_stamp_ += 2;
+        const std::uint32_t seen = marks_stamp_;
+        for (std::size_t k = ref_start_[u]; k < ref_start_[u] + ref_count_[u]; ++k) {
+            if (triangle_removed_[pool_[k]]) continue;
+            for (auto x : triangles_[pool_[k]]) marks_[x] = seen;
+        }
+        std::size_t shared = 0, common = 0;
+        core::VertexId apex[2] = {u, u};
+        for (std::size_t k = ref_start_[v]; k < ref_start_[v] + ref_count_[v]; ++k) {
+            const std::uint32_t t = pool_[k];
+            if (triangle_removed_[t]) continue;
+            const Triangle& tri = triangles_[t];
+            if (contains(tri, u)) {
+                for (auto x : tri) {
+                    if (x != u && x != v && shared < 2) apex[shared] = x;
+                }
+                ++shared;
+            }
+            for (auto x : tri) {
+                if (x != u && x != v && marks_[x] == seen) {
+                    marks_[x] = seen + 1;
+                    ++common;
+                }
+            }
+        }
+        if (shared == 0 || common != shared) return Outcome::REJECTED;
+
+        // The boundary acts as one more vertex linked to every boundary vertex: an
+        // inner edge between two boundary vertices would pinch the boundary into a bowtie
+        if ((flags_[u] & DECIMATION_BOUNDARY) && (flags_[v] & DECIMATION_BOUNDARY) && shared != 1) {
+            return Outcome::REJECTED;
+        }
+
+        // Tetrahedron: u and v both span a triangle with the two apexes, which would
+        // end up as two triangles on the same three vertices
+        if (shared == 2 && spans(u, apex[0], apex[1]) && spans(v, apex[0], apex[1])) return Outcome::REJECTED;
+        if (shared > max_removed) return Outcome::OVER_BUDGET;
+
+        // Orientation check on every triangle that survives the collapse
+        for (core::VertexId end : {u, v}) {
+            const core::VertexId other = end == u ? v : u;
+            for (std::size_t k = ref_start_[end]; k < ref_start_[end] + ref_count_[end]; ++k) {
+                const std::uint32_t t = pool_[k];
+                if (triangle_removed_[t] || contains(triangles_[t], other)) continue;
+                if (flips(t, end, candidate.target)) return Outcome::REJECTED;
+            }
+        }
+
+        // Apply: v takes the target, the merged cost data and u's triangles. A fixed v
+        // stays put and keeps its exact source position, also when a cluster of
+        // partitioned decimation hands it on to the seam pass.
+        if (!(candidate.target == positions_[v])) flags_[v] |= DECIMATION_MOVED;
+        positions_[v] = candidate.target;
+        cost_.merge(v, u);
+        flags_[v] |= flags_[u] & (DECIMATION_BOUNDARY | DECIMATION_LOCKED);
+        flags_[u] |= DECIMATION_REMOVED;
+        ++versions_[v];
+        ++collapses_;
+
+        const std::size_t start = pool_.size();
+        for (core::VertexId end : {v, u}) {
+            const std::size_t first = ref_start_[end];
+            const std::size_t count = ref_count_[end];
+            for (std::size_t k = first; k < first + count; ++k) {
+                const std::uint32_t t = pool_[k];
+                if (triangle_removed_[t]) continue;
+                Triangle& tri = triangles_[t];
+                if (contains(tri, u) && contains(tri, v)) {
+                    triangle_removed_[t] = 1;
+                    --live_triangles_;
+                    continue;
+                }
+                for (auto& x : tri) {
+                    if (x == u) x = v;
+                }
+                pool_.push_back(t);
+            }
+        }
+        ref_start_[v] = start;
+        ref_count_[v] = static_cast<std::uint32_t>(pool_.size() - start);
+        ref_count_[u] = 0;
+
+        // New candidates around v
+        marks_stamp_ += 2;
+        const std::uint32_t pushed = marks_stamp_;
+        marks_[v] = pushed;
+        CollapseCandidate<T> next;
+        for (std::size_t k = ref_start_[v]; k < ref_start_[v] + ref_count_[v]; ++k) {
+            for (auto w : triangles_[pool_[k]]) {
+                if (marks_[w] == pushed) continue;
+                marks_[w] = pushed;
+                if (evaluate(v, w, next)) queue_.push(next);
+            }
+        }
+
+        if (pool_.size() > 4 * 3 * live_triangles_ + 1024) compact_pool();
+        return Outcome::DONE;
+    }
+
+    // Drops removed triangles from every list and packs the pool
+    void compact_pool() {
+        std::vector<std::uint32_t> packed;
+        packed.reserve(3 * live_triangles_);
+        for (std::size_t x = 0; x < positions_.size(); ++x) {
+            const std::size_t first = ref_start_[x];
+            const std::size_t count = ref_count_[x];
+            ref_start_[x] = packed.size();
+            for (std::size_t k = first; k < first + count; ++k) {
+                if (!triangle_removed_[pool_[k]]) packed.push_back(pool_[k]);
+            }
+            ref_count_[x] = static_cast<std::uint32_t>(packed.size() - ref_start_[x]);
+        }
+        pool_.swap(packed);
+    }
+
+    DecimationData<T>& data_;
+    std::vector<Triangle>& triangles_;
+    std::vector<math::Vector3<T>>& positions_;
+    std::vector<std::uint8_t>& flags_;
+    const bool preserve_boundaries_;
+    Cost cost_;
+
+    std::vector<std::uint8_t> triangle_removed_;
+    std::size_t live_triangles_ = 0;
+    std::size_t collapses_ = 0;
+    std::vector<std::uint32_t> versions_;
+
+    std::vector<std::uint32_t> pool_;
+    std::vector<std::size_t> ref_start_;
+    std::vector<std::uint32_t> ref_count_;
+
+    std::vector<std::uint32_t> marks_;
+    std::uint32_t marks_stamp_ = 0;
+
+    CollapseQueue<T> queue_;
+    bool seeded_ = false;
+    bool exact_ = false;
+};
+
+// EdgeCollapser with quadric costs, as quadric_decimation runs it
+template<typename T>
+class QuadricDecimator : public EdgeCollapser<T, QuadricCollapseCost<T>> {
+public:
+    QuadricDecimator(DecimationData<T>& data, bool preserve_boundaries, double singular_threshold,
+                     bool classify = true)
+        : EdgeCollapser<T, QuadricCollapseCost<T>>(
+              data, preserve_boundaries, QuadricCollapseCost<T>(data, preserve_boundaries, singular_threshold),
+              classify) {}
+};
+
+// Triangle count to stop at: target_triangles when set, else the count left after
+// removing reduction_ratio of the triangles
+inline std::size_t decimation_target(std::size_t triangles, const DecimationConfig& config) {
+    if (config.target_triangles > 0) return config.target_triangles;
+    const double ratio = std::min(std::max(double(config.reduction_ratio), 0.0), 1.0);
+    return triangles - static_cast<std::size_t>(std::llround(double(triangles) * ratio));
+}
+
+// Decimates spatial clusters concurrently, then finishes with one serial pass over the
+// whole mesh. Triangles are binned by centroid on a grid whose cells, taken in Morton
+// order, are cut into `partitions` runs of about equal triangle count. Each cluster is
+// decimated on a local copy with the vertices along its seams locked, and writes back
+// the vertices it owns. The final pass starts from the carried-over quadrics.
+template<typename T>
+void partitioned_decimation(DecimationData<T>& data, std::size_t target_triangles, std::size_t partitions,
+                            bool preserve_boundaries, double singular_threshold) {
+    using Triangle = typename DecimationData<T>::Triangle;
+    const std::size_t triangle_count = data.triangles.size();
+    const std::size_t n = data.positions.size();
+
+    // Quadrics and flags for the whole mesh; clusters inherit them
+    {
+        QuadricDecimator<T> classifier(data, preserve_boundaries, singular_threshold);
+    }
+
+    std::vector<std::size_t> cluster_start(partitions + 1, 0);
+    std::vector<std::uint32_t> order(triangle_count);
+    {
+        // Bin centroids; the unit box spans [-0.5, 0.5] on its longest axis
+        const std::uint32_t grid = DECIMATION_CLUSTER_GRID;
+        std::vector<std::uint32_t> cell(triangle_count);
+        utils::parallel_for_range(0, triangle_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            auto coordinate = [&](T x) {
+                const T scaled = (x + T(0.5)) * T(grid);
+                return static_cast<std::uint32_t>(scaled > T(0) ? std::min(scaled, T(grid - 1)) : T(0));
+            };
+            for (std::size_t t = begin; t < end; ++t) {
+                const Triangle& tri = data.triangles[t];
+                const math::Vector3<T> centroid =
+                    (data.positions[tri[0]] + data.positions[tri[1]] + data.positions[tri[2]]) / T(3);
+                cell[t] = math::morton_encode(coordinate(centroid.x), coordinate(centroid.y), coordinate(centroid.z));
+            }
+        }, DECIMATION_MIN_CHUNK);
+
+        // Cut the cells, in Morton order, into runs of about equal triangle count
+        std::vector<std::uint32_t> cluster_of_cell(std::size_t(grid) * grid * grid);
+        {
+            std::vector<std::size_t> cell_count(cluster_of_cell.size(), 0);
+            for (auto c : cell) ++cell_count[c];
+            std::size_t before = 0;
+            for (std::size_t c = 0; c < cell_count.size(); ++c) {
+                cluster_of_cell[c] = static_cast<std::uint32_t>(std::min(before * partitions / triangle_count, partitions - 1));
+                before += cell_count[c];
+            }
+        }
+
+        // Counting sort of the triangles by cluster
+        for (auto c : cell) ++cluster_start[cluster_of_cell[c] + 1];
+        for (std::size_t c = 0; c < partitions; ++c) cluster_start[c + 1] += cluster_start[c];
+        std::vector<std::size_t> cursor(cluster_start.begin(), cluster_start.end() - 1);
+        for (std::size_t t = 0; t < triangle_count; ++t) {
+            order[cursor[cluster_of_cell[cell[t]]]++] = static_cast<std::uint32_t>(t);
+        }
+    }
+
+    // Owning cluster of each vertex, or shared when several clusters use it
+    const std::uint32_t unowned = std::numeric_limits<std::uint32_t>::max();
+    const std::uint32_t shared = unowned - 1;
+    std::vector<std::uint32_t> owner(n, unowned);
+    for (std::size_t c = 0; c < partitions; ++c) {
+        for (std::size_t k = cluster_start[c]; k < cluster_start[c + 1]; ++k) {
+            for (auto x : data.triangles[order[k]]) {
+                if (owner[x] == unowned) owner[x] = static_cast<std::uint32_t>(c);
+                else if (owner[x] != c) owner[x] = shared;
+            }
+        }
+    }
+
+    // Local copy of each cluster with its own vertex numbering
+    struct Cluster {
+        std::vector<core::VertexId> vertices;   // source index of each local vertex
+        DecimationData<T> data;
+        std::unique_ptr<QuadricDecimator<T>> decimator;
+        std::size_t free_vertices = 0;         // not locked, so the cluster may remove them
+    };
+    std::vector<Cluster> clusters(partitions);
+
+    utils::parallel_for_range(0, partitions, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (std::size_t c = first; c < last; ++c) {
+            const std::size_t begin = cluster_start[c];
+            const std::size_t end = cluster_start[c + 1];
+            if (begin == end) continue;
+
+            Cluster& cluster = clusters[c];
+            auto& vertices = cluster.vertices;
+            for (std::size_t k = begin; k < end; ++k) {
+                for (auto x : data.triangles[order[k]]) vertices.push_back(x);
+            }
+            std::sort(vertices.begin(), vertices.end());
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            auto local_index = [&](core::VertexId x) {
+                return static_cast<core::VertexId>(std::lower_bound(vertices.begin(), vertices.end(), x) - vertices.begin());
+            };
+
+            DecimationData<T>& local = cluster.data;
+            local.positions.resize(vertices.size());
+            local.quadrics.resize(vertices.size());
+            local.flags.resize(vertices.size());
+            for (std::size_t i = 0; i < vertices.size(); ++i) {
+                local.positions[i] = data.positions[vertices[i]];
+                local.quadrics[i] = data.quadrics[vertices[i]];
+                local.flags[i] = data.flags[vertices[i]];
+            }
+
+            // Lock the seam and the ring of owned vertices around it. A collapse then
+            // only involves vertices whose triangles all lie in this cluster, so the
+            // link and flip checks see the whole neighborhood, and shared vertices are
+            // left untouched.
+            local.triangles.reserve(end - begin);
+            local.source_face.reserve(end - begin);
+            local.normals.reserve(end - begin);
+            for (std::size_t k = begin; k < end; ++k) {
+                const Triangle& tri = data.triangles[order[k]];
+                const Triangle local_tri = {local_index(tri[0]), local_index(tri[1]), local_index(tri[2])};
+                if (owner[tri[0]] == shared || owner[tri[1]] == shared || owner[tri[2]] == shared) {
+                    for (auto x : local_tri) local.flags[x] |= DECIMATION_LOCKED;
+                }
+                local.triangles.push_back(local_tri);
+                local.source_face.push_back(data.source_face[order[k]]);
+                local.normals.push_back(data.normals[order[k]]);
+            }
+
+            const std::uint8_t fixed = preserve_boundaries ? (DECIMATION_LOCKED | DECIMATION_BOUNDARY) : DECIMATION_LOCKED;
+            for (auto flags : local.flags) {
+                if (!(flags & fixed)) ++cluster.free_vertices;
+            }
+
+            cluster.decimator.reset(new QuadricDecimator<T>(local, preserve_boundaries, singular_threshold, false));
+            cluster.decimator->next_cost();  // seeds the queue on this thread
+        }
+    }, 1);
+    std::vector<std::uint32_t>().swap(order);
+
+    // Each cluster removes the overall share of its free vertices, about two triangles
+    // each, and leaves the rest to the final pass. Its interior then ends as dense as
+    // the result. Running a cluster down by triangle count instead can use up every
+    // free vertex, and it then spans its interior with triangles between seam vertices.
+    const double removed_share = 1.0 - double(target_triangles) / double(triangle_count);
+    utils::parallel_for_range(0, partitions, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (std::size_t c = first; c < last; ++c) {
+            Cluster& cluster = clusters[c];
+            if (!cluster.decimator) continue;
+            const std::size_t live = cluster.decimator->live_triangles();
+            const auto removed = 2 * static_cast<std::size_t>(double(cluster.free_vertices) * removed_share);
+            cluster.decimator->decimate(live - std::min(live, removed));
+        }
+    }, 1);
+
+    // Owned vertices belong to one cluster alone; drop the temporary locks
+    utils::parallel_for_range(0, partitions, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (std::size_t c = first; c < last; ++c) {
+            Cluster& cluster = clusters[c];
+            if (!cluster.decimator) continue;
+            cluster.decimator->finish();
+            cluster.decimator.reset();
+
+            const DecimationData<T>& local = cluster.data;
+            for (std::size_t i = 0; i < cluster.vertices.size(); ++i) {
+                const core::VertexId g = cluster.vertices[i];
+                if (owner[g] == shared) continue;
+                data.positions[g] = local.positions[i];
+                data.quadrics[g] = local.quadrics[i];
+                data.flags[g] = static_cast<std::uint8_t>((local.flags[i] & ~DECIMATION_LOCKED) |
+                                                          (data.flags[g] & DECIMATION_LOCKED));
+            }
+        }
+    }, 1);
+
+    // Survivors in cluster order, then the serial pass across the seams
+    data.triangles.clear();
+    data.source_face.clear();
+    data.normals.clear();
+    for (Cluster& cluster : clusters) {
+        for (const Triangle& tri : cluster.data.triangles) {
+            data.triangles.push_back({cluster.vertices[tri[0]], cluster.vertices[tri[1]], cluster.vertices[tri[2]]});
+        }
+        data.source_face.insert(data.source_face.end(), cluster.data.source_face.begin(), cluster.data.source_face.end());
+        data.normals.insert(data.normals.end(), cluster.data.normals.begin(), cluster.data.normals.end());
+        cluster = Cluster();
+    }
+
+    QuadricDecimator<T> decimator(data, preserve_boundaries, singular_threshold, false);
+    decimator.decimate(target_triangles);
+    decimator.finish();
+}
+
+} // namespace detail
+
+// Quadric error decimation down to the target from config. preserve_boundaries keeps
+// boundary vertices fixed; otherwise boundaries are held by constraint planes.
+// quadric_threshold is the relative determinant below which a quadric is treated as
+// singular and the collapse target falls back to an endpoint or the midpoint. With
+// partitions > 1, spatial clusters are decimated in parallel before a final serial pass.
+template<typename T>
+void quadric_decimation(core::Mesh<T>& mesh, const DecimationConfig& config) {
+    if (mesh.face_count() == 0) return;
+
+    detail::DecimationData<T> data;
+    detail::load_decimation_data(mesh, data);
+    const std::size_t target = detail::decimation_target(data.triangles.size(), config);
+
+    if (config.partitions > 1 && target < data.triangles.size()) {
+        detail::partitioned_decimation(data, target, config.partitions, config.preserve_boundaries,
+                                       config.quadric_threshold);
+    } else {
+        detail::QuadricDecimator<T> decimator(data, config.preserve_boundaries, config.quadric_threshold);
+        decimator.decimate(target);
+        decimator.finish();
+    }
+
+    std::vector<core::Vertex<T>> vertices;
+    std::vector<core::Face<T>> faces;
+    detail::extract_decimation_data(data, mesh, vertices, faces);
+    mesh.assign(std::move(vertices), std::move(faces));
+    mesh.compute_face_normals();
+}
+
+// Removes reduction_ratio (0..1) of the triangles
+template<typename T>
+void quadric_decimation(core::Mesh<T>& mesh, T reduction_ratio) {
+    DecimationConfig config;
+    config.reduction_ratio = static_cast<float>(reduction_ratio);
+    quadric_decimation(mesh, config);
+}
+
+// Cost used by edge_collapse_decimation unless another is given: the squared edge
+// length, with the merged vertex at the midpoint
+struct ShortestEdgeCost {
+    template<typename T>
+    T operator()(const math::Vector3<T>& a, const math::Vector3<T>& b, math::Vector3<T>& target) const {
+        target = (a + b) * T(0.5);
+        return (a - b).length_squared();
+    }
+};
+
+namespace detail {
+
+// target(triangles) gives the triangle count to stop at from the count loaded
+template<typename T, typename Cost, typename Target>
+EdgeCollapseResult edge_collapse(core::Mesh<T>& mesh, Target&& target, bool preserve_boundaries,
+                                 Cost cost, const std::atomic<bool>* cancel) {
+    EdgeCollapseResult result;
+    if (mesh.face_count() == 0) return result;
+
+    DecimationData<T> data;
+    load_decimation_data(mesh, data);
+    result.initial_triangles = data.triangles.size();
+    const std::size_t target_triangles = target(data.triangles.size());
+
+    using Policy = FunctorCollapseCost<T, Cost>;
+    EdgeCollapser<T, Policy> collapser(data, preserve_boundaries, Policy(data, std::move(cost)));
+    collapser.set_exact_target(true);
+    collapser.decimate(target_triangles, std::numeric_limits<float>::infinity(), cancel);
+    result.collapses = collapser.collapses();
+    result.final_triangles = collapser.live_triangles();
+    if (cancel && cancel->load(std::memory_order_relaxed) && result.final_triangles > target_triangles) {
+        result.cancelled = true;
+        return result;
+    }
+
+    collapser.finish();
+    std::vector<core::Vertex<T>> vertices;
+    std::vector<core::Face<T>> faces;
+    extract_decimation_data(data, mesh, vertices, faces);
+    mesh.assign(std::move(vertices), std::move(faces));
+    mesh.compute_face_normals();
+    return result;
+}
+
+} // namespace detail
+
+// Collapses edges in order of cost(a, b, target) until exactly target_triangles remain.
+// Cost is any functor taking the two end positions and a position to set for the merged
+// vertex, returning a non-negative cost; it is called concurrently while the queue is
+// seeded. Collapses keep the surface manifold (link condition) and do not fold
+// triangles; boundary vertices stay fixed when preserve_boundaries is set. The run
+// stops short when no valid collapse is left, or one above the target when only
+// two-triangle collapses remain. Polling *cancel, it also stops when that is set; the
+// mesh is then left unchanged and the result says so.
+template<typename T, typename Cost>
+EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, std::size_t target_triangles, Cost cost,
+                                            const std::atomic<bool>* cancel, bool preserve_boundaries) {
+    return detail::edge_collapse(mesh, [=](std::size_t) { return target_triangles; }, preserve_boundaries,
+                                 std::move(cost), cancel);
+}
+
+// Shortest edge first, with boundaries preserved
+template<typename T>
+EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, std::size_t target_triangles) {
+    return edge_collapse_decimation(mesh, target_triangles, ShortestEdgeCost(), nullptr, true);
+}
+
+// Target and boundary handling from config
+template<typename T, typename Cost>
+EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, const DecimationConfig& config, Cost cost,
+                                            const std::atomic<bool>* cancel) {
+    return detail::edge_collapse(mesh, [&](std::size_t triangles) { return detail::decimation_target(triangles, config); },
+                                 config.preserve_boundaries, std::move(cost), cancel);
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
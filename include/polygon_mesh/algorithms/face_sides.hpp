@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <polygon_mesh/core/mesh.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace detail {
+
+// Entries grouped by a vertex: bucket v holds entries[offsets[v] .. offsets[v + 1])
+template<typename Entry>
+struct SideBuckets {
+    std::vector<std::size_t> offsets;  // bucket_count + 1 entries
+    std::vector<Entry> entries;
+};
+
+// Parallel counting sort of face sides (or anything else keyed by a vertex).
+// sides(i, emit) calls emit(bucket, entry) for every entry that item i contributes; it
+// runs once to count and once to scatter, so it must emit the same entries both times.
+// Entries land in a bucket in thread order, so callers sort each bucket as they scan it.
+template<typename Entry, typename Sides>
+SideBuckets<Entry> bucket_sides(std::size_t bucket_count, std::size_t item_count, Sides&& sides,
+                                std::size_t min_chunk) {
+    SideBuckets<Entry> buckets;
+    buckets.offsets.assign(bucket_count + 1, 0);
+
+    // One chunk: plain counters, no atomics
+    if (utils::parallel_chunk_count(item_count, min_chunk) <= 1) {
+        for (std::size_t i = 0; i < item_count; ++i) {
+            sides(i, [&](core::VertexId bucket, Entry) { ++buckets.offsets[bucket + 1]; });
+        }
+        for (std::size_t v = 0; v < bucket_count; ++v) {
+            buckets.offsets[v + 1] += buckets.offsets[v];
+        }
+        buckets.entries.resize(buckets.offsets[bucket_count]);
+        std::vector<std::size_t> cursor(buckets.offsets.begin(), buckets.offsets.end() - 1);
+        for (std::size_t i = 0; i < item_count; ++i) {
+            sides(i, [&](core::VertexId bucket, Entry entry) { buckets.entries[cursor[bucket]++] = entry; });
+        }
+        return buckets;
+    }
+
+    std::unique_ptr<std::atomic<std::uint32_t>[]> bucket_sizes(new std::atomic<std::uint32_t>[bucket_count + 1]());
+    utils::parallel_for_range(0, item_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            sides(i, [&](core::VertexId bucket, Entry) {
+                bucket_sizes[bucket + 1].fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }, min_chunk);
+
+    for (std::size_t v = 0; v < bucket_count; ++v) {
+        buckets.offsets[v + 1] = buckets.offsets[v] + bucket_sizes[v + 1].load(std::memory_order_relaxed);
+        bucket_sizes[v + 1].store(0, std::memory_order_relaxed);
+    }
+
+    buckets.entries.resize(buckets.offsets[bucket_count]);
+    utils::parallel_for_range(0, item_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            sides(i, [&](core::VertexId bucket, Entry entry) {
+                const std::size_t slot = buckets.offsets[bucket] + bucket_sizes[bucket + 1].fetch_add(1, std::memory_order_relaxed);
+                buckets.entries[slot] = entry;
+            });
+        }
+    }, min_chunk);
+    return buckets;
+}
+
+// Every face side a -> b with a != b, in the bucket of its lower vertex as the higher one.
+// An edge shared by k faces leaves k equal entries in its bucket.
+template<typename T>
+SideBuckets<core::VertexId> bucket_face_sides(const core::Mesh<T>& mesh, std::size_t min_chunk) {
+    const auto& faces = mesh.faces();
+    return bucket_sides<core::VertexId>(mesh.vertex_count(), faces.size(), [&](std::size_t f, auto&& emit) {
+        const auto& ids = faces[f].vertices;
+        for (std::size_t i = 0, n = ids.size(); i < n; ++i) {
+            const core::VertexId a = ids[i];
+            const core::VertexId b = ids[i + 1 == n ? 0 : i + 1];
+            if (a != b) emit(std::min(a, b), std::max(a, b));
+        }
+    }, min_chunk);
+}
+
+} // namespace detail
+} // namespace algorithms
+} // namespace polygon_mesh
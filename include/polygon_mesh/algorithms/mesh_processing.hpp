@@ -1,15 +1,21 @@
 #pragma once
 
+#include <polygon_mesh/algorithms/config.hpp>
 #include <polygon_mesh/core/mesh.hpp>
 #include <polygon_mesh/math/vector3.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <atomic>
+#include <utility>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace polygon_mesh {
 namespace algorithms {
 
 // Forward declarations
 template<typename T> class Mesh;
+template<typename T> class CotangentLaplacian;
 
 // Mesh generation algorithms
 namespace generation {
@@ -60,24 +66,76 @@ namespace processing {
     template<typename T>
     void laplacian_smoothing(core::Mesh<T>& mesh, std::size_t iterations = 1, T lambda = T(0.5));
 
+    template<typename T>
+    void laplacian_smoothing(core::Mesh<T>& mesh, const SmoothingConfig& config);
+
     template<typename T>
     void taubin_smoothing(core::Mesh<T>& mesh, std::size_t iterations = 1, 
                           T lambda = T(0.5), T mu = T(-0.53));
 
+    template<typename T>
+    void taubin_smoothing(core::Mesh<T>& mesh, const SmoothingConfig& config);
+
     // Mesh decimation (simplification)
     template<typename T>
     void quadric_decimation(core::Mesh<T>& mesh, T reduction_ratio);
 
     template<typename T>
-    void edge_collapse_decimation(core::Mesh<T>& mesh, std::size_t target_triangles);
+    void quadric_decimation(core::Mesh<T>& mesh, const DecimationConfig& config);
+
+    // Outcome of edge_collapse_decimation, in triangles after fan triangulation
+    struct EdgeCollapseResult {
+        std::size_t initial_triangles = 0;
+        std::size_t final_triangles = 0;
+        std::size_t collapses = 0;
+        bool cancelled = false;    // stopped by the cancel flag; the mesh is unchanged
+    };
+
+    struct ShortestEdgeCost;
+
+    template<typename T>
+    EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, std::size_t target_triangles);
+
+    template<typename T, typename Cost>
+    EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, std::size_t target_triangles, Cost cost,
+                                                const std::atomic<bool>* cancel = nullptr,
+                                                bool preserve_boundaries = true);
+
+    template<typename T, typename Cost = ShortestEdgeCost>
+    EdgeCollapseResult edge_collapse_decimation(core::Mesh<T>& mesh, const DecimationConfig& config,
+                                                Cost cost = Cost(), const std::atomic<bool>* cancel = nullptr);
+
+    // Position given to the single vertex each grid cell is merged into
+    enum class ClusterRepresentative {
+        MEAN,     // average of the cell's vertices
+        QUADRIC   // point of least error for the cell's face planes that lies nearest the mean
+    };
+
+    template<typename T>
+    void cluster_decimation(core::Mesh<T>& mesh, std::size_t grid_resolution,
+                            ClusterRepresentative representative = ClusterRepresentative::QUADRIC);
 
     // Mesh refinement
     template<typename T>
     void loop_subdivision(core::Mesh<T>& mesh, std::size_t levels = 1);
 
+    template<typename T>
+    void loop_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config);
+
+    template<typename T>
+    void loop_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config,
+                          const std::vector<std::pair<core::VertexId, core::VertexId>>& creases);
+
     template<typename T>
     void catmull_clark_subdivision(core::Mesh<T>& mesh, std::size_t levels = 1);
 
+    template<typename T>
+    void catmull_clark_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config);
+
+    template<typename T>
+    void catmull_clark_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config,
+                                   const std::vector<std::pair<core::VertexId, core::VertexId>>& creases);
+
     // Mesh validation and repair
     template<typename T>
     bool validate_topology(const core::Mesh<T>& mesh);
@@ -85,14 +143,34 @@ namespace processing {
     template<typename T>
     void remove_duplicate_vertices(core::Mesh<T>& mesh, T epsilon = T(1e-6));
 
+    // Counts reported by remove_degenerate_faces. A face failing several tests is
+    // counted once, under the first of: non-finite, repeated index, zero area.
+    struct DegenerateFaceStats {
+        std::size_t non_finite_faces = 0;
+        std::size_t repeated_index_faces = 0;
+        std::size_t zero_area_faces = 0;
+        std::size_t removed_faces = 0;
+        std::size_t removed_vertices = 0;
+    };
+
     template<typename T>
-    void remove_degenerate_faces(core::Mesh<T>& mesh, T min_area = T(1e-8));
+    DegenerateFaceStats remove_degenerate_faces(core::Mesh<T>& mesh, T min_area = T(1e-8),
+                                                bool remove_unreferenced_vertices = false);
 
     template<typename T>
     void flip_normals(core::Mesh<T>& mesh);
 
+    // Counts reported by make_normals_consistent. Components are groups of faces joined
+    // across edges that exactly two faces share; closed ones have no other edges.
+    struct OrientationStats {
+        std::size_t components = 0;
+        std::size_t closed_components = 0;
+        std::size_t flipped_faces = 0;
+        std::size_t inconsistent_edges = 0;   // left mismatched in non-orientable components
+    };
+
     template<typename T>
-    void make_normals_consistent(core::Mesh<T>& mesh);
+    OrientationStats make_normals_consistent(core::Mesh<T>& mesh);
 
 } // namespace processing
 
@@ -106,6 +184,25 @@ namespace analysis {
     template<typename T>
     std::vector<T> compute_gaussian_curvature(const core::Mesh<T>& mesh);
 
+    // Per-vertex results of compute_curvature. Each span is either empty, to skip that
+    // quantity, or holds one entry per vertex.
+    template<typename T>
+    struct CurvatureOutput {
+        utils::Span<T> mean;
+        utils::Span<T> gaussian;
+        utils::Span<T> max_curvature;                  // principal curvatures
+        utils::Span<T> min_curvature;
+        utils::Span<math::Vector3<T>> max_direction;   // unit tangents of the principal directions
+        utils::Span<math::Vector3<T>> min_direction;
+    };
+
+    template<typename T>
+    void compute_curvature(const core::Mesh<T>& mesh, const CurvatureOutput<T>& output);
+
+    template<typename T>
+    void compute_curvature(const core::Mesh<T>& mesh, CotangentLaplacian<T>& laplacian,
+                           const CurvatureOutput<T>& output);
+
     // Quality metrics
     template<typename T>
     std::vector<T> compute_aspect_ratios(const core::Mesh<T>& mesh);
@@ -116,10 +213,91 @@ namespace analysis {
     template<typename T>
     std::vector<T> compute_triangle_angles(const core::Mesh<T>& mesh);
 
+    // Span versions write one value per face (three angles per face) and throw
+    // std::invalid_argument when the span has any other size
+    template<typename T>
+    void compute_aspect_ratios(const core::Mesh<T>& mesh, utils::Span<T> ratios);
+
+    template<typename T>
+    void compute_triangle_areas(const core::Mesh<T>& mesh, utils::Span<T> areas);
+
+    template<typename T>
+    void compute_triangle_angles(const core::Mesh<T>& mesh, utils::Span<T> angles);
+
+    // Counts per bin over [lower, upper), values outside going to the end bins, with
+    // the exact minimum, maximum and mean of the values
+    template<typename T>
+    struct QualityHistogram {
+        T lower = T(0);
+        T upper = T(0);
+        std::vector<std::size_t> bins;
+        T minimum = T(0);
+        T maximum = T(0);
+        T mean = T(0);
+    };
+
+    // Distributions of triangle areas, aspect ratios and angles (radians, over [0, pi)).
+    // Faces that are not triangles are skipped; degenerate triangles count by area only.
+    template<typename T>
+    struct TriangleQualityReport {
+        std::size_t triangles = 0;
+        std::size_t degenerate_triangles = 0;
+        QualityHistogram<T> areas;
+        QualityHistogram<T> aspect_ratios;
+        QualityHistogram<T> angles;
+    };
+
+    template<typename T>
+    TriangleQualityReport<T> triangle_quality_report(const core::Mesh<T>& mesh);
+
+    template<typename T>
+    TriangleQualityReport<T> triangle_quality_report(const core::Mesh<T>& mesh, const QualityConfig& config);
+
     // Topology analysis
     template<typename T>
     std::size_t compute_genus(const core::Mesh<T>& mesh);
 
+    // What joins two faces into the same connected component
+    enum class ComponentAdjacency {
+        VERTEX,   // any shared vertex
+        EDGE      // a shared edge; faces touching only at a vertex stay apart
+    };
+
+    // Component label of every face, with components numbered in order of their first
+    // face, and the face count and bounding box of each component
+    template<typename T>
+    struct ConnectedComponents {
+        std::vector<std::uint32_t> face_labels;
+        std::vector<std::size_t> face_counts;
+        std::vector<core::BoundingBox<T>> bounding_boxes;
+
+        std::size_t size() const { return face_counts.size(); }
+    };
+
+    template<typename T>
+    ConnectedComponents<T> connected_components(const core::Mesh<T>& mesh,
+                                                ComponentAdjacency adjacency = ComponentAdjacency::VERTEX);
+
+    // Element counts of one connected component, or of the whole mesh, and what follows
+    // from them. Vertices count only when used by a face. The genus is
+    // (2 - boundary_loops - euler_characteristic) / 2, exact for orientable manifolds.
+    struct SurfaceTopology {
+        std::size_t vertices = 0;
+        std::size_t edges = 0;
+        std::size_t faces = 0;
+        std::size_t boundary_loops = 0;
+        std::int64_t euler_characteristic = 0;   // V - E + F
+        std::int64_t genus = 0;
+    };
+
+    struct TopologyReport {
+        std::vector<SurfaceTopology> components;   // numbered as by connected_components
+        SurfaceTopology total;                     // sums over the components
+    };
+
+    template<typename T>
+    TopologyReport analyze_topology(const core::Mesh<T>& mesh);
+
     template<typename T>
     T compute_surface_area(const core::Mesh<T>& mesh);
 
@@ -182,18 +360,9 @@ namespace spatial {
     math::Vector3<T> closest_point_on_mesh(const math::Vector3<T>& point, 
                                            const core::Mesh<T>& mesh);
 
-    // Spatial partitioning structures
-    template<typename T>
-    class BVH {
-    public:
-        explicit BVH(const core::Mesh<T>& mesh);
-        RayHit<T> ray_intersection(const math::Vector3<T>& ray_origin,
-                                   const math::Vector3<T>& ray_direction) const;
-    private:
-        struct Node;
-        std::vector<Node> nodes_;
-        const core::Mesh<T>* mesh_;
-    };
+    // Spatial partitioning structures (bvh.hpp)
+    template<typename T>
+    class BVH;
 
 } // namespace spatial
 
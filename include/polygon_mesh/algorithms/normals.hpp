@@ -0,0 +1,25 @@
+#pragma once
+
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/normalize.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Normal computation. Both run the batched SIMD normalize (math/normalize.hpp) over
+// the whole mesh instead of normalizing one vector at a time.
+
+template<typename T>
+void compute_face_normals(core::Mesh<T>& mesh) {
+    mesh.compute_face_normals();
+}
+
+template<typename T>
+void compute_vertex_normals(core::Mesh<T>& mesh) {
+    mesh.compute_vertex_normals();
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/face_sides.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/algorithms/union_find.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Face orientation. make_normals_consistent pairs the faces on each manifold edge in
+// one bucketed pass over the face sides, joins the pairs in a concurrent union-find,
+// and then walks every component breadth-first on its own thread, flipping faces to
+// agree with their already visited neighbors. Faces are only paired across edges used
+// by exactly two faces, so non-manifold edges separate components.
+
+// Minimum faces (or corners) per thread
+constexpr std::size_t ORIENTATION_MIN_CHUNK = 16384;
+
+namespace detail {
+
+// Mate of a face side that has none: a boundary, non-manifold or degenerate side
+constexpr std::uint32_t ORIENTATION_NO_MATE = std::numeric_limits<std::uint32_t>::max();
+
+// Six times the signed volume of the cone from origin over the fan of the face
+template<typename T>
+double face_signed_volume(const core::Vertex<T>* vertices, const core::VertexId* ids, std::size_t size,
+                          const math::Vector3<T>& origin) {
+    double volume = 0.0;
+    const math::Vector3<T> p0 = vertices[ids[0]].position - origin;
+    for (std::size_t i = 1; i + 1 < size; ++i) {
+        const math::Vector3<T> p1 = vertices[ids[i]].position - origin;
+        const math::Vector3<T> p2 = vertices[ids[i + 1]].position - origin;
+        volume += double(p0.dot(p1.cross(p2)));
+    }
+    return volume;
+}
+
+} // namespace detail
+
+// Reverses the winding of every face (the first vertex stays first) and negates the
+// face and vertex normals
+template<typename T>
+void flip_normals(core::Mesh<T>& mesh) {
+    mesh.update_faces([](core::Face<T>* faces, std::size_t count) {
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                auto& ids = faces[f].vertices;
+                if (ids.size() > 2) std::reverse(ids.begin() + 1, ids.end());
+                faces[f].normal = -faces[f].normal;
+            }
+        }, ORIENTATION_MIN_CHUNK);
+    });
+    mesh.update_vertices([](core::Vertex<T>* vertices, std::size_t count) {
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                vertices[v].normal = -vertices[v].normal;
+            }
+        }, ORIENTATION_MIN_CHUNK);
+    });
+}
+
+// Gives every connected component a consistent winding. Closed components (no
+// boundary or non-manifold edges) are turned to face outward, by the sign of their
+// enclosed volume; open ones keep whichever orientation more of their faces already
+// had. Flipped faces are reversed as by flip_normals and their face normals negated;
+// vertex normals are left alone. Non-orientable parts are walked all the same, and the
+// edges left with mismatched windings are counted.
+template<typename T>
+OrientationStats make_normals_consistent(core::Mesh<T>& mesh) {
+    OrientationStats stats;
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    const std::size_t vertex_count = mesh.vertex_count();
+    if (face_count == 0) return stats;
+
+    // Corners of all faces in one array; face f owns first_corner[f] .. first_corner[f + 1]
+    std::vector<std::uint32_t> first_corner(face_count + 1, 0);
+    std::size_t corner_total = 0;
+    bool triangles = true;
+    for (std::size_t f = 0; f < face_count; ++f) {
+        const std::size_t size = faces[f].vertices.size();
+        triangles = triangles && size == 3;
+        corner_total += size;
+        if (corner_total >= detail::ORIENTATION_NO_MATE || f >= detail::ORIENTATION_NO_MATE / 2) {
+            throw std::out_of_range("make_normals_consistent: mesh exceeds 32-bit corner indices");
+        }
+        first_corner[f + 1] = static_cast<std::uint32_t>(corner_total);
+    }
+
+    std::vector<core::VertexId> corners(corner_total);
+    std::vector<std::uint32_t> corner_faces(triangles ? 0 : corner_total);
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            std::copy(faces[f].vertices.begin(), faces[f].vertices.end(), corners.begin() + first_corner[f]);
+            if (!triangles) {
+                std::fill(corner_faces.begin() + first_corner[f], corner_faces.begin() + first_corner[f + 1],
+                          static_cast<std::uint32_t>(f));
+            }
+        }
+    }, ORIENTATION_MIN_CHUNK);
+    auto face_of = [&](std::uint32_t corner) { return triangles ? corner / 3 : corner_faces[corner]; };
+    auto side_end = [&](std::uint32_t corner) {
+        const std::uint32_t f = face_of(corner);
+        return corners[corner + 1 == first_corner[f + 1] ? first_corner[f] : corner + 1];
+    };
+
+    // Bucket every side by its lower vertex as (higher vertex << 32 | corner)
+    auto buckets = algorithms::detail::bucket_sides<std::uint64_t>(vertex_count, corner_total, [&](std::size_t c, auto&& emit) {
+        const core::VertexId a = corners[c];
+        const core::VertexId b = side_end(static_cast<std::uint32_t>(c));
+        if (a != b) emit(std::min(a, b), (std::uint64_t(std::max(a, b)) << 32) | c);
+    }, ORIENTATION_MIN_CHUNK);
+    const auto& bucket_offsets = buckets.offsets;
+    auto& sides = buckets.entries;
+
+    // Pair the two sides of each manifold edge. mates[c] is (g << 1 | same) for the face
+    // g across the side starting at corner c, with same set when both faces run the
+    // edge the same way, so exactly one of them has to flip.
+    std::vector<std::uint32_t> mates(corner_total, detail::ORIENTATION_NO_MATE);
+    ConcurrentUnionFind components(face_count);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const auto first = sides.begin() + bucket_offsets[v];
+            const auto last = sides.begin() + bucket_offsets[v + 1];
+            std::sort(first, last);
+            for (auto it = first; it != last;) {
+                auto run = it + 1;
+                while (run != last && (*run >> 32) == (*it >> 32)) ++run;
+                if (run - it == 2) {
+                    const auto c1 = static_cast<std::uint32_t>(it[0]);
+                    const auto c2 = static_cast<std::uint32_t>(it[1]);
+                    const std::uint32_t f1 = face_of(c1);
+                    const std::uint32_t f2 = face_of(c2);
+                    if (f1 != f2) {
+                        const std::uint32_t same = corners[c1] == corners[c2] ? 1 : 0;
+                        mates[c1] = (f2 << 1) | same;
+                        mates[c2] = (f1 << 1) | same;
+                        components.unite(f1, f2);
+                    }
+                }
+                it = run;
+            }
+        }
+    }, ORIENTATION_MIN_CHUNK);
+    std::vector<std::uint64_t>().swap(sides);
+
+    // Every component is rooted at its smallest face
+    std::vector<std::uint32_t> roots(face_count);
+    auto is_root = [&](std::size_t f) { return components.find(static_cast<std::uint32_t>(f)) == f; };
+    roots.resize(utils::parallel_compact(face_count, is_root, [&](std::size_t f, std::size_t position) {
+        roots[position] = static_cast<std::uint32_t>(f);
+    }, ORIENTATION_MIN_CHUNK));
+
+    // Breadth-first walk of each component, handed out to threads one component at a
+    // time. flipped[f] is 0 while f is unvisited, then 1 to keep or 2 to flip.
+    enum : std::uint8_t { UNVISITED, KEEP, FLIP };
+    std::vector<std::uint8_t> flipped(face_count, UNVISITED);
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    const std::size_t threads = std::min(utils::parallel_chunk_count(face_count, ORIENTATION_MIN_CHUNK), roots.size());
+    std::vector<OrientationStats> partials(threads);
+    std::atomic<std::size_t> next_root(0);
+
+    utils::parallel_team(threads, [&](std::size_t thread) {
+        OrientationStats& partial = partials[thread];
+        std::vector<std::uint32_t> order;
+        for (std::size_t i = next_root.fetch_add(1); i < roots.size(); i = next_root.fetch_add(1)) {
+            const std::uint32_t root = roots[i];
+            const math::Vector3<T> origin = first_corner[root + 1] > first_corner[root]
+                                                ? vertices[corners[first_corner[root]]].position
+                                                : math::Vector3<T>(0);
+            bool closed = true;
+            double volume = 0.0;
+            std::size_t flips = 0;
+            std::size_t conflicts = 0;
+
+            order.assign(1, root);
+            flipped[root] = KEEP;
+            for (std::size_t head = 0; head < order.size(); ++head) {
+                const std::uint32_t f = order[head];
+                const bool flip = flipped[f] == FLIP;
+                const std::uint32_t first = first_corner[f];
+                const std::uint32_t size = first_corner[f + 1] - first;
+                const double cone = detail::face_signed_volume(vertices, corners.data() + first, size, origin);
+                volume += flip ? -cone : cone;
+                flips += flip ? 1 : 0;
+
+                for (std::uint32_t c = first; c < first + size; ++c) {
+                    const std::uint32_t mate = mates[c];
+                    if (mate == detail::ORIENTATION_NO_MATE) {
+                        closed = false;
+                        continue;
+                    }
+                    const std::uint32_t g = mate >> 1;
+                    const bool flip_g = flip != ((mate & 1) != 0);
+                    if (flipped[g] == UNVISITED) {
+                        flipped[g] = flip_g ? FLIP : KEEP;
+                        order.push_back(g);
+                    } else if ((flipped[g] == FLIP) != flip_g) {
+                        ++conflicts;
+                    }
+                }
+            }
+
+            // Settle the component's orientation as a whole
+            const bool invert = closed ? volume < 0.0 : flips * 2 > order.size();
+            for (std::uint32_t f : order) {
+                flipped[f] = (flipped[f] == FLIP) != invert ? FLIP : KEEP;
+            }
+            partial.components += 1;
+            partial.closed_components += closed ? 1 : 0;
+            partial.flipped_faces += invert ? order.size() - flips : flips;
+            partial.inconsistent_edges += conflicts / 2;
+        }
+    });
+
+    for (const auto& partial : partials) {
+        stats.components += partial.components;
+        stats.closed_components += partial.closed_components;
+        stats.flipped_faces += partial.flipped_faces;
+        stats.inconsistent_edges += partial.inconsistent_edges;
+    }
+    if (stats.flipped_faces == 0) return stats;
+
+    mesh.update_faces([&](core::Face<T>* mesh_faces, std::size_t count) {
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                auto& ids = mesh_faces[f].vertices;
+                if (flipped[f] != FLIP || ids.size() < 3) continue;
+                std::reverse(ids.begin() + 1, ids.end());
+                mesh_faces[f].normal = -mesh_faces[f].normal;
+            }
+        }, ORIENTATION_MIN_CHUNK);
+    });
+    return stats;
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace analysis {
+
+// Triangle quality. Runs of triangles are measured eight at a time in SIMD packets;
+// polygons and the tail of a chunk take the scalar path. The aspect ratio is
+// longest edge / (2 sqrt(3) inradius), which is 1 for an equilateral triangle and
+// infinite for a degenerate one. Angles are in radians. Faces that are not triangles
+// get their fan-triangulated area, and zero aspect ratio and angles.
+
+// Faces per SIMD batch
+constexpr std::size_t QUALITY_BATCH_SIZE = 8;
+
+// Minimum faces per thread
+constexpr std::size_t QUALITY_MIN_CHUNK = 16384;
+
+namespace detail {
+
+// Which metrics a pass needs; the others are not computed
+enum QualityMetrics : unsigned {
+    QUALITY_AREA = 1,
+    QUALITY_ASPECT_RATIO = 2,
+    QUALITY_ANGLES = 4
+};
+
+// Measurements of one face. Angles are kept as cosines until someone needs radians.
+template<typename T>
+struct FaceQuality {
+    bool triangle;
+    T area;
+    T aspect_ratio;
+    T cosines[3];   // at vertices 0, 1, 2
+};
+
+template<typename T>
+T quality_aspect_ratio(T longest, T perimeter, T twice_area) {
+    return twice_area > T(0) ? longest * perimeter / (T(2) * std::sqrt(T(3)) * twice_area)
+                             : std::numeric_limits<T>::infinity();
+}
+
+template<typename T>
+T quality_cosine(T dot, T lengths) {
+    return lengths > T(0) ? std::min(std::max(dot / lengths, T(-1)), T(1)) : T(1);
+}
+
+template<typename T>
+FaceQuality<T> measure_face(const core::Face<T>& face, const core::Vertex<T>* vertices) {
+    FaceQuality<T> quality{face.vertices.size() == 3, T(0), T(0), {T(1), T(1), T(1)}};
+    const auto& ids = face.vertices;
+    if (ids.size() < 3) return quality;
+    if (!quality.triangle) {
+        const math::Vector3<T>& origin = vertices[ids[0]].position;
+        for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+            quality.area += (vertices[ids[i]].position - origin).cross(vertices[ids[i + 1]].position - origin).length();
+        }
+        quality.area *= T(0.5);
+        return quality;
+    }
+
+    const math::Vector3<T>& a = vertices[ids[0]].position;
+    const math::Vector3<T>& b = vertices[ids[1]].position;
+    const math::Vector3<T>& c = vertices[ids[2]].position;
+    const math::Vector3<T> ab = b - a, bc = c - b, ca = a - c;
+    const T twice_area = ab.cross(ca).length();
+    const T l_ab = ab.length(), l_bc = bc.length(), l_ca = ca.length();
+    quality.area = T(0.5) * twice_area;
+    quality.aspect_ratio = quality_aspect_ratio(std::max(std::max(l_ab, l_bc), l_ca), l_ab + l_bc + l_ca, twice_area);
+    quality.cosines[0] = quality_cosine(-ab.dot(ca), l_ab * l_ca);
+    quality.cosines[1] = quality_cosine(-ab.dot(bc), l_ab * l_bc);
+    quality.cosines[2] = quality_cosine(-bc.dot(ca), l_bc * l_ca);
+    return quality;
+}
+
+// Calls visit(f, quality) for faces [begin, end) in order, filling in the requested
+// metrics. Full batches of triangles are measured together.
+template<unsigned Metrics, typename T, typename Visit>
+void measure_faces(const core::Face<T>* faces, const core::Vertex<T>* vertices, std::size_t begin,
+                   std::size_t end, Visit&& visit) {
+    constexpr std::size_t B = QUALITY_BATCH_SIZE;
+    using Vec = math::Vector3xN<T, B>;
+    using P = math::Packet<T, B>;
+
+    std::size_t base = begin;
+    for (; base + B <= end; base += B) {
+        bool triangles = true;
+        for (std::size_t l = 0; l < B; ++l) {
+            triangles &= faces[base + l].vertices.size() == 3;
+        }
+        if (!triangles) {
+            for (std::size_t l = 0; l < B; ++l) {
+                visit(base + l, measure_face(faces[base + l], vertices));
+            }
+            continue;
+        }
+
+        auto corner = [&](std::size_t k) {
+            return Vec::generate([&](std::size_t l) -> const math::Vector3<T>& {
+                return vertices[faces[base + l].vertices[k]].position;
+            });
+        };
+        const Vec a = corner(0);
+        const Vec b = corner(1);
+        const Vec c = corner(2);
+        const Vec ab = b - a, bc = c - b, ca = a - c;
+        const P twice_area = ab.cross(ca).length();
+
+        alignas(sizeof(T) * B) T area[B] = {};
+        alignas(sizeof(T) * B) T aspect[B] = {};
+        alignas(sizeof(T) * B) T cosines[3][B] = {};
+        if constexpr ((Metrics & QUALITY_AREA) != 0) {
+            (twice_area * P(T(0.5))).store(area);
+        }
+        if constexpr ((Metrics & (QUALITY_ASPECT_RATIO | QUALITY_ANGLES)) != 0) {
+            const P l_ab = ab.length(), l_bc = bc.length(), l_ca = ca.length();
+            const P zero = P::zero();
+            const P one(T(1));
+            if constexpr ((Metrics & QUALITY_ASPECT_RATIO) != 0) {
+                const P longest = max(max(l_ab, l_bc), l_ca);
+                const P ratio = longest * (l_ab + l_bc + l_ca) / (P(T(2) * std::sqrt(T(3))) * twice_area);
+                select(twice_area > zero, ratio, P(std::numeric_limits<T>::infinity())).store(aspect);
+            }
+            if constexpr ((Metrics & QUALITY_ANGLES) != 0) {
+                auto cosine = [&](const P& dot, const P& lengths) {
+                    return select(lengths > zero, min(max(dot / lengths, -one), one), one);
+                };
+                cosine(-ab.dot(ca), l_ab * l_ca).store(cosines[0]);
+                cosine(-ab.dot(bc), l_ab * l_bc).store(cosines[1]);
+                cosine(-bc.dot(ca), l_bc * l_ca).store(cosines[2]);
+            }
+        }
+
+        for (std::size_t l = 0; l < B; ++l) {
+            visit(base + l, FaceQuality<T>{true, area[l], aspect[l], {cosines[0][l], cosines[1][l], cosines[2][l]}});
+        }
+    }
+    for (; base < end; ++base) {
+        visit(base, measure_face(faces[base], vertices));
+    }
+}
+
+template<unsigned Metrics, typename T, typename Visit>
+void measure_mesh(const core::Mesh<T>& mesh, Visit&& visit) {
+    const core::Face<T>* faces = mesh.faces().data();
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    utils::parallel_for_range(0, mesh.face_count(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        measure_faces<Metrics>(faces, vertices, begin, end, [&](std::size_t f, const FaceQuality<T>& quality) {
+            visit(chunk, f, quality);
+        });
+    }, QUALITY_MIN_CHUNK);
+}
+
+inline void check_quality_output(std::size_t size, std::size_t expected) {
+    if (size != expected) {
+        throw std::invalid_argument("triangle quality: output size does not match the face count");
+    }
+}
+
+// Histogram of one chunk
+template<typename T>
+struct HistogramPartial {
+    std::vector<std::size_t> bins;
+    std::size_t count = 0;
+    T minimum = std::numeric_limits<T>::max();
+    T maximum = std::numeric_limits<T>::lowest();
+    double sum = 0.0;
+
+    void add(T value, T lower, T scale) {
+        const T position = (value - lower) * scale;
+        const std::size_t last = bins.size() - 1;
+        const std::size_t bin = !(position > T(0)) ? 0 : position < T(last) ? static_cast<std::size_t>(position) : last;
+        ++bins[bin];
+        ++count;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+        sum += double(value);
+    }
+};
+
+template<typename T>
+void merge_histograms(const std::vector<HistogramPartial<T>>& partials, QualityHistogram<T>& histogram) {
+    histogram.bins.assign(partials.empty() ? 0 : partials.front().bins.size(), 0);
+    std::size_t count = 0;
+    double sum = 0.0;
+    T minimum = std::numeric_limits<T>::max();
+    T maximum = std::numeric_limits<T>::lowest();
+    for (const auto& partial : partials) {
+        for (std::size_t i = 0; i < partial.bins.size(); ++i) histogram.bins[i] += partial.bins[i];
+        count += partial.count;
+        sum += partial.sum;
+        minimum = std::min(minimum, partial.minimum);
+        maximum = std::max(maximum, partial.maximum);
+    }
+    histogram.minimum = count > 0 ? minimum : T(0);
+    histogram.maximum = count > 0 ? maximum : T(0);
+    histogram.mean = count > 0 ? static_cast<T>(sum / double(count)) : T(0);
+}
+
+} // namespace detail
+
+template<typename T>
+void compute_triangle_areas(const core::Mesh<T>& mesh, utils::Span<T> areas) {
+    detail::check_quality_output(areas.size(), mesh.face_count());
+    detail::measure_mesh<detail::QUALITY_AREA>(mesh, [&](std::size_t, std::size_t f, const detail::FaceQuality<T>& q) {
+        areas[f] = q.area;
+    });
+}
+
+template<typename T>
+void compute_aspect_ratios(const core::Mesh<T>& mesh, utils::Span<T> ratios) {
+    detail::check_quality_output(ratios.size(), mesh.face_count());
+    detail::measure_mesh<detail::QUALITY_ASPECT_RATIO>(mesh, [&](std::size_t, std::size_t f,
+                                                                 const detail::FaceQuality<T>& q) {
+        ratios[f] = q.aspect_ratio;
+    });
+}
+
+template<typename T>
+void compute_triangle_angles(const core::Mesh<T>& mesh, utils::Span<T> angles) {
+    detail::check_quality_output(angles.size(), mesh.face_count() * 3);
+    detail::measure_mesh<detail::QUALITY_ANGLES>(mesh, [&](std::size_t, std::size_t f, const detail::FaceQuality<T>& q) {
+        for (std::size_t k = 0; k < 3; ++k) angles[f * 3 + k] = std::acos(q.cosines[k]);
+    });
+}
+
+template<typename T>
+std::vector<T> compute_triangle_areas(const core::Mesh<T>& mesh) {
+    std::vector<T> areas(mesh.face_count());
+    compute_triangle_areas(mesh, utils::Span<T>(areas));
+    return areas;
+}
+
+template<typename T>
+std::vector<T> compute_aspect_ratios(const core::Mesh<T>& mesh) {
+    std::vector<T> ratios(mesh.face_count());
+    compute_aspect_ratios(mesh, utils::Span<T>(ratios));
+    return ratios;
+}
+
+template<typename T>
+std::vector<T> compute_triangle_angles(const core::Mesh<T>& mesh) {
+    std::vector<T> angles(mesh.face_count() * 3);
+    compute_triangle_angles(mesh, utils::Span<T>(angles));
+    return angles;
+}
+
+template<typename T>
+TriangleQualityReport<T> triangle_quality_report(const core::Mesh<T>& mesh, const QualityConfig& config) {
+    if (config.bins == 0) {
+        throw std::invalid_argument("triangle_quality_report: bins must be positive");
+    }
+
+    // The area range needs the largest area first unless the caller fixed it
+    T max_area = static_cast<T>(config.max_area);
+    if (!(max_area > T(0))) {
+        std::vector<T> largest(utils::parallel_chunk_count(mesh.face_count(), QUALITY_MIN_CHUNK), T(0));
+        detail::measure_mesh<detail::QUALITY_AREA>(mesh, [&](std::size_t chunk, std::size_t,
+                                                             const detail::FaceQuality<T>& q) {
+            if (q.triangle) largest[chunk] = std::max(largest[chunk], q.area);
+        });
+        max_area = largest.empty() ? T(0) : *std::max_element(largest.begin(), largest.end());
+    }
+
+    TriangleQualityReport<T> report;
+    report.areas.lower = T(0);
+    report.areas.upper = max_area;
+    report.aspect_ratios.lower = T(1);
+    report.aspect_ratios.upper = std::max(static_cast<T>(config.max_aspect_ratio), T(1));
+    report.angles.lower = T(0);
+    report.angles.upper = math::pi<T>();
+
+    auto scale = [&](const QualityHistogram<T>& h) {
+        return h.upper > h.lower ? T(config.bins) / (h.upper - h.lower) : T(0);
+    };
+    const T area_scale = scale(report.areas);
+    const T aspect_scale = scale(report.aspect_ratios);
+    const T angle_scale = scale(report.angles);
+
+    const std::size_t chunks = utils::parallel_chunk_count(mesh.face_count(), QUALITY_MIN_CHUNK);
+    std::vector<detail::HistogramPartial<T>> areas(chunks), aspects(chunks), angles(chunks);
+    std::vector<std::size_t> degenerate(chunks, 0);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        areas[c].bins.assign(config.bins, 0);
+        aspects[c].bins.assign(config.bins, 0);
+        angles[c].bins.assign(config.bins, 0);
+    }
+
+    constexpr unsigned all = detail::QUALITY_AREA | detail::QUALITY_ASPECT_RATIO | detail::QUALITY_ANGLES;
+    detail::measure_mesh<all>(mesh, [&](std::size_t chunk, std::size_t, const detail::FaceQuality<T>& q) {
+        if (!q.triangle) return;
+        areas[chunk].add(q.area, T(0), area_scale);
+        if (std::isinf(q.aspect_ratio)) {
+            ++degenerate[chunk];
+            return;
+        }
+        aspects[chunk].add(q.aspect_ratio, T(1), aspect_scale);
+        for (std::size_t k = 0; k < 3; ++k) angles[chunk].add(std::acos(q.cosines[k]), T(0), angle_scale);
+    });
+
+    detail::merge_histograms(areas, report.areas);
+    detail::merge_histograms(aspects, report.aspect_ratios);
+    detail::merge_histograms(angles, report.angles);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        report.triangles += areas[c].count;
+        report.degenerate_triangles += degenerate[c];
+    }
+    if (chunks == 0) {
+        report.areas.bins.assign(config.bins, 0);
+        report.aspect_ratios.bins.assign(config.bins, 0);
+        report.angles.bins.assign(config.bins, 0);
+    }
+    return report;
+}
+
+template<typename T>
+TriangleQualityReport<T> triangle_quality_report(const core::Mesh<T>& mesh) {
+    return triangle_quality_report(mesh, QualityConfig());
+}
+
+} // namespace analysis
+} // namespace algorithms
+} // namespace polygon_mesh
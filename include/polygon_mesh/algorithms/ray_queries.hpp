@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <polygon_mesh/algorithms/bvh.hpp>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace spatial {
+
+// Batched ray queries against a BVH. Rays are traced in packets of 8 or 16 that walk
+// the tree together: each node's box is tested against every ray of the packet at
+// once, a subtree is entered if any ray enters it, and leaves run Möller-Trumbore on
+// all rays against one triangle at a time. The rays of a packet carry a lane mask
+// for the boxes they actually entered, so a ray that has left a subtree stops
+// accepting hits in it. Packets only pay off when their rays take similar paths; in
+// the incoherent order the stream is first sorted on direction octant, origin and
+// direction, so neighbouring rays in the sorted stream form the packets. Packets are
+// independent and spread across threads. Occlusion queries retire a ray at its first
+// hit and a packet once all its rays are retired.
+
+// Minimum rays per thread
+constexpr std::size_t RAY_MIN_CHUNK = 1024;
+
+// Hits are accepted along origin + t * direction for t in (0, t_max)
+template<typename T>
+struct Ray {
+    math::Vector3<T> origin;
+    math::Vector3<T> direction;
+    T t_max = std::numeric_limits<T>::infinity();
+};
+
+namespace detail {
+
+// Up to K rays of a stream in SIMD layout; lanes past count repeat the first ray and
+// start inactive
+template<typename T, std::size_t K>
+struct RayPacket {
+    using P = math::Packet<T, K>;
+    using M = typename P::mask_type;
+    using V = math::Vector3xN<T, K>;
+
+    V origin;
+    V direction;
+    V inverse_direction;
+    P t_max;
+    M active;
+
+    RayPacket(const Ray<T>* rays, const std::uint32_t* order, std::size_t first, std::size_t count) {
+        auto ray = [&](std::size_t lane) -> const Ray<T>& {
+            const std::size_t i = first + (lane < count ? lane : 0);
+            return rays[order ? order[i] : i];
+        };
+        origin = V::generate([&](std::size_t lane) -> const math::Vector3<T>& { return ray(lane).origin; });
+        direction = V::generate([&](std::size_t lane) -> const math::Vector3<T>& { return ray(lane).direction; });
+        inverse_direction = V(P(T(1)) / direction.x, P(T(1)) / direction.y, P(T(1)) / direction.z);
+        t_max = P::generate([&](std::size_t lane) { return ray(lane).t_max; });
+        active = P::iota() < P(T(count));
+    }
+};
+
+// intersect_node for every ray of a packet, with the same operations per lane
+template<typename T, std::size_t K, typename Node>
+typename math::Packet<T, K>::mask_type intersect_node_packet(const Node& node, const RayPacket<T, K>& rays,
+                                                             const math::Packet<T, K>& t_max,
+                                                             math::Packet<T, K>& t_entry) {
+    using P = math::Packet<T, K>;
+    P t_near = P::zero();
+    P t_far = t_max;
+    auto slab = [&](T low, T high, const P& start, const P& inverse) {
+        const P t0 = (P(low) - start) * inverse;
+        const P t1 = (P(high) - start) * inverse;
+        const auto swap = t0 > t1;
+        const P first = select(swap, t1, t0);
+        const P second = select(swap, t0, t1);
+        t_near = select(first > t_near, first, t_near);
+        t_far = select(second < t_far, second, t_far);
+    };
+    slab(node.min_point.x, node.max_point.x, rays.origin.x, rays.inverse_direction.x);
+    slab(node.min_point.y, node.max_point.y, rays.origin.y, rays.inverse_direction.y);
+    slab(node.min_point.z, node.max_point.z, rays.origin.z, rays.inverse_direction.z);
+    t_entry = t_near;
+    return t_near <= t_far * P(T(1) + T(4) * std::numeric_limits<T>::epsilon());
+}
+
+// Dot product in the order of Vector3::dot, so packet and single-ray tests round alike
+// on the shared edges of a mesh
+template<typename T, std::size_t K>
+math::Packet<T, K> dot_in_order(const math::Vector3xN<T, K>& a, const math::Vector3xN<T, K>& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// intersect_triangle for every ray of a packet against one triangle
+template<typename T, std::size_t K>
+typename math::Packet<T, K>::mask_type intersect_triangle_packet(const RayPacket<T, K>& rays,
+                                                                 const typename BVH<T>::Triangle& triangle,
+                                                                 const math::Packet<T, K>& t_max,
+                                                                 math::Packet<T, K>& t, math::Packet<T, K>& u,
+                                                                 math::Packet<T, K>& v) {
+    using P = math::Packet<T, K>;
+    using V = math::Vector3xN<T, K>;
+    const V edge1(triangle.edge1);
+    const V edge2(triangle.edge2);
+    const V p = rays.direction.cross(edge2);
+    const P det = dot_in_order(edge1, p);
+    const P inv_det = P(T(1)) / det;
+    const V s = rays.origin - V(triangle.vertex);
+    u = dot_in_order(s, p) * inv_det;
+    const V q = s.cross(edge1);
+    v = dot_in_order(rays.direction, q) * inv_det;
+    t = dot_in_order(edge2, q) * inv_det;
+    return (abs(det) > P(std::numeric_limits<T>::min())) & (u >= P::zero()) & (u <= P(T(1))) &
+           (v >= P::zero()) & (u + v <= P(T(1))) & (t > P::zero()) & (t < t_max);
+}
+
+// Closest hits of a packet: hit distance and barycentrics per lane, and the triangle
+// in leaf order, or the triangle count for a miss
+template<typename T, std::size_t K>
+struct PacketHits {
+    math::Packet<T, K> t;
+    math::Packet<T, K> u;
+    math::Packet<T, K> v;
+    std::uint32_t triangle[K];
+};
+
+// Traces a packet through the binary tree, nearer child first by the closest entry
+// of its rays. Returns the lanes that hit anything; closest hits go to hits unless
+// AnyHit is set, in which case rays retire at their first hit.
+template<bool AnyHit, typename T, std::size_t K>
+unsigned trace_packet(const BVH<T>& bvh, const RayPacket<T, K>& rays, PacketHits<T, K>& hits) {
+    using P = math::Packet<T, K>;
+    using M = typename P::mask_type;
+    using Node = typename BVH<T>::Node;
+
+    const std::uint32_t none = static_cast<std::uint32_t>(bvh.triangle_count());
+    for (std::size_t lane = 0; lane < K; ++lane) hits.triangle[lane] = none;
+    hits.t = rays.t_max;
+    hits.u = P::zero();
+    hits.v = P::zero();
+    if (bvh.empty()) return 0;
+
+    const std::vector<Node>& nodes = bvh.nodes();
+    const auto& triangles = bvh.triangles();
+    const P infinity(std::numeric_limits<T>::infinity());
+    auto nearest = [&](const M& mask, const P& entry) { return reduce_min(select(mask, entry, infinity)); };
+
+    struct Entry {
+        std::uint32_t node;
+        M mask;
+        P entry;
+    };
+    Entry stack[BVH_MAX_DEPTH];
+    std::size_t stack_size = 0;
+
+    M alive = rays.active;
+    M hit_lanes(false);
+    P t_entry;
+    M mask = intersect_node_packet(nodes[0], rays, hits.t, t_entry) & alive;
+    std::uint32_t index = 0;
+    while (mask.any()) {
+        const Node& node = nodes[index];
+        if (node.is_leaf()) {
+            for (std::size_t i = node.offset, end = node.offset + node.count; i < end; ++i) {
+                P t, u, v;
+                const M accept = intersect_triangle_packet(rays, triangles[i], hits.t, t, u, v) & mask;
+                if (accept.none()) continue;
+                hit_lanes = hit_lanes | accept;
+                if constexpr (AnyHit) {
+                    alive = alive & ~accept;
+                    mask = mask & ~accept;
+                    if (mask.none()) break;
+                    continue;
+                }
+                hits.t = select(accept, t, hits.t);
+                hits.u = select(accept, u, hits.u);
+                hits.v = select(accept, v, hits.v);
+                for (unsigned bits = accept.bits(), lane = 0; bits; bits >>= 1, ++lane) {
+                    if (bits & 1u) hits.triangle[lane] = static_cast<std::uint32_t>(i);
+                }
+            }
+            if (AnyHit && alive.none()) break;
+        } else {
+            std::uint32_t near_child = index + 1;
+            std::uint32_t far_child = node.offset;
+            P near_entry, far_entry;
+            M near_mask = intersect_node_packet(nodes[near_child], rays, hits.t, near_entry) & mask;
+            M far_mask = intersect_node_packet(nodes[far_child], rays, hits.t, far_entry) & mask;
+            const bool enter_near = near_mask.any();
+            const bool enter_far = far_mask.any();
+            if (enter_near && enter_far) {
+                if (nearest(far_mask, far_entry) < nearest(near_mask, near_entry)) {
+                    std::swap(near_child, far_child);
+                    std::swap(near_mask, far_mask);
+                    std::swap(near_entry, far_entry);
+                }
+                stack[stack_size++] = Entry{far_child, far_mask, far_entry};
+                index = near_child;
+                mask = near_mask;
+                continue;
+            }
+            if (enter_near || enter_far) {
+                index = enter_near ? near_child : far_child;
+                mask = enter_near ? near_mask : far_mask;
+                continue;
+            }
+        }
+
+        // Rays whose closest hit so far lies before a stacked box skip it
+        mask = M(false);
+        while (stack_size > 0 && mask.none()) {
+            const Entry& entry = stack[--stack_size];
+            index = entry.node;
+            mask = entry.mask & alive & (entry.entry <= hits.t);
+        }
+    }
+    return hit_lanes.bits();
+}
+
+struct RayKey {
+    std::uint64_t key;
+    std::uint32_t ray;
+};
+
+// Ray order for the incoherent stream: direction octant, then the Morton code of the
+// origin within the tree's bounds, then that of the direction
+template<typename T>
+std::vector<std::uint32_t> sort_rays(const BVH<T>& bvh, utils::Span<const Ray<T>> rays) {
+    const std::size_t n = rays.size();
+    math::Vector3<T> low(0), extent(0);
+    if (!bvh.empty()) {
+        low = bvh.nodes()[0].min_point;
+        extent = bvh.nodes()[0].max_point - low;
+    }
+    constexpr std::size_t bucket_count = std::size_t(1) << 12;
+
+    std::vector<RayKey> keys(n);
+    std::unique_ptr<std::atomic<std::uint32_t>[]> bucket_sizes(new std::atomic<std::uint32_t>[bucket_count + 1]());
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        auto coordinate = [](T x, T min_x, T size) {
+            const T scaled = size > T(0) ? (x - min_x) / size * T(1024) : T(0);
+            return static_cast<std::uint32_t>(scaled > T(0) ? std::min(scaled, T(1023)) : T(0));
+        };
+        for (std::size_t i = begin; i < end; ++i) {
+            const math::Vector3<T>& o = rays[i].origin;
+            const math::Vector3<T> d = rays[i].direction.normalize();
+            const std::uint64_t octant = (d.x < T(0) ? 1u : 0u) | (d.y < T(0) ? 2u : 0u) | (d.z < T(0) ? 4u : 0u);
+            const std::uint64_t origin = math::morton_encode(coordinate(o.x, low.x, extent.x),
+                                                             coordinate(o.y, low.y, extent.y),
+                                                             coordinate(o.z, low.z, extent.z));
+            const std::uint64_t direction = math::morton_encode(coordinate(d.x, T(-1), T(2)),
+                                                                coordinate(d.y, T(-1), T(2)),
+                                                                coordinate(d.z, T(-1), T(2)));
+            keys[i] = RayKey{octant << 61 | origin << 31 | direction << 1, static_cast<std::uint32_t>(i)};
+            bucket_sizes[(keys[i].key >> 52) + 1].fetch_add(1, std::memory_order_relaxed);
+        }
+    }, RAY_MIN_CHUNK);
+
+    std::vector<std::size_t> bucket_offsets(bucket_count + 1, 0);
+    for (std::size_t b = 0; b < bucket_count; ++b) {
+        bucket_offsets[b + 1] = bucket_offsets[b] + bucket_sizes[b + 1].load(std::memory_order_relaxed);
+        bucket_sizes[b + 1].store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<RayKey> sorted(n);
+    utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::size_t bucket = keys[i].key >> 52;
+            sorted[bucket_offsets[bucket] + bucket_sizes[bucket + 1].fetch_add(1, std::memory_order_relaxed)] = keys[i];
+        }
+    }, RAY_MIN_CHUNK);
+
+    std::vector<std::uint32_t> order(n);
+    utils::parallel_for_range(0, bucket_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t b = begin; b < end; ++b) {
+            std::sort(sorted.begin() + bucket_offsets[b], sorted.begin() + bucket_offsets[b + 1],
+                      [](const RayKey& a, const RayKey& c) { return a.key != c.key ? a.key < c.key : a.ray < c.ray; });
+            for (std::size_t i = bucket_offsets[b]; i < bucket_offsets[b + 1]; ++i) order[i] = sorted[i].ray;
+        }
+    }, 64);
+    return order;
+}
+
+// Traces the stream packet by packet; closest hits go to hits, occlusion to occluded
+template<bool AnyHit, std::size_t K, typename T>
+void trace_stream(const BVH<T>& bvh, utils::Span<const Ray<T>> rays, const std::uint32_t* order,
+                  RayHit<T>* hits, std::uint8_t* occluded) {
+    const std::size_t packet_count = (rays.size() + K - 1) / K;
+    utils::parallel_for_range(0, packet_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        alignas(sizeof(T) * K) T ts[K], us[K], vs[K];
+        for (std::size_t packet = begin; packet < end; ++packet) {
+            const std::size_t first = packet * K;
+            const std::size_t count = std::min(K, rays.size() - first);
+            const RayPacket<T, K> rays_packet(rays.data(), order, first, count);
+            PacketHits<T, K> packet_hits;
+            const unsigned hit_lanes = trace_packet<AnyHit>(bvh, rays_packet, packet_hits);
+
+            if constexpr (AnyHit) {
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    occluded[order ? order[first + lane] : first + lane] = (hit_lanes >> lane) & 1u;
+                }
+                continue;
+            }
+            packet_hits.t.store_aligned(ts);
+            packet_hits.u.store_aligned(us);
+            packet_hits.v.store_aligned(vs);
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                const std::size_t i = order ? order[first + lane] : first + lane;
+                if (!((hit_lanes >> lane) & 1u)) {
+                    hits[i] = ray_miss<T>();
+                    continue;
+                }
+                const std::uint32_t triangle = packet_hits.triangle[lane];
+                const auto& corners = bvh.triangles()[triangle];
+                hits[i] = ray_hit(rays[i].origin, rays[i].direction, corners.edge1, corners.edge2, ts[lane],
+                                  us[lane], vs[lane], bvh.triangle_faces()[triangle]);
+            }
+        }
+    }, std::max<std::size_t>(1, RAY_MIN_CHUNK / K));
+}
+
+template<bool AnyHit, typename T>
+void trace_rays(const BVH<T>& bvh, utils::Span<const Ray<T>> rays, const RayQueryConfig& config,
+                RayHit<T>* hits, std::uint8_t* occluded) {
+    if (config.packet_size != 8 && config.packet_size != 16) {
+        throw std::invalid_argument("RayQueryConfig: packet_size must be 8 or 16");
+    }
+    if (rays.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::out_of_range("ray queries: stream exceeds 32-bit ray indices");
+    }
+    std::vector<std::uint32_t> order;
+    if (config.order == RayQueryConfig::INCOHERENT) order = sort_rays(bvh, rays);
+    const std::uint32_t* ordered = order.empty() ? nullptr : order.data();
+    if (config.packet_size == 8) {
+        trace_stream<AnyHit, 8>(bvh, rays, ordered, hits, occluded);
+    } else {
+        trace_stream<AnyHit, 16>(bvh, rays, ordered, hits, occluded);
+    }
+}
+
+} // namespace detail
+
+// Closest hit of every ray, as BVH::ray_intersection would report it, into the hit of
+// the same index. Throws std::invalid_argument when the spans differ in size or the
+// packet size is not 8 or 16.
+template<typename T>
+void intersect_rays(const BVH<T>& bvh, utils::Span<const Ray<T>> rays, utils::Span<RayHit<T>> hits,
+                    const RayQueryConfig& config = RayQueryConfig()) {
+    if (hits.size() != rays.size()) {
+        throw std::invalid_argument("intersect_rays: hits and rays differ in size");
+    }
+    detail::trace_rays<false, T>(bvh, rays, config, hits.data(), nullptr);
+}
+
+// occluded[i] is 1 when ray i hits anything in (0, t_max), else 0. Each ray stops at
+// the first hit found, so this is cheaper than intersect_rays for visibility.
+template<typename T>
+void occluded_rays(const BVH<T>& bvh, utils::Span<const Ray<T>> rays, utils::Span<std::uint8_t> occluded,
+                   const RayQueryConfig& config = RayQueryConfig()) {
+    if (occluded.size() != rays.size()) {
+        throw std::invalid_argument("occluded_rays: occluded and rays differ in size");
+    }
+    detail::trace_rays<true, T>(bvh, rays, config, nullptr, occluded.data());
+}
+
+} // namespace spatial
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Mesh repair. Faces are classified in parallel, then the survivors are compacted into
+// fresh arrays with a parallel prefix sum and swapped into the mesh in one step.
+
+// Faces per SIMD area batch
+constexpr std::size_t REPAIR_BATCH_SIZE = 8;
+
+// Minimum faces (or vertices) per thread
+constexpr std::size_t REPAIR_MIN_CHUNK = 16384;
+
+namespace detail {
+
+enum class FaceDefect : std::uint8_t {
+    NONE,
+    NON_FINITE,
+    REPEATED_INDEX,
+    ZERO_AREA
+};
+
+template<typename T>
+bool is_finite(const math::Vector3<T>& v) {
+    return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+}
+
+// Lanes whose coordinates are all finite: x * 0 is NaN exactly for NaN and infinities
+template<typename T, std::size_t N>
+auto finite_lanes(const math::Vector3xN<T, N>& v) {
+    using P = math::Packet<T, N>;
+    const P zero = P::zero();
+    return (v.x * zero == zero) & (v.y * zero == zero) & (v.z * zero == zero);
+}
+
+template<typename T>
+bool has_repeated_index(const core::Face<T>& face) {
+    const auto& ids = face.vertices;
+    if (ids.size() == 3) {
+        return ids[0] == ids[1] || ids[1] == ids[2] || ids[0] == ids[2];
+    }
+    for (std::size_t i = 1; i < ids.size(); ++i) {
+        if (std::find(ids.begin(), ids.begin() + i, ids[i]) != ids.begin() + i) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Scalar classification, used for polygons and partial batches
+template<typename T>
+FaceDefect classify_face(const core::Face<T>& face, const core::Vertex<T>* vertices, T min_area2x4) {
+    const auto& ids = face.vertices;
+    for (auto id : ids) {
+        if (!is_finite(vertices[id].position)) return FaceDefect::NON_FINITE;
+    }
+    if (has_repeated_index(face)) return FaceDefect::REPEATED_INDEX;
+
+    // Fan sum of cross products: twice the vector area of the polygon
+    const math::Vector3<T>& origin = vertices[ids[0]].position;
+    math::Vector3<T> twice_area(0);
+    for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+        twice_area += (vertices[ids[i]].position - origin).cross(vertices[ids[i + 1]].position - origin);
+    }
+    return twice_area.length_squared() <= min_area2x4 ? FaceDefect::ZERO_AREA : FaceDefect::NONE;
+}
+
+// Classifies faces [begin, end). Runs of triangles go through the SIMD area kernel.
+template<typename T>
+void classify_faces(const core::Face<T>* faces, const core::Vertex<T>* vertices, T min_area2x4,
+                    FaceDefect* defects, std::size_t begin, std::size_t end) {
+    constexpr std::size_t B = REPAIR_BATCH_SIZE;
+    using Vec = math::Vector3xN<T, B>;
+    using P = math::Packet<T, B>;
+
+    std::size_t base = begin;
+    for (; base + B <= end; base += B) {
+        bool triangles = true;
+        for (std::size_t l = 0; l < B; ++l) {
+            triangles &= faces[base + l].vertices.size() == 3;
+        }
+        if (!triangles) {
+            for (std::size_t l = 0; l < B; ++l) {
+                defects[base + l] = classify_face(faces[base + l], vertices, min_area2x4);
+            }
+            continue;
+        }
+
+        auto corner = [&](std::size_t k) {
+            return Vec::generate([&](std::size_t l) -> const math::Vector3<T>& {
+                return vertices[faces[base + l].vertices[k]].position;
+            });
+        };
+        const Vec a = corner(0);
+        const Vec b = corner(1);
+        const Vec c = corner(2);
+
+        const unsigned finite = (finite_lanes(a) & finite_lanes(b) & finite_lanes(c)).bits();
+        const unsigned small = ((b - a).cross(c - a).length_squared() <= P(min_area2x4)).bits();
+
+        for (std::size_t l = 0; l < B; ++l) {
+            FaceDefect defect = FaceDefect::NONE;
+            if (!((finite >> l) & 1u)) {
+                defect = FaceDefect::NON_FINITE;
+            } else if (has_repeated_index(faces[base + l])) {
+                defect = FaceDefect::REPEATED_INDEX;
+            } else if ((small >> l) & 1u) {
+                defect = FaceDefect::ZERO_AREA;
+            }
+            defects[base + l] = defect;
+        }
+    }
+    for (; base < end; ++base) {
+        defects[base] = classify_face(faces[base], vertices, min_area2x4);
+    }
+}
+
+} // namespace detail
+
+// Removes faces that are non-finite, reference a vertex twice, or have an area of at
+// most min_area, without erasing from the middle of the face array. With
+// remove_unreferenced_vertices, vertices no surviving face uses are dropped as well and
+// face indices are remapped. Face and vertex order is preserved; ids are reassigned.
+template<typename T>
+DegenerateFaceStats remove_degenerate_faces(core::Mesh<T>& mesh, T min_area,
+                                            bool remove_unreferenced_vertices) {
+    DegenerateFaceStats stats;
+    const std::size_t face_count = mesh.face_count();
+    const std::size_t vertex_count = mesh.vertex_count();
+    if (face_count == 0 && !remove_unreferenced_vertices) {
+        return stats;
+    }
+
+    const core::Face<T>* faces = mesh.faces().data();
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    const T threshold = std::max(min_area, T(0));
+    const T min_area2x4 = T(4) * threshold * threshold;
+
+    // Classify, counting defects per chunk
+    std::vector<detail::FaceDefect> defects(face_count);
+    const std::size_t chunks = utils::parallel_chunk_count(face_count, REPAIR_MIN_CHUNK);
+    std::vector<std::array<std::size_t, 4>> counts(chunks, std::array<std::size_t, 4>{});
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        detail::classify_faces(faces, vertices, min_area2x4, defects.data(), begin, end);
+        for (std::size_t f = begin; f < end; ++f) {
+            ++counts[chunk][static_cast<std::size_t>(defects[f])];
+        }
+    }, REPAIR_MIN_CHUNK);
+
+    for (const auto& c : counts) {
+        stats.non_finite_faces += c[static_cast<std::size_t>(detail::FaceDefect::NON_FINITE)];
+        stats.repeated_index_faces += c[static_cast<std::size_t>(detail::FaceDefect::REPEATED_INDEX)];
+        stats.zero_area_faces += c[static_cast<std::size_t>(detail::FaceDefect::ZERO_AREA)];
+    }
+    stats.removed_faces = stats.non_finite_faces + stats.repeated_index_faces + stats.zero_area_faces;
+
+    if (stats.removed_faces == 0 && !remove_unreferenced_vertices) {
+        return stats;
+    }
+
+    // Compact the surviving faces; moving them keeps the index vectors' allocations
+    auto keep_face = [&](std::size_t f) { return defects[f] == detail::FaceDefect::NONE; };
+    std::vector<core::Face<T>> kept_faces(face_count - stats.removed_faces);
+    mesh.update_faces([&](core::Face<T>* mesh_faces, std::size_t) {
+        utils::parallel_compact(face_count, keep_face, [&](std::size_t f, std::size_t position) {
+            kept_faces[position] = std::move(mesh_faces[f]);
+        }, REPAIR_MIN_CHUNK);
+    });
+
+    if (!remove_unreferenced_vertices) {
+        mesh.assign_faces(std::move(kept_faces));
+        return stats;
+    }
+
+    // Mark referenced vertices; concurrent relaxed stores of the same value are benign
+    std::unique_ptr<std::atomic<std::uint8_t>[]> used(new std::atomic<std::uint8_t>[vertex_count]());
+    utils::parallel_for_range(0, kept_faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            for (auto id : kept_faces[f].vertices) {
+                used[id].store(1, std::memory_order_relaxed);
+            }
+        }
+    }, REPAIR_MIN_CHUNK);
+
+    // Compact vertices, recording old -> new indices
+    auto keep_vertex = [&](std::size_t v) { return used[v].load(std::memory_order_relaxed) != 0; };
+    std::vector<core::VertexId> remap(vertex_count);
+    const std::size_t kept_vertex_count = utils::parallel_compact(vertex_count, keep_vertex, [&](std::size_t v, std::size_t position) {
+        remap[v] = static_cast<core::VertexId>(position);
+    }, REPAIR_MIN_CHUNK);
+    stats.removed_vertices = vertex_count - kept_vertex_count;
+
+    if (stats.removed_vertices == 0) {
+        mesh.assign_faces(std::move(kept_faces));
+        return stats;
+    }
+
+    std::vector<core::Vertex<T>> kept_vertices(kept_vertex_count);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            if (keep_vertex(v)) kept_vertices[remap[v]] = vertices[v];
+        }
+    }, REPAIR_MIN_CHUNK);
+
+    utils::parallel_for_range(0, kept_faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            for (auto& id : kept_faces[f].vertices) {
+                id = remap[id];
+            }
+        }
+    }, REPAIR_MIN_CHUNK);
+
+    mesh.assign(std::move(kept_vertices), std::move(kept_faces));
+    return stats;
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
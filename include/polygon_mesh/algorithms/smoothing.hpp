@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/adjacency.hpp>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Iterative smoothing. Each run builds the one-ring adjacency once and does all its
+// sweeps on a single thread team; every thread owns a fixed vertex range for the whole
+// run. Laplacian smoothing ping-pongs Jacobi sweeps between two structure-of-arrays
+// position buffers; Taubin smoothing updates the mesh in place (see taubin_sweep).
+
+// Minimum vertices per thread
+constexpr std::size_t SMOOTHING_MIN_CHUNK = 16384;
+
+namespace detail {
+
+template<typename T>
+struct PositionBuffer {
+    T* x;
+    T* y;
+    T* z;
+};
+
+// Average of the neighbors of v (weighted when Weighted); read(j) yields position j.
+// v must have at least one neighbor.
+template<typename T, bool Weighted, typename Read>
+math::Vector3<T> neighbor_average(const VertexAdjacency<T>& adjacency, std::size_t v, Read&& read) {
+    const std::size_t row_begin = adjacency.offsets[v];
+    const std::size_t row_end = adjacency.offsets[v + 1];
+    const core::VertexId* neighbors = adjacency.neighbors.data();
+
+    math::Vector3<T> sum(0);
+    for (std::size_t k = row_begin; k < row_end; ++k) {
+        if (Weighted) {
+            sum += read(neighbors[k]) * adjacency.weights[k];
+        } else {
+            sum += read(neighbors[k]);
+        }
+    }
+    if (!Weighted) {
+        sum *= T(1) / T(row_end - row_begin);
+    }
+    return sum;
+}
+
+// One Jacobi sweep over vertices [begin, end):
+// out = in + factor * (neighbor average - in). Pinned and isolated vertices are copied.
+template<typename T, bool Weighted>
+void laplacian_sweep(const VertexAdjacency<T>& adjacency, const std::uint8_t* pinned,
+                     const PositionBuffer<T>& in, const PositionBuffer<T>& out, T factor,
+                     std::size_t begin, std::size_t end) {
+    auto read = [&in](std::size_t j) { return math::Vector3<T>(in.x[j], in.y[j], in.z[j]); };
+
+    for (std::size_t v = begin; v < end; ++v) {
+        math::Vector3<T> p = read(v);
+        if (!pinned[v] && adjacency.degree(v) != 0) {
+            p += (neighbor_average<T, Weighted>(adjacency, v, read) - p) * factor;
+        }
+        out.x[v] = p.x;
+        out.y[v] = p.y;
+        out.z[v] = p.z;
+    }
+}
+
+template<typename T>
+void laplacian_sweep(const VertexAdjacency<T>& adjacency, const std::uint8_t* pinned,
+                     const PositionBuffer<T>& in, const PositionBuffer<T>& out, T factor,
+                     std::size_t begin, std::size_t end) {
+    if (adjacency.weights.empty()) {
+        laplacian_sweep<T, false>(adjacency, pinned, in, out, factor, begin, end);
+    } else {
+        laplacian_sweep<T, true>(adjacency, pinned, in, out, factor, begin, end);
+    }
+}
+
+// True when some neighbor of v lies outside [begin, end)
+template<typename T>
+bool crosses_range(const VertexAdjacency<T>& adjacency, std::size_t v, std::size_t begin, std::size_t end) {
+    const std::size_t row_begin = adjacency.offsets[v];
+    const std::size_t row_end = adjacency.offsets[v + 1];
+    return row_begin != row_end &&
+           (adjacency.neighbors[row_begin] < begin || adjacency.neighbors[row_end - 1] >= end);
+}
+
+// Shrink step of one Taubin iteration for the vertices [begin, end) owned by the
+// calling thread, fused with the inflate step. Shrunk positions go to mid; a vertex is
+// inflated back into positions as soon as the sweep has passed all its neighbors
+// (rows are sorted, so that is its last neighbor), while its row is still in cache.
+// Overwriting positions[u] then is safe: only u's neighbors read it, and they have all
+// been shrunk. Vertices with neighbors in other threads' ranges are skipped here and
+// handled by taubin_inflate once every thread has finished shrinking.
+template<typename T, bool Weighted>
+void taubin_sweep(const VertexAdjacency<T>& adjacency, const std::uint8_t* pinned,
+                  core::Vertex<T>* vertices, const PositionBuffer<T>& mid, T lambda, T mu,
+                  std::size_t begin, std::size_t end) {
+    auto read_position = [vertices](std::size_t j) -> const math::Vector3<T>& { return vertices[j].position; };
+    auto read_mid = [&mid](std::size_t j) { return math::Vector3<T>(mid.x[j], mid.y[j], mid.z[j]); };
+
+    auto ready = [&](std::size_t u, std::size_t shrunk_end) {
+        return adjacency.degree(u) == 0 ||
+               adjacency.neighbors[adjacency.offsets[u + 1] - 1] < shrunk_end ||
+               crosses_range(adjacency, u, begin, end);
+    };
+    auto inflate = [&](std::size_t u) {
+        if (pinned[u] || adjacency.degree(u) == 0 || crosses_range(adjacency, u, begin, end)) return;
+        const math::Vector3<T> q = read_mid(u);
+        vertices[u].position = q + (neighbor_average<T, Weighted>(adjacency, u, read_mid) - q) * mu;
+    };
+
+    std::size_t next = begin;  // first vertex not yet inflated
+    for (std::size_t v = begin; v < end; ++v) {
+        math::Vector3<T> q = vertices[v].position;
+        if (!pinned[v] && adjacency.degree(v) != 0) {
+            q += (neighbor_average<T, Weighted>(adjacency, v, read_position) - q) * lambda;
+        }
+        mid.x[v] = q.x;
+        mid.y[v] = q.y;
+        mid.z[v] = q.z;
+
+        for (; next <= v && ready(next, v + 1); ++next) {
+            inflate(next);
+        }
+    }
+    for (; next < end; ++next) {
+        inflate(next);
+    }
+}
+
+// Inflate step for vertices deferred by taubin_sweep
+template<typename T, bool Weighted>
+void taubin_inflate(const VertexAdjacency<T>& adjacency, const std::uint8_t* pinned,
+                    core::Vertex<T>* vertices, const PositionBuffer<T>& mid, T mu,
+                    const std::vector<std::size_t>& deferred) {
+    auto read_mid = [&mid](std::size_t j) { return math::Vector3<T>(mid.x[j], mid.y[j], mid.z[j]); };
+    for (std::size_t u : deferred) {
+        if (pinned[u]) continue;
+        const math::Vector3<T> q = read_mid(u);
+        vertices[u].position = q + (neighbor_average<T, Weighted>(adjacency, u, read_mid) - q) * mu;
+    }
+}
+
+template<typename T>
+std::vector<std::uint8_t> pinned_vertices(const VertexAdjacency<T>& adjacency, bool pin_boundaries) {
+    if (pin_boundaries) return adjacency.boundary;
+    return std::vector<std::uint8_t>(adjacency.vertex_count(), 0);
+}
+
+inline AdjacencyWeighting adjacency_weighting(const SmoothingConfig& config) {
+    return config.weighting == SmoothingConfig::COTANGENT ? AdjacencyWeighting::COTANGENT
+                                                          : AdjacencyWeighting::UNIFORM;
+}
+
+// Runs passes Jacobi sweeps over the mesh positions. sweep(pass, in, out, begin, end)
+// computes pass for vertices [begin, end) reading in and writing out; a barrier
+// separates passes. Buffers are first touched by the thread that owns each range.
+template<typename T, typename Sweep>
+void run_jacobi_sweeps(core::Mesh<T>& mesh, std::size_t passes, Sweep&& sweep) {
+    const std::size_t n = mesh.vertex_count();
+    if (n == 0 || passes == 0) return;
+
+    std::unique_ptr<T[]> storage(new T[6 * n]);
+    const PositionBuffer<T> buffers[2] = {
+        {storage.get(), storage.get() + n, storage.get() + 2 * n},
+        {storage.get() + 3 * n, storage.get() + 4 * n, storage.get() + 5 * n}
+    };
+
+    const std::size_t threads = utils::parallel_chunk_count(n, SMOOTHING_MIN_CHUNK);
+    utils::Barrier barrier(threads);
+
+    mesh.update_vertices([&](core::Vertex<T>* vertices, std::size_t) {
+        utils::parallel_team(threads, [&](std::size_t thread) {
+            const std::size_t begin = n * thread / threads;
+            const std::size_t end = n * (thread + 1) / threads;
+
+            for (std::size_t v = begin; v < end; ++v) {
+                buffers[0].x[v] = vertices[v].position.x;
+                buffers[0].y[v] = vertices[v].position.y;
+                buffers[0].z[v] = vertices[v].position.z;
+            }
+
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                barrier.arrive_and_wait();
+                sweep(pass, buffers[pass & 1], buffers[(pass + 1) & 1], begin, end);
+            }
+
+            // Each thread reads back only the range it wrote last
+            const PositionBuffer<T>& result = buffers[passes & 1];
+            for (std::size_t v = begin; v < end; ++v) {
+                vertices[v].position = math::Vector3<T>(result.x[v], result.y[v], result.z[v]);
+            }
+        });
+    });
+}
+
+template<typename T>
+void laplacian_smoothing(core::Mesh<T>& mesh, std::size_t iterations, T lambda,
+                         AdjacencyWeighting weighting, bool pin_boundaries) {
+    if (iterations == 0 || mesh.vertex_count() == 0) return;
+
+    const auto adjacency = build_vertex_adjacency(mesh, weighting);
+    const auto pinned = pinned_vertices(adjacency, pin_boundaries);
+
+    run_jacobi_sweeps(mesh, iterations,
+        [&](std::size_t, const PositionBuffer<T>& in, const PositionBuffer<T>& out,
+            std::size_t begin, std::size_t end) {
+            laplacian_sweep(adjacency, pinned.data(), in, out, lambda, begin, end);
+        });
+}
+
+template<typename T, bool Weighted>
+void taubin_smoothing(core::Mesh<T>& mesh, const VertexAdjacency<T>& adjacency,
+                      const std::uint8_t* pinned, std::size_t iterations, T lambda, T mu) {
+    const std::size_t n = mesh.vertex_count();
+
+    // The only position-sized scratch: shrunk positions between the two half steps
+    std::unique_ptr<T[]> storage(new T[3 * n]);
+    const PositionBuffer<T> mid = {storage.get(), storage.get() + n, storage.get() + 2 * n};
+
+    const std::size_t threads = utils::parallel_chunk_count(n, SMOOTHING_MIN_CHUNK);
+    utils::Barrier barrier(threads);
+
+    mesh.update_vertices([&](core::Vertex<T>* vertices, std::size_t) {
+        utils::parallel_team(threads, [&](std::size_t thread) {
+            const std::size_t begin = n * thread / threads;
+            const std::size_t end = n * (thread + 1) / threads;
+
+            std::vector<std::size_t> deferred;
+            for (std::size_t v = begin; v < end; ++v) {
+                if (crosses_range(adjacency, v, begin, end)) deferred.push_back(v);
+            }
+
+            for (std::size_t iteration = 0; iteration < iterations; ++iteration) {
+                // Positions read from other ranges belong to their deferred vertices,
+                // which are not written before the barrier
+                taubin_sweep<T, Weighted>(adjacency, pinned, vertices, mid, lambda, mu, begin, end);
+                barrier.arrive_and_wait();
+                taubin_inflate<T, Weighted>(adjacency, pinned, vertices, mid, mu, deferred);
+                barrier.arrive_and_wait();
+            }
+        });
+    });
+}
+
+template<typename T>
+void taubin_smoothing(core::Mesh<T>& mesh, std::size_t iterations, T lambda, T mu,
+                      AdjacencyWeighting weighting, bool pin_boundaries) {
+    if (iterations == 0 || mesh.vertex_count() == 0) return;
+
+    const auto adjacency = build_vertex_adjacency(mesh, weighting);
+    const auto pinned = pinned_vertices(adjacency, pin_boundaries);
+
+    if (adjacency.weights.empty()) {
+        taubin_smoothing<T, false>(mesh, adjacency, pinned.data(), iterations, lambda, mu);
+    } else {
+        taubin_smoothing<T, true>(mesh, adjacency, pinned.data(), iterations, lambda, mu);
+    }
+}
+
+} // namespace detail
+
+// Laplacian smoothing: p += lambda * (neighbor average - p), repeated with uniform
+// weights. Boundary vertices are pinned.
+template<typename T>
+void laplacian_smoothing(core::Mesh<T>& mesh, std::size_t iterations, T lambda) {
+    detail::laplacian_smoothing(mesh, iterations, lambda, AdjacencyWeighting::UNIFORM, true);
+}
+
+// Laplacian smoothing with the weighting and boundary handling from config
+template<typename T>
+void laplacian_smoothing(core::Mesh<T>& mesh, const SmoothingConfig& config) {
+    detail::laplacian_smoothing(mesh, config.iterations, static_cast<T>(config.lambda),
+                                detail::adjacency_weighting(config), config.pin_boundaries);
+}
+
+// Taubin smoothing: a shrinking Laplacian step with lambda followed by an inflating
+// one with mu (mu < -lambda), which smooths without the volume loss of plain Laplacian
+// smoothing. Both steps run in a single fused pass over the adjacency and update the
+// positions in place; the only scratch is one structure-of-arrays position buffer.
+template<typename T>
+void taubin_smoothing(core::Mesh<T>& mesh, std::size_t iterations, T lambda, T mu) {
+    detail::taubin_smoothing(mesh, iterations, lambda, mu, AdjacencyWeighting::UNIFORM, true);
+}
+
+template<typename T>
+void taubin_smoothing(core::Mesh<T>& mesh, const SmoothingConfig& config) {
+    detail::taubin_smoothing(mesh, config.iterations, static_cast<T>(config.lambda),
+                             static_cast<T>(config.mu), detail::adjacency_weighting(config),
+                             config.pin_boundaries);
+}
+
+// Runs the smoother selected by config.type
+template<typename T>
+void smooth(core::Mesh<T>& mesh, const SmoothingConfig& config) {
+    if (config.type == SmoothingConfig::TAUBIN) {
+        taubin_smoothing(mesh, config);
+    } else {
+        laplacian_smoothing(mesh, config);
+    }
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
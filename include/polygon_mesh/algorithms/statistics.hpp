@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <polygon_mesh/algorithms/face_sides.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace analysis {
+
+// Mesh statistics. Everything measured per face (face kinds, areas, volume) is summed
+// in one parallel pass into per-chunk partials, which also counts the sides of every
+// face by their lower vertex. Unique edges then come from a counting sort on that
+// vertex: each side's higher vertex is scattered into its bucket, and buckets are
+// sorted and scanned in parallel, measuring each edge once. The bounding box rides
+// along with the bucket scan. Memory beyond the mesh is one 32-bit entry per side.
+
+// Minimum faces (or vertices) per thread
+constexpr std::size_t STATISTICS_MIN_CHUNK = 16384;
+
+namespace detail {
+
+// Per-chunk sums of the face pass
+struct FaceTotals {
+    std::size_t triangles = 0;
+    std::size_t quads = 0;
+    std::size_t ngons = 0;
+    double area = 0.0;
+    double volume = 0.0;      // six times the signed volume
+    double min_triangle_area = std::numeric_limits<double>::max();
+    double max_triangle_area = 0.0;
+    double triangle_area = 0.0;
+
+    void merge(const FaceTotals& other) {
+        triangles += other.triangles;
+        quads += other.quads;
+        ngons += other.ngons;
+        area += other.area;
+        volume += other.volume;
+        min_triangle_area = std::min(min_triangle_area, other.min_triangle_area);
+        max_triangle_area = std::max(max_triangle_area, other.max_triangle_area);
+        triangle_area += other.triangle_area;
+    }
+};
+
+// Fan-triangulated area and signed volume of faces begin .. end
+template<typename T>
+void accumulate_faces(const core::Mesh<T>& mesh, std::size_t begin, std::size_t end, FaceTotals& totals) {
+    const auto& faces = mesh.faces();
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    for (std::size_t f = begin; f < end; ++f) {
+        const auto& ids = faces[f].vertices;
+        const std::size_t size = ids.size();
+        totals.triangles += size == 3 ? 1 : 0;
+        totals.quads += size == 4 ? 1 : 0;
+        totals.ngons += size > 4 ? 1 : 0;
+        if (size < 3) continue;
+
+        const math::Vector3<T>& p0 = vertices[ids[0]].position;
+        double face_area = 0.0;
+        for (std::size_t i = 1; i + 1 < size; ++i) {
+            const math::Vector3<T>& p1 = vertices[ids[i]].position;
+            const math::Vector3<T>& p2 = vertices[ids[i + 1]].position;
+            face_area += double((p1 - p0).cross(p2 - p0).length()) * 0.5;
+            totals.volume += double(p0.dot(p1.cross(p2)));
+        }
+        totals.area += face_area;
+        if (size == 3) {
+            totals.min_triangle_area = std::min(totals.min_triangle_area, face_area);
+            totals.max_triangle_area = std::max(totals.max_triangle_area, face_area);
+            totals.triangle_area += face_area;
+        }
+    }
+}
+
+template<typename T>
+FaceTotals sum_faces(const core::Mesh<T>& mesh) {
+    std::vector<FaceTotals> partials(utils::parallel_chunk_count(mesh.face_count(), STATISTICS_MIN_CHUNK));
+    utils::parallel_for_range(0, mesh.face_count(), [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        accumulate_faces(mesh, begin, end, partials[chunk]);
+    }, STATISTICS_MIN_CHUNK);
+
+    FaceTotals totals;
+    for (const auto& partial : partials) totals.merge(partial);
+    return totals;
+}
+
+// Per-chunk sums of the bucket scan
+template<typename T>
+struct EdgeTotals {
+    std::size_t edges = 0;
+    double min_length = std::numeric_limits<double>::max();
+    double max_length = 0.0;
+    double length = 0.0;
+    core::BoundingBox<T> bounds;
+};
+
+} // namespace detail
+
+template<typename T>
+T compute_surface_area(const core::Mesh<T>& mesh) {
+    return static_cast<T>(detail::sum_faces(mesh).area);
+}
+
+// Signed volume enclosed by the faces; meaningful for closed, consistently oriented meshes
+template<typename T>
+T compute_volume(const core::Mesh<T>& mesh) {
+    return static_cast<T>(detail::sum_faces(mesh).volume / 6.0);
+}
+
+template<typename T>
+MeshStatistics<T> compute_mesh_statistics(const core::Mesh<T>& mesh) {
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    const std::size_t vertex_count = mesh.vertex_count();
+
+    // Face pass: areas, volume and face kinds
+    std::vector<detail::FaceTotals> face_partials(utils::parallel_chunk_count(face_count, STATISTICS_MIN_CHUNK));
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        detail::accumulate_faces(mesh, begin, end, face_partials[chunk]);
+    }, STATISTICS_MIN_CHUNK);
+
+    // Higher vertex of every face side, bucketed by the lower one
+    auto buckets = algorithms::detail::bucket_face_sides(mesh, STATISTICS_MIN_CHUNK);
+    const auto& bucket_offsets = buckets.offsets;
+    auto& higher = buckets.entries;
+
+    // Bucket scan: every distinct higher vertex in bucket v is one edge
+    const core::Vertex<T>* vertices = mesh.vertices().data();
+    std::vector<detail::EdgeTotals<T>> edge_partials(utils::parallel_chunk_count(vertex_count, STATISTICS_MIN_CHUNK));
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        auto& partial = edge_partials[chunk];
+        for (std::size_t v = begin; v < end; ++v) {
+            const math::Vector3<T>& p = vertices[v].position;
+            partial.bounds.expand(p);
+            const auto first = higher.begin() + bucket_offsets[v];
+            const auto last = higher.begin() + bucket_offsets[v + 1];
+            std::sort(first, last);
+            for (auto it = first; it != last; ++it) {
+                if (it != first && *it == it[-1]) continue;
+                const double length = double((vertices[*it].position - p).length());
+                partial.edges += 1;
+                partial.min_length = std::min(partial.min_length, length);
+                partial.max_length = std::max(partial.max_length, length);
+                partial.length += length;
+            }
+        }
+    }, STATISTICS_MIN_CHUNK);
+
+    detail::FaceTotals face_totals;
+    for (const auto& partial : face_partials) face_totals.merge(partial);
+    detail::EdgeTotals<T> edge_totals;
+    for (const auto& partial : edge_partials) {
+        edge_totals.edges += partial.edges;
+        edge_totals.min_length = std::min(edge_totals.min_length, partial.min_length);
+        edge_totals.max_length = std::max(edge_totals.max_length, partial.max_length);
+        edge_totals.length += partial.length;
+        if (partial.bounds.is_valid()) edge_totals.bounds.expand(partial.bounds);
+    }
+
+    MeshStatistics<T> stats;
+    stats.vertex_count = vertex_count;
+    stats.edge_count = edge_totals.edges;
+    stats.face_count = face_count;
+    stats.triangle_count = face_totals.triangles;
+    stats.quad_count = face_totals.quads;
+    stats.ngon_count = face_totals.ngons;
+
+    const bool any_edges = edge_totals.edges > 0;
+    stats.min_edge_length = any_edges ? static_cast<T>(edge_totals.min_length) : T(0);
+    stats.max_edge_length = static_cast<T>(edge_totals.max_length);
+    stats.avg_edge_length = any_edges ? static_cast<T>(edge_totals.length / double(edge_totals.edges)) : T(0);
+
+    const bool any_triangles = face_totals.triangles > 0;
+    stats.min_triangle_area = any_triangles ? static_cast<T>(face_totals.min_triangle_area) : T(0);
+    stats.max_triangle_area = static_cast<T>(face_totals.max_triangle_area);
+    stats.avg_triangle_area = any_triangles ? static_cast<T>(face_totals.triangle_area / double(face_totals.triangles))
+                                            : T(0);
+
+    stats.total_surface_area = static_cast<T>(face_totals.area);
+    stats.volume = static_cast<T>(face_totals.volume / 6.0);
+    stats.bounding_box = edge_totals.bounds;
+    return stats;
+}
+
+} // namespace analysis
+} // namespace algorithms
+} // namespace polygon_mesh
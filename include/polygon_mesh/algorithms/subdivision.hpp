@@ -0,0 +1,1095 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/algorithms/config.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace processing {
+
+// Loop subdivision (Loop 1987, with Hoppe et al.'s crease rules). Every level splits
+// each triangle into four and adds one vertex per edge, so a level maps V, E, F to
+// V + E, 2E + 3F, 4F; all of these are known from the input, and every buffer is
+// reserved for the largest level before the first one runs. Each level rebuilds its
+// edge table with one sorted pass over the triangle corners and then computes the even
+// (old vertex) and odd (edge vertex) stencils and the child triangles in parallel.
+//
+// An edge is sharp when it is a boundary, is used by more than two faces, or is a
+// crease. Vertices with two sharp edges follow the curve rule along them, vertices with
+// more are corners and stay put, and edge vertices on sharp edges take the midpoint.
+// Creases are inherited by both halves of a split edge.
+
+// Minimum vertices, edges or faces per thread
+constexpr std::size_t SUBDIVISION_MIN_CHUNK = 16384;
+
+// Valences below this have their stencil weights tabulated before the first level
+constexpr std::size_t SUBDIVISION_STENCIL_TABLE_SIZE = 64;
+
+// Sharpness bits of SubdivisionEdges::sharp
+constexpr std::uint8_t SUBDIVISION_EDGE_NON_MANIFOLD = 1;  // used by one face or more than two
+constexpr std::uint8_t SUBDIVISION_EDGE_CREASE = 2;
+
+namespace detail {
+
+// Corners of an all-triangle level: face f owns corners 3f, 3f + 1 and 3f + 2
+struct TriangleLayout {
+    std::size_t faces;
+
+    std::size_t face_count() const { return faces; }
+    std::size_t corner_count() const { return faces * 3; }
+    std::size_t begin(std::size_t f) const { return f * 3; }
+    std::size_t size(std::size_t) const { return 3; }
+    std::size_t face_of(std::size_t corner) const { return corner / 3; }
+};
+
+// Corners of an all-quad level
+struct QuadLayout {
+    std::size_t faces;
+
+    std::size_t face_count() const { return faces; }
+    std::size_t corner_count() const { return faces * 4; }
+    std::size_t begin(std::size_t f) const { return f * 4; }
+    std::size_t size(std::size_t) const { return 4; }
+    std::size_t face_of(std::size_t corner) const { return corner / 4; }
+};
+
+// Corners of mixed polygons: face f owns corners offsets[f] .. offsets[f + 1]
+struct PolygonLayout {
+    const std::size_t* offsets;
+    const std::uint32_t* corner_faces;
+    std::size_t faces;
+
+    std::size_t face_count() const { return faces; }
+    std::size_t corner_count() const { return offsets[faces]; }
+    std::size_t begin(std::size_t f) const { return offsets[f]; }
+    std::size_t size(std::size_t f) const { return offsets[f + 1] - offsets[f]; }
+    std::size_t face_of(std::size_t corner) const { return corner_faces[corner]; }
+};
+
+// Edge table of one subdivision level. Edges are numbered in order of their (lower,
+// higher) endpoint pair. The sorted neighbors of vertex v are
+// neighbors[offsets[v] .. offsets[v + 1]), with the ids of the edges to them in
+// row_edges; corner_edges holds, for each face corner, the edge to the next corner.
+// Faces must not repeat a vertex. Buffers are kept between builds so a table reserved
+// for the largest level never reallocates.
+class SubdivisionEdges {
+public:
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::size_t> offsets;
+    std::vector<core::VertexId> neighbors;
+    std::vector<std::uint32_t> row_edges;
+    std::vector<std::array<core::VertexId, 2>> ends;          // lower endpoint first
+    std::vector<std::array<std::uint32_t, 2>> edge_corners;   // first two corners on the edge, or NONE
+    std::vector<std::uint8_t> sharp;                          // SUBDIVISION_EDGE_* bits
+    std::vector<std::uint32_t> corner_edges;
+
+    std::size_t edge_count() const { return ends.size(); }
+
+    void reserve(std::size_t vertex_count, std::size_t edge_count, std::size_t corner_count) {
+        offsets.reserve(vertex_count + 1);
+        neighbors.reserve(edge_count * 2);
+        row_edges.reserve(edge_count * 2);
+        ends.reserve(edge_count);
+        edge_corners.reserve(edge_count);
+        sharp.reserve(edge_count);
+        corner_edges.reserve(corner_count);
+        raw_offsets_.reserve(vertex_count + 1);
+        cursor_.reserve(vertex_count);
+        raw_.reserve(corner_count * 2);
+        row_counts_.reserve(vertex_count);
+        edge_offsets_.reserve(vertex_count + 1);
+    }
+
+    template<typename Layout>
+    void build(const core::VertexId* corners, const Layout& layout, std::size_t vertex_count) {
+        const std::size_t n = vertex_count;
+
+        // Every face side is entered in the buckets of both its endpoints as
+        // (other endpoint << 32 | corner), so sorting a bucket groups the corners of
+        // each edge and orders the neighbors
+        raw_offsets_.assign(n + 1, 0);
+        for (std::size_t f = 0; f < layout.face_count(); ++f) {
+            const std::size_t first = layout.begin(f);
+            const std::size_t size = layout.size(f);
+            for (std::size_t k = 0; k < size; ++k) {
+                ++raw_offsets_[corners[first + k] + 1];
+                ++raw_offsets_[corners[first + (k + 1) % size] + 1];
+            }
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            raw_offsets_[v + 1] += raw_offsets_[v];
+        }
+
+        raw_.resize(raw_offsets_[n]);
+        cursor_.assign(raw_offsets_.begin(), raw_offsets_.end() - 1);
+        for (std::size_t f = 0; f < layout.face_count(); ++f) {
+            const std::size_t first = layout.begin(f);
+            const std::size_t size = layout.size(f);
+            for (std::size_t k = 0; k < size; ++k) {
+                const std::uint64_t corner = first + k;
+                const core::VertexId a = corners[first + k];
+                const core::VertexId b = corners[first + (k + 1) % size];
+                raw_[cursor_[a]++] = (std::uint64_t(b) << 32) | corner;
+                raw_[cursor_[b]++] = (std::uint64_t(a) << 32) | corner;
+            }
+        }
+
+        // Sort the buckets and count distinct neighbors, in total and above v
+        row_counts_.resize(n);
+        edge_offsets_.resize(n + 1);
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                const auto first = raw_.begin() + raw_offsets_[v];
+                const auto last = raw_.begin() + raw_offsets_[v + 1];
+                std::sort(first, last);
+
+                std::size_t count = 0;
+                std::size_t above = 0;
+                for (auto it = first; it != last;) {
+                    const std::uint64_t w = *it >> 32;
+                    while (it != last && (*it >> 32) == w) ++it;
+                    ++count;
+                    above += w > v ? 1 : 0;
+                }
+                row_counts_[v] = count;
+                edge_offsets_[v + 1] = above;
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+
+        offsets.resize(n + 1);
+        offsets[0] = 0;
+        edge_offsets_[0] = 0;
+        for (std::size_t v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + row_counts_[v];
+            edge_offsets_[v + 1] += edge_offsets_[v];
+        }
+
+        const std::size_t edge_total = edge_offsets_[n];
+        neighbors.resize(offsets[n]);
+        row_edges.resize(offsets[n]);
+        ends.resize(edge_total);
+        edge_corners.resize(edge_total);
+        sharp.resize(edge_total);
+        corner_edges.resize(layout.corner_count());
+
+        // Rows, and the edges each vertex is the lower endpoint of. A corner appears in
+        // exactly one bucket as the lower endpoint, so its edge is written once.
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                const auto last = raw_.begin() + raw_offsets_[v + 1];
+                std::size_t slot = offsets[v];
+                std::uint32_t edge = static_cast<std::uint32_t>(edge_offsets_[v]);
+                for (auto it = raw_.begin() + raw_offsets_[v]; it != last;) {
+                    const auto w = static_cast<core::VertexId>(*it >> 32);
+                    auto run = it;
+                    while (run != last && (*run >> 32) == w) ++run;
+
+                    neighbors[slot] = w;
+                    if (w > v) {
+                        row_edges[slot] = edge;
+                        ends[edge] = {static_cast<core::VertexId>(v), w};
+                        edge_corners[edge] = {static_cast<std::uint32_t>(*it),
+                                              run - it > 1 ? static_cast<std::uint32_t>(it[1]) : NONE};
+                        sharp[edge] = run - it == 2 ? 0 : SUBDIVISION_EDGE_NON_MANIFOLD;
+                        for (auto corner = it; corner != run; ++corner) {
+                            corner_edges[static_cast<std::uint32_t>(*corner)] = edge;
+                        }
+                        ++edge;
+                    }
+                    ++slot;
+                    it = run;
+                }
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+
+        // Edges to lower neighbors were numbered in those neighbors' rows
+        utils::parallel_for_range(0, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t v = begin; v < end; ++v) {
+                for (std::size_t slot = offsets[v]; slot < offsets[v + 1] && neighbors[slot] < v; ++slot) {
+                    row_edges[slot] = find(neighbors[slot], static_cast<core::VertexId>(v));
+                }
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+    }
+
+    // Id of edge (a, b), or NONE when no face has it
+    std::uint32_t find(core::VertexId a, core::VertexId b) const {
+        if (a > b) std::swap(a, b);
+        if (a == b || std::size_t(b) + 1 >= offsets.size()) return NONE;
+        const auto first = neighbors.begin() + offsets[a];
+        const auto last = neighbors.begin() + offsets[a + 1];
+        const auto it = std::lower_bound(first, last, b);
+        return it != last && *it == b ? row_edges[static_cast<std::size_t>(it - neighbors.begin())] : NONE;
+    }
+
+    // Endpoint of edge e that is not v
+    core::VertexId other(std::uint32_t e, std::size_t v) const {
+        return ends[e][0] == v ? ends[e][1] : ends[e][0];
+    }
+
+    // Flags the listed vertex pairs as creases; pairs that are not edges are ignored
+    void mark_creases(const std::vector<std::pair<core::VertexId, core::VertexId>>& creases) {
+        for (const auto& crease : creases) {
+            const std::uint32_t edge = find(crease.first, crease.second);
+            if (edge != NONE) sharp[edge] |= SUBDIVISION_EDGE_CREASE;
+        }
+    }
+
+    // Vertex pairs of the creases after each edge e gets the new vertex first_new + e
+    void split_creases(std::size_t first_new, std::vector<std::pair<core::VertexId, core::VertexId>>& creases) const {
+        creases.clear();
+        for (std::size_t e = 0; e < ends.size(); ++e) {
+            if (!(sharp[e] & SUBDIVISION_EDGE_CREASE)) continue;
+            const auto middle = static_cast<core::VertexId>(first_new + e);
+            creases.emplace_back(ends[e][0], middle);
+            creases.emplace_back(ends[e][1], middle);
+        }
+    }
+
+private:
+    std::vector<std::size_t> raw_offsets_;
+    std::vector<std::size_t> cursor_;
+    std::vector<std::uint64_t> raw_;
+    std::vector<std::size_t> row_counts_;
+    std::vector<std::size_t> edge_offsets_;
+};
+
+// Loop's weights by valence n: beta(n) for the neighbors of a smooth even vertex, and
+// limit(n) for the neighbors when projecting to the limit surface
+template<typename T>
+class LoopStencils {
+public:
+    LoopStencils() {
+        for (std::size_t n = 0; n < SUBDIVISION_STENCIL_TABLE_SIZE; ++n) {
+            beta_[n] = compute_beta(n);
+            limit_[n] = compute_limit(n);
+        }
+    }
+
+    T beta(std::size_t n) const { return n < SUBDIVISION_STENCIL_TABLE_SIZE ? beta_[n] : compute_beta(n); }
+    T limit(std::size_t n) const { return n < SUBDIVISION_STENCIL_TABLE_SIZE ? limit_[n] : compute_limit(n); }
+
+private:
+    static T compute_beta(std::size_t n) {
+        if (n == 0) return T(0);
+        const double c = 0.375 + 0.25 * std::cos(math::two_pi<double>() / double(n));
+        return static_cast<T>((0.625 - c * c) / double(n));
+    }
+
+    static T compute_limit(std::size_t n) {
+        if (n == 0) return T(0);
+        const double beta = double(compute_beta(n));
+        return static_cast<T>(beta / (0.375 + double(n) * beta));
+    }
+
+    std::array<T, SUBDIVISION_STENCIL_TABLE_SIZE> beta_;
+    std::array<T, SUBDIVISION_STENCIL_TABLE_SIZE> limit_;
+};
+
+// Number of sharp edges at vertex v; the first two are stored in found, which is all
+// the curve rule (exactly two) needs
+inline std::size_t sharp_edges_at(const SubdivisionEdges& edges, std::size_t v, std::uint32_t (&found)[2]) {
+    std::size_t count = 0;
+    for (std::size_t slot = edges.offsets[v]; slot < edges.offsets[v + 1]; ++slot) {
+        const std::uint32_t edge = edges.row_edges[slot];
+        if (edges.sharp[edge]) {
+            if (count < 2) found[count] = edge;
+            ++count;
+        }
+    }
+    return count;
+}
+
+// One level of Loop subdivision from (positions, uvs, triangles) with the given edge
+// table into the output arrays, which hold at least V + E vertices and 4F triangles.
+// Edge vertex e is numbered V + e; the children of triangle f are 4f .. 4f + 3.
+template<typename T>
+void loop_level(const SubdivisionEdges& edges, const LoopStencils<T>& stencils,
+                const math::Vector3<T>* positions, const math::Vector2<T>* uvs, std::size_t vertex_count,
+                const core::VertexId* triangles, std::size_t triangle_count,
+                math::Vector3<T>* out_positions, math::Vector2<T>* out_uvs, core::VertexId* out_triangles) {
+    // Even vertices
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const std::size_t valence = edges.offsets[v + 1] - edges.offsets[v];
+            std::uint32_t sharp_edges[2];
+            const std::size_t sharp = sharp_edges_at(edges, v, sharp_edges);
+
+            math::Vector3<T> p = positions[v];
+            if (sharp == 2) {
+                p = p * T(0.75) + (positions[edges.other(sharp_edges[0], v)] +
+                                   positions[edges.other(sharp_edges[1], v)]) * T(0.125);
+            } else if (sharp < 2 && valence > 0) {
+                math::Vector3<T> sum(0);
+                for (std::size_t slot = edges.offsets[v]; slot < edges.offsets[v + 1]; ++slot) {
+                    sum += positions[edges.neighbors[slot]];
+                }
+                const T beta = stencils.beta(valence);
+                p = p * (T(1) - T(valence) * beta) + sum * beta;
+            }
+            out_positions[v] = p;
+            out_uvs[v] = uvs[v];
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    // Odd vertices
+    math::Vector3<T>* odd_positions = out_positions + vertex_count;
+    math::Vector2<T>* odd_uvs = out_uvs + vertex_count;
+    utils::parallel_for_range(0, edges.edge_count(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t e = begin; e < end; ++e) {
+            const auto& ends = edges.ends[e];
+            const math::Vector3<T> sum = positions[ends[0]] + positions[ends[1]];
+            if (edges.sharp[e]) {
+                odd_positions[e] = sum * T(0.5);
+            } else {
+                // The vertex opposite the edge in each of its two triangles
+                const auto& corners = edges.edge_corners[e];
+                const core::VertexId c = triangles[corners[0] - corners[0] % 3 + (corners[0] + 2) % 3];
+                const core::VertexId d = triangles[corners[1] - corners[1] % 3 + (corners[1] + 2) % 3];
+                odd_positions[e] = sum * T(0.375) + (positions[c] + positions[d]) * T(0.125);
+            }
+            odd_uvs[e] = (uvs[ends[0]] + uvs[ends[1]]) * T(0.5);
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    // Children: the three corner triangles, then the middle one
+    utils::parallel_for_range(0, triangle_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            const core::VertexId* tri = triangles + f * 3;
+            const auto m0 = static_cast<core::VertexId>(vertex_count + edges.corner_edges[f * 3]);
+            const auto m1 = static_cast<core::VertexId>(vertex_count + edges.corner_edges[f * 3 + 1]);
+            const auto m2 = static_cast<core::VertexId>(vertex_count + edges.corner_edges[f * 3 + 2]);
+            core::VertexId* out = out_triangles + f * 12;
+            out[0] = tri[0]; out[1] = m0;     out[2] = m2;
+            out[3] = m0;     out[4] = tri[1]; out[5] = m1;
+            out[6] = m2;     out[7] = m1;     out[8] = tri[2];
+            out[9] = m0;     out[10] = m1;    out[11] = m2;
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+}
+
+// Moves every vertex to its position on the Loop limit surface
+template<typename T>
+void loop_limit(const SubdivisionEdges& edges, const LoopStencils<T>& stencils,
+                const math::Vector3<T>* positions, std::size_t vertex_count, math::Vector3<T>* out_positions) {
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const std::size_t valence = edges.offsets[v + 1] - edges.offsets[v];
+            std::uint32_t sharp_edges[2];
+            const std::size_t sharp = sharp_edges_at(edges, v, sharp_edges);
+
+            math::Vector3<T> p = positions[v];
+            if (sharp == 2) {
+                p = (p * T(4) + positions[edges.other(sharp_edges[0], v)] +
+                     positions[edges.other(sharp_edges[1], v)]) * (T(1) / T(6));
+            } else if (sharp < 2 && valence > 0) {
+                math::Vector3<T> sum(0);
+                for (std::size_t slot = edges.offsets[v]; slot < edges.offsets[v + 1]; ++slot) {
+                    sum += positions[edges.neighbors[slot]];
+                }
+                const T weight = stencils.limit(valence);
+                p = p * (T(1) - T(valence) * weight) + sum * weight;
+            }
+            out_positions[v] = p;
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+}
+
+// Marks the edges whose two faces' normals are more than angle_degrees apart
+template<typename T, typename Layout>
+void mark_crease_angle(SubdivisionEdges& edges, const math::Vector3<T>* positions,
+                       const core::VertexId* corners, const Layout& layout, T angle_degrees) {
+    std::vector<math::Vector3<T>> normals(layout.face_count());
+    utils::parallel_for_range(0, layout.face_count(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            // Newell's normal, the triangle cross product for three corners
+            const std::size_t first = layout.begin(f);
+            const std::size_t size = layout.size(f);
+            math::Vector3<T> normal(0);
+            for (std::size_t k = 0; k < size; ++k) {
+                normal += positions[corners[first + k]].cross(positions[corners[first + (k + 1) % size]]);
+            }
+            const T length = normal.length();
+            normals[f] = length > T(0) ? normal / length : math::Vector3<T>(0);
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    const T threshold = std::cos(math::degrees_to_radians(angle_degrees));
+    utils::parallel_for_range(0, edges.edge_count(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t e = begin; e < end; ++e) {
+            if (edges.sharp[e]) continue;
+            const auto& ends = edges.edge_corners[e];
+            if (normals[layout.face_of(ends[0])].dot(normals[layout.face_of(ends[1])]) < threshold) {
+                edges.sharp[e] |= SUBDIVISION_EDGE_CREASE;
+            }
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+}
+
+} // namespace detail
+
+// Loop subdivision by config.levels, then onto the limit surface when
+// config.limit_surface is set. Polygons are fan-triangulated and faces repeating a
+// vertex are dropped first. Creases are the listed vertex pairs plus, with
+// config.crease_angle > 0, the edges whose faces meet at more than that many degrees
+// in the input. Vertex uvs are interpolated linearly, children keep their face's
+// material and normals are recomputed. Throws std::out_of_range when the result would
+// not fit 32-bit indices. config.type is not consulted; subdivide() dispatches on it.
+template<typename T>
+void loop_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config,
+                      const std::vector<std::pair<core::VertexId, core::VertexId>>& creases) {
+    const std::size_t levels = config.levels;
+    if (mesh.face_count() == 0 || (levels == 0 && !config.limit_surface)) return;
+
+    const auto& source_vertices = mesh.vertices();
+    const auto& source_faces = mesh.faces();
+    const std::size_t vertex_count = source_vertices.size();
+    for (const auto& crease : creases) {
+        if (crease.first >= vertex_count || crease.second >= vertex_count) {
+            throw std::invalid_argument("loop_subdivision: crease vertex out of range");
+        }
+    }
+
+    std::vector<core::VertexId> triangles[2];
+    std::vector<std::uint32_t> source_face;
+    triangles[0].reserve(source_faces.size() * 3);
+    source_face.reserve(source_faces.size());
+    for (std::size_t f = 0; f < source_faces.size(); ++f) {
+        const auto& ids = source_faces[f].vertices;
+        for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+            if (ids[0] == ids[i] || ids[i] == ids[i + 1] || ids[0] == ids[i + 1]) continue;
+            triangles[0].insert(triangles[0].end(), {ids[0], ids[i], ids[i + 1]});
+            source_face.push_back(static_cast<std::uint32_t>(f));
+        }
+    }
+    if (source_face.empty()) return;
+
+    detail::SubdivisionEdges edges;
+    edges.build(triangles[0].data(), detail::TriangleLayout{source_face.size()}, vertex_count);
+
+    // Exact sizes of every level
+    std::vector<std::size_t> vertex_counts(levels + 1);
+    std::vector<std::size_t> edge_counts(levels + 1);
+    std::vector<std::size_t> triangle_counts(levels + 1);
+    vertex_counts[0] = vertex_count;
+    edge_counts[0] = edges.edge_count();
+    triangle_counts[0] = source_face.size();
+    for (std::size_t level = 0; level < levels; ++level) {
+        vertex_counts[level + 1] = vertex_counts[level] + edge_counts[level];
+        edge_counts[level + 1] = edge_counts[level] * 2 + triangle_counts[level] * 3;
+        triangle_counts[level + 1] = triangle_counts[level] * 4;
+        if (vertex_counts[level + 1] > std::numeric_limits<core::VertexId>::max() ||
+            triangle_counts[level + 1] * 3 > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::out_of_range("loop_subdivision: result exceeds 32-bit indices");
+        }
+    }
+
+    // Level l lives in buffer l % 2, so each buffer is reserved for its last level
+    std::vector<math::Vector3<T>> positions[2];
+    std::vector<math::Vector2<T>> uvs[2];
+    for (std::size_t parity = 0; parity < 2; ++parity) {
+        const std::size_t last = levels >= parity ? levels - (levels - parity) % 2 : 0;
+        std::size_t vertex_capacity = vertex_counts[last];
+        if (config.limit_surface && levels % 2 != parity) {
+            vertex_capacity = vertex_counts[levels];
+        }
+        positions[parity].reserve(vertex_capacity);
+        uvs[parity].reserve(vertex_counts[last]);
+        triangles[parity].reserve(triangle_counts[last] * 3);
+    }
+    const std::size_t table_level = config.limit_surface ? levels : levels - 1;
+    edges.reserve(vertex_counts[table_level], edge_counts[table_level], triangle_counts[table_level] * 3);
+
+    positions[0].resize(vertex_count);
+    uvs[0].resize(vertex_count);
+    for (std::size_t v = 0; v < vertex_count; ++v) {
+        positions[0][v] = source_vertices[v].position;
+        uvs[0][v] = source_vertices[v].uv;
+    }
+
+    const detail::LoopStencils<T> stencils;
+    std::vector<std::pair<core::VertexId, core::VertexId>> level_creases = creases;
+    edges.mark_creases(level_creases);
+    if (config.crease_angle > 0.0f) {
+        detail::mark_crease_angle(edges, positions[0].data(), triangles[0].data(),
+                                  detail::TriangleLayout{source_face.size()}, static_cast<T>(config.crease_angle));
+    }
+
+    for (std::size_t level = 0; level < levels; ++level) {
+        const std::size_t in = level % 2;
+        const std::size_t out = 1 - in;
+        if (level > 0) {
+            edges.build(triangles[in].data(), detail::TriangleLayout{triangle_counts[level]}, vertex_counts[level]);
+            edges.mark_creases(level_creases);
+        }
+
+        positions[out].resize(vertex_counts[level + 1]);
+        uvs[out].resize(vertex_counts[level + 1]);
+        triangles[out].resize(triangle_counts[level + 1] * 3);
+        detail::loop_level(edges, stencils, positions[in].data(), uvs[in].data(), vertex_counts[level],
+                           triangles[in].data(), triangle_counts[level],
+                           positions[out].data(), uvs[out].data(), triangles[out].data());
+        edges.split_creases(vertex_counts[level], level_creases);
+    }
+
+    std::size_t result = levels % 2;
+    if (config.limit_surface) {
+        if (levels > 0) {
+            edges.build(triangles[result].data(), detail::TriangleLayout{triangle_counts[levels]}, vertex_counts[levels]);
+            edges.mark_creases(level_creases);
+        }
+        positions[1 - result].resize(vertex_counts[levels]);
+        detail::loop_limit(edges, stencils, positions[result].data(), vertex_counts[levels], positions[1 - result].data());
+        positions[result].swap(positions[1 - result]);
+    }
+
+    const std::vector<math::Vector3<T>>& final_positions = positions[result];
+    const std::vector<math::Vector2<T>>& final_uvs = uvs[result];
+    const std::vector<core::VertexId>& final_triangles = triangles[result];
+
+    std::vector<core::Vertex<T>> vertices(vertex_counts[levels]);
+    utils::parallel_for_range(0, vertices.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            vertices[v].position = final_positions[v];
+            vertices[v].uv = final_uvs[v];
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    // Children of input triangle t are t * 4^levels onwards
+    std::vector<core::Face<T>> faces(triangle_counts[levels]);
+    const std::size_t shift = levels * 2;
+    utils::parallel_for_range(0, faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t t = begin; t < end; ++t) {
+            const core::VertexId* tri = final_triangles.data() + t * 3;
+            faces[t].vertices.assign(tri, tri + 3);
+            faces[t].material_id = source_faces[source_face[t >> shift]].material_id;
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    mesh.assign(std::move(vertices), std::move(faces));
+    mesh.compute_normals();
+}
+
+template<typename T>
+void loop_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config) {
+    loop_subdivision(mesh, config, {});
+}
+
+template<typename T>
+void loop_subdivision(core::Mesh<T>& mesh, std::size_t levels) {
+    SubdivisionConfig config;
+    config.levels = levels;
+    loop_subdivision(mesh, config, {});
+}
+
+// Catmull-Clark subdivision (Catmull & Clark 1978, with the sharp-edge rules above),
+// split into a topology stage run once and an evaluation stage run per set of control
+// positions. CatmullClarkRefiner refines the cage's connectivity and composes the rules
+// of every level, and the limit projection, into one sparse stencil per refined vertex
+// over the control vertices. Evaluating new control positions, e.g. every frame of an
+// animation, is then a single parallel sparse matrix-vector product. Each level keeps
+// the V vertex points first, then adds one point per edge and one per face, and splits
+// every n-gon into n quads.
+
+namespace detail {
+
+// Sparse weights over the control vertices: refined vertex r is the sum of
+// weights[k] * control[indices[k]] for k in offsets[r] .. offsets[r + 1]
+template<typename T>
+struct StencilTable {
+    std::vector<std::size_t> offsets;
+    std::vector<std::uint32_t> indices;
+    std::vector<T> weights;
+
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// Stencils of rows new vertices. local(r, emit) calls emit(i, w) for each source i that
+// row r uses with weight w, and expand(i, w, add) calls add(c, weight) for the control
+// vertices c making up w times source i. Repeated control vertices are merged and
+// every row is sorted by index.
+template<typename T, typename Local, typename Expand>
+StencilTable<T> compose_stencils(std::size_t rows, std::size_t control_count, const Local& local,
+                                 const Expand& expand) {
+    struct Part {
+        std::vector<std::uint32_t> indices;
+        std::vector<T> weights;
+    };
+    std::vector<Part> parts(utils::parallel_chunk_count(rows, SUBDIVISION_MIN_CHUNK));
+
+    StencilTable<T> table;
+    table.offsets.assign(rows + 1, 0);
+    utils::parallel_for_range(0, rows, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        // Dense accumulator over the control vertices; stamps mark the slots the
+        // current row has touched, so nothing is cleared between rows
+        std::vector<T> sums(control_count);
+        std::vector<std::size_t> stamps(control_count, 0);
+        std::vector<std::uint32_t> touched;
+        Part& part = parts[chunk];
+
+        for (std::size_t r = begin; r < end; ++r) {
+            const auto add = [&](std::uint32_t c, T w) {
+                if (stamps[c] != r + 1) {
+                    stamps[c] = r + 1;
+                    sums[c] = T(0);
+                    touched.push_back(c);
+                }
+                sums[c] += w;
+            };
+            local(r, [&](std::size_t i, T w) { expand(i, w, add); });
+
+            std::sort(touched.begin(), touched.end());
+            for (std::uint32_t c : touched) {
+                part.indices.push_back(c);
+                part.weights.push_back(sums[c]);
+            }
+            table.offsets[r + 1] = touched.size();
+            touched.clear();
+        }
+    }, SUBDIVISION_MIN_CHUNK);
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        table.offsets[r + 1] += table.offsets[r];
+    }
+    table.indices.resize(table.offsets[rows]);
+    table.weights.resize(table.offsets[rows]);
+    utils::parallel_for_range(0, rows, [&](std::size_t begin, std::size_t, std::size_t chunk) {
+        Part& part = parts[chunk];
+        std::copy(part.indices.begin(), part.indices.end(), table.indices.begin() + table.offsets[begin]);
+        std::copy(part.weights.begin(), part.weights.end(), table.weights.begin() + table.offsets[begin]);
+        part = Part();
+    }, SUBDIVISION_MIN_CHUNK);
+    return table;
+}
+
+// Calls add for w times row i of table
+template<typename T, typename Add>
+void expand_stencil(const StencilTable<T>& table, std::size_t i, T w, const Add& add) {
+    for (std::size_t k = table.offsets[i]; k < table.offsets[i + 1]; ++k) {
+        add(table.indices[k], w * table.weights[k]);
+    }
+}
+
+enum class CatmullClarkRule { SMOOTH, CREASE, CORNER };
+
+// Refinement rules of one level as weights on its vertices. Face, edge and vertex
+// points are emitted scaled, so rules can nest; the limit point of a vertex is built
+// from the next level's points around it, where every face is a quad. With
+// tagged_faces, face points are emitted whole as FACE_POINT | f instead of as their
+// corners, for callers that have their stencils already.
+template<typename T, typename Layout>
+struct CatmullClarkRules {
+    static constexpr std::size_t FACE_POINT = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+
+    const SubdivisionEdges& edges;
+    const core::VertexId* corners;
+    Layout layout;
+    bool tagged_faces;
+
+    CatmullClarkRule rule(std::size_t v, std::uint32_t (&sharp_edges)[2]) const {
+        const std::size_t sharp = sharp_edges_at(edges, v, sharp_edges);
+        if (edges.offsets[v + 1] == edges.offsets[v] || sharp > 2) return CatmullClarkRule::CORNER;
+        if (sharp == 2) return CatmullClarkRule::CREASE;
+        // A lone boundary or non-manifold edge leaves no consistent fan of faces
+        if (sharp == 1 && (edges.sharp[sharp_edges[0]] & SUBDIVISION_EDGE_NON_MANIFOLD)) {
+            return CatmullClarkRule::CORNER;
+        }
+        return CatmullClarkRule::SMOOTH;
+    }
+
+    template<typename Emit>
+    void face_point(std::size_t f, T scale, const Emit& emit) const {
+        if (tagged_faces) {
+            emit(FACE_POINT | f, scale);
+            return;
+        }
+        const std::size_t first = layout.begin(f);
+        const std::size_t size = layout.size(f);
+        const T w = scale / T(size);
+        for (std::size_t k = 0; k < size; ++k) {
+            emit(corners[first + k], w);
+        }
+    }
+
+    // Both faces of smooth edge e
+    template<typename Emit>
+    void edge_faces(std::size_t e, T scale, const Emit& emit) const {
+        face_point(layout.face_of(edges.edge_corners[e][0]), scale, emit);
+        face_point(layout.face_of(edges.edge_corners[e][1]), scale, emit);
+    }
+
+    template<typename Emit>
+    void edge_point(std::size_t e, T scale, const Emit& emit) const {
+        const auto& ends = edges.ends[e];
+        if (edges.sharp[e]) {
+            emit(ends[0], scale * T(0.5));
+            emit(ends[1], scale * T(0.5));
+            return;
+        }
+        emit(ends[0], scale * T(0.25));
+        emit(ends[1], scale * T(0.25));
+        edge_faces(e, scale * T(0.25), emit);
+    }
+
+    // Smooth: ((n - 2) v + (sum of neighbors + sum of face points) / n) / n. Every
+    // face around v shares two of its edges, so summing both faces of each edge
+    // counts each face point twice.
+    template<typename Emit>
+    void vertex_point(std::size_t v, T scale, const Emit& emit) const {
+        std::uint32_t sharp_edges[2];
+        switch (rule(v, sharp_edges)) {
+        case CatmullClarkRule::CORNER:
+            emit(v, scale);
+            return;
+        case CatmullClarkRule::CREASE:
+            emit(v, scale * T(0.75));
+            emit(edges.other(sharp_edges[0], v), scale * T(0.125));
+            emit(edges.other(sharp_edges[1], v), scale * T(0.125));
+            return;
+        case CatmullClarkRule::SMOOTH:
+            break;
+        }
+        const T n = T(edges.offsets[v + 1] - edges.offsets[v]);
+        const T ring = scale / (n * n);
+        emit(v, scale * (n - T(2)) / n);
+        for (std::size_t slot = edges.offsets[v]; slot < edges.offsets[v + 1]; ++slot) {
+            emit(edges.neighbors[slot], ring);
+            edge_faces(edges.row_edges[slot], ring * T(0.5), emit);
+        }
+    }
+
+    // Smooth: (n^2 v' + 4 * sum of edge points + sum of face points) / (n (n + 5)) on
+    // the next level; along a crease, the cubic B-spline limit (e'_a + 4 v' + e'_b) / 6
+    template<typename Emit>
+    void limit_point(std::size_t v, const Emit& emit) const {
+        std::uint32_t sharp_edges[2];
+        switch (rule(v, sharp_edges)) {
+        case CatmullClarkRule::CORNER:
+            emit(v, T(1));
+            return;
+        case CatmullClarkRule::CREASE:
+            vertex_point(v, T(4) / T(6), emit);
+            edge_point(sharp_edges[0], T(1) / T(6), emit);
+            edge_point(sharp_edges[1], T(1) / T(6), emit);
+            return;
+        case CatmullClarkRule::SMOOTH:
+            break;
+        }
+        const T n = T(edges.offsets[v + 1] - edges.offsets[v]);
+        const T scale = T(1) / (n * (n + T(5)));
+        vertex_point(v, n * n * scale, emit);
+        for (std::size_t slot = edges.offsets[v]; slot < edges.offsets[v + 1]; ++slot) {
+            const std::uint32_t edge = edges.row_edges[slot];
+            edge_point(edge, T(4) * scale, emit);
+            edge_faces(edge, scale * T(0.5), emit);
+        }
+    }
+};
+
+} // namespace detail
+
+// Refined connectivity and composed stencils of a Catmull-Clark control cage. Faces
+// with fewer than three corners or a repeated vertex are left out of the cage. Creases
+// are the listed vertex pairs plus, with config.crease_angle > 0, the edges whose faces
+// meet at more than that many degrees in the cage as given to the constructor.
+template<typename T>
+class CatmullClarkRefiner {
+public:
+    CatmullClarkRefiner(const core::Mesh<T>& control, const SubdivisionConfig& config,
+                        const std::vector<std::pair<core::VertexId, core::VertexId>>& creases = {})
+        : control_count_(control.vertex_count()) {
+        const auto& faces = control.faces();
+        for (const auto& crease : creases) {
+            if (crease.first >= control_count_ || crease.second >= control_count_) {
+                throw std::invalid_argument("CatmullClarkRefiner: crease vertex out of range");
+            }
+        }
+
+        std::vector<std::size_t> offsets(1, 0);
+        std::vector<core::VertexId> corners;
+        std::vector<std::uint32_t> corner_faces;
+        std::vector<std::uint32_t> kept_faces;
+        for (std::size_t f = 0; f < faces.size(); ++f) {
+            const auto& ids = faces[f].vertices;
+            bool repeated = ids.size() < 3;
+            for (std::size_t i = 0; i < ids.size() && !repeated; ++i) {
+                repeated = std::find(ids.begin() + i + 1, ids.end(), ids[i]) != ids.end();
+            }
+            if (repeated) continue;
+            corners.insert(corners.end(), ids.begin(), ids.end());
+            corner_faces.insert(corner_faces.end(), ids.size(), static_cast<std::uint32_t>(kept_faces.size()));
+            offsets.push_back(corners.size());
+            kept_faces.push_back(static_cast<std::uint32_t>(f));
+        }
+        const detail::PolygonLayout polygons{offsets.data(), corner_faces.data(), kept_faces.size()};
+
+        const std::size_t levels = config.levels;
+        detail::SubdivisionEdges edges;
+        std::vector<std::pair<core::VertexId, core::VertexId>> level_creases = creases;
+        std::vector<core::VertexId> quads;
+        std::size_t vertex_count = control_count_;
+        bool composed = false;
+
+        // Topology of one level, then either its refinement or the limit projection
+        auto run_level = [&](std::size_t level, const core::VertexId* level_corners, const auto& layout) {
+            edges.build(level_corners, layout, vertex_count);
+            edges.mark_creases(level_creases);
+            if (level == 0 && config.crease_angle > 0.0f) {
+                std::vector<math::Vector3<T>> positions(control_count_);
+                for (std::size_t v = 0; v < control_count_; ++v) {
+                    positions[v] = control.vertices()[v].position;
+                }
+                detail::mark_crease_angle(edges, positions.data(), level_corners, layout,
+                                          static_cast<T>(config.crease_angle));
+            }
+
+            // Face points first, so the other rows can use their stencils whole
+            using Rules = detail::CatmullClarkRules<T, std::decay_t<decltype(layout)>>;
+            const std::size_t face_count = layout.face_count();
+            const detail::StencilTable<T> previous = std::move(stencils_);
+            const auto expand_vertex = [&](std::size_t i, T w, const auto& add) {
+                if (composed) {
+                    detail::expand_stencil(previous, i, w, add);
+                } else {
+                    add(static_cast<std::uint32_t>(i), w);
+                }
+            };
+            const Rules corner_rules{edges, level_corners, layout, false};
+            const detail::StencilTable<T> face_points = detail::compose_stencils<T>(
+                face_count, control_count_,
+                [&](std::size_t f, const auto& emit) { corner_rules.face_point(f, T(1), emit); }, expand_vertex);
+            const Rules rules{edges, level_corners, layout, true};
+            const auto expand = [&](std::size_t i, T w, const auto& add) {
+                if (i & Rules::FACE_POINT) {
+                    detail::expand_stencil(face_points, i & ~Rules::FACE_POINT, w, add);
+                } else {
+                    expand_vertex(i, w, add);
+                }
+            };
+
+            if (level == levels) {
+                stencils_ = detail::compose_stencils<T>(
+                    vertex_count, control_count_,
+                    [&](std::size_t v, const auto& emit) { rules.limit_point(v, emit); }, expand);
+                composed = true;
+                return;
+            }
+
+            const std::size_t edge_count = edges.edge_count();
+            const std::size_t rows = vertex_count + edge_count + face_count;
+            if (rows > std::numeric_limits<core::VertexId>::max() ||
+                layout.corner_count() * 4 > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::out_of_range("CatmullClarkRefiner: result exceeds 32-bit indices");
+            }
+            stencils_ = detail::compose_stencils<T>(rows, control_count_, [&](std::size_t r, const auto& emit) {
+                if (r < vertex_count) {
+                    rules.vertex_point(r, T(1), emit);
+                } else if (r < vertex_count + edge_count) {
+                    rules.edge_point(r - vertex_count, T(1), emit);
+                } else {
+                    rules.face_point(r - vertex_count - edge_count, T(1), emit);
+                }
+            }, expand);
+            composed = true;
+
+            // Child quad c of face f starts at its corner c: (corner, next edge point,
+            // face point, previous edge point)
+            std::vector<core::VertexId> children(layout.corner_count() * 4);
+            utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+                for (std::size_t f = begin; f < end; ++f) {
+                    const std::size_t first = layout.begin(f);
+                    const std::size_t size = layout.size(f);
+                    const auto face_point = static_cast<core::VertexId>(vertex_count + edge_count + f);
+                    for (std::size_t k = 0; k < size; ++k) {
+                        const std::size_t c = first + k;
+                        const std::size_t previous_corner = first + (k + size - 1) % size;
+                        core::VertexId* quad = children.data() + c * 4;
+                        quad[0] = level_corners[c];
+                        quad[1] = static_cast<core::VertexId>(vertex_count + edges.corner_edges[c]);
+                        quad[2] = face_point;
+                        quad[3] = static_cast<core::VertexId>(vertex_count + edges.corner_edges[previous_corner]);
+                    }
+                }
+            }, SUBDIVISION_MIN_CHUNK);
+            quads.swap(children);
+            edges.split_creases(vertex_count, level_creases);
+            vertex_count = rows;
+        };
+
+        for (std::size_t level = 0; level < levels + (config.limit_surface ? 1 : 0); ++level) {
+            if (level == 0) {
+                run_level(level, corners.data(), polygons);
+            } else {
+                run_level(level, quads.data(), detail::QuadLayout{quads.size() / 4});
+            }
+        }
+
+        if (!composed) {
+            stencils_.offsets.resize(control_count_ + 1);
+            stencils_.indices.resize(control_count_);
+            stencils_.weights.assign(control_count_, T(1));
+            for (std::size_t v = 0; v < control_count_; ++v) {
+                stencils_.offsets[v] = v;
+                stencils_.indices[v] = static_cast<std::uint32_t>(v);
+            }
+            stencils_.offsets[control_count_] = control_count_;
+        }
+
+        // Refined faces and the control face each comes from; the quads of level l + 1
+        // are numbered by the corners of level l
+        if (levels == 0) {
+            face_offsets_ = std::move(offsets);
+            face_corners_ = std::move(corners);
+            source_faces_ = std::move(kept_faces);
+            return;
+        }
+        const std::size_t quad_count = quads.size() / 4;
+        const std::size_t shift = (levels - 1) * 2;
+        face_offsets_.resize(quad_count + 1);
+        source_faces_.resize(quad_count);
+        utils::parallel_for_range(0, quad_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t q = begin; q < end; ++q) {
+                face_offsets_[q] = q * 4;
+                source_faces_[q] = kept_faces[corner_faces[q >> shift]];
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+        face_offsets_[quad_count] = quad_count * 4;
+        face_corners_ = std::move(quads);
+    }
+
+    std::size_t control_count() const { return control_count_; }
+    std::size_t vertex_count() const { return stencils_.size(); }
+    std::size_t face_count() const { return source_faces_.size(); }
+    const detail::StencilTable<T>& stencils() const { return stencils_; }
+
+    // refined[r] = sum of stencil weights times control values, for any value type
+    // with + and * T (positions, uvs); refined holds vertex_count() values
+    template<typename Value>
+    void evaluate(const Value* control, Value* refined) const {
+        apply<Value>([&](std::size_t i) -> const Value& { return control[i]; },
+                     [&](std::size_t r, const Value& value) { refined[r] = value; });
+    }
+
+    // Moves the vertices of a mesh made by refine() to the stencils applied to the
+    // control mesh's current positions, and recomputes its normals
+    void update(const core::Mesh<T>& control, core::Mesh<T>& refined) const {
+        if (control.vertex_count() != control_count_ || refined.vertex_count() != vertex_count()) {
+            throw std::invalid_argument("CatmullClarkRefiner: mesh does not match the refined topology");
+        }
+        const core::Vertex<T>* source = control.vertices().data();
+        refined.update_vertices([&](core::Vertex<T>* vertices, std::size_t) {
+            apply<math::Vector3<T>>([&](std::size_t i) -> const math::Vector3<T>& { return source[i].position; },
+                                    [&](std::size_t r, const math::Vector3<T>& p) { vertices[r].position = p; });
+        });
+        refined.compute_normals();
+    }
+
+    // Replaces refined with the refined mesh of control; the two may be the same mesh.
+    // Positions and uvs come from the stencils, faces keep the material of the control
+    // face they came from, and normals are recomputed.
+    void refine(const core::Mesh<T>& control, core::Mesh<T>& refined) const {
+        if (control.vertex_count() != control_count_) {
+            throw std::invalid_argument("CatmullClarkRefiner: mesh does not match the control cage");
+        }
+        const auto& source = control.vertices();
+        std::vector<core::Vertex<T>> vertices(vertex_count());
+        apply<math::Vector3<T>>([&](std::size_t i) -> const math::Vector3<T>& { return source[i].position; },
+                                [&](std::size_t r, const math::Vector3<T>& p) { vertices[r].position = p; });
+        apply<math::Vector2<T>>([&](std::size_t i) -> const math::Vector2<T>& { return source[i].uv; },
+                                [&](std::size_t r, const math::Vector2<T>& uv) { vertices[r].uv = uv; });
+
+        const auto& source_faces = control.faces();
+        std::vector<core::Face<T>> faces(face_count());
+        utils::parallel_for_range(0, faces.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                faces[f].vertices.assign(face_corners_.begin() + face_offsets_[f],
+                                         face_corners_.begin() + face_offsets_[f + 1]);
+                faces[f].material_id = source_faces[source_faces_[f]].material_id;
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+
+        refined.assign(std::move(vertices), std::move(faces));
+        refined.compute_normals();
+    }
+
+private:
+    template<typename Value, typename Get, typename Set>
+    void apply(const Get& get, const Set& set) const {
+        const auto& offsets = stencils_.offsets;
+        const std::uint32_t* indices = stencils_.indices.data();
+        const T* weights = stencils_.weights.data();
+        utils::parallel_for_range(0, vertex_count(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t r = begin; r < end; ++r) {
+                Value sum(T(0));
+                for (std::size_t k = offsets[r]; k < offsets[r + 1]; ++k) {
+                    sum = sum + get(indices[k]) * weights[k];
+                }
+                set(r, sum);
+            }
+        }, SUBDIVISION_MIN_CHUNK);
+    }
+
+    std::size_t control_count_;
+    detail::StencilTable<T> stencils_;
+    std::vector<std::size_t> face_offsets_;
+    std::vector<core::VertexId> face_corners_;
+    std::vector<std::uint32_t> source_faces_;
+};
+
+// Catmull-Clark subdivision by config.levels, then onto the limit surface when
+// config.limit_surface is set; see CatmullClarkRefiner. To re-evaluate the same cage
+// with new positions, keep a refiner and call update() instead. Like
+// loop_subdivision, it ignores config.type.
+template<typename T>
+void catmull_clark_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config,
+                               const std::vector<std::pair<core::VertexId, core::VertexId>>& creases) {
+    if (mesh.face_count() == 0 || (config.levels == 0 && !config.limit_surface)) return;
+    const CatmullClarkRefiner<T> refiner(mesh, config, creases);
+    refiner.refine(mesh, mesh);
+}
+
+template<typename T>
+void catmull_clark_subdivision(core::Mesh<T>& mesh, const SubdivisionConfig& config) {
+    catmull_clark_subdivision(mesh, config, {});
+}
+
+template<typename T>
+void catmull_clark_subdivision(core::Mesh<T>& mesh, std::size_t levels) {
+    SubdivisionConfig config;
+    config.type = SubdivisionConfig::CATMULL_CLARK;
+    config.levels = levels;
+    catmull_clark_subdivision(mesh, config, {});
+}
+
+// Runs the scheme selected by config.type
+template<typename T>
+void subdivide(core::Mesh<T>& mesh, const SubdivisionConfig& config,
+               const std::vector<std::pair<core::VertexId, core::VertexId>>& creases) {
+    if (config.type == SubdivisionConfig::CATMULL_CLARK) {
+        catmull_clark_subdivision(mesh, config, creases);
+    } else {
+        loop_subdivision(mesh, config, creases);
+    }
+}
+
+template<typename T>
+void subdivide(core::Mesh<T>& mesh, const SubdivisionConfig& config) {
+    subdivide(mesh, config, {});
+}
+
+} // namespace processing
+} // namespace algorithms
+} // namespace polygon_mesh
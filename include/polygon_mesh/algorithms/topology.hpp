@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <polygon_mesh/algorithms/components.hpp>
+#include <polygon_mesh/algorithms/face_sides.hpp>
+#include <polygon_mesh/algorithms/mesh_processing.hpp>
+#include <polygon_mesh/algorithms/union_find.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace analysis {
+
+// Surface topology without an edge table. Face sides are radix sorted on their lower
+// vertex with one parallel counting pass, leaving only the higher vertex (32 bits) per
+// side in the bucket of the lower one; buckets are then sorted and scanned in
+// parallel. A run of length one is a boundary edge, and boundary edges are joined in
+// a concurrent union-find to count boundary loops. Components come from
+// connected_components with vertex adjacency, and every count is charged to a vertex:
+// the vertex itself and the edges and loop roots in its bucket.
+
+// Minimum faces (or vertices) per thread
+constexpr std::size_t TOPOLOGY_MIN_CHUNK = 16384;
+
+namespace detail {
+
+constexpr std::uint32_t TOPOLOGY_NO_LABEL = std::numeric_limits<std::uint32_t>::max();
+
+// Counts of one vertex range that all belong to the same component
+struct TopologyRun {
+    std::uint32_t label;
+    std::size_t vertices;
+    std::size_t edges;
+    std::size_t boundary_loops;
+};
+
+inline void add_to_run(std::vector<TopologyRun>& runs, std::uint32_t label, std::size_t vertices, std::size_t edges,
+                       std::size_t loops) {
+    if (runs.empty() || runs.back().label != label) runs.push_back(TopologyRun{label, 0, 0, 0});
+    runs.back().vertices += vertices;
+    runs.back().edges += edges;
+    runs.back().boundary_loops += loops;
+}
+
+} // namespace detail
+
+template<typename T>
+TopologyReport analyze_topology(const core::Mesh<T>& mesh) {
+    TopologyReport report;
+    const auto& faces = mesh.faces();
+    const std::size_t face_count = faces.size();
+    const std::size_t vertex_count = mesh.vertex_count();
+    if (face_count == 0) return report;
+
+    const ConnectedComponents<T> components = connected_components(mesh);
+    report.components.resize(components.size());
+
+    // Component of every vertex used by a face; all faces around a vertex agree
+    std::unique_ptr<std::atomic<std::uint32_t>[]> vertex_labels(new std::atomic<std::uint32_t>[vertex_count]);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            vertex_labels[v].store(detail::TOPOLOGY_NO_LABEL, std::memory_order_relaxed);
+        }
+    }, TOPOLOGY_MIN_CHUNK);
+
+    utils::parallel_for_range(0, face_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t f = begin; f < end; ++f) {
+            for (core::VertexId id : faces[f].vertices) {
+                vertex_labels[id].store(components.face_labels[f], std::memory_order_relaxed);
+            }
+        }
+    }, TOPOLOGY_MIN_CHUNK);
+
+    // Higher vertex of every face side, bucketed by the lower one
+    auto buckets = algorithms::detail::bucket_face_sides(mesh, TOPOLOGY_MIN_CHUNK);
+    const auto& bucket_offsets = buckets.offsets;
+    auto& higher = buckets.entries;
+
+    // Edges per bucket, and boundary edges at every vertex
+    std::unique_ptr<std::atomic<std::uint32_t>[]> boundary_degree(new std::atomic<std::uint32_t>[vertex_count]());
+    std::vector<std::vector<detail::TopologyRun>> runs(utils::parallel_chunk_count(vertex_count, TOPOLOGY_MIN_CHUNK));
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        for (std::size_t v = begin; v < end; ++v) {
+            const std::uint32_t label = vertex_labels[v].load(std::memory_order_relaxed);
+            if (label == detail::TOPOLOGY_NO_LABEL) continue;
+
+            const auto first = higher.begin() + bucket_offsets[v];
+            const auto last = higher.begin() + bucket_offsets[v + 1];
+            std::sort(first, last);
+            std::size_t edges = 0;
+            for (auto it = first; it != last;) {
+                auto run = it + 1;
+                while (run != last && *run == *it) ++run;
+                if (run - it == 1) {
+                    boundary_degree[v].fetch_add(1, std::memory_order_relaxed);
+                    boundary_degree[*it].fetch_add(1, std::memory_order_relaxed);
+                }
+                ++edges;
+                it = run;
+            }
+            detail::add_to_run(runs[chunk], label, 1, edges, 0);
+        }
+    }, TOPOLOGY_MIN_CHUNK);
+
+    // Boundary edges are named by their slot in the buckets and joined into loops with
+    // the next boundary edge around each end. A vertex on two boundary edges joins
+    // them; where loops touch at a vertex, they are followed across the gaps between
+    // its face fans.
+    ConcurrentUnionFind loops(higher.size());
+    auto edge_slot = [&](core::VertexId a, core::VertexId b) {
+        const auto first = higher.begin() + bucket_offsets[std::min(a, b)];
+        const auto last = higher.begin() + bucket_offsets[std::min(a, b) + 1];
+        return static_cast<std::uint32_t>(std::lower_bound(first, last, std::max(a, b)) - higher.begin());
+    };
+    const std::uint32_t no_edge = std::numeric_limits<std::uint32_t>::max();
+    std::unique_ptr<std::atomic<std::uint32_t>[]> waiting(new std::atomic<std::uint32_t>[vertex_count]);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) waiting[v].store(no_edge, std::memory_order_relaxed);
+    }, TOPOLOGY_MIN_CHUNK);
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t v = begin; v < end; ++v) {
+            for (std::size_t k = bucket_offsets[v]; k < bucket_offsets[v + 1];) {
+                std::size_t run = k + 1;
+                while (run < bucket_offsets[v + 1] && higher[run] == higher[k]) ++run;
+                if (run - k == 1) {
+                    for (core::VertexId x : {static_cast<core::VertexId>(v), higher[k]}) {
+                        if (boundary_degree[x].load(std::memory_order_relaxed) != 2) continue;
+                        const std::uint32_t other = waiting[x].exchange(static_cast<std::uint32_t>(k), std::memory_order_relaxed);
+                        if (other != no_edge) loops.unite(other, static_cast<std::uint32_t>(k));
+                    }
+                }
+                k = run;
+            }
+        }
+    }, TOPOLOGY_MIN_CHUNK);
+
+    std::vector<core::VertexId> pinched(vertex_count);
+    pinched.resize(utils::parallel_compact(vertex_count,
+        [&](std::size_t v) { return boundary_degree[v].load(std::memory_order_relaxed) > 2; },
+        [&](std::size_t v, std::size_t position) { pinched[position] = static_cast<core::VertexId>(v); },
+        TOPOLOGY_MIN_CHUNK));
+    if (!pinched.empty()) {
+        // The corners at each pinched vertex, as the neighbors before and after it
+        std::vector<std::uint32_t> slot(vertex_count, no_edge);
+        for (std::size_t i = 0; i < pinched.size(); ++i) slot[pinched[i]] = static_cast<std::uint32_t>(i);
+        std::vector<std::vector<std::pair<core::VertexId, core::VertexId>>> corners(pinched.size());
+        for (const auto& face : faces) {
+            const auto& ids = face.vertices;
+            for (std::size_t i = 0, n = ids.size(); i < n; ++i) {
+                if (slot[ids[i]] == no_edge) continue;
+                const core::VertexId before = ids[i == 0 ? n - 1 : i - 1];
+                const core::VertexId after = ids[i + 1 == n ? 0 : i + 1];
+                if (before != ids[i] && after != ids[i]) corners[slot[ids[i]]].emplace_back(before, after);
+            }
+        }
+
+        // Corners sharing an inner edge form a fan. A loop reaches the vertex along the
+        // fan's boundary edge to a neighbor after it and leaves along the boundary edge
+        // to a neighbor before it in the previous fan counterclockwise.
+        const auto& vertices = mesh.vertices();
+        std::vector<std::pair<core::VertexId, std::uint32_t>> ends;
+        std::vector<std::uint32_t> fan;
+        struct Fan {
+            core::VertexId into, out;
+            std::uint32_t ins, outs;
+            T angle;
+        };
+        std::vector<Fan> fans;
+        std::vector<Fan> open;
+        for (std::size_t i = 0; i < pinched.size(); ++i) {
+            const core::VertexId center = pinched[i];
+            const auto& around = corners[i];
+            ends.clear();
+            for (std::uint32_t c = 0; c < around.size(); ++c) {
+                ends.emplace_back(around[c].first, 2 * c);
+                ends.emplace_back(around[c].second, 2 * c + 1);
+            }
+            std::sort(ends.begin(), ends.end());
+            fan.resize(around.size());
+            for (std::uint32_t c = 0; c < fan.size(); ++c) fan[c] = c;
+            auto root = [&](std::uint32_t c) {
+                while (fan[c] != c) c = fan[c] = fan[fan[c]];
+                return c;
+            };
+            for (std::size_t k = 1; k < ends.size(); ++k) {
+                if (ends[k].first == ends[k - 1].first) fan[root(ends[k].second / 2)] = root(ends[k - 1].second / 2);
+            }
+
+            fans.assign(around.size(), Fan{0, 0, 0, 0, T(0)});
+            for (std::size_t k = 0; k < ends.size(); ++k) {
+                const bool single = (k == 0 || ends[k - 1].first != ends[k].first) &&
+                                    (k + 1 == ends.size() || ends[k + 1].first != ends[k].first);
+                if (!single) continue;
+                Fan& f = fans[root(ends[k].second / 2)];
+                if (ends[k].second % 2) {
+                    if (f.ins++ == 0) f.into = ends[k].first;
+                    else loops.unite(edge_slot(center, f.into), edge_slot(center, ends[k].first));
+                } else {
+                    if (f.outs++ == 0) f.out = ends[k].first;
+                    else loops.unite(edge_slot(center, f.out), edge_slot(center, ends[k].first));
+                }
+            }
+
+            // Fans in counterclockwise order, measured from the first one entered
+            const auto& p = vertices[center].position;
+            math::Vector3<T> normal(T(0));
+            for (const auto& corner : around) {
+                normal += (vertices[corner.second].position - p).cross(vertices[corner.first].position - p);
+            }
+            open.clear();
+            for (const Fan& f : fans) {
+                if (f.ins != 0 && f.outs != 0) open.push_back(f);
+            }
+            if (open.empty()) continue;
+            const math::Vector3<T> reference = vertices[open[0].into].position - p;
+            for (Fan& f : open) {
+                const math::Vector3<T> to = vertices[f.into].position - p;
+                f.angle = std::atan2(normal.dot(reference.cross(to)), reference.dot(to) * normal.length());
+            }
+            std::sort(open.begin(), open.end(), [](const Fan& a, const Fan& b) { return a.angle < b.angle; });
+            for (std::size_t k = 0; k < open.size(); ++k) {
+                const Fan& previous = open[k == 0 ? open.size() - 1 : k - 1];
+                loops.unite(edge_slot(center, open[k].into), edge_slot(center, previous.out));
+            }
+        }
+    }
+
+    // One loop per boundary edge that is its set's root
+    utils::parallel_for_range(0, vertex_count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        for (std::size_t v = begin; v < end; ++v) {
+            for (std::size_t k = bucket_offsets[v]; k < bucket_offsets[v + 1];) {
+                std::size_t run = k + 1;
+                while (run < bucket_offsets[v + 1] && higher[run] == higher[k]) ++run;
+                if (run - k == 1 && loops.find(static_cast<std::uint32_t>(k)) == k) {
+                    detail::add_to_run(runs[chunk], vertex_labels[v].load(std::memory_order_relaxed), 0, 0, 1);
+                }
+                k = run;
+            }
+        }
+    }, TOPOLOGY_MIN_CHUNK);
+
+    for (const auto& chunk_runs : runs) {
+        for (const auto& run : chunk_runs) {
+            auto& component = report.components[run.label];
+            component.vertices += run.vertices;
+            component.edges += run.edges;
+            component.boundary_loops += run.boundary_loops;
+        }
+    }
+
+    for (std::size_t c = 0; c < report.components.size(); ++c) {
+        auto& component = report.components[c];
+        component.faces = components.face_counts[c];
+        component.euler_characteristic = std::int64_t(component.vertices) - std::int64_t(component.edges) +
+                                         std::int64_t(component.faces);
+        component.genus = (2 - std::int64_t(component.boundary_loops) - component.euler_characteristic) / 2;
+
+        report.total.vertices += component.vertices;
+        report.total.edges += component.edges;
+        report.total.faces += component.faces;
+        report.total.boundary_loops += component.boundary_loops;
+        report.total.euler_characteristic += component.euler_characteristic;
+        report.total.genus += component.genus;
+    }
+    return report;
+}
+
+// Sum of the genera of all components, each taken as at least zero
+template<typename T>
+std::size_t compute_genus(const core::Mesh<T>& mesh) {
+    std::size_t genus = 0;
+    for (const auto& component : analyze_topology(mesh).components) {
+        genus += component.genus > 0 ? static_cast<std::size_t>(component.genus) : 0;
+    }
+    return genus;
+}
+
+} // namespace analysis
+} // namespace algorithms
+} // namespace polygon_mesh
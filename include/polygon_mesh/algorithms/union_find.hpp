@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <polygon_mesh/utils/threading.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+
+// Minimum elements per thread while initializing
+constexpr std::size_t UNION_FIND_MIN_CHUNK = 65536;
+
+// Disjoint sets over 0 .. size - 1 that any number of threads may unite and query at
+// once without locks (after Anderson & Woll). A root is linked below a smaller index
+// with one compare-and-swap, so every set's root is its smallest element; finds halve
+// the paths they walk. Results are only stable once all unions have finished, but a
+// union is never lost: a failed link retries from the new roots.
+class ConcurrentUnionFind {
+public:
+    explicit ConcurrentUnionFind(std::size_t size)
+        : parents_(new std::atomic<std::uint32_t>[size]), size_(size) {
+        utils::parallel_for_range(0, size, [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                parents_[i].store(static_cast<std::uint32_t>(i), std::memory_order_relaxed);
+            }
+        }, UNION_FIND_MIN_CHUNK);
+    }
+
+    std::size_t size() const { return size_; }
+
+    std::uint32_t find(std::uint32_t x) const {
+        while (true) {
+            std::uint32_t parent = parents_[x].load(std::memory_order_relaxed);
+            if (parent == x) return x;
+            const std::uint32_t grandparent = parents_[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent) {
+                // Path halving; losing the race only means another thread shortened it
+                parents_[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    // Returns true when a and b were in different sets
+    bool unite(std::uint32_t a, std::uint32_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) std::swap(a, b);
+            std::uint32_t expected = a;
+            if (parents_[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    bool same(std::uint32_t a, std::uint32_t b) const {
+        return find(a) == find(b);
+    }
+
+private:
+    std::unique_ptr<std::atomic<std::uint32_t>[]> parents_;
+    std::size_t size_;
+};
+
+} // namespace algorithms
+} // namespace polygon_mesh
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <polygon_mesh/algorithms/bvh.hpp>
+#include <polygon_mesh/math/simd.hpp>
+
+namespace polygon_mesh {
+namespace algorithms {
+namespace spatial {
+
+// N-ary hierarchy collapsed from a binary BVH. Each wide node is grown from a binary
+// node by repeatedly opening its inner child with the largest surface area until it
+// has N children or only leaves are left, so the levels with the most traffic are
+// removed first; small subtrees are merged into single leaves. Child bounds are
+// stored as six rows of N coordinates, and a ray is tested against all children of a
+// node with one packet per slab; the children it enters are visited nearest first.
+// Leaves stay in the binary tree's leaf order, so the triangles are taken over from it
+// unchanged.
+
+namespace detail {
+
+// Entry distance of the ray into each child box of a wide node, and the lanes it
+// enters before t_max. planes holds the rows of bounds with the near plane on each
+// axis, then the far ones; choosing them by the sign of the direction means
+// a ray in a slab plane with a zero component is inside the slab, and the NaN it
+// produces fails the comparisons and leaves the interval alone, as in intersect_node.
+template<typename T, std::size_t N>
+unsigned intersect_children(const T (&bounds)[6][N], const math::Vector3xN<T, N>& origin,
+                            const math::Vector3xN<T, N>& inverse_direction, const std::size_t (&planes)[6],
+                            T t_max, math::Packet<T, N>& t_entry) {
+    using P = math::Packet<T, N>;
+    P t_near = P::zero();
+    P t_far(t_max);
+    auto slab = [&](std::size_t axis, const P& start, const P& inverse) {
+        const P t0 = (P::load_aligned(bounds[planes[axis]]) - start) * inverse;
+        const P t1 = (P::load_aligned(bounds[planes[axis + 3]]) - start) * inverse;
+        t_near = select(t0 > t_near, t0, t_near);
+        t_far = select(t1 < t_far, t1, t_far);
+    };
+    slab(0, origin.x, inverse_direction.x);
+    slab(1, origin.y, inverse_direction.y);
+    slab(2, origin.z, inverse_direction.z);
+    t_entry = t_near;
+    return (t_near <= t_far * P(T(1) + T(4) * std::numeric_limits<T>::epsilon())).bits();
+}
+
+} // namespace detail
+
+template<typename T, std::size_t N>
+class WideBVH {
+    static_assert(N == 4 || N == 8, "WideBVH: width must be 4 or 8");
+
+public:
+    using Triangle = typename BVH<T>::Triangle;
+
+    // Child bounds in structure-of-arrays order: min x, y, z, then max x, y, z, each
+    // with one lane per child. A leaf child holds triangles child .. child + count; an
+    // inner child names its node and has count 0. Unused slots have an inverted box
+    // and name node 0, which is never a child.
+    struct alignas(sizeof(T) * N) Node {
+        T bounds[6][N];
+        std::uint32_t child[N];
+        std::uint32_t count[N];
+    };
+
+    WideBVH() : mesh_(nullptr) {}
+
+    explicit WideBVH(const core::Mesh<T>& mesh, const BVHConfig& config = BVHConfig()) : mesh_(nullptr) {
+        build(mesh, config);
+    }
+
+    explicit WideBVH(const BVH<T>& bvh) : mesh_(nullptr) { collapse(bvh); }
+
+    // Builds a binary BVH with config and collapses it, keeping its triangles. Throws
+    // what BVH::build throws.
+    void build(const core::Mesh<T>& mesh, const BVHConfig& config = BVHConfig()) {
+        BVH<T> binary(mesh, config);
+        collapse_nodes(binary.nodes_);
+        triangles_ = std::move(binary.triangles_);
+        faces_ = std::move(binary.faces_);
+        mesh_ = binary.mesh_;
+    }
+
+    // Collapses an existing binary BVH, copying its triangles
+    void collapse(const BVH<T>& bvh) {
+        collapse_nodes(bvh.nodes());
+        triangles_ = bvh.triangles();
+        faces_ = bvh.triangle_faces();
+        mesh_ = bvh.mesh();
+    }
+
+    // Same contract as BVH::ray_intersection
+    RayHit<T> ray_intersection(const math::Vector3<T>& ray_origin,
+                               const math::Vector3<T>& ray_direction) const;
+
+    bool empty() const { return nodes_.empty(); }
+    std::size_t triangle_count() const { return triangles_.size(); }
+    const core::Mesh<T>* mesh() const { return mesh_; }
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::vector<Triangle>& triangles() const { return triangles_; }
+    const std::vector<core::FaceId>& triangle_faces() const { return faces_; }
+
+private:
+    using BinaryNode = typename BVH<T>::Node;
+
+    static Node empty_node() {
+        Node node;
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                node.bounds[axis][i] = std::numeric_limits<T>::infinity();
+                node.bounds[axis + 3][i] = -std::numeric_limits<T>::infinity();
+            }
+            node.child[i] = 0;
+            node.count[i] = 0;
+        }
+        return node;
+    }
+
+    void collapse_nodes(const std::vector<BinaryNode>& binary);
+
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    std::vector<core::FaceId> faces_;
+    const core::Mesh<T>* mesh_;
+};
+
+template<typename T>
+using BVH4 = WideBVH<T, 4>;
+
+template<typename T>
+using BVH8 = WideBVH<T, 8>;
+
+template<typename T, std::size_t N>
+void WideBVH<T, N>::collapse_nodes(const std::vector<BinaryNode>& binary) {
+    nodes_.clear();
+    if (binary.empty()) return;
+
+    auto area = [&](std::uint32_t b) {
+        return core::BoundingBox<T>(binary[b].min_point, binary[b].max_point).surface_area();
+    };
+
+    // Triangles under every binary node; nodes follow their parents, and a subtree's
+    // triangles are contiguous starting at those of its leftmost leaf. Subtrees of at
+    // most N triangles become a single leaf, which costs about as much to test as the
+    // wide node it replaces.
+    std::vector<std::uint32_t> sizes(binary.size());
+    std::vector<std::uint32_t> firsts(binary.size());
+    for (std::size_t b = binary.size(); b-- > 0;) {
+        const BinaryNode& node = binary[b];
+        sizes[b] = node.is_leaf() ? node.count : sizes[b + 1] + sizes[node.offset];
+        firsts[b] = node.is_leaf() ? node.offset : firsts[b + 1];
+    }
+    auto is_leaf = [&](std::uint32_t b) { return binary[b].is_leaf() || sizes[b] <= N; };
+
+    // Wide nodes waiting to be filled from the binary node they replace; children of
+    // a node are allocated together so they are adjacent
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pending;
+    nodes_.push_back(empty_node());
+    pending.emplace_back(0, 0);
+    while (!pending.empty()) {
+        const std::uint32_t wide = pending.back().first;
+        const std::uint32_t root_index = pending.back().second;
+        const BinaryNode& root = binary[root_index];
+        pending.pop_back();
+
+        std::uint32_t children[N];
+        std::size_t count = 0;
+        if (root.is_leaf()) {
+            children[count++] = root_index;
+        } else {
+            children[count++] = root_index + 1;
+            children[count++] = root.offset;
+        }
+        while (count < N) {
+            std::size_t widest = count;
+            T widest_area = T(0);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (is_leaf(children[i])) continue;
+                const T child_area = area(children[i]);
+                if (widest == count || child_area > widest_area) {
+                    widest = i;
+                    widest_area = child_area;
+                }
+            }
+            if (widest == count) break;
+            const std::uint32_t opened = children[widest];
+            children[widest] = opened + 1;
+            children[count++] = binary[opened].offset;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const BinaryNode& child = binary[children[i]];
+            std::uint32_t target = firsts[children[i]];
+            if (!is_leaf(children[i])) {
+                target = static_cast<std::uint32_t>(nodes_.size());
+                nodes_.push_back(empty_node());
+                pending.emplace_back(target, children[i]);
+            }
+            Node& node = nodes_[wide];
+            node.bounds[0][i] = child.min_point.x;
+            node.bounds[1][i] = child.min_point.y;
+            node.bounds[2][i] = child.min_point.z;
+            node.bounds[3][i] = child.max_point.x;
+            node.bounds[4][i] = child.max_point.y;
+            node.bounds[5][i] = child.max_point.z;
+            node.child[i] = target;
+            node.count[i] = is_leaf(children[i]) ? sizes[children[i]] : 0;
+        }
+    }
+}
+
+template<typename T, std::size_t N>
+RayHit<T> WideBVH<T, N>::ray_intersection(const math::Vector3<T>& ray_origin,
+                                          const math::Vector3<T>& ray_direction) const {
+    using V = math::Vector3xN<T, N>;
+    if (nodes_.empty()) return detail::ray_miss<T>();
+
+    const math::Vector3<T> inverse(T(1) / ray_direction.x, T(1) / ray_direction.y, T(1) / ray_direction.z);
+    const V origin(ray_origin);
+    const V inverse_direction(inverse);
+    const std::size_t near_x = inverse.x < T(0) ? 3 : 0;
+    const std::size_t near_y = inverse.y < T(0) ? 4 : 1;
+    const std::size_t near_z = inverse.z < T(0) ? 5 : 2;
+    const std::size_t planes[6] = {near_x, near_y, near_z, (near_x + 3) % 6, (near_y + 3) % 6, (near_z + 3) % 6};
+
+    // Children a node's box test accepts are pushed farthest first, so the nearest is
+    // popped next; entries behind the closest hit so far are dropped when popped
+    struct Entry {
+        std::uint32_t child;
+        std::uint32_t count;
+        T entry;
+    };
+    Entry stack[BVH_MAX_DEPTH * (N - 1) + 1];
+    std::size_t stack_size = 0;
+    stack[stack_size++] = Entry{0, 0, T(0)};
+
+    T t_max = std::numeric_limits<T>::infinity();
+    std::size_t hit_triangle = triangles_.size();
+    T hit_u = T(0), hit_v = T(0);
+    const detail::LeafRay<T> ray(ray_origin, ray_direction);
+    while (stack_size > 0) {
+        const Entry current = stack[--stack_size];
+        if (current.entry > t_max) continue;
+
+        if (current.count != 0) {
+            std::size_t i;
+            if (ray.intersect(triangles_.data() + current.child, current.count, t_max, i, hit_u, hit_v)) {
+                hit_triangle = current.child + i;
+            }
+            continue;
+        }
+
+        const Node& node = nodes_[current.child];
+        math::Packet<T, N> t_entry;
+        const unsigned hits = detail::intersect_children(node.bounds, origin, inverse_direction, planes, t_max, t_entry);
+        if (hits == 0) continue;
+        alignas(sizeof(T) * N) T entries[N];
+        t_entry.store_aligned(entries);
+
+        const std::size_t first = stack_size;
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            if (!((hits >> lane) & 1u) || (node.child[lane] == 0 && node.count[lane] == 0)) continue;
+            Entry entry{node.child[lane], node.count[lane], entries[lane]};
+            std::size_t i = stack_size++;
+            for (; i > first && stack[i - 1].entry < entry.entry; --i) stack[i] = stack[i - 1];
+            stack[i] = entry;
+        }
+    }
+
+    if (hit_triangle == triangles_.size()) return detail::ray_miss<T>();
+    const Triangle& triangle = triangles_[hit_triangle];
+    return detail::ray_hit(ray_origin, ray_direction, triangle.edge1, triangle.edge2, t_max, hit_u, hit_v,
+                           faces_[hit_triangle]);
+}
+
+} // namespace spatial
+} // namespace algorithms
+} // namespace polygon_mesh
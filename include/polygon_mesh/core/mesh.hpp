@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -7,10 +9,28 @@
 #include <stdexcept>
 #include <polygon_mesh/core/types.hpp>
 #include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/math/matrix4.hpp>
+#include <polygon_mesh/math/transform.hpp>
+#include <polygon_mesh/math/normalize.hpp>
+#include <polygon_mesh/math/bounds.hpp>
+#include <polygon_mesh/utils/threading.hpp>
 
 namespace polygon_mesh {
 namespace core {
 
+namespace detail {
+
+// Process-wide source of mesh versions. Every mutation, construction and assignment
+// draws a fresh value, so a (mesh address, version) pair never repeats for different
+// contents, even after one mesh is assigned over another.
+inline std::atomic<std::uint64_t> mesh_version_counter{0};
+
+inline std::uint64_t next_mesh_version() {
+    return mesh_version_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace detail
+
 template<typename T>
 class Mesh {
 private:
@@ -31,17 +51,66 @@ private:
     mutable bool bounding_box_dirty_;
     mutable BoundingBox<T> bounding_box_;
 
+    // Renewed whenever vertex positions may have changed; lets derived data
+    // (bounding volume hierarchies, cached operators) detect staleness cheaply
+    std::uint64_t position_version_;
+
+    // Renewed whenever faces are added, removed or re-indexed
+    std::uint64_t topology_version_;
+
 public:
     // Constructors
-    Mesh() : topology_valid_(true), bounding_box_dirty_(true) {}
+    Mesh() : topology_valid_(true), bounding_box_dirty_(true),
+             position_version_(detail::next_mesh_version()),
+             topology_version_(detail::next_mesh_version()) {}
     
-    // Copy constructor
-    Mesh(const Mesh& other) = default;
-    Mesh& operator=(const Mesh& other) = default;
+    // Copy constructor; versions are never copied, the copy gets fresh ones
+    Mesh(const Mesh& other)
+        : vertices_(other.vertices_), edges_(other.edges_), faces_(other.faces_),
+          edge_map_(other.edge_map_), topology_valid_(other.topology_valid_),
+          bounding_box_dirty_(other.bounding_box_dirty_), bounding_box_(other.bounding_box_),
+          position_version_(detail::next_mesh_version()),
+          topology_version_(detail::next_mesh_version()) {}
+
+    Mesh& operator=(const Mesh& other) {
+        if (this != &other) {
+            vertices_ = other.vertices_;
+            edges_ = other.edges_;
+            faces_ = other.faces_;
+            edge_map_ = other.edge_map_;
+            topology_valid_ = other.topology_valid_;
+            bounding_box_dirty_ = other.bounding_box_dirty_;
+            bounding_box_ = other.bounding_box_;
+            renew_versions();
+        }
+        return *this;
+    }
     
-    // Move constructor
-    Mesh(Mesh&& other) noexcept = default;
-    Mesh& operator=(Mesh&& other) noexcept = default;
+    // Move constructor; the moved-from mesh is emptied and renewed as well
+    Mesh(Mesh&& other) noexcept
+        : vertices_(std::move(other.vertices_)), edges_(std::move(other.edges_)),
+          faces_(std::move(other.faces_)), edge_map_(std::move(other.edge_map_)),
+          topology_valid_(other.topology_valid_), bounding_box_dirty_(other.bounding_box_dirty_),
+          bounding_box_(other.bounding_box_),
+          position_version_(detail::next_mesh_version()),
+          topology_version_(detail::next_mesh_version()) {
+        other.clear();
+    }
+
+    Mesh& operator=(Mesh&& other) noexcept {
+        if (this != &other) {
+            vertices_ = std::move(other.vertices_);
+            edges_ = std::move(other.edges_);
+            faces_ = std::move(other.faces_);
+            edge_map_ = std::move(other.edge_map_);
+            topology_valid_ = other.topology_valid_;
+            bounding_box_dirty_ = other.bounding_box_dirty_;
+            bounding_box_ = other.bounding_box_;
+            renew_versions();
+            other.clear();
+        }
+        return *this;
+    }
 
     // Destructor
     ~Mesh() = default;
@@ -53,6 +122,7 @@ public:
         v.id = id;
         vertices_.push_back(v);
         bounding_box_dirty_ = true;
+        position_version_ = detail::next_mesh_version();
         return id;
     }
 
@@ -86,6 +156,7 @@ public:
         Face<T> face(vertex_indices);
         face.id = face_id;
         faces_.push_back(face);
+        topology_version_ = detail::next_mesh_version();
 
         // Edge topology update disabled for stability
         // TODO: Implement stable edge topology management
@@ -124,9 +195,19 @@ public:
             throw std::out_of_range("Invalid vertex ID");
         }
         bounding_box_dirty_ = true;
+        position_version_ = detail::next_mesh_version();
         return vertices_[id];
     }
 
+    // Bulk vertex update: func(Vertex<T>* vertices, std::size_t count) may rewrite any
+    // vertex data in place. The bounding box and position version are invalidated after.
+    template<typename Function>
+    void update_vertices(Function&& func) {
+        func(vertices_.data(), vertices_.size());
+        bounding_box_dirty_ = true;
+        position_version_ = detail::next_mesh_version();
+    }
+
     const Face<T>& get_face(FaceId id) const {
         if (id >= faces_.size()) {
             throw std::out_of_range("Invalid face ID");
@@ -134,13 +215,27 @@ public:
         return faces_[id];
     }
 
+    // Mutable access may re-index the face, so the topology version is renewed; bulk
+    // edits should go through update_faces
     Face<T>& get_face(FaceId id) {
         if (id >= faces_.size()) {
             throw std::out_of_range("Invalid face ID");
         }
+        topology_version_ = detail::next_mesh_version();
         return faces_[id];
     }
 
+    // Bulk face update: func(Face<T>* faces, std::size_t count) may rewrite any face
+    // data in place, such as the order of a face's vertices; indices must stay valid.
+    // Edges are dropped and the topology version is invalidated after.
+    template<typename Function>
+    void update_faces(Function&& func) {
+        func(faces_.data(), faces_.size());
+        edges_.clear();
+        edge_map_.clear();
+        topology_version_ = detail::next_mesh_version();
+    }
+
     const Edge<T>& get_edge(EdgeId id) const {
         if (id >= edges_.size()) {
             throw std::out_of_range("Invalid edge ID");
@@ -150,8 +245,16 @@ public:
 
     // Geometry operations
     void compute_face_normals() {
-        for (auto& face : faces_) {
-            compute_face_normal(face);
+        // Unnormalized Newell normals in parallel, then one batched normalize
+        Face<T>* face_data = faces_.data();
+        utils::parallel_for_range(0, faces_.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t f = begin; f < end; ++f) {
+                face_data[f].normal = newell_normal(face_data[f]);
+            }
+        }, math::NORMALIZE_MIN_CHUNK);
+
+        if (!faces_.empty()) {
+            math::normalize_all(&face_data->normal, faces_.size(), sizeof(Face<T>));
         }
     }
 
@@ -171,8 +274,8 @@ public:
         }
 
         // Normalize
-        for (auto& vertex : vertices_) {
-            vertex.normal.normalize_in_place();
+        if (!vertices_.empty()) {
+            math::normalize_all(&vertices_.front().normal, vertices_.size(), sizeof(Vertex<T>));
         }
     }
 
@@ -181,6 +284,51 @@ public:
         compute_vertex_normals();
     }
 
+    // Apply a transformation to the whole mesh: positions as points, vertex and face
+    // normals through the inverse-transpose. The bounding box is carried over from the
+    // transformed corners when that is exact, otherwise it is gathered during the pass.
+    void transform(const math::Matrix4<T>& matrix) {
+        const bool corners_exact = !bounding_box_dirty_ && bounding_box_.is_valid() &&
+                                   math::detail::is_axis_aligned(matrix);
+
+        auto bounds = math::detail::empty_bounds<T>();
+        if (!vertices_.empty()) {
+            Vertex<T>& first = vertices_.front();
+            bounds = math::detail::transform_strided(
+                matrix, math::TransformKind::POINT, &first.position, sizeof(Vertex<T>),
+                &first.position, sizeof(Vertex<T>), vertices_.size(), !corners_exact);
+            math::detail::transform_strided(
+                matrix, math::TransformKind::NORMAL, &first.normal, sizeof(Vertex<T>),
+                &first.normal, sizeof(Vertex<T>), vertices_.size(), false);
+        }
+        if (!faces_.empty()) {
+            Face<T>& first = faces_.front();
+            math::detail::transform_strided(
+                matrix, math::TransformKind::NORMAL, &first.normal, sizeof(Face<T>),
+                &first.normal, sizeof(Face<T>), faces_.size(), false);
+        }
+
+        if (corners_exact) {
+            const auto& lo = bounding_box_.min_point;
+            const auto& hi = bounding_box_.max_point;
+            BoundingBox<T> box;
+            for (int corner = 0; corner < 8; ++corner) {
+                box.expand(matrix.transform_point(math::Vector3<T>(
+                    (corner & 1) ? hi.x : lo.x,
+                    (corner & 2) ? hi.y : lo.y,
+                    (corner & 4) ? hi.z : lo.z)));
+            }
+            bounding_box_ = box;
+        } else {
+            bounding_box_ = BoundingBox<T>(bounds[0], bounds[1]);
+        }
+        bounding_box_dirty_ = false;
+        position_version_ = detail::next_mesh_version();
+    }
+
+    std::uint64_t position_version() const { return position_version_; }
+    std::uint64_t topology_version() const { return topology_version_; }
+
     // Bounding box
     const BoundingBox<T>& bounding_box() const {
         if (bounding_box_dirty_) {
@@ -237,6 +385,33 @@ public:
         edge_map_.clear();
         topology_valid_ = true;
         bounding_box_dirty_ = true;
+        position_version_ = detail::next_mesh_version();
+        topology_version_ = detail::next_mesh_version();
+    }
+
+    // Bulk replacement for algorithms that rebuild the arrays (repair, decimation,
+    // subdivision). Ids are reset to array positions. Face indices are not validated:
+    // they must refer to the new vertex array.
+    void assign(std::vector<Vertex<T>> vertices, std::vector<Face<T>> faces) {
+        vertices_ = std::move(vertices);
+        for (std::size_t i = 0; i < vertices_.size(); ++i) {
+            vertices_[i].id = static_cast<VertexId>(i);
+        }
+        bounding_box_dirty_ = true;
+        position_version_ = detail::next_mesh_version();
+        assign_faces(std::move(faces));
+    }
+
+    // Replaces the faces only; vertices are untouched
+    void assign_faces(std::vector<Face<T>> faces) {
+        faces_ = std::move(faces);
+        for (std::size_t i = 0; i < faces_.size(); ++i) {
+            faces_[i].id = static_cast<FaceId>(i);
+        }
+        edges_.clear();
+        edge_map_.clear();
+        topology_valid_ = true;
+        topology_version_ = detail::next_mesh_version();
     }
 
     void reserve_vertices(std::size_t count) {
@@ -283,6 +458,11 @@ public:
     }
 
 private:
+    void renew_versions() {
+        position_version_ = detail::next_mesh_version();
+        topology_version_ = detail::next_mesh_version();
+    }
+
     void update_edges_for_face(FaceId face_id) {
         const auto& face = faces_[face_id];
         auto face_edges = face.get_edges();
@@ -309,9 +489,13 @@ private:
     }
 
     void compute_face_normal(Face<T>& face) const {
+        face.normal = newell_normal(face).normalize();
+    }
+
+    // Unnormalized face normal (twice the area vector); zero for faces with fewer than 3 vertices
+    math::Vector3<T> newell_normal(const Face<T>& face) const {
         if (face.vertex_count() < 3) {
-            face.normal = math::Vector3<T>(0);
-            return;
+            return math::Vector3<T>(0);
         }
 
         // Use Newell's method for robust normal computation
@@ -326,7 +510,7 @@ private:
             normal.z += (v1.x - v2.x) * (v1.y + v2.y);
         }
         
-        face.normal = normal.normalize();
+        return normal;
     }
 
     T compute_triangle_area(const Face<T>& face) const {
@@ -341,9 +525,11 @@ private:
 
     void compute_bounding_box() const {
         bounding_box_.reset();
-        for (const auto& vertex : vertices_) {
-            bounding_box_.expand(vertex.position);
-        }
+        if (vertices_.empty()) return;
+
+        const auto bounds = math::compute_bounds(&vertices_.front().position, vertices_.size(),
+                                                 sizeof(Vertex<T>));
+        bounding_box_ = BoundingBox<T>(bounds[0], bounds[1]);
     }
 };
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace polygon_mesh {
+namespace kernels {
+
+// Runtime-dispatched float kernels from the compiled polygon_mesh_kernels library.
+//
+// The header-only library is compiled with whatever instruction set the consumer
+// selects. Linking polygon_mesh::kernels adds per-ISA builds of the hot loops (scalar,
+// SSE2, AVX2+FMA) and picks the best one the CPU supports on first use. The target
+// also defines POLYGON_MESH_HAS_KERNELS, which routes the float paths of Mesh::transform,
+// normal computation, normalize_all, bounding boxes and BVH leaf tests through the table.
+//
+// All kernels take strided xyz data: element i starts stride bytes after element i-1,
+// so positions and normals can be read in place from an array of vertex structs.
+// They are single-threaded; callers split large ranges across threads.
+
+enum class Isa {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Closest ray-triangle hit reported by KernelTable::intersect_ray_triangles
+struct RayTriangleHit {
+    float t;                 // distance along the ray direction (in units of |direction|)
+    std::uint32_t triangle;  // index into the triangles passed to the kernel
+    float u, v;              // barycentric coordinates of corners 1 and 2
+};
+
+struct KernelTable {
+    Isa isa;
+
+    // Normalizes count vectors in place; zero-length vectors become zero.
+    // fast selects rsqrt + one Newton step instead of sqrt and divide.
+    void (*normalize)(float* xyz, std::size_t stride, std::size_t count, bool fast);
+
+    // Component-wise min/max over count points; leaves min3/max3 untouched when count is 0
+    void (*bounds)(const float* xyz, std::size_t stride, std::size_t count,
+                   float* min3, float* max3);
+
+    // out[i] = rows (row-major 4x4) * (in[i], 1 or 0). projective divides by w (skipped
+    // for |w| <= epsilon), normalize renormalizes the result (for normal transforms).
+    // When bounds6 is non-null it receives min xyz then max xyz of the outputs.
+    void (*transform)(const float* rows, bool projective, bool normalize,
+                      const float* in, std::size_t in_stride,
+                      float* out, std::size_t out_stride, std::size_t count, float* bounds6);
+
+    // Closest hit in (0, t_max) of one ray against count triangles, each stored as nine
+    // floats (a corner, then the edges to the other two corners, as in BVH leaves)
+    // stride bytes apart. Returns false when nothing is hit; ties go to the first.
+    bool (*intersect_ray_triangles)(const float* origin3, const float* direction3, float t_max,
+                                    const float* triangles, std::size_t stride, std::size_t count,
+                                    RayTriangleHit* hit);
+};
+
+// Best instruction set supported by the CPU and operating system
+Isa detected_isa();
+
+// Instruction set of the active kernel table. The first call selects detected_isa(),
+// capped by the POLYGON_MESH_ISA environment variable ("scalar", "sse2" or "avx2").
+Isa active_isa();
+
+const char* isa_name(Isa isa);
+
+// Kernel table for the active instruction set
+const KernelTable& active();
+
+// Kernel table for a specific instruction set; nullptr when it was not built or the
+// CPU does not support it
+const KernelTable* table_for(Isa isa);
+
+// Switches the active table (for testing and benchmarking). Returns false and leaves
+// the selection unchanged when the instruction set is unavailable.
+bool set_active_isa(Isa isa);
+
+} // namespace kernels
+} // namespace polygon_mesh
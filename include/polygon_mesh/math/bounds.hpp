@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <polygon_mesh/math/vector3.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+#include <polygon_mesh/kernels/kernels.hpp>
+#endif
+
+namespace polygon_mesh {
+namespace math {
+
+// Axis-aligned bounds of Vector3 arrays, reduced in SIMD batches.
+// Results are {min, max}; an empty input yields min = max(T), max = lowest(T).
+
+// Lanes per batch
+constexpr std::size_t BOUNDS_BATCH_SIZE = 8;
+
+// Minimum elements per thread before a reduction is split across threads
+constexpr std::size_t BOUNDS_MIN_CHUNK = 65536;
+
+namespace detail {
+
+template<typename T>
+std::array<Vector3<T>, 2> empty_bounds() {
+    return {Vector3<T>(std::numeric_limits<T>::max()), Vector3<T>(std::numeric_limits<T>::lowest())};
+}
+
+template<typename T>
+void merge_bounds(std::array<Vector3<T>, 2>& into, const std::array<Vector3<T>, 2>& other) {
+    into[0] = Vector3<T>(std::min(into[0].x, other[0].x), std::min(into[0].y, other[0].y),
+                         std::min(into[0].z, other[0].z));
+    into[1] = Vector3<T>(std::max(into[1].x, other[1].x), std::max(into[1].y, other[1].y),
+                         std::max(into[1].z, other[1].z));
+}
+
+// Bounds of elements [begin, end); at(i) yields element i
+template<typename T, typename Access>
+std::array<Vector3<T>, 2> bounds_range(Access&& at, std::size_t begin, std::size_t end) {
+    constexpr std::size_t B = BOUNDS_BATCH_SIZE;
+    using Vec = Vector3xN<T, B>;
+
+    if (begin >= end) return empty_bounds<T>();
+
+    // Tail lanes repeat the first element of the range, so they never widen the result
+    auto load = [&](std::size_t base) {
+        const std::size_t lanes = std::min(B, end - base);
+        return Vec::generate([&](std::size_t l) -> const Vector3<T>& {
+            return at(l < lanes ? base + l : begin);
+        });
+    };
+
+    Vec lo = load(begin);
+    Vec hi = lo;
+    for (std::size_t base = begin + B; base < end; base += B) {
+        const Vec v = load(base);
+        lo = min(lo, v);
+        hi = max(hi, v);
+    }
+    return {lo.min_lanes(), hi.max_lanes()};
+}
+
+// Parallel bounds of count elements laid out stride bytes apart
+template<typename T>
+std::array<Vector3<T>, 2> bounds_strided(const Vector3<T>* first, std::size_t count, std::size_t stride) {
+    const std::size_t chunks = utils::parallel_chunk_count(count, BOUNDS_MIN_CHUNK);
+    std::vector<std::array<Vector3<T>, 2>> partial(chunks, empty_bounds<T>());
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(first);
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+    if constexpr (std::is_same_v<T, float>) {
+        const kernels::KernelTable& table = kernels::active();
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            table.bounds(reinterpret_cast<const float*>(bytes + begin * stride), stride, end - begin,
+                         &partial[chunk][0].x, &partial[chunk][1].x);
+        }, BOUNDS_MIN_CHUNK);
+    } else
+#endif
+    {
+        auto at = [bytes, stride](std::size_t i) -> const Vector3<T>& {
+            return *reinterpret_cast<const Vector3<T>*>(bytes + i * stride);
+        };
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            partial[chunk] = bounds_range<T>(at, begin, end);
+        }, BOUNDS_MIN_CHUNK);
+    }
+
+    auto bounds = empty_bounds<T>();
+    for (const auto& p : partial) {
+        merge_bounds(bounds, p);
+    }
+    return bounds;
+}
+
+} // namespace detail
+
+template<typename T>
+std::array<Vector3<T>, 2> compute_bounds(utils::Span<const Vector3<T>> points) {
+    return detail::bounds_strided(points.data(), points.size(), sizeof(Vector3<T>));
+}
+
+template<typename T>
+std::array<Vector3<T>, 2> compute_bounds(const std::vector<Vector3<T>>& points) {
+    return compute_bounds(utils::Span<const Vector3<T>>(points));
+}
+
+// count points laid out stride bytes apart, e.g. positions inside vertex structs
+template<typename T>
+std::array<Vector3<T>, 2> compute_bounds(const Vector3<T>* first, std::size_t count, std::size_t stride) {
+    return detail::bounds_strided(first, count, stride);
+}
+
+} // namespace math
+} // namespace polygon_mesh
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <type_traits>
 #include <cstdint>
+#include <cstring>
 
 namespace polygon_mesh {
 namespace math {
@@ -80,15 +81,17 @@ T safe_sqrt(T x) {
     return std::sqrt(std::max(x, T(0)));
 }
 
-// Safe inverse square root (fast approximation for float)
+// Safe inverse square root (fast approximation for float).
+// For whole arrays use math::normalize_all, which runs the hardware rsqrt in SIMD lanes.
 template<typename T>
 T fast_inv_sqrt(T x) {
     if constexpr (std::is_same_v<T, float>) {
-        // Quake's fast inverse square root
+        // Quake's fast inverse square root; memcpy is the defined way to reinterpret bits
         float x2 = x * 0.5f;
-        std::uint32_t i = *(std::uint32_t*)&x;
+        std::uint32_t i;
+        std::memcpy(&i, &x, sizeof(i));
         i = 0x5f3759df - (i >> 1);
-        x = *(float*)&i;
+        std::memcpy(&x, &i, sizeof(x));
         x = x * (1.5f - x2 * x * x);  // Newton iteration
         return x;
     } else {
@@ -137,6 +140,22 @@ T wrap_angle_pi(T angle) {
     return angle;
 }
 
+// Spreads the low 10 bits of x so two zero bits follow each one
+constexpr std::uint32_t morton_spread(std::uint32_t x) {
+    x &= 0x3FFu;
+    x = (x | (x << 16)) & 0x030000FFu;
+    x = (x | (x << 8)) & 0x0300F00Fu;
+    x = (x | (x << 4)) & 0x030C30C3u;
+    x = (x | (x << 2)) & 0x09249249u;
+    return x;
+}
+
+// 30-bit Morton (Z-order) code of a cell with 10-bit coordinates; nearby cells get
+// nearby codes, so sorting by code groups primitives spatially
+constexpr std::uint32_t morton_encode(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+    return morton_spread(x) | (morton_spread(y) << 1) | (morton_spread(z) << 2);
+}
+
 // Barycentric coordinates
 template<typename T>
 struct BarycentricCoords {
@@ -2,7 +2,14 @@
 
 #include <array>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include <polygon_mesh/math/vector3.hpp>
+#include <polygon_mesh/math/simd_config.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
 
 namespace polygon_mesh {
 namespace math {
@@ -11,7 +18,7 @@ template<typename T>
 class Matrix4 {
 private:
     // Column-major order: data[column][row]
-    std::array<std::array<T, 4>, 4> data_;
+    alignas(16) std::array<std::array<T, 4>, 4> data_;
 
 public:
     // Constructors
@@ -88,14 +95,39 @@ public:
 
     Matrix4 operator*(const Matrix4& other) const {
         Matrix4 result(T(0));
+        multiply(*this, other, result);
+        return result;
+    }
+
+    // result = a * b, computed column by column as a linear combination of the columns
+    // of a (four broadcast multiply-adds per column). result must not alias a.
+    static void multiply(const Matrix4& a, const Matrix4& b, Matrix4& result) {
+#if defined(POLYGON_MESH_SIMD_SSE2)
+        if constexpr (std::is_same_v<T, float>) {
+            const __m128 a0 = _mm_loadu_ps(a.data_[0].data());
+            const __m128 a1 = _mm_loadu_ps(a.data_[1].data());
+            const __m128 a2 = _mm_loadu_ps(a.data_[2].data());
+            const __m128 a3 = _mm_loadu_ps(a.data_[3].data());
+            for (std::size_t col = 0; col < 4; ++col) {
+                const float* bc = b.data_[col].data();
+                __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+                r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+                _mm_storeu_ps(result.data_[col].data(), r);
+            }
+            return;
+        }
+#endif
         for (std::size_t col = 0; col < 4; ++col) {
+            const auto& bc = b.data_[col];
+            std::array<T, 4> r;
             for (std::size_t row = 0; row < 4; ++row) {
-                for (std::size_t k = 0; k < 4; ++k) {
-                    result.data_[col][row] += data_[k][row] * other.data_[col][k];
-                }
+                r[row] = a.data_[0][row] * bc[0] + a.data_[1][row] * bc[1] +
+                         a.data_[2][row] * bc[2] + a.data_[3][row] * bc[3];
             }
+            result.data_[col] = r;
         }
-        return result;
     }
 
     Matrix4 operator*(T scalar) const {
@@ -280,6 +312,12 @@ public:
     }
 
     // Advanced operations
+    // True when the bottom row is (0, 0, 0, 1), i.e. no projective component
+    bool is_affine() const {
+        return data_[0][3] == T(0) && data_[1][3] == T(0) &&
+               data_[2][3] == T(0) && data_[3][3] == T(1);
+    }
+
     Matrix4 transpose() const {
         Matrix4 result;
         for (std::size_t col = 0; col < 4; ++col) {
@@ -310,27 +348,108 @@ public:
         );
     }
 
+    // Full inverse via 2x2 sub-determinants (Laplace expansion). Returns false and
+    // leaves result untouched when the matrix is singular.
+    bool try_inverse(Matrix4& result) const {
+        const auto& m = data_;
+        // a(row, col) == m[col][row]
+        const T s0 = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+        const T s1 = m[0][0] * m[2][1] - m[0][1] * m[2][0];
+        const T s2 = m[0][0] * m[3][1] - m[0][1] * m[3][0];
+        const T s3 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        const T s4 = m[1][0] * m[3][1] - m[1][1] * m[3][0];
+        const T s5 = m[2][0] * m[3][1] - m[2][1] * m[3][0];
+
+        const T c5 = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+        const T c4 = m[1][2] * m[3][3] - m[1][3] * m[3][2];
+        const T c3 = m[1][2] * m[2][3] - m[1][3] * m[2][2];
+        const T c2 = m[0][2] * m[3][3] - m[0][3] * m[3][2];
+        const T c1 = m[0][2] * m[2][3] - m[0][3] * m[2][2];
+        const T c0 = m[0][2] * m[1][3] - m[0][3] * m[1][2];
+
+        const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        const T inv_det = T(1) / det;
+        if (det == T(0) || !std::isfinite(inv_det)) {
+            return false;
+        }
+
+        Matrix4& r = result;
+        r(0, 0) = ( m[1][1] * c5 - m[2][1] * c4 + m[3][1] * c3) * inv_det;
+        r(0, 1) = (-m[1][0] * c5 + m[2][0] * c4 - m[3][0] * c3) * inv_det;
+        r(0, 2) = ( m[1][3] * s5 - m[2][3] * s4 + m[3][3] * s3) * inv_det;
+        r(0, 3) = (-m[1][2] * s5 + m[2][2] * s4 - m[3][2] * s3) * inv_det;
+
+        r(1, 0) = (-m[0][1] * c5 + m[2][1] * c2 - m[3][1] * c1) * inv_det;
+        r(1, 1) = ( m[0][0] * c5 - m[2][0] * c2 + m[3][0] * c1) * inv_det;
+        r(1, 2) = (-m[0][3] * s5 + m[2][3] * s2 - m[3][3] * s1) * inv_det;
+        r(1, 3) = ( m[0][2] * s5 - m[2][2] * s2 + m[3][2] * s1) * inv_det;
+
+        r(2, 0) = ( m[0][1] * c4 - m[1][1] * c2 + m[3][1] * c0) * inv_det;
+        r(2, 1) = (-m[0][0] * c4 + m[1][0] * c2 - m[3][0] * c0) * inv_det;
+        r(2, 2) = ( m[0][3] * s4 - m[1][3] * s2 + m[3][3] * s0) * inv_det;
+        r(2, 3) = (-m[0][2] * s4 + m[1][2] * s2 - m[3][2] * s0) * inv_det;
+
+        r(3, 0) = (-m[0][1] * c3 + m[1][1] * c1 - m[2][1] * c0) * inv_det;
+        r(3, 1) = ( m[0][0] * c3 - m[1][0] * c1 + m[2][0] * c0) * inv_det;
+        r(3, 2) = (-m[0][3] * s3 + m[1][3] * s1 - m[2][3] * s0) * inv_det;
+        r(3, 3) = ( m[0][2] * s3 - m[1][2] * s1 + m[2][2] * s0) * inv_det;
+        return true;
+    }
+
     Matrix4 inverse() const {
-        T det = determinant();
-        if (std::abs(det) < std::numeric_limits<T>::epsilon()) {
-            // Return identity matrix if not invertible
-            Matrix4 result;
-            result.identity();
-            return result;
+        Matrix4 result(T(0));
+        if (!try_inverse(result)) {
+            throw std::domain_error("Matrix4 is not invertible");
         }
+        return result;
+    }
 
-        Matrix4 result;
-        T inv_det = T(1) / det;
+    // Inverse of an affine matrix [R t; 0 1] as [R^-1  -R^-1 t; 0 1]: one 3x3 cofactor
+    // inverse instead of the full 4x4 expansion. Falls back to try_inverse for
+    // projective matrices.
+    bool try_affine_inverse(Matrix4& result) const {
+        if (!is_affine()) {
+            return try_inverse(result);
+        }
 
-        // Calculate the adjugate matrix (cofactor matrix transposed)
-        // This is a simplified version - full implementation would be quite long
-        result.data_[0][0] = (data_[1][1] * (data_[2][2] * data_[3][3] - data_[2][3] * data_[3][2]) -
-                              data_[1][2] * (data_[2][1] * data_[3][3] - data_[2][3] * data_[3][1]) +
-                              data_[1][3] * (data_[2][1] * data_[3][2] - data_[2][2] * data_[3][1])) * inv_det;
+        const T a = data_[0][0], b = data_[1][0], c = data_[2][0];
+        const T d = data_[0][1], e = data_[1][1], f = data_[2][1];
+        const T g = data_[0][2], h = data_[1][2], i = data_[2][2];
+
+        const T co00 = e * i - f * h;
+        const T co01 = f * g - d * i;
+        const T co02 = d * h - e * g;
+        const T det = a * co00 + b * co01 + c * co02;
+        const T inv_det = T(1) / det;
+        if (det == T(0) || !std::isfinite(inv_det)) {
+            return false;
+        }
 
-        // For brevity, implementing a basic inversion method
-        // Full 4x4 matrix inversion would require all 16 cofactor calculations
-        
+        Matrix4& r = result;
+        r(0, 0) = co00 * inv_det;
+        r(0, 1) = (c * h - b * i) * inv_det;
+        r(0, 2) = (b * f - c * e) * inv_det;
+        r(1, 0) = co01 * inv_det;
+        r(1, 1) = (a * i - c * g) * inv_det;
+        r(1, 2) = (c * d - a * f) * inv_det;
+        r(2, 0) = co02 * inv_det;
+        r(2, 1) = (b * g - a * h) * inv_det;
+        r(2, 2) = (a * e - b * d) * inv_det;
+
+        const T tx = data_[3][0], ty = data_[3][1], tz = data_[3][2];
+        for (std::size_t row = 0; row < 3; ++row) {
+            r(row, 3) = -(r(row, 0) * tx + r(row, 1) * ty + r(row, 2) * tz);
+        }
+        r(3, 0) = r(3, 1) = r(3, 2) = T(0);
+        r(3, 3) = T(1);
+        return true;
+    }
+
+    Matrix4 affine_inverse() const {
+        Matrix4 result(T(0));
+        if (!try_affine_inverse(result)) {
+            throw std::domain_error("Matrix4 is not invertible");
+        }
         return result;
     }
 
@@ -371,5 +490,81 @@ Matrix4<T> operator*(T scalar, const Matrix4<T>& matrix) {
     return matrix * scalar;
 }
 
+// Batched matrix products and inverses for skinning / instancing workloads.
+// Large batches are split across threads. The span overloads take T explicitly
+// (multiply_many<float>(...)); the vector and Matrix4 overloads deduce it.
+
+// Minimum matrices per thread for the batch operations
+constexpr std::size_t MATRIX_BATCH_MIN_CHUNK = 4096;
+
+// out[i] = lhs[i] * rhs[i]
+template<typename T>
+void multiply_many(utils::Span<const Matrix4<utils::non_deduced_t<T>>> lhs,
+                   utils::Span<const Matrix4<utils::non_deduced_t<T>>> rhs,
+                   utils::Span<Matrix4<utils::non_deduced_t<T>>> out) {
+    if (lhs.size() != rhs.size() || lhs.size() != out.size()) {
+        throw std::invalid_argument("multiply_many: span sizes differ");
+    }
+    utils::parallel_for_range(0, out.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            Matrix4<T> product(T(0));
+            Matrix4<T>::multiply(lhs[i], rhs[i], product);
+            out[i] = product;
+        }
+    }, MATRIX_BATCH_MIN_CHUNK);
+}
+
+template<typename T>
+void multiply_many(const std::vector<Matrix4<T>>& lhs, const std::vector<Matrix4<T>>& rhs,
+                   std::vector<Matrix4<T>>& out) {
+    multiply_many<T>(utils::Span<const Matrix4<T>>(lhs), utils::Span<const Matrix4<T>>(rhs),
+                     utils::Span<Matrix4<T>>(out));
+}
+
+// out[i] = lhs * rhs[i] (e.g. a parent transform applied to many instances)
+template<typename T>
+void multiply_many(const Matrix4<T>& lhs, utils::Span<const Matrix4<utils::non_deduced_t<T>>> rhs,
+                   utils::Span<Matrix4<utils::non_deduced_t<T>>> out) {
+    if (rhs.size() != out.size()) {
+        throw std::invalid_argument("multiply_many: span sizes differ");
+    }
+    utils::parallel_for_range(0, out.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t i = begin; i < end; ++i) {
+            Matrix4<T> product(T(0));
+            Matrix4<T>::multiply(lhs, rhs[i], product);
+            out[i] = product;
+        }
+    }, MATRIX_BATCH_MIN_CHUNK);
+}
+
+// out[i] = inverse(in[i]). Singular inputs produce an all-zero matrix; the number of
+// singular inputs is returned. With affine_only the faster affine inverse is used.
+template<typename T>
+std::size_t inverse_many(utils::Span<const Matrix4<utils::non_deduced_t<T>>> in,
+                         utils::Span<Matrix4<utils::non_deduced_t<T>>> out,
+                         bool affine_only = false) {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("inverse_many: span sizes differ");
+    }
+    std::atomic<std::size_t> singular(0);
+    utils::parallel_for_range(0, out.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        std::size_t local_singular = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            Matrix4<T> inv(T(0));
+            const bool ok = affine_only ? in[i].try_affine_inverse(inv) : in[i].try_inverse(inv);
+            local_singular += ok ? 0 : 1;
+            out[i] = inv;
+        }
+        singular.fetch_add(local_singular);
+    }, MATRIX_BATCH_MIN_CHUNK);
+    return singular.load();
+}
+
+template<typename T>
+std::size_t inverse_many(const std::vector<Matrix4<T>>& in, std::vector<Matrix4<T>>& out,
+                         bool affine_only = false) {
+    return inverse_many<T>(utils::Span<const Matrix4<T>>(in), utils::Span<Matrix4<T>>(out), affine_only);
+}
+
 } // namespace math
 } // namespace polygon_mesh
\ No newline at end of file
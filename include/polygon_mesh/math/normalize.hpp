@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <polygon_mesh/math/vector3.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+#include <polygon_mesh/kernels/kernels.hpp>
+#endif
+
+namespace polygon_mesh {
+namespace math {
+
+// Array-wide normalization of Vector3 data in SIMD batches. Vectors whose squared
+// length is zero (or below the smallest normal value of T) are set to zero.
+
+enum class NormalizePrecision {
+    FAST,   // hardware reciprocal square root refined by one Newton step (~1e-7 relative)
+    EXACT   // sqrt and divide, matches Vector3::normalize
+};
+
+// Lanes per batch
+constexpr std::size_t NORMALIZE_BATCH_SIZE = 8;
+
+// Minimum elements per thread before a normalization is split across threads
+constexpr std::size_t NORMALIZE_MIN_CHUNK = 32768;
+
+namespace detail {
+
+// 1 / |v| per lane, zero where the vector is (numerically) zero
+template<typename T, std::size_t N>
+Packet<T, N> inverse_length(const Vector3xN<T, N>& v, NormalizePrecision precision) {
+    using P = Packet<T, N>;
+    const P len2 = v.length_squared();
+    const auto nonzero = len2 >= P(std::numeric_limits<T>::min());
+
+    P inv_len;
+    if (precision == NormalizePrecision::FAST) {
+        // y' = y * (1.5 - 0.5 * x * y * y)
+        const P y = rsqrt(len2);
+        inv_len = y * fmadd(P(T(-0.5)) * len2, y * y, P(T(1.5)));
+    } else {
+        inv_len = P(T(1)) / sqrt(len2);
+    }
+    return select(nonzero, inv_len, P::zero());
+}
+
+template<typename T, std::size_t N>
+Vector3xN<T, N> normalize_packet(const Vector3xN<T, N>& v, NormalizePrecision precision) {
+    return v * inverse_length(v, precision);
+}
+
+// Normalizes elements [begin, end) in place; at(i) yields a reference to element i
+template<typename T, typename Access>
+void normalize_range(Access&& at, std::size_t begin, std::size_t end, NormalizePrecision precision) {
+    constexpr std::size_t B = NORMALIZE_BATCH_SIZE;
+    using Vec = Vector3xN<T, B>;
+
+    for (std::size_t base = begin; base < end; base += B) {
+        const std::size_t lanes = std::min(B, end - base);
+
+        Vec v;
+        if (lanes == B) {
+            v = Vec::generate([&](std::size_t l) -> const Vector3<T>& { return at(base + l); });
+        } else {
+            alignas(32) T x[B] = {}, y[B] = {}, z[B] = {};
+            for (std::size_t l = 0; l < lanes; ++l) {
+                const Vector3<T>& src = at(base + l);
+                x[l] = src.x;
+                y[l] = src.y;
+                z[l] = src.z;
+            }
+            v = Vec::load_soa(x, y, z);
+        }
+
+        alignas(32) T x[B], y[B], z[B];
+        normalize_packet(v, precision).store_soa(x, y, z);
+
+        for (std::size_t l = 0; l < lanes; ++l) {
+            Vector3<T>& out = at(base + l);
+            out.x = x[l];
+            out.y = y[l];
+            out.z = z[l];
+        }
+    }
+}
+
+// Parallel driver over [0, count)
+template<typename T, typename Access>
+void normalize_parallel(Access&& at, std::size_t count, NormalizePrecision precision) {
+    utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+        normalize_range<T>(at, begin, end, precision);
+    }, NORMALIZE_MIN_CHUNK);
+}
+
+// Parallel normalize of count vectors laid out stride bytes apart
+template<typename T>
+void normalize_strided(Vector3<T>* first, std::size_t count, std::size_t stride,
+                       NormalizePrecision precision) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(first);
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+    if constexpr (std::is_same_v<T, float>) {
+        const kernels::KernelTable& table = kernels::active();
+        const bool fast = precision == NormalizePrecision::FAST;
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t) {
+            table.normalize(reinterpret_cast<float*>(bytes + begin * stride), stride, end - begin, fast);
+        }, NORMALIZE_MIN_CHUNK);
+        return;
+    }
+#endif
+
+    normalize_parallel<T>(
+        [bytes, stride](std::size_t i) -> Vector3<T>& {
+            return *reinterpret_cast<Vector3<T>*>(bytes + i * stride);
+        },
+        count, precision);
+}
+
+} // namespace detail
+
+// Normalizes every vector in place
+template<typename T>
+void normalize_all(utils::Span<Vector3<T>> vectors,
+                   NormalizePrecision precision = NormalizePrecision::FAST) {
+    detail::normalize_strided(vectors.data(), vectors.size(), sizeof(Vector3<T>), precision);
+}
+
+template<typename T>
+void normalize_all(std::vector<Vector3<T>>& vectors,
+                   NormalizePrecision precision = NormalizePrecision::FAST) {
+    normalize_all(utils::Span<Vector3<T>>(vectors), precision);
+}
+
+// Normalizes count vectors laid out stride_bytes apart, e.g. the normal member of an
+// array of vertex structs: normalize_all(&verts[0].normal, verts.size(), sizeof(verts[0]))
+template<typename T>
+void normalize_all(Vector3<T>* first, std::size_t count, std::size_t stride_bytes,
+                   NormalizePrecision precision = NormalizePrecision::FAST) {
+    detail::normalize_strided(first, count, stride_bytes, precision);
+}
+
+} // namespace math
+} // namespace polygon_mesh
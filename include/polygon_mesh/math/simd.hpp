@@ -0,0 +1,987 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <polygon_mesh/math/simd_config.hpp>
+#include <polygon_mesh/math/vector3.hpp>
+
+namespace polygon_mesh {
+namespace math {
+
+// Portable SIMD packet types for kernel writers.
+//
+//   Packet<T, N>     N lanes of T with arithmetic, comparisons and reductions
+//   Mask<T, N>       per-lane booleans produced by Packet comparisons
+//   Vector3xN<T, N>  N Vector3 values stored as x/y/z packets (SoA within a register)
+//
+// The generic templates are plain lane arrays that compilers auto-vectorize; float x4
+// (SSE2), float x8 (AVX, or two SSE halves) and float x16 (two x8 halves) are
+// specialized on intrinsics. Everything lives in an inline namespace keyed on the
+// instruction set (POLYGON_MESH_SIMD_ABI) so kernels compiled with different -m flags
+// never share symbols.
+inline namespace POLYGON_MESH_SIMD_ABI {
+
+// Natural packet width for T at the compiled instruction set (one full register)
+template<typename T>
+constexpr std::size_t native_width() {
+#if defined(POLYGON_MESH_SIMD_AVX)
+    return 32 / sizeof(T);
+#else
+    return 16 / sizeof(T);
+#endif
+}
+
+template<typename T, std::size_t N>
+class Mask;
+
+// Number of set bits in a lane mask
+inline std::size_t mask_popcount(unsigned bits) {
+    std::size_t result = 0;
+    for (; bits; bits &= bits - 1) ++result;
+    return result;
+}
+
+template<typename T, std::size_t N>
+class Packet;
+
+// Generic mask: one bool per lane
+template<typename T, std::size_t N>
+class Mask {
+public:
+    bool lanes[N];
+
+    Mask() = default;
+    explicit Mask(bool value) {
+        for (std::size_t i = 0; i < N; ++i) lanes[i] = value;
+    }
+
+    bool operator[](std::size_t i) const { return lanes[i]; }
+
+    // Bit i set when lane i is true
+    unsigned bits() const {
+        unsigned result = 0;
+        for (std::size_t i = 0; i < N; ++i) result |= unsigned(lanes[i]) << i;
+        return result;
+    }
+
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == (N >= 32 ? ~0u : ((1u << N) - 1u)); }
+    bool none() const { return bits() == 0; }
+
+    std::size_t count() const {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < N; ++i) result += lanes[i];
+        return result;
+    }
+
+    friend Mask operator&(const Mask& a, const Mask& b) {
+        Mask r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] && b.lanes[i];
+        return r;
+    }
+    friend Mask operator|(const Mask& a, const Mask& b) {
+        Mask r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] || b.lanes[i];
+        return r;
+    }
+    friend Mask operator^(const Mask& a, const Mask& b) {
+        Mask r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] != b.lanes[i];
+        return r;
+    }
+    friend Mask operator~(const Mask& a) {
+        Mask r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = !a.lanes[i];
+        return r;
+    }
+};
+
+// Generic packet: a lane array with element-wise operations
+template<typename T, std::size_t N>
+class Packet {
+    static_assert(std::is_arithmetic_v<T>, "T must be arithmetic type");
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Packet width must be a power of two");
+
+public:
+    using value_type = T;
+    using mask_type = Mask<T, N>;
+    static constexpr std::size_t width = N;
+
+    alignas(sizeof(T) * N) T lanes[N];
+
+    // Constructors
+    Packet() = default;
+    Packet(T value) {
+        for (std::size_t i = 0; i < N; ++i) lanes[i] = value;
+    }
+
+    static Packet zero() { return Packet(T(0)); }
+
+    // Lane index sequence 0, 1, ..., N-1
+    static Packet iota() {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = T(i);
+        return r;
+    }
+
+    // lane i = f(i), evaluated for every lane
+    template<typename F>
+    static Packet generate(F&& f) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = f(i);
+        return r;
+    }
+
+    // Memory access
+    static Packet load(const T* ptr) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = ptr[i];
+        return r;
+    }
+
+    static Packet load_aligned(const T* ptr) { return load(ptr); }
+
+    // Loads count < N lanes, filling the rest with fill
+    static Packet load_partial(const T* ptr, std::size_t count, T fill = T(0)) {
+        Packet r(fill);
+        for (std::size_t i = 0; i < count && i < N; ++i) r.lanes[i] = ptr[i];
+        return r;
+    }
+
+    void store(T* ptr) const {
+        for (std::size_t i = 0; i < N; ++i) ptr[i] = lanes[i];
+    }
+
+    void store_aligned(T* ptr) const { store(ptr); }
+
+    void store_partial(T* ptr, std::size_t count) const {
+        for (std::size_t i = 0; i < count && i < N; ++i) ptr[i] = lanes[i];
+    }
+
+    // lane i = base[indices[i] * stride]
+    static Packet gather(const T* base, const std::uint32_t* indices, std::size_t stride = 1) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = base[std::size_t(indices[i]) * stride];
+        return r;
+    }
+
+    // base[indices[i] * stride] = lane i (later lanes win on duplicate indices)
+    void scatter(T* base, const std::uint32_t* indices, std::size_t stride = 1) const {
+        for (std::size_t i = 0; i < N; ++i) base[std::size_t(indices[i]) * stride] = lanes[i];
+    }
+
+    // Element access
+    T operator[](std::size_t i) const { return lanes[i]; }
+    void set(std::size_t i, T value) { lanes[i] = value; }
+
+    // Compound assignment
+    Packet& operator+=(const Packet& o) { return *this = *this + o; }
+    Packet& operator-=(const Packet& o) { return *this = *this - o; }
+    Packet& operator*=(const Packet& o) { return *this = *this * o; }
+    Packet& operator/=(const Packet& o) { return *this = *this / o; }
+
+    // Arithmetic
+#define POLYGON_MESH_PACKET_BINARY(op)                                              \
+    friend Packet operator op(const Packet& a, const Packet& b) {                   \
+        Packet r;                                                                   \
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] op b.lanes[i];  \
+        return r;                                                                   \
+    }
+    POLYGON_MESH_PACKET_BINARY(+)
+    POLYGON_MESH_PACKET_BINARY(-)
+    POLYGON_MESH_PACKET_BINARY(*)
+    POLYGON_MESH_PACKET_BINARY(/)
+#undef POLYGON_MESH_PACKET_BINARY
+
+    friend Packet operator-(const Packet& a) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = -a.lanes[i];
+        return r;
+    }
+
+    // Comparisons
+#define POLYGON_MESH_PACKET_COMPARE(op)                                             \
+    friend mask_type operator op(const Packet& a, const Packet& b) {                \
+        mask_type r;                                                                \
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] op b.lanes[i];  \
+        return r;                                                                   \
+    }
+    POLYGON_MESH_PACKET_COMPARE(<)
+    POLYGON_MESH_PACKET_COMPARE(<=)
+    POLYGON_MESH_PACKET_COMPARE(>)
+    POLYGON_MESH_PACKET_COMPARE(>=)
+    POLYGON_MESH_PACKET_COMPARE(==)
+    POLYGON_MESH_PACKET_COMPARE(!=)
+#undef POLYGON_MESH_PACKET_COMPARE
+
+    // Math
+    friend Packet min(const Packet& a, const Packet& b) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = b.lanes[i] < a.lanes[i] ? b.lanes[i] : a.lanes[i];
+        return r;
+    }
+    friend Packet max(const Packet& a, const Packet& b) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] < b.lanes[i] ? b.lanes[i] : a.lanes[i];
+        return r;
+    }
+    friend Packet abs(const Packet& a) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] < T(0) ? -a.lanes[i] : a.lanes[i];
+        return r;
+    }
+    friend Packet sqrt(const Packet& a) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = static_cast<T>(std::sqrt(a.lanes[i]));
+        return r;
+    }
+    // Approximate 1/sqrt(x); exact on the generic path
+    friend Packet rsqrt(const Packet& a) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = static_cast<T>(T(1) / std::sqrt(a.lanes[i]));
+        return r;
+    }
+    // Approximate 1/x; exact on the generic path
+    friend Packet rcp(const Packet& a) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = T(1) / a.lanes[i];
+        return r;
+    }
+    // a * b + c
+    friend Packet fmadd(const Packet& a, const Packet& b, const Packet& c) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = a.lanes[i] * b.lanes[i] + c.lanes[i];
+        return r;
+    }
+    // Lane-wise mask ? a : b
+    friend Packet select(const mask_type& m, const Packet& a, const Packet& b) {
+        Packet r;
+        for (std::size_t i = 0; i < N; ++i) r.lanes[i] = m.lanes[i] ? a.lanes[i] : b.lanes[i];
+        return r;
+    }
+
+    // Horizontal reductions
+    friend T reduce_add(const Packet& a) {
+        T r = a.lanes[0];
+        for (std::size_t i = 1; i < N; ++i) r += a.lanes[i];
+        return r;
+    }
+    friend T reduce_min(const Packet& a) {
+        T r = a.lanes[0];
+        for (std::size_t i = 1; i < N; ++i) r = a.lanes[i] < r ? a.lanes[i] : r;
+        return r;
+    }
+    friend T reduce_max(const Packet& a) {
+        T r = a.lanes[0];
+        for (std::size_t i = 1; i < N; ++i) r = r < a.lanes[i] ? a.lanes[i] : r;
+        return r;
+    }
+};
+
+#if defined(POLYGON_MESH_SIMD_SSE2)
+
+// float x4 on SSE2
+template<>
+class Mask<float, 4> {
+public:
+    __m128 v;
+
+    Mask() = default;
+    Mask(__m128 value) : v(value) {}
+    explicit Mask(bool value) : v(_mm_castsi128_ps(_mm_set1_epi32(value ? -1 : 0))) {}
+
+    bool operator[](std::size_t i) const { return (bits() >> i) & 1u; }
+    unsigned bits() const { return static_cast<unsigned>(_mm_movemask_ps(v)); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xFu; }
+    bool none() const { return bits() == 0; }
+    std::size_t count() const { return mask_popcount(bits()); }
+
+    friend Mask operator&(const Mask& a, const Mask& b) { return _mm_and_ps(a.v, b.v); }
+    friend Mask operator|(const Mask& a, const Mask& b) { return _mm_or_ps(a.v, b.v); }
+    friend Mask operator^(const Mask& a, const Mask& b) { return _mm_xor_ps(a.v, b.v); }
+    friend Mask operator~(const Mask& a) {
+        return _mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+    }
+};
+
+template<>
+class Packet<float, 4> {
+public:
+    using value_type = float;
+    using mask_type = Mask<float, 4>;
+    static constexpr std::size_t width = 4;
+
+    __m128 v;
+
+    Packet() = default;
+    Packet(__m128 value) : v(value) {}
+    Packet(float value) : v(_mm_set1_ps(value)) {}
+
+    static Packet zero() { return _mm_setzero_ps(); }
+    static Packet iota() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+
+    template<typename F>
+    static Packet generate(F&& f) {
+        return _mm_setr_ps(f(std::size_t(0)), f(std::size_t(1)), f(std::size_t(2)), f(std::size_t(3)));
+    }
+
+    static Packet load(const float* ptr) { return _mm_loadu_ps(ptr); }
+    static Packet load_aligned(const float* ptr) { return _mm_load_ps(ptr); }
+    static Packet load_partial(const float* ptr, std::size_t count, float fill = 0.0f) {
+        alignas(16) float tmp[4] = {fill, fill, fill, fill};
+        for (std::size_t i = 0; i < count && i < 4; ++i) tmp[i] = ptr[i];
+        return _mm_load_ps(tmp);
+    }
+
+    void store(float* ptr) const { _mm_storeu_ps(ptr, v); }
+    void store_aligned(float* ptr) const { _mm_store_ps(ptr, v); }
+    void store_partial(float* ptr, std::size_t count) const {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, v);
+        for (std::size_t i = 0; i < count && i < 4; ++i) ptr[i] = tmp[i];
+    }
+
+    static Packet gather(const float* base, const std::uint32_t* indices, std::size_t stride = 1) {
+        return _mm_setr_ps(base[std::size_t(indices[0]) * stride], base[std::size_t(indices[1]) * stride],
+                           base[std::size_t(indices[2]) * stride], base[std::size_t(indices[3]) * stride]);
+    }
+
+    void scatter(float* base, const std::uint32_t* indices, std::size_t stride = 1) const {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, v);
+        for (std::size_t i = 0; i < 4; ++i) base[std::size_t(indices[i]) * stride] = tmp[i];
+    }
+
+    float operator[](std::size_t i) const {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, v);
+        return tmp[i];
+    }
+
+    void set(std::size_t i, float value) {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, v);
+        tmp[i] = value;
+        v = _mm_load_ps(tmp);
+    }
+
+    Packet& operator+=(const Packet& o) { v = _mm_add_ps(v, o.v); return *this; }
+    Packet& operator-=(const Packet& o) { v = _mm_sub_ps(v, o.v); return *this; }
+    Packet& operator*=(const Packet& o) { v = _mm_mul_ps(v, o.v); return *this; }
+    Packet& operator/=(const Packet& o) { v = _mm_div_ps(v, o.v); return *this; }
+
+    friend Packet operator+(const Packet& a, const Packet& b) { return _mm_add_ps(a.v, b.v); }
+    friend Packet operator-(const Packet& a, const Packet& b) { return _mm_sub_ps(a.v, b.v); }
+    friend Packet operator*(const Packet& a, const Packet& b) { return _mm_mul_ps(a.v, b.v); }
+    friend Packet operator/(const Packet& a, const Packet& b) { return _mm_div_ps(a.v, b.v); }
+    friend Packet operator-(const Packet& a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+    friend mask_type operator<(const Packet& a, const Packet& b) { return _mm_cmplt_ps(a.v, b.v); }
+    friend mask_type operator<=(const Packet& a, const Packet& b) { return _mm_cmple_ps(a.v, b.v); }
+    friend mask_type operator>(const Packet& a, const Packet& b) { return _mm_cmpgt_ps(a.v, b.v); }
+    friend mask_type operator>=(const Packet& a, const Packet& b) { return _mm_cmpge_ps(a.v, b.v); }
+    friend mask_type operator==(const Packet& a, const Packet& b) { return _mm_cmpeq_ps(a.v, b.v); }
+    friend mask_type operator!=(const Packet& a, const Packet& b) { return _mm_cmpneq_ps(a.v, b.v); }
+
+    friend Packet min(const Packet& a, const Packet& b) { return _mm_min_ps(a.v, b.v); }
+    friend Packet max(const Packet& a, const Packet& b) { return _mm_max_ps(a.v, b.v); }
+    friend Packet abs(const Packet& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+    friend Packet sqrt(const Packet& a) { return _mm_sqrt_ps(a.v); }
+    friend Packet rsqrt(const Packet& a) { return _mm_rsqrt_ps(a.v); }
+    friend Packet rcp(const Packet& a) { return _mm_rcp_ps(a.v); }
+    friend Packet fmadd(const Packet& a, const Packet& b, const Packet& c) {
+#if defined(POLYGON_MESH_SIMD_FMA)
+        return _mm_fmadd_ps(a.v, b.v, c.v);
+#else
+        return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+    }
+    friend Packet select(const mask_type& m, const Packet& a, const Packet& b) {
+#if defined(POLYGON_MESH_SIMD_SSE41)
+        return _mm_blendv_ps(b.v, a.v, m.v);
+#else
+        return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v));
+#endif
+    }
+
+    friend float reduce_add(const Packet& a) {
+        __m128 shuf = _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(a.v, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+    friend float reduce_min(const Packet& a) {
+        __m128 m = _mm_min_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)));
+        m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+        return _mm_cvtss_f32(m);
+    }
+    friend float reduce_max(const Packet& a) {
+        __m128 m = _mm_max_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        return _mm_cvtss_f32(m);
+    }
+};
+
+#if !defined(POLYGON_MESH_SIMD_AVX)
+
+// float x8 without AVX: two SSE halves, so 8-lane kernels stay in registers
+template<>
+class Mask<float, 8> {
+public:
+    Mask<float, 4> lo, hi;
+
+    Mask() = default;
+    Mask(const Mask<float, 4>& l, const Mask<float, 4>& h) : lo(l), hi(h) {}
+    explicit Mask(bool value) : lo(value), hi(value) {}
+
+    bool operator[](std::size_t i) const { return (bits() >> i) & 1u; }
+    unsigned bits() const { return lo.bits() | (hi.bits() << 4); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xFFu; }
+    bool none() const { return bits() == 0; }
+    std::size_t count() const { return mask_popcount(bits()); }
+
+    friend Mask operator&(const Mask& a, const Mask& b) { return Mask(a.lo & b.lo, a.hi & b.hi); }
+    friend Mask operator|(const Mask& a, const Mask& b) { return Mask(a.lo | b.lo, a.hi | b.hi); }
+    friend Mask operator^(const Mask& a, const Mask& b) { return Mask(a.lo ^ b.lo, a.hi ^ b.hi); }
+    friend Mask operator~(const Mask& a) { return Mask(~a.lo, ~a.hi); }
+};
+
+template<>
+class Packet<float, 8> {
+public:
+    using value_type = float;
+    using mask_type = Mask<float, 8>;
+    using half_type = Packet<float, 4>;
+    static constexpr std::size_t width = 8;
+
+    half_type lo, hi;
+
+    Packet() = default;
+    Packet(const half_type& l, const half_type& h) : lo(l), hi(h) {}
+    Packet(float value) : lo(value), hi(value) {}
+
+    static Packet zero() { return Packet(half_type::zero(), half_type::zero()); }
+    static Packet iota() { return Packet(half_type::iota(), half_type::iota() + half_type(4.0f)); }
+
+    template<typename F>
+    static Packet generate(F&& f) {
+        return Packet(half_type::generate(f), half_type::generate([&f](std::size_t i) { return f(i + 4); }));
+    }
+
+    static Packet load(const float* ptr) { return Packet(half_type::load(ptr), half_type::load(ptr + 4)); }
+    static Packet load_aligned(const float* ptr) {
+        return Packet(half_type::load_aligned(ptr), half_type::load_aligned(ptr + 4));
+    }
+    static Packet load_partial(const float* ptr, std::size_t count, float fill = 0.0f) {
+        return Packet(half_type::load_partial(ptr, count, fill),
+                      half_type::load_partial(ptr + 4, count > 4 ? count - 4 : 0, fill));
+    }
+
+    void store(float* ptr) const { lo.store(ptr); hi.store(ptr + 4); }
+    void store_aligned(float* ptr) const { lo.store_aligned(ptr); hi.store_aligned(ptr + 4); }
+    void store_partial(float* ptr, std::size_t count) const {
+        lo.store_partial(ptr, count);
+        if (count > 4) hi.store_partial(ptr + 4, count - 4);
+    }
+
+    static Packet gather(const float* base, const std::uint32_t* indices, std::size_t stride = 1) {
+        return Packet(half_type::gather(base, indices, stride), half_type::gather(base, indices + 4, stride));
+    }
+
+    void scatter(float* base, const std::uint32_t* indices, std::size_t stride = 1) const {
+        lo.scatter(base, indices, stride);
+        hi.scatter(base, indices + 4, stride);
+    }
+
+    float operator[](std::size_t i) const { return i < 4 ? lo[i] : hi[i - 4]; }
+    void set(std::size_t i, float value) {
+        if (i < 4) lo.set(i, value);
+        else hi.set(i - 4, value);
+    }
+
+    Packet& operator+=(const Packet& o) { lo += o.lo; hi += o.hi; return *this; }
+    Packet& operator-=(const Packet& o) { lo -= o.lo; hi -= o.hi; return *this; }
+    Packet& operator*=(const Packet& o) { lo *= o.lo; hi *= o.hi; return *this; }
+    Packet& operator/=(const Packet& o) { lo /= o.lo; hi /= o.hi; return *this; }
+
+    friend Packet operator+(const Packet& a, const Packet& b) { return Packet(a.lo + b.lo, a.hi + b.hi); }
+    friend Packet operator-(const Packet& a, const Packet& b) { return Packet(a.lo - b.lo, a.hi - b.hi); }
+    friend Packet operator*(const Packet& a, const Packet& b) { return Packet(a.lo * b.lo, a.hi * b.hi); }
+    friend Packet operator/(const Packet& a, const Packet& b) { return Packet(a.lo / b.lo, a.hi / b.hi); }
+    friend Packet operator-(const Packet& a) { return Packet(-a.lo, -a.hi); }
+
+    friend mask_type operator<(const Packet& a, const Packet& b) { return mask_type(a.lo < b.lo, a.hi < b.hi); }
+    friend mask_type operator<=(const Packet& a, const Packet& b) { return mask_type(a.lo <= b.lo, a.hi <= b.hi); }
+    friend mask_type operator>(const Packet& a, const Packet& b) { return mask_type(a.lo > b.lo, a.hi > b.hi); }
+    friend mask_type operator>=(const Packet& a, const Packet& b) { return mask_type(a.lo >= b.lo, a.hi >= b.hi); }
+    friend mask_type operator==(const Packet& a, const Packet& b) { return mask_type(a.lo == b.lo, a.hi == b.hi); }
+    friend mask_type operator!=(const Packet& a, const Packet& b) { return mask_type(a.lo != b.lo, a.hi != b.hi); }
+
+    friend Packet min(const Packet& a, const Packet& b) { return Packet(min(a.lo, b.lo), min(a.hi, b.hi)); }
+    friend Packet max(const Packet& a, const Packet& b) { return Packet(max(a.lo, b.lo), max(a.hi, b.hi)); }
+    friend Packet abs(const Packet& a) { return Packet(abs(a.lo), abs(a.hi)); }
+    friend Packet sqrt(const Packet& a) { return Packet(sqrt(a.lo), sqrt(a.hi)); }
+    friend Packet rsqrt(const Packet& a) { return Packet(rsqrt(a.lo), rsqrt(a.hi)); }
+    friend Packet rcp(const Packet& a) { return Packet(rcp(a.lo), rcp(a.hi)); }
+    friend Packet fmadd(const Packet& a, const Packet& b, const Packet& c) {
+        return Packet(fmadd(a.lo, b.lo, c.lo), fmadd(a.hi, b.hi, c.hi));
+    }
+    friend Packet select(const mask_type& m, const Packet& a, const Packet& b) {
+        return Packet(select(m.lo, a.lo, b.lo), select(m.hi, a.hi, b.hi));
+    }
+
+    friend float reduce_add(const Packet& a) { return reduce_add(a.lo + a.hi); }
+    friend float reduce_min(const Packet& a) { return reduce_min(min(a.lo, a.hi)); }
+    friend float reduce_max(const Packet& a) { return reduce_max(max(a.lo, a.hi)); }
+};
+
+#endif // !POLYGON_MESH_SIMD_AVX
+
+#endif // POLYGON_MESH_SIMD_SSE2
+
+#if defined(POLYGON_MESH_SIMD_AVX)
+
+// float x8 on AVX
+template<>
+class Mask<float, 8> {
+public:
+    __m256 v;
+
+    Mask() = default;
+    Mask(__m256 value) : v(value) {}
+    explicit Mask(bool value) : v(_mm256_castsi256_ps(_mm256_set1_epi32(value ? -1 : 0))) {}
+
+    bool operator[](std::size_t i) const { return (bits() >> i) & 1u; }
+    unsigned bits() const { return static_cast<unsigned>(_mm256_movemask_ps(v)); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xFFu; }
+    bool none() const { return bits() == 0; }
+    std::size_t count() const { return mask_popcount(bits()); }
+
+    friend Mask operator&(const Mask& a, const Mask& b) { return _mm256_and_ps(a.v, b.v); }
+    friend Mask operator|(const Mask& a, const Mask& b) { return _mm256_or_ps(a.v, b.v); }
+    friend Mask operator^(const Mask& a, const Mask& b) { return _mm256_xor_ps(a.v, b.v); }
+    friend Mask operator~(const Mask& a) {
+        return _mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+    }
+};
+
+template<>
+class Packet<float, 8> {
+public:
+    using value_type = float;
+    using mask_type = Mask<float, 8>;
+    static constexpr std::size_t width = 8;
+
+    __m256 v;
+
+    Packet() = default;
+    Packet(__m256 value) : v(value) {}
+    Packet(float value) : v(_mm256_set1_ps(value)) {}
+
+    static Packet zero() { return _mm256_setzero_ps(); }
+    static Packet iota() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+
+    template<typename F>
+    static Packet generate(F&& f) {
+        return _mm256_setr_ps(f(std::size_t(0)), f(std::size_t(1)), f(std::size_t(2)), f(std::size_t(3)),
+                              f(std::size_t(4)), f(std::size_t(5)), f(std::size_t(6)), f(std::size_t(7)));
+    }
+
+    static Packet load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+    static Packet load_aligned(const float* ptr) { return _mm256_load_ps(ptr); }
+    static Packet load_partial(const float* ptr, std::size_t count, float fill = 0.0f) {
+        alignas(32) float tmp[8] = {fill, fill, fill, fill, fill, fill, fill, fill};
+        for (std::size_t i = 0; i < count && i < 8; ++i) tmp[i] = ptr[i];
+        return _mm256_load_ps(tmp);
+    }
+
+    void store(float* ptr) const { _mm256_storeu_ps(ptr, v); }
+    void store_aligned(float* ptr) const { _mm256_store_ps(ptr, v); }
+    void store_partial(float* ptr, std::size_t count) const {
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, v);
+        for (std::size_t i = 0; i < count && i < 8; ++i) ptr[i] = tmp[i];
+    }
+
+    static Packet gather(const float* base, const std::uint32_t* indices, std::size_t stride = 1) {
+        alignas(32) float tmp[8];
+        for (std::size_t i = 0; i < 8; ++i) tmp[i] = base[std::size_t(indices[i]) * stride];
+        return _mm256_load_ps(tmp);
+    }
+
+    void scatter(float* base, const std::uint32_t* indices, std::size_t stride = 1) const {
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, v);
+        for (std::size_t i = 0; i < 8; ++i) base[std::size_t(indices[i]) * stride] = tmp[i];
+    }
+
+    float operator[](std::size_t i) const {
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, v);
+        return tmp[i];
+    }
+
+    void set(std::size_t i, float value) {
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, v);
+        tmp[i] = value;
+        v = _mm256_load_ps(tmp);
+    }
+
+    Packet& operator+=(const Packet& o) { v = _mm256_add_ps(v, o.v); return *this; }
+    Packet& operator-=(const Packet& o) { v = _mm256_sub_ps(v, o.v); return *this; }
+    Packet& operator*=(const Packet& o) { v = _mm256_mul_ps(v, o.v); return *this; }
+    Packet& operator/=(const Packet& o) { v = _mm256_div_ps(v, o.v); return *this; }
+
+    friend Packet operator+(const Packet& a, const Packet& b) { return _mm256_add_ps(a.v, b.v); }
+    friend Packet operator-(const Packet& a, const Packet& b) { return _mm256_sub_ps(a.v, b.v); }
+    friend Packet operator*(const Packet& a, const Packet& b) { return _mm256_mul_ps(a.v, b.v); }
+    friend Packet operator/(const Packet& a, const Packet& b) { return _mm256_div_ps(a.v, b.v); }
+    friend Packet operator-(const Packet& a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+    friend mask_type operator<(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    friend mask_type operator<=(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+    friend mask_type operator>(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+    friend mask_type operator>=(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+    friend mask_type operator==(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+    friend mask_type operator!=(const Packet& a, const Packet& b) { return _mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ); }
+
+    friend Packet min(const Packet& a, const Packet& b) { return _mm256_min_ps(a.v, b.v); }
+    friend Packet max(const Packet& a, const Packet& b) { return _mm256_max_ps(a.v, b.v); }
+    friend Packet abs(const Packet& a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+    friend Packet sqrt(const Packet& a) { return _mm256_sqrt_ps(a.v); }
+    friend Packet rsqrt(const Packet& a) { return _mm256_rsqrt_ps(a.v); }
+    friend Packet rcp(const Packet& a) { return _mm256_rcp_ps(a.v); }
+    friend Packet fmadd(const Packet& a, const Packet& b, const Packet& c) {
+#if defined(POLYGON_MESH_SIMD_FMA)
+        return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+    }
+    friend Packet select(const mask_type& m, const Packet& a, const Packet& b) {
+        return _mm256_blendv_ps(b.v, a.v, m.v);
+    }
+
+    friend float reduce_add(const Packet& a) {
+        return reduce_add(Packet<float, 4>(_mm_add_ps(_mm256_castps256_ps128(a.v),
+                                                      _mm256_extractf128_ps(a.v, 1))));
+    }
+    friend float reduce_min(const Packet& a) {
+        return reduce_min(Packet<float, 4>(_mm_min_ps(_mm256_castps256_ps128(a.v),
+                                                      _mm256_extractf128_ps(a.v, 1))));
+    }
+    friend float reduce_max(const Packet& a) {
+        return reduce_max(Packet<float, 4>(_mm_max_ps(_mm256_castps256_ps128(a.v),
+                                                      _mm256_extractf128_ps(a.v, 1))));
+    }
+};
+
+#endif // POLYGON_MESH_SIMD_AVX
+
+#if defined(POLYGON_MESH_SIMD_SSE2)
+
+// float x16: two x8 halves, for kernels that keep sixteen lanes in flight (ray packets)
+template<>
+class Mask<float, 16> {
+public:
+    Mask<float, 8> lo, hi;
+
+    Mask() = default;
+    Mask(const Mask<float, 8>& l, const Mask<float, 8>& h) : lo(l), hi(h) {}
+    explicit Mask(bool value) : lo(value), hi(value) {}
+
+    bool operator[](std::size_t i) const { return (bits() >> i) & 1u; }
+    unsigned bits() const { return lo.bits() | (hi.bits() << 8); }
+    bool any() const { return bits() != 0; }
+    bool all() const { return bits() == 0xFFFFu; }
+    bool none() const { return bits() == 0; }
+    std::size_t count() const { return mask_popcount(bits()); }
+
+    friend Mask operator&(const Mask& a, const Mask& b) { return Mask(a.lo & b.lo, a.hi & b.hi); }
+    friend Mask operator|(const Mask& a, const Mask& b) { return Mask(a.lo | b.lo, a.hi | b.hi); }
+    friend Mask operator^(const Mask& a, const Mask& b) { return Mask(a.lo ^ b.lo, a.hi ^ b.hi); }
+    friend Mask operator~(const Mask& a) { return Mask(~a.lo, ~a.hi); }
+};
+
+template<>
+class Packet<float, 16> {
+public:
+    using value_type = float;
+    using mask_type = Mask<float, 16>;
+    using half_type = Packet<float, 8>;
+    static constexpr std::size_t width = 16;
+
+    half_type lo, hi;
+
+    Packet() = default;
+    Packet(const half_type& l, const half_type& h) : lo(l), hi(h) {}
+    Packet(float value) : lo(value), hi(value) {}
+
+    static Packet zero() { return Packet(half_type::zero(), half_type::zero()); }
+    static Packet iota() { return Packet(half_type::iota(), half_type::iota() + half_type(8.0f)); }
+
+    template<typename F>
+    static Packet generate(F&& f) {
+        return Packet(half_type::generate(f), half_type::generate([&f](std::size_t i) { return f(i + 8); }));
+    }
+
+    static Packet load(const float* ptr) { return Packet(half_type::load(ptr), half_type::load(ptr + 8)); }
+    static Packet load_aligned(const float* ptr) {
+        return Packet(half_type::load_aligned(ptr), half_type::load_aligned(ptr + 8));
+    }
+    static Packet load_partial(const float* ptr, std::size_t count, float fill = 0.0f) {
+        return Packet(half_type::load_partial(ptr, count, fill),
+                      half_type::load_partial(ptr + 8, count > 8 ? count - 8 : 0, fill));
+    }
+
+    void store(float* ptr) const { lo.store(ptr); hi.store(ptr + 8); }
+    void store_aligned(float* ptr) const { lo.store_aligned(ptr); hi.store_aligned(ptr + 8); }
+    void store_partial(float* ptr, std::size_t count) const {
+        lo.store_partial(ptr, count);
+        if (count > 8) hi.store_partial(ptr + 8, count - 8);
+    }
+
+    static Packet gather(const float* base, const std::uint32_t* indices, std::size_t stride = 1) {
+        return Packet(half_type::gather(base, indices, stride), half_type::gather(base, indices + 8, stride));
+    }
+
+    void scatter(float* base, const std::uint32_t* indices, std::size_t stride = 1) const {
+        lo.scatter(base, indices, stride);
+        hi.scatter(base, indices + 8, stride);
+    }
+
+    float operator[](std::size_t i) const { return i < 8 ? lo[i] : hi[i - 8]; }
+    void set(std::size_t i, float value) {
+        if (i < 8) lo.set(i, value);
+        else hi.set(i - 8, value);
+    }
+
+    Packet& operator+=(const Packet& o) { lo += o.lo; hi += o.hi; return *this; }
+    Packet& operator-=(const Packet& o) { lo -= o.lo; hi -= o.hi; return *this; }
+    Packet& operator*=(const Packet& o) { lo *= o.lo; hi *= o.hi; return *this; }
+    Packet& operator/=(const Packet& o) { lo /= o.lo; hi /= o.hi; return *this; }
+
+    friend Packet operator+(const Packet& a, const Packet& b) { return Packet(a.lo + b.lo, a.hi + b.hi); }
+    friend Packet operator-(const Packet& a, const Packet& b) { return Packet(a.lo - b.lo, a.hi - b.hi); }
+    friend Packet operator*(const Packet& a, const Packet& b) { return Packet(a.lo * b.lo, a.hi * b.hi); }
+    friend Packet operator/(const Packet& a, const Packet& b) { return Packet(a.lo / b.lo, a.hi / b.hi); }
+    friend Packet operator-(const Packet& a) { return Packet(-a.lo, -a.hi); }
+
+    friend mask_type operator<(const Packet& a, const Packet& b) { return mask_type(a.lo < b.lo, a.hi < b.hi); }
+    friend mask_type operator<=(const Packet& a, const Packet& b) { return mask_type(a.lo <= b.lo, a.hi <= b.hi); }
+    friend mask_type operator>(const Packet& a, const Packet& b) { return mask_type(a.lo > b.lo, a.hi > b.hi); }
+    friend mask_type operator>=(const Packet& a, const Packet& b) { return mask_type(a.lo >= b.lo, a.hi >= b.hi); }
+    friend mask_type operator==(const Packet& a, const Packet& b) { return mask_type(a.lo == b.lo, a.hi == b.hi); }
+    friend mask_type operator!=(const Packet& a, const Packet& b) { return mask_type(a.lo != b.lo, a.hi != b.hi); }
+
+    friend Packet min(const Packet& a, const Packet& b) { return Packet(min(a.lo, b.lo), min(a.hi, b.hi)); }
+    friend Packet max(const Packet& a, const Packet& b) { return Packet(max(a.lo, b.lo), max(a.hi, b.hi)); }
+    friend Packet abs(const Packet& a) { return Packet(abs(a.lo), abs(a.hi)); }
+    friend Packet sqrt(const Packet& a) { return Packet(sqrt(a.lo), sqrt(a.hi)); }
+    friend Packet rsqrt(const Packet& a) { return Packet(rsqrt(a.lo), rsqrt(a.hi)); }
+    friend Packet rcp(const Packet& a) { return Packet(rcp(a.lo), rcp(a.hi)); }
+    friend Packet fmadd(const Packet& a, const Packet& b, const Packet& c) {
+        return Packet(fmadd(a.lo, b.lo, c.lo), fmadd(a.hi, b.hi, c.hi));
+    }
+    friend Packet select(const mask_type& m, const Packet& a, const Packet& b) {
+        return Packet(select(m.lo, a.lo, b.lo), select(m.hi, a.hi, b.hi));
+    }
+
+    friend float reduce_add(const Packet& a) { return reduce_add(a.lo + a.hi); }
+    friend float reduce_min(const Packet& a) { return reduce_min(min(a.lo, a.hi)); }
+    friend float reduce_max(const Packet& a) { return reduce_max(max(a.lo, a.hi)); }
+};
+
+#endif // POLYGON_MESH_SIMD_SSE2
+
+// N three-component vectors, one packet per component
+template<typename T, std::size_t N>
+class Vector3xN {
+public:
+    using packet_type = Packet<T, N>;
+    using mask_type = typename packet_type::mask_type;
+    static constexpr std::size_t width = N;
+
+    packet_type x, y, z;
+
+    // Constructors
+    Vector3xN() = default;
+    Vector3xN(const packet_type& px, const packet_type& py, const packet_type& pz) : x(px), y(py), z(pz) {}
+    Vector3xN(const Vector3<T>& v) : x(v.x), y(v.y), z(v.z) {}
+
+    static Vector3xN zero() { return Vector3xN(packet_type::zero(), packet_type::zero(), packet_type::zero()); }
+
+    // lane i = f(i) for a callable returning a Vector3 (or reference to one). Builds the
+    // packets in registers, which avoids the store-forwarding stall of staging scalars
+    // through memory when the source is strided or reached through an accessor.
+    template<typename F>
+    static Vector3xN generate(F&& f) {
+        return Vector3xN(packet_type::generate([&f](std::size_t i) { return f(i).x; }),
+                         packet_type::generate([&f](std::size_t i) { return f(i).y; }),
+                         packet_type::generate([&f](std::size_t i) { return f(i).z; }));
+    }
+
+    // Structure-of-arrays load/store: lane i = (xs[i], ys[i], zs[i])
+    static Vector3xN load_soa(const T* xs, const T* ys, const T* zs) {
+        return Vector3xN(packet_type::load(xs), packet_type::load(ys), packet_type::load(zs));
+    }
+
+    static Vector3xN load_soa_partial(const T* xs, const T* ys, const T* zs, std::size_t count) {
+        return Vector3xN(packet_type::load_partial(xs, count), packet_type::load_partial(ys, count),
+                         packet_type::load_partial(zs, count));
+    }
+
+    void store_soa(T* xs, T* ys, T* zs) const {
+        x.store(xs);
+        y.store(ys);
+        z.store(zs);
+    }
+
+    void store_soa_partial(T* xs, T* ys, T* zs, std::size_t count) const {
+        x.store_partial(xs, count);
+        y.store_partial(ys, count);
+        z.store_partial(zs, count);
+    }
+
+    // Array-of-structures load/store from N consecutive Vector3 values
+    static Vector3xN load(const Vector3<T>* ptr) {
+        return load_partial(ptr, N);
+    }
+
+    static Vector3xN load_partial(const Vector3<T>* ptr, std::size_t count) {
+        alignas(sizeof(T) * N) T xs[N] = {}, ys[N] = {}, zs[N] = {};
+        for (std::size_t i = 0; i < count && i < N; ++i) {
+            xs[i] = ptr[i].x;
+            ys[i] = ptr[i].y;
+            zs[i] = ptr[i].z;
+        }
+        return load_soa(xs, ys, zs);
+    }
+
+    void store(Vector3<T>* ptr) const { store_partial(ptr, N); }
+
+    void store_partial(Vector3<T>* ptr, std::size_t count) const {
+        alignas(sizeof(T) * N) T xs[N], ys[N], zs[N];
+        store_soa(xs, ys, zs);
+        for (std::size_t i = 0; i < count && i < N; ++i) {
+            ptr[i] = Vector3<T>(xs[i], ys[i], zs[i]);
+        }
+    }
+
+    // Indexed access into a Vector3 array: lane i = base[indices[i]]
+    static Vector3xN gather(const Vector3<T>* base, const std::uint32_t* indices) {
+        const T* scalars = &base[0].x;
+        return Vector3xN(packet_type::gather(scalars, indices, 3),
+                         packet_type::gather(scalars + 1, indices, 3),
+                         packet_type::gather(scalars + 2, indices, 3));
+    }
+
+    // Indexed access into structure-of-arrays positions
+    static Vector3xN gather_soa(const T* xs, const T* ys, const T* zs, const std::uint32_t* indices) {
+        return Vector3xN(packet_type::gather(xs, indices), packet_type::gather(ys, indices),
+                         packet_type::gather(zs, indices));
+    }
+
+    void scatter(Vector3<T>* base, const std::uint32_t* indices) const {
+        T* scalars = &base[0].x;
+        x.scatter(scalars, indices, 3);
+        y.scatter(scalars + 1, indices, 3);
+        z.scatter(scalars + 2, indices, 3);
+    }
+
+    void scatter_soa(T* xs, T* ys, T* zs, const std::uint32_t* indices) const {
+        x.scatter(xs, indices);
+        y.scatter(ys, indices);
+        z.scatter(zs, indices);
+    }
+
+    // Lane access
+    Vector3<T> get(std::size_t lane) const { return Vector3<T>(x[lane], y[lane], z[lane]); }
+
+    void set(std::size_t lane, const Vector3<T>& v) {
+        x.set(lane, v.x);
+        y.set(lane, v.y);
+        z.set(lane, v.z);
+    }
+
+    // Arithmetic
+    Vector3xN operator+(const Vector3xN& o) const { return Vector3xN(x + o.x, y + o.y, z + o.z); }
+    Vector3xN operator-(const Vector3xN& o) const { return Vector3xN(x - o.x, y - o.y, z - o.z); }
+    Vector3xN operator*(const packet_type& s) const { return Vector3xN(x * s, y * s, z * s); }
+    Vector3xN operator/(const packet_type& s) const { return Vector3xN(x / s, y / s, z / s); }
+    Vector3xN operator-() const { return Vector3xN(-x, -y, -z); }
+
+    Vector3xN& operator+=(const Vector3xN& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    Vector3xN& operator-=(const Vector3xN& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    Vector3xN& operator*=(const packet_type& s) { x *= s; y *= s; z *= s; return *this; }
+
+    // Component-wise product
+    Vector3xN hadamard(const Vector3xN& o) const { return Vector3xN(x * o.x, y * o.y, z * o.z); }
+
+    // Vector operations
+    packet_type dot(const Vector3xN& o) const { return fmadd(x, o.x, fmadd(y, o.y, z * o.z)); }
+
+    Vector3xN cross(const Vector3xN& o) const {
+        return Vector3xN(y * o.z - z * o.y,
+                         z * o.x - x * o.z,
+                         x * o.y - y * o.x);
+    }
+
+    packet_type length_squared() const { return dot(*this); }
+    packet_type length() const { return sqrt(length_squared()); }
+
+    // Zero-length lanes stay zero
+    Vector3xN normalize() const {
+        const packet_type len2 = length_squared();
+        const mask_type nonzero = len2 > packet_type::zero();
+        const packet_type inv_len = select(nonzero, packet_type(T(1)) / sqrt(len2), packet_type::zero());
+        return *this * inv_len;
+    }
+
+    // Reductions
+    Vector3<T> sum() const { return Vector3<T>(reduce_add(x), reduce_add(y), reduce_add(z)); }
+    Vector3<T> min_lanes() const { return Vector3<T>(reduce_min(x), reduce_min(y), reduce_min(z)); }
+    Vector3<T> max_lanes() const { return Vector3<T>(reduce_max(x), reduce_max(y), reduce_max(z)); }
+
+    friend Vector3xN operator*(const packet_type& s, const Vector3xN& v) { return v * s; }
+
+    friend Vector3xN min(const Vector3xN& a, const Vector3xN& b) {
+        return Vector3xN(min(a.x, b.x), min(a.y, b.y), min(a.z, b.z));
+    }
+    friend Vector3xN max(const Vector3xN& a, const Vector3xN& b) {
+        return Vector3xN(max(a.x, b.x), max(a.y, b.y), max(a.z, b.z));
+    }
+    friend Vector3xN select(const mask_type& m, const Vector3xN& a, const Vector3xN& b) {
+        return Vector3xN(select(m, a.x, b.x), select(m, a.y, b.y), select(m, a.z, b.z));
+    }
+};
+
+// Type aliases
+using Packet4f = Packet<float, 4>;
+using Packet8f = Packet<float, 8>;
+using Packet16f = Packet<float, 16>;
+using Packet2d = Packet<double, 2>;
+using Packet4d = Packet<double, 4>;
+
+using Vec3x4f = Vector3xN<float, 4>;
+using Vec3x8f = Vector3xN<float, 8>;
+using Vec3x16f = Vector3xN<float, 16>;
+using Vec3x2d = Vector3xN<double, 2>;
+using Vec3x4d = Vector3xN<double, 4>;
+
+template<typename T>
+using NativePacket = Packet<T, native_width<T>()>;
+
+template<typename T>
+using NativeVector3xN = Vector3xN<T, native_width<T>()>;
+
+} // inline namespace POLYGON_MESH_SIMD_ABI
+} // namespace math
+} // namespace polygon_mesh
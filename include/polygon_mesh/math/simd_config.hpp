@@ -0,0 +1,57 @@
+#pragma once
+
+// Compile-time SIMD capability detection shared by the math kernels.
+// Define POLYGON_MESH_NO_SIMD to force the portable scalar code paths.
+
+#if !defined(POLYGON_MESH_NO_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POLYGON_MESH_SIMD_SSE2 1
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define POLYGON_MESH_SIMD_SSE41 1
+#endif
+
+#if defined(__AVX__)
+#define POLYGON_MESH_SIMD_AVX 1
+#endif
+
+#if defined(__AVX2__)
+#define POLYGON_MESH_SIMD_AVX2 1
+#endif
+
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define POLYGON_MESH_SIMD_FMA 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define POLYGON_MESH_SIMD_NEON 1
+#endif
+
+#endif // !POLYGON_MESH_NO_SIMD
+
+#if defined(POLYGON_MESH_SIMD_SSE2) || defined(POLYGON_MESH_SIMD_AVX)
+#include <immintrin.h>
+#endif
+
+#if defined(POLYGON_MESH_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// Inline namespace tag for code whose layout or codegen depends on the SIMD level
+// (see math/simd.hpp). Translation units built with different instruction sets get
+// distinct symbol names, so per-ISA kernels can be linked into one binary safely.
+#if defined(POLYGON_MESH_SIMD_AVX2)
+#define POLYGON_MESH_SIMD_ABI simd_avx2
+#elif defined(POLYGON_MESH_SIMD_AVX)
+#define POLYGON_MESH_SIMD_ABI simd_avx
+#elif defined(POLYGON_MESH_SIMD_SSE41)
+#define POLYGON_MESH_SIMD_ABI simd_sse41
+#elif defined(POLYGON_MESH_SIMD_SSE2)
+#define POLYGON_MESH_SIMD_ABI simd_sse2
+#elif defined(POLYGON_MESH_SIMD_NEON)
+#define POLYGON_MESH_SIMD_ABI simd_neon
+#else
+#define POLYGON_MESH_SIMD_ABI simd_scalar
+#endif
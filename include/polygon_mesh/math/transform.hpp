@@ -0,0 +1,325 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <polygon_mesh/math/vector3.hpp>
+#include <polygon_mesh/math/matrix4.hpp>
+#include <polygon_mesh/math/bounds.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/math/normalize.hpp>
+#include <polygon_mesh/utils/span.hpp>
+#include <polygon_mesh/utils/threading.hpp>
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+#include <polygon_mesh/kernels/kernels.hpp>
+#endif
+
+namespace polygon_mesh {
+namespace math {
+
+// Batched transformation of point, direction and normal arrays by a Matrix4.
+// Elements are processed in fixed-size batches as Vector3xN packets (math/simd.hpp);
+// large arrays are split across threads.
+
+// Lanes per batch
+constexpr std::size_t TRANSFORM_BATCH_SIZE = 8;
+
+// Minimum elements per thread before a transform is split across threads
+constexpr std::size_t TRANSFORM_MIN_CHUNK = 16384;
+
+enum class TransformKind {
+    POINT,      // full affine/projective transform (w divide when projective)
+    DIRECTION,  // upper 3x3 only, no translation
+    NORMAL      // inverse-transpose of the upper 3x3, renormalized
+};
+
+namespace detail {
+
+// Row-major 3x4 (plus projective row) copy of a Matrix4, laid out for the batch kernels
+template<typename T>
+struct TransformRows {
+    T r[4][4];
+    bool projective;
+};
+
+template<typename T>
+TransformRows<T> point_rows(const Matrix4<T>& m) {
+    TransformRows<T> rows;
+    for (std::size_t row = 0; row < 4; ++row) {
+        for (std::size_t col = 0; col < 4; ++col) {
+            rows.r[row][col] = m(row, col);
+        }
+    }
+    rows.projective = !m.is_affine();
+    return rows;
+}
+
+template<typename T>
+TransformRows<T> direction_rows(const Matrix4<T>& m) {
+    TransformRows<T> rows = point_rows(m);
+    for (std::size_t row = 0; row < 3; ++row) {
+        rows.r[row][3] = T(0);
+    }
+    rows.projective = false;
+    return rows;
+}
+
+// Normal matrix as the cofactor matrix of the upper 3x3. The cofactor matrix equals
+// det * inverse-transpose, so it is well defined for singular matrices too; the sign of
+// det is folded back in so mirrored transforms keep normals on the correct side.
+template<typename T>
+TransformRows<T> normal_rows(const Matrix4<T>& m) {
+    const T a = m(0, 0), b = m(0, 1), c = m(0, 2);
+    const T d = m(1, 0), e = m(1, 1), f = m(1, 2);
+    const T g = m(2, 0), h = m(2, 1), i = m(2, 2);
+
+    TransformRows<T> rows{};
+    rows.r[0][0] = e * i - f * h;
+    rows.r[0][1] = f * g - d * i;
+    rows.r[0][2] = d * h - e * g;
+    rows.r[1][0] = c * h - b * i;
+    rows.r[1][1] = a * i - c * g;
+    rows.r[1][2] = b * g - a * h;
+    rows.r[2][0] = b * f - c * e;
+    rows.r[2][1] = c * d - a * f;
+    rows.r[2][2] = a * e - b * d;
+
+    const T det = a * rows.r[0][0] + b * rows.r[0][1] + c * rows.r[0][2];
+    if (det < T(0)) {
+        for (std::size_t row = 0; row < 3; ++row) {
+            for (std::size_t col = 0; col < 3; ++col) {
+                rows.r[row][col] = -rows.r[row][col];
+            }
+        }
+    }
+    rows.projective = false;
+    return rows;
+}
+
+template<typename T>
+TransformRows<T> rows_for(const Matrix4<T>& m, TransformKind kind) {
+    switch (kind) {
+        case TransformKind::DIRECTION: return direction_rows(m);
+        case TransformKind::NORMAL: return normal_rows(m);
+        default: return point_rows(m);
+    }
+}
+
+// True when every row and column of the upper 3x3 has at most one non-zero entry
+// (scales, axis permutations and mirrors). Such transforms map an axis-aligned box
+// exactly onto the box spanned by its transformed corners.
+template<typename T>
+bool is_axis_aligned(const Matrix4<T>& m) {
+    if (!m.is_affine()) return false;
+    for (std::size_t row = 0; row < 3; ++row) {
+        int row_nonzero = 0;
+        int col_nonzero = 0;
+        for (std::size_t k = 0; k < 3; ++k) {
+            row_nonzero += m(row, k) != T(0);
+            col_nonzero += m(k, row) != T(0);
+        }
+        if (row_nonzero > 1 || col_nonzero > 1) return false;
+    }
+    return true;
+}
+
+// Transforms one packet of vectors by the rows. projective divides by w (skipped for
+// w ~ 0, matching Matrix4::transform_point); normalize renormalizes the results.
+template<typename T, std::size_t N>
+Vector3xN<T, N> transform_packet(const TransformRows<T>& m, const Vector3xN<T, N>& v,
+                                 bool projective, bool normalize) {
+    using P = Packet<T, N>;
+    Vector3xN<T, N> o(
+        fmadd(P(m.r[0][0]), v.x, fmadd(P(m.r[0][1]), v.y, fmadd(P(m.r[0][2]), v.z, P(m.r[0][3])))),
+        fmadd(P(m.r[1][0]), v.x, fmadd(P(m.r[1][1]), v.y, fmadd(P(m.r[1][2]), v.z, P(m.r[1][3])))),
+        fmadd(P(m.r[2][0]), v.x, fmadd(P(m.r[2][1]), v.y, fmadd(P(m.r[2][2]), v.z, P(m.r[2][3])))));
+
+    if (projective) {
+        const P w = fmadd(P(m.r[3][0]), v.x, fmadd(P(m.r[3][1]), v.y, fmadd(P(m.r[3][2]), v.z, P(m.r[3][3]))));
+        const P inv_w = select(abs(w) > P(std::numeric_limits<T>::epsilon()), P(T(1)) / w, P(T(1)));
+        o *= inv_w;
+    } else if (normalize) {
+        o = normalize_packet(o, NormalizePrecision::FAST);
+    }
+    return o;
+}
+
+// Transforms elements [begin, end) in batches. src(i) yields the input vector and dst(i)
+// the output location (they may alias). When bounds is non-null the transformed values
+// are folded into bounds[0] (min) and bounds[1] (max).
+template<typename T, typename Src, typename Dst>
+void transform_range(const TransformRows<T>& m, TransformKind kind,
+                     Src&& src, Dst&& dst, std::size_t begin, std::size_t end,
+                     Vector3<T>* bounds) {
+    constexpr std::size_t B = TRANSFORM_BATCH_SIZE;
+    const bool normalize = kind == TransformKind::NORMAL;
+    const bool projective = m.projective;
+
+    using P = Packet<T, B>;
+    using Vec = Vector3xN<T, B>;
+
+    Vec lo(Vector3<T>(std::numeric_limits<T>::max()));
+    Vec hi(Vector3<T>(std::numeric_limits<T>::lowest()));
+
+    for (std::size_t base = begin; base < end; base += B) {
+        const std::size_t lanes = std::min(B, end - base);
+
+        Vec v;
+        if (lanes == B) {
+            v = Vec::generate([&](std::size_t l) -> const Vector3<T>& { return src(base + l); });
+        } else {
+            alignas(32) T x[B] = {}, y[B] = {}, z[B] = {};
+            for (std::size_t l = 0; l < lanes; ++l) {
+                const Vector3<T>& in = src(base + l);
+                x[l] = in.x;
+                y[l] = in.y;
+                z[l] = in.z;
+            }
+            v = Vec::load_soa(x, y, z);
+        }
+
+        const Vec o = transform_packet(m, v, projective, normalize);
+
+        alignas(32) T x[B], y[B], z[B];
+        o.store_soa(x, y, z);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            Vector3<T>& out = dst(base + l);
+            out.x = x[l];
+            out.y = y[l];
+            out.z = z[l];
+        }
+
+        if (bounds) {
+            // Pad the tail with a real output so it cannot disturb the reduction
+            const Vec tail = lanes == B ? o : select(P::iota() < P(T(lanes)), o, Vec(o.get(0)));
+            lo = min(lo, tail);
+            hi = max(hi, tail);
+        }
+    }
+
+    if (bounds) {
+        bounds[0] = lo.min_lanes();
+        bounds[1] = hi.max_lanes();
+    }
+}
+
+// Parallel driver over [0, count). Returns the min/max of the outputs when
+// compute_bounds is set (min > max for an empty range).
+template<typename T, typename Src, typename Dst>
+std::array<Vector3<T>, 2> transform_parallel(const Matrix4<T>& matrix, TransformKind kind,
+                                             Src&& src, Dst&& dst, std::size_t count,
+                                             bool compute_bounds) {
+    const TransformRows<T> rows = rows_for(matrix, kind);
+    const std::size_t chunks = utils::parallel_chunk_count(count, TRANSFORM_MIN_CHUNK);
+
+    std::vector<std::array<Vector3<T>, 2>> partial(compute_bounds ? chunks : 0);
+
+    utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        transform_range(rows, kind, src, dst, begin, end,
+                        compute_bounds ? partial[chunk].data() : nullptr);
+    }, TRANSFORM_MIN_CHUNK);
+
+    auto bounds = empty_bounds<T>();
+    for (const auto& p : partial) merge_bounds(bounds, p);
+    return bounds;
+}
+
+// Strided driver: element i of in/out starts i * stride bytes after the first (they may
+// alias). Float data goes through the dispatched kernels when they are linked.
+template<typename T>
+std::array<Vector3<T>, 2> transform_strided(const Matrix4<T>& matrix, TransformKind kind,
+                                            const Vector3<T>* in, std::size_t in_stride,
+                                            Vector3<T>* out, std::size_t out_stride,
+                                            std::size_t count, bool compute_bounds) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    unsigned char* dst = reinterpret_cast<unsigned char*>(out);
+
+#if defined(POLYGON_MESH_HAS_KERNELS)
+    if constexpr (std::is_same_v<T, float>) {
+        const TransformRows<float> rows = rows_for(matrix, kind);
+        const kernels::KernelTable& table = kernels::active();
+        const std::size_t chunks = utils::parallel_chunk_count(count, TRANSFORM_MIN_CHUNK);
+        std::vector<std::array<float, 6>> partial(compute_bounds ? chunks : 0);
+
+        utils::parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+            table.transform(&rows.r[0][0], rows.projective, kind == TransformKind::NORMAL,
+                            reinterpret_cast<const float*>(src + begin * in_stride), in_stride,
+                            reinterpret_cast<float*>(dst + begin * out_stride), out_stride,
+                            end - begin, compute_bounds ? partial[chunk].data() : nullptr);
+        }, TRANSFORM_MIN_CHUNK);
+
+        auto bounds = empty_bounds<float>();
+        for (const auto& p : partial) {
+            merge_bounds(bounds, {Vector3<float>(p[0], p[1], p[2]), Vector3<float>(p[3], p[4], p[5])});
+        }
+        return bounds;
+    }
+#endif
+
+    return transform_parallel(matrix, kind,
+        [src, in_stride](std::size_t i) -> const Vector3<T>& {
+            return *reinterpret_cast<const Vector3<T>*>(src + i * in_stride);
+        },
+        [dst, out_stride](std::size_t i) -> Vector3<T>& {
+            return *reinterpret_cast<Vector3<T>*>(dst + i * out_stride);
+        },
+        count, compute_bounds);
+}
+
+template<typename T>
+void transform_span(const Matrix4<T>& matrix, TransformKind kind,
+                    utils::Span<const Vector3<T>> in, utils::Span<Vector3<T>> out) {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("Transform input and output sizes differ");
+    }
+    transform_strided(matrix, kind, in.data(), sizeof(Vector3<T>), out.data(), sizeof(Vector3<T>),
+                      in.size(), false);
+}
+
+} // namespace detail
+
+// Points: out[i] = M * (in[i], 1), divided by w for projective matrices
+template<typename T>
+void transform_points(const Matrix4<T>& matrix, utils::Span<const Vector3<utils::non_deduced_t<T>>> in,
+                      utils::Span<Vector3<utils::non_deduced_t<T>>> out) {
+    detail::transform_span(matrix, TransformKind::POINT, in, out);
+}
+
+template<typename T>
+void transform_points(const Matrix4<T>& matrix, utils::Span<Vector3<utils::non_deduced_t<T>>> points) {
+    detail::transform_span(matrix, TransformKind::POINT, utils::Span<const Vector3<T>>(points), points);
+}
+
+// Directions: out[i] = M3x3 * in[i] (translation ignored, length not preserved)
+template<typename T>
+void transform_directions(const Matrix4<T>& matrix, utils::Span<const Vector3<utils::non_deduced_t<T>>> in,
+                          utils::Span<Vector3<utils::non_deduced_t<T>>> out) {
+    detail::transform_span(matrix, TransformKind::DIRECTION, in, out);
+}
+
+template<typename T>
+void transform_directions(const Matrix4<T>& matrix, utils::Span<Vector3<utils::non_deduced_t<T>>> directions) {
+    detail::transform_span(matrix, TransformKind::DIRECTION, utils::Span<const Vector3<T>>(directions),
+                           directions);
+}
+
+// Normals: out[i] = normalize(inverse-transpose(M3x3) * in[i]); zero normals stay zero
+template<typename T>
+void transform_normals(const Matrix4<T>& matrix, utils::Span<const Vector3<utils::non_deduced_t<T>>> in,
+                       utils::Span<Vector3<utils::non_deduced_t<T>>> out) {
+    detail::transform_span(matrix, TransformKind::NORMAL, in, out);
+}
+
+template<typename T>
+void transform_normals(const Matrix4<T>& matrix, utils::Span<Vector3<utils::non_deduced_t<T>>> normals) {
+    detail::transform_span(matrix, TransformKind::NORMAL, utils::Span<const Vector3<T>>(normals), normals);
+}
+
+} // namespace math
+} // namespace polygon_mesh
@@ -12,6 +12,10 @@
 #include <polygon_mesh/math/vector3.hpp>
 #include <polygon_mesh/math/matrix4.hpp>
 #include <polygon_mesh/math/math_utils.hpp>
+#include <polygon_mesh/math/transform.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/math/normalize.hpp>
+#include <polygon_mesh/math/bounds.hpp>
 
 // Algorithm modules
 #include <polygon_mesh/algorithms/algorithms.hpp>
@@ -49,13 +53,13 @@ namespace polygon_mesh {
         inline constexpr bool has_threading_utils() { return true; }
         inline constexpr bool has_memory_pool() { return true; }
         inline constexpr bool has_profiling() { return true; }
+        inline constexpr bool has_mesh_decimation() { return true; }
+        inline constexpr bool has_subdivision_surfaces() { return true; }
         
         // Future features (not yet implemented)
         inline constexpr bool has_stl_support() { return false; }
         inline constexpr bool has_off_support() { return false; }
         inline constexpr bool has_gpu_acceleration() { return false; }
-        inline constexpr bool has_subdivision_surfaces() { return false; }
-        inline constexpr bool has_mesh_decimation() { return false; }
     }
     
     // Common type aliases for convenience
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <type_traits>
+#include <stdexcept>
+
+namespace polygon_mesh {
+namespace utils {
+
+// Non-owning view over a contiguous range (minimal C++17 stand-in for std::span)
+template<typename T>
+class Span {
+private:
+    T* data_;
+    std::size_t size_;
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    // Constructors
+    constexpr Span() noexcept : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    template<std::size_t N>
+    constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+    template<typename U, std::size_t N,
+             typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr Span(std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template<typename U, std::size_t N,
+             typename = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+    constexpr Span(const std::array<U, N>& array) noexcept : data_(array.data()), size_(N) {}
+
+    template<typename U, typename Alloc,
+             typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template<typename U, typename Alloc,
+             typename = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+    Span(const std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    // Span<T> converts to Span<const T>
+    template<typename U,
+             typename = std::enable_if_t<!std::is_same_v<U, T> &&
+                                         std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr Span(const Span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+
+    // Element access
+    constexpr T& operator[](std::size_t index) const { return data_[index]; }
+
+    T& at(std::size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Span index out of range");
+        }
+        return data_[index];
+    }
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr std::size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    T& front() const { return data_[0]; }
+    T& back() const { return data_[size_ - 1]; }
+
+    // Iterators
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    // Subviews
+    Span subspan(std::size_t offset, std::size_t count) const {
+        if (offset > size_ || count > size_ - offset) {
+            throw std::out_of_range("Span subspan out of range");
+        }
+        return Span(data_ + offset, count);
+    }
+
+    Span subspan(std::size_t offset) const {
+        return subspan(offset, size_ - offset);
+    }
+
+    Span first(std::size_t count) const { return subspan(0, count); }
+    Span last(std::size_t count) const { return subspan(size_ - count, count); }
+};
+
+// Blocks template argument deduction, so a Span<Vector3<T>> parameter accepts a
+// std::vector<Vector3<T>> once T has been deduced from another argument
+template<typename T>
+struct type_identity {
+    using type = T;
+};
+
+template<typename T>
+using non_deduced_t = typename type_identity<T>::type;
+
+// Deduction guides
+template<typename T, typename Alloc>
+Span(std::vector<T, Alloc>&) -> Span<T>;
+
+template<typename T, typename Alloc>
+Span(const std::vector<T, Alloc>&) -> Span<const T>;
+
+template<typename T, std::size_t N>
+Span(std::array<T, N>&) -> Span<T>;
+
+template<typename T, std::size_t N>
+Span(const std::array<T, N>&) -> Span<const T>;
+
+} // namespace utils
+} // namespace polygon_mesh
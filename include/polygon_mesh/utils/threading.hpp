@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <algorithm>
 
 namespace polygon_mesh {
 namespace utils {
@@ -180,6 +181,144 @@ void parallel_for_index(std::size_t start, std::size_t end, Function&& func,
     }
 }
 
+// Number of contiguous chunks parallel_for_range splits a range of the given length into.
+// Useful for sizing per-chunk partial results before the loop runs.
+inline std::size_t parallel_chunk_count(std::size_t length, std::size_t min_chunk = 1024,
+                                        std::size_t num_threads = std::thread::hardware_concurrency()) {
+    if (length == 0) return 0;
+    if (num_threads == 0) num_threads = 1;
+    if (min_chunk == 0) min_chunk = 1;
+
+    const std::size_t max_chunks = (length + min_chunk - 1) / min_chunk;
+    return std::max<std::size_t>(1, std::min(num_threads, max_chunks));
+}
+
+// Parallel for over contiguous sub-ranges.
+// func(chunk_begin, chunk_end, chunk_index) is called once per chunk; chunks hold at
+// least min_chunk elements so small inputs stay on the calling thread.
+template<typename Function>
+void parallel_for_range(std::size_t start, std::size_t end, Function&& func,
+                        std::size_t min_chunk = 1024,
+                        std::size_t num_threads = std::thread::hardware_concurrency()) {
+    if (end <= start) return;
+
+    const std::size_t length = end - start;
+    const std::size_t chunks = parallel_chunk_count(length, min_chunk, num_threads);
+
+    if (chunks == 1) {
+        func(start, end, std::size_t(0));
+        return;
+    }
+
+    auto chunk_begin = [&](std::size_t chunk) {
+        return start + length * chunk / chunks;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+        threads.emplace_back([&func, chunk, b = chunk_begin(chunk), e = chunk_begin(chunk + 1)]() {
+            func(b, e, chunk);
+        });
+    }
+
+    // First chunk runs on the calling thread
+    func(start, chunk_begin(1), std::size_t(0));
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Reusable barrier for a fixed number of threads
+class Barrier {
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    const std::size_t count_;
+    std::size_t waiting_;
+    std::size_t generation_;
+    
+public:
+    explicit Barrier(std::size_t count) : count_(count), waiting_(0), generation_(0) {}
+    
+    // Blocks until all count threads have arrived; the barrier then resets itself
+    void arrive_and_wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const std::size_t generation = generation_;
+        if (++waiting_ == count_) {
+            waiting_ = 0;
+            ++generation_;
+            condition_.notify_all();
+            return;
+        }
+        condition_.wait(lock, [&] { return generation != generation_; });
+    }
+    
+    // Non-copyable, non-moveable
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+};
+
+// Runs func(thread_index) on thread_count threads for the duration of the call, with
+// index 0 on the calling thread. Iterative solvers use it with a Barrier to keep one
+// team alive across sweeps instead of spawning threads per sweep.
+template<typename Function>
+void parallel_team(std::size_t thread_count, Function&& func) {
+    if (thread_count <= 1) {
+        func(std::size_t(0));
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t index = 1; index < thread_count; ++index) {
+        threads.emplace_back([&func, index]() { func(index); });
+    }
+
+    func(std::size_t(0));
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Stable parallel stream compaction over [0, count). keep(i) selects elements and is
+// evaluated twice per element, so it should be a cheap lookup; emit(i, position) is
+// called once per kept element with its index in the compacted order. Returns the
+// number of kept elements.
+template<typename Keep, typename Emit>
+std::size_t parallel_compact(std::size_t count, Keep&& keep, Emit&& emit,
+                             std::size_t min_chunk = 4096) {
+    const std::size_t chunks = parallel_chunk_count(count, min_chunk);
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+
+    // Count per chunk, then exclusive scan; both passes see the same chunk boundaries
+    parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        std::size_t kept = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            kept += keep(i) ? 1 : 0;
+        }
+        offsets[chunk + 1] = kept;
+    }, min_chunk);
+
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        offsets[chunk + 1] += offsets[chunk];
+    }
+
+    parallel_for_range(0, count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+        std::size_t position = offsets[chunk];
+        for (std::size_t i = begin; i < end; ++i) {
+            if (keep(i)) {
+                emit(i, position++);
+            }
+        }
+    }, min_chunk);
+
+    return offsets[chunks];
+}
+
 // Atomic counter for thread-safe counting
 class AtomicCounter {
 private:
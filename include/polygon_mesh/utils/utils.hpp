@@ -5,6 +5,7 @@
 #include <polygon_mesh/utils/memory.hpp>
 #include <polygon_mesh/utils/threading.hpp>
 #include <polygon_mesh/utils/profiling.hpp>
+#include <polygon_mesh/utils/span.hpp>
 
 #include <string>
 #include <vector>
@@ -0,0 +1,124 @@
+#include <polygon_mesh/kernels/kernels.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace polygon_mesh {
+namespace kernels {
+namespace detail {
+
+// Defined by the per-ISA translation units
+const KernelTable& scalar_kernels();
+#if defined(POLYGON_MESH_KERNELS_X86)
+const KernelTable& sse2_kernels();
+const KernelTable& avx2_kernels();
+#endif
+
+namespace {
+
+bool cpu_has_avx2_fma() {
+#if defined(POLYGON_MESH_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    // libgcc/compiler-rt also check that the OS saves the YMM state (XGETBV)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(POLYGON_MESH_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;  // XMM and YMM state enabled by the OS
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+Isa detect() {
+#if defined(POLYGON_MESH_KERNELS_X86)
+    return cpu_has_avx2_fma() ? Isa::AVX2 : Isa::SSE2;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+// Optional cap from the environment, e.g. POLYGON_MESH_ISA=sse2
+Isa apply_env_cap(Isa isa) {
+    const char* value = std::getenv("POLYGON_MESH_ISA");
+    if (!value) return isa;
+
+    Isa cap = isa;
+    if (std::strcmp(value, "scalar") == 0) cap = Isa::SCALAR;
+    else if (std::strcmp(value, "sse2") == 0) cap = Isa::SSE2;
+    else if (std::strcmp(value, "avx2") == 0) cap = Isa::AVX2;
+    return static_cast<int>(cap) < static_cast<int>(isa) ? cap : isa;
+}
+
+std::atomic<const KernelTable*> active_table{nullptr};
+
+} // namespace
+} // namespace detail
+
+Isa detected_isa() {
+    static const Isa isa = detail::detect();
+    return isa;
+}
+
+const KernelTable* table_for(Isa isa) {
+    if (static_cast<int>(isa) > static_cast<int>(detected_isa())) {
+        return nullptr;
+    }
+    switch (isa) {
+#if defined(POLYGON_MESH_KERNELS_X86)
+        case Isa::AVX2: return &detail::avx2_kernels();
+        case Isa::SSE2: return &detail::sse2_kernels();
+#endif
+        case Isa::SCALAR: return &detail::scalar_kernels();
+        default: return nullptr;
+    }
+}
+
+const KernelTable& active() {
+    const KernelTable* table = detail::active_table.load(std::memory_order_acquire);
+    if (!table) {
+        // Concurrent first calls all compute the same table, so a plain store is enough
+        table = table_for(detail::apply_env_cap(detected_isa()));
+        detail::active_table.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+Isa active_isa() {
+    return active().isa;
+}
+
+bool set_active_isa(Isa isa) {
+    const KernelTable* table = table_for(isa);
+    if (!table) return false;
+    detail::active_table.store(table, std::memory_order_release);
+    return true;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::SSE2: return "sse2";
+        case Isa::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+} // namespace kernels
+} // namespace polygon_mesh
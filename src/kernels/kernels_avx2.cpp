@@ -0,0 +1,5 @@
+// AVX2 + FMA kernels: built with -mavx2 -mfma (/arch:AVX2 on MSVC), only called after
+// dispatch.cpp has confirmed CPU and OS support
+#define POLYGON_MESH_KERNEL_ENTRY avx2_kernels
+#define POLYGON_MESH_KERNEL_ISA Isa::AVX2
+#include "kernels_impl.inl"
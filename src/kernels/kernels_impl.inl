@@ -0,0 +1,188 @@
+// Kernel bodies shared by the per-ISA translation units (kernels_scalar.cpp,
+// kernels_sse2.cpp, kernels_avx2.cpp). Each unit defines POLYGON_MESH_KERNEL_ENTRY and
+// POLYGON_MESH_KERNEL_ISA, then includes this file with its own compiler flags.
+//
+// Everything here has internal linkage or is instantiated on the ISA-tagged packet
+// types of math/simd.hpp, so no inline function compiled with wider instructions can be
+// picked by the linker for code that runs on older CPUs. Do not use Vector3 or other
+// untagged header templates in this file.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <polygon_mesh/kernels/kernels.hpp>
+#include <polygon_mesh/math/simd.hpp>
+#include <polygon_mesh/math/normalize.hpp>
+#include <polygon_mesh/math/transform.hpp>
+
+namespace polygon_mesh {
+namespace kernels {
+namespace {
+
+constexpr std::size_t W = 8;
+using P = math::Packet<float, W>;
+using Vec = math::Vector3xN<float, W>;
+
+inline const float* element(const float* base, std::size_t stride, std::size_t i) {
+    return reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(base) + i * stride);
+}
+
+inline float* element(float* base, std::size_t stride, std::size_t i) {
+    return reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(base) + i * stride);
+}
+
+// Loads lanes [base, base + lanes) of strided xyz data; missing lanes repeat the first
+template<typename Lane>
+Vec load_lanes(Lane&& lane) {
+    return Vec(P::generate([&](std::size_t l) { return lane(l)[0]; }),
+               P::generate([&](std::size_t l) { return lane(l)[1]; }),
+               P::generate([&](std::size_t l) { return lane(l)[2]; }));
+}
+
+Vec load(const float* xyz, std::size_t stride, std::size_t base, std::size_t lanes) {
+    if (lanes == W) {
+        return load_lanes([&](std::size_t l) { return element(xyz, stride, base + l); });
+    }
+    return load_lanes([&](std::size_t l) { return element(xyz, stride, base + (l < lanes ? l : 0)); });
+}
+
+void store(const Vec& v, float* xyz, std::size_t stride, std::size_t base, std::size_t lanes) {
+    alignas(32) float x[W], y[W], z[W];
+    v.store_soa(x, y, z);
+    for (std::size_t l = 0; l < lanes; ++l) {
+        float* out = element(xyz, stride, base + l);
+        out[0] = x[l];
+        out[1] = y[l];
+        out[2] = z[l];
+    }
+}
+
+void normalize_kernel(float* xyz, std::size_t stride, std::size_t count, bool fast) {
+    const auto precision = fast ? math::NormalizePrecision::FAST : math::NormalizePrecision::EXACT;
+    for (std::size_t base = 0; base < count; base += W) {
+        const std::size_t lanes = count - base < W ? count - base : W;
+        store(math::detail::normalize_packet(load(xyz, stride, base, lanes), precision),
+              xyz, stride, base, lanes);
+    }
+}
+
+void bounds_kernel(const float* xyz, std::size_t stride, std::size_t count, float* min3, float* max3) {
+    if (count == 0) return;
+
+    Vec lo = load(xyz, stride, 0, count < W ? count : W);
+    Vec hi = lo;
+    for (std::size_t base = W; base < count; base += W) {
+        const Vec v = load(xyz, stride, base, count - base < W ? count - base : W);
+        lo = min(lo, v);
+        hi = max(hi, v);
+    }
+
+    min3[0] = reduce_min(lo.x); min3[1] = reduce_min(lo.y); min3[2] = reduce_min(lo.z);
+    max3[0] = reduce_max(hi.x); max3[1] = reduce_max(hi.y); max3[2] = reduce_max(hi.z);
+}
+
+void transform_kernel(const float* rows, bool projective, bool normalize,
+                      const float* in, std::size_t in_stride,
+                      float* out, std::size_t out_stride, std::size_t count, float* bounds6) {
+    math::detail::TransformRows<float> m;
+    for (std::size_t r = 0; r < 4; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            m.r[r][c] = rows[r * 4 + c];
+        }
+    }
+    m.projective = projective;
+
+    Vec lo(P(std::numeric_limits<float>::max()), P(std::numeric_limits<float>::max()),
+           P(std::numeric_limits<float>::max()));
+    Vec hi(P(std::numeric_limits<float>::lowest()), P(std::numeric_limits<float>::lowest()),
+           P(std::numeric_limits<float>::lowest()));
+
+    for (std::size_t base = 0; base < count; base += W) {
+        const std::size_t lanes = count - base < W ? count - base : W;
+        // Padding lanes repeat the first element, so they never widen the bounds
+        const Vec o = math::detail::transform_packet(m, load(in, in_stride, base, lanes),
+                                                     projective, normalize);
+        store(o, out, out_stride, base, lanes);
+        if (bounds6) {
+            lo = min(lo, o);
+            hi = max(hi, o);
+        }
+    }
+
+    if (bounds6) {
+        bounds6[0] = reduce_min(lo.x); bounds6[1] = reduce_min(lo.y); bounds6[2] = reduce_min(lo.z);
+        bounds6[3] = reduce_max(hi.x); bounds6[4] = reduce_max(hi.y); bounds6[5] = reduce_max(hi.z);
+    }
+}
+
+// Moller-Trumbore against eight triangles per step, with the accept rules of the
+// scalar test in algorithms/bvh.hpp
+bool intersect_ray_triangles_kernel(const float* origin3, const float* direction3, float t_max,
+                                    const float* triangles, std::size_t stride, std::size_t count,
+                                    RayTriangleHit* hit) {
+    const Vec origin{P(origin3[0]), P(origin3[1]), P(origin3[2])};
+    const Vec dir{P(direction3[0]), P(direction3[1]), P(direction3[2])};
+    const P tiny(std::numeric_limits<float>::min());
+
+    bool found = false;
+    float best_t = t_max;
+
+    for (std::size_t base = 0; base < count; base += W) {
+        const std::size_t lanes = count - base < W ? count - base : W;
+        const Vec v0 = load(triangles, stride, base, lanes);
+        const Vec e1 = load(triangles + 3, stride, base, lanes);
+        const Vec e2 = load(triangles + 6, stride, base, lanes);
+
+        const Vec p = dir.cross(e2);
+        const P det = e1.dot(p);
+        const P inv_det = P(1.0f) / det;
+
+        const Vec s = origin - v0;
+        const P u = s.dot(p) * inv_det;
+        const Vec q = s.cross(e1);
+        const P v = dir.dot(q) * inv_det;
+        const P t = e2.dot(q) * inv_det;
+
+        const auto accept = (abs(det) > tiny) & (u >= P::zero()) & (u <= P(1.0f)) & (v >= P::zero()) &
+                            (u + v <= P(1.0f)) & (t > P::zero()) & (t < P(best_t)) &
+                            (P::iota() < P(float(lanes)));
+        unsigned bits = accept.bits();
+        if (!bits) continue;
+
+        alignas(32) float ts[W], us[W], vs[W];
+        t.store(ts);
+        u.store(us);
+        v.store(vs);
+        for (std::size_t l = 0; bits; ++l, bits >>= 1) {
+            if ((bits & 1u) && ts[l] < best_t) {
+                best_t = ts[l];
+                hit->t = ts[l];
+                hit->triangle = static_cast<std::uint32_t>(base + l);
+                hit->u = us[l];
+                hit->v = vs[l];
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+namespace detail {
+
+const KernelTable& POLYGON_MESH_KERNEL_ENTRY() {
+    static const KernelTable table = {
+        POLYGON_MESH_KERNEL_ISA,
+        &normalize_kernel,
+        &bounds_kernel,
+        &transform_kernel,
+        &intersect_ray_triangles_kernel
+    };
+    return table;
+}
+
+} // namespace detail
+} // namespace kernels
+} // namespace polygon_mesh
@@ -0,0 +1,8 @@
+// Portable kernels: built with POLYGON_MESH_NO_SIMD so every packet is a plain lane array
+#ifndef POLYGON_MESH_NO_SIMD
+#define POLYGON_MESH_NO_SIMD
+#endif
+
+#define POLYGON_MESH_KERNEL_ENTRY scalar_kernels
+#define POLYGON_MESH_KERNEL_ISA Isa::SCALAR
+#include "kernels_impl.inl"
@@ -0,0 +1,4 @@
+// SSE2 kernels: the x86-64 baseline, built with the default compiler flags
+#define POLYGON_MESH_KERNEL_ENTRY sse2_kernels
+#define POLYGON_MESH_KERNEL_ISA Isa::SSE2
+#include "kernels_impl.inl"
@@ -0,0 +1,1983 @@
+// Algorithm and math tests. The asserts are the checks, so they stay on in every
+// build type, Release included.
+#undef NDEBUG
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <polygon_mesh/polygon_mesh.hpp>
+
+using namespace polygon_mesh;
+using namespace polygon_mesh::core;
+
+void test_mesh_transform() {
+    std::cout << "Testing mesh transform..." << std::endl;
+    
+    core::Meshf mesh;
+    auto v0 = mesh.add_vertex(math::Vector3f(0.0f, 0.0f, 0.0f));
+    auto v1 = mesh.add_vertex(math::Vector3f(1.0f, 0.0f, 0.0f));
+    auto v2 = mesh.add_vertex(math::Vector3f(0.0f, 1.0f, 0.0f));
+    mesh.add_triangle(v0, v1, v2);
+    mesh.compute_normals();
+    
+    // Axis-aligned transform: bounding box comes from the transformed corners
+    (void)mesh.bounding_box();
+    auto version = mesh.position_version();
+    auto scale = math::Matrix4f::translation(math::Vector3f(1.0f, 2.0f, 3.0f)) *
+                 math::Matrix4f::scaling(math::Vector3f(2.0f, 1.0f, -1.0f));
+    mesh.transform(scale);
+    assert(mesh.position_version() != version);
+
+    // Versions are never shared: copies and assignments draw fresh ones
+    core::Meshf copy = mesh;
+    assert(copy.position_version() != mesh.position_version());
+    assert(copy.topology_version() != mesh.topology_version());
+    core::Meshf assigned;
+    auto assigned_topology = assigned.topology_version();
+    assigned = copy;
+    assert(assigned.topology_version() != assigned_topology);
+    assert(assigned.topology_version() != copy.topology_version());
+    auto topology = assigned.topology_version();
+    std::swap(assigned.get_face(0).vertices[1], assigned.get_face(0).vertices[2]);
+    assert(assigned.topology_version() != topology);
+    assert(std::abs(mesh.get_vertex(v1).position.x - 3.0f) < 1e-6f);
+    assert(std::abs(mesh.get_vertex(v2).position.y - 3.0f) < 1e-6f);
+    assert(std::abs(mesh.get_vertex(v0).position.z - 3.0f) < 1e-6f);
+    const auto& bbox = mesh.bounding_box();
+    assert(std::abs(bbox.min_point.x - 1.0f) < 1e-6f && std::abs(bbox.max_point.x - 3.0f) < 1e-6f);
+    assert(std::abs(bbox.min_point.z - 3.0f) < 1e-6f && std::abs(bbox.max_point.z - 3.0f) < 1e-6f);
+    
+    // Mirroring z flips the +Z normal
+    assert(std::abs(mesh.get_face(0).normal.z + 1.0f) < 1e-6f);
+    assert(std::abs(mesh.vertices()[0].normal.z + 1.0f) < 1e-6f);
+    
+    // Rotation: normals stay unit length and perpendicular to the face
+    mesh.transform(math::Matrix4f::rotation_x(math::half_pi<float>()));
+    const auto& n = mesh.get_face(0).normal;
+    assert(std::abs(n.length() - 1.0f) < 1e-5f);
+    assert(std::abs(n.y - 1.0f) < 1e-5f);
+    
+    // Bounding box after a general rotation matches a full recomputation
+    const auto& rotated = mesh.bounding_box();
+    float min_y = std::min({mesh.vertices()[0].position.y, mesh.vertices()[1].position.y,
+                            mesh.vertices()[2].position.y});
+    assert(std::abs(rotated.min_point.y - min_y) < 1e-6f);
+    
+    // Span-based batch transform agrees with the scalar helper
+    std::vector<math::Vector3f> points;
+    for (int i = 0; i < 37; ++i) {
+        points.emplace_back(static_cast<float>(i), static_cast<float>(i) * 0.5f, -1.0f);
+    }
+    std::vector<math::Vector3f> out(points.size());
+    auto projection = math::Matrix4f::perspective(1.0f, 1.5f, 0.1f, 100.0f);
+    math::transform_points(projection, points, out);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        auto expected = projection.transform_point(points[i]);
+        assert(std::abs(out[i].x - expected.x) < 1e-5f);
+        assert(std::abs(out[i].y - expected.y) < 1e-5f);
+        assert(std::abs(out[i].z - expected.z) < 1e-5f);
+    }
+    
+    std::cout << "Mesh transform tests passed!" << std::endl;
+}
+
+void test_matrix_inverse() {
+    std::cout << "Testing Matrix4 inverse..." << std::endl;
+    
+    auto general = math::Matrix4d::perspective(0.8, 1.3, 0.5, 50.0) *
+                   math::Matrix4d::rotation_axis(math::Vector3d(0.3, -1.0, 0.2), 0.7) *
+                   math::Matrix4d::translation(math::Vector3d(1.0, -2.0, 3.0));
+    math::Matrix4d identity;
+    
+    auto inv = general.inverse();
+    auto product = general * inv;
+    for (std::size_t r = 0; r < 4; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            assert(std::abs(product(r, c) - identity(r, c)) < 1e-9);
+        }
+    }
+    
+    // Affine fast path agrees with the general inverse
+    auto affine = math::Matrix4d::translation(math::Vector3d(4.0, 5.0, -6.0)) *
+                  math::Matrix4d::rotation_z(0.4) * math::Matrix4d::scaling(math::Vector3d(2.0, 0.5, 3.0));
+    auto affine_inv = affine.affine_inverse();
+    auto full_inv = affine.inverse();
+    for (std::size_t r = 0; r < 4; ++r) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            assert(std::abs(affine_inv(r, c) - full_inv(r, c)) < 1e-12);
+        }
+    }
+    
+    // Tiny but regular scales are still invertible
+    auto tiny = math::Matrix4f::scaling(1e-3f);
+    math::Matrix4f tiny_inv;
+    assert(tiny.try_inverse(tiny_inv));
+    assert(std::abs(tiny_inv(0, 0) - 1000.0f) < 1e-2f);
+    
+    // Singular input is reported
+    math::Matrix4f singular(1.0f);
+    math::Matrix4f out;
+    assert(!singular.try_inverse(out));
+    try {
+        singular.inverse();
+        assert(false); // Should not reach here
+    } catch (const std::domain_error&) {
+        // Expected
+    }
+    
+    // Batched products and inverses agree with the scalar operations
+    std::vector<math::Matrix4f> lhs, rhs;
+    for (int i = 0; i < 50; ++i) {
+        lhs.push_back(math::Matrix4f::rotation_y(0.1f * i) * math::Matrix4f::translation(math::Vector3f(1.0f * i, 0.0f, 2.0f)));
+        rhs.push_back(math::Matrix4f::scaling(1.0f + 0.01f * i));
+    }
+    rhs[7] = math::Matrix4f(0.0f);
+    std::vector<math::Matrix4f> products(lhs.size()), inverses(lhs.size());
+    math::multiply_many(lhs, rhs, products);
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        assert(products[i] == lhs[i] * rhs[i]);
+    }
+    math::multiply_many(lhs[1], rhs, products);
+    assert(products[5] == lhs[1] * rhs[5]);
+    math::multiply_many<float>(utils::Span<const math::Matrix4f>(lhs.data(), 10), utils::Span<const math::Matrix4f>(rhs.data(), 10),
+                               utils::Span<math::Matrix4f>(products.data() + 10, 10));
+    assert(products[10] == lhs[0] * rhs[0]);
+    std::size_t singular_count = math::inverse_many(rhs, inverses, true);
+    assert(singular_count == 1);
+    assert(std::abs(inverses[3](0, 0) * rhs[3](0, 0) - 1.0f) < 1e-6f);
+    
+    std::cout << "Matrix4 inverse tests passed!" << std::endl;
+}
+
+template<std::size_t N>
+void check_simd_packets() {
+    using P = math::Packet<float, N>;
+    using V = math::Vector3xN<float, N>;
+
+    float xs[N], ys[N], zs[N];
+    std::uint32_t idx[N];
+    std::vector<math::Vector3f> points;
+    for (std::size_t i = 0; i < N; ++i) {
+        xs[i] = float(i) + 1.0f;
+        ys[i] = -float(i);
+        zs[i] = 0.5f * float(i);
+        idx[i] = static_cast<std::uint32_t>(N - 1 - i);
+        points.emplace_back(xs[i], ys[i], zs[i]);
+    }
+
+    // Packet arithmetic, comparisons and reductions
+    P a = P::load(xs);
+    P b(2.0f);
+    assert(reduce_add(a) == float(N * (N + 1) / 2));
+    assert(reduce_min(a) == 1.0f && reduce_max(a) == float(N));
+    assert(reduce_add(fmadd(a, b, P(1.0f))) == 2.0f * reduce_add(a) + float(N));
+    assert((a > b).count() == N - 2 && (a <= b).bits() == 0x3u);
+    assert(((a > b) | (a <= b)).all() && (~(a == a)).none());
+    assert(reduce_max(select(a > b, P::zero(), a)) == 2.0f);
+
+    float out[N] = {};
+    P::iota().store_partial(out, 2);
+    assert(out[0] == 0.0f && out[1] == 1.0f && (N < 3 || out[2] == 0.0f));
+
+    // AoS and SoA round trips, gather/scatter by index
+    V v = V::load(points.data());
+    assert(v.get(1) == points[1]);
+    V g = V::gather(points.data(), idx);
+    assert(g.get(0) == points[N - 1]);
+    std::vector<math::Vector3f> scattered(N);
+    g.scatter(scattered.data(), idx);
+    assert(scattered == points);
+
+    // Geometry matches the scalar Vector3 operations lane by lane
+    V w(math::Vector3f(0.0f, 1.0f, 2.0f));
+    P d = v.dot(w);
+    V c = v.cross(w);
+    V n = select(v.length_squared() > P(4.0f), v, V::zero()).normalize();
+    for (std::size_t i = 0; i < N; ++i) {
+        assert(std::abs(d[i] - points[i].dot(math::Vector3f(0.0f, 1.0f, 2.0f))) < 1e-5f);
+        assert((c.get(i) - points[i].cross(math::Vector3f(0.0f, 1.0f, 2.0f))).length() < 1e-5f);
+        if (points[i].length_squared() > 4.0f) {
+            assert((n.get(i) - points[i].normalize()).length() < 1e-5f);
+        } else {
+            assert(n.get(i) == math::Vector3f::zero());
+        }
+    }
+}
+
+void test_simd_packets() {
+    std::cout << "Testing SIMD packets..." << std::endl;
+    
+    check_simd_packets<4>();
+    check_simd_packets<8>();
+    check_simd_packets<16>();
+    
+    std::cout << "SIMD packet tests passed!" << std::endl;
+}
+
+void test_normalize_all() {
+    std::cout << "Testing batched normalize..." << std::endl;
+    
+    std::vector<math::Vector3f> vectors;
+    for (int i = 0; i < 37; ++i) {
+        vectors.emplace_back(float(i) - 18.0f, 0.25f * float(i), 3.0f);
+    }
+    vectors[5] = math::Vector3f(0.0f);
+    vectors[20] = math::Vector3f(1e-30f, 0.0f, 0.0f);  // squared length underflows
+    
+    for (auto precision : {math::NormalizePrecision::FAST, math::NormalizePrecision::EXACT}) {
+        auto normalized = vectors;
+        math::normalize_all(normalized, precision);
+        for (std::size_t i = 0; i < vectors.size(); ++i) {
+            if (i == 5 || i == 20) {
+                assert(normalized[i] == math::Vector3f(0.0f));
+            } else {
+                assert((normalized[i] - vectors[i].normalize()).length() < 1e-6f);
+            }
+        }
+    }
+    
+    // Strided form over the normal member of vertex structs
+    std::vector<Vertex<float>> verts(vectors.size());
+    for (std::size_t i = 0; i < verts.size(); ++i) {
+        verts[i].normal = vectors[i];
+        verts[i].position = vectors[i];
+    }
+    math::normalize_all(&verts[0].normal, verts.size(), sizeof(verts[0]));
+    assert(std::abs(verts[0].normal.length() - 1.0f) < 1e-6f);
+    assert(verts[0].position == vectors[0]);
+    
+    assert(std::abs(math::fast_inv_sqrt(4.0f) - 0.5f) < 1e-2f);
+    
+    std::cout << "Batched normalize tests passed!" << std::endl;
+}
+
+void test_remove_degenerate_faces() {
+    std::cout << "Testing degenerate face removal..." << std::endl;
+    
+    // Strip of 20 triangles so the SIMD batches see full and partial runs
+    core::Meshf mesh;
+    for (int i = 0; i <= 10; ++i) {
+        mesh.add_vertex(math::Vector3f(float(i), 0.0f, 0.0f));
+        mesh.add_vertex(math::Vector3f(float(i), 1.0f, 0.0f));
+    }
+    for (VertexId i = 0; i < 10; ++i) {
+        mesh.add_triangle(2 * i, 2 * i + 2, 2 * i + 1);
+        mesh.add_triangle(2 * i + 1, 2 * i + 2, 2 * i + 3);
+    }
+    
+    VertexId nan_vertex = mesh.add_vertex(math::Vector3f(std::nanf(""), 0.0f, 0.0f));
+    VertexId far_vertex = mesh.add_vertex(math::Vector3f(30.0f, 0.0f, 0.0f));
+    mesh.add_vertex(math::Vector3f(50.0f, 0.0f, 0.0f));  // never referenced
+    
+    mesh.add_triangle(0, 2, 4);                   // collinear: zero area
+    mesh.add_triangle(3, 3, 5);                   // repeated index
+    mesh.add_triangle(0, 1, nan_vertex);          // NaN coordinate
+    mesh.add_triangle(0, far_vertex, 1);          // valid, uses far_vertex
+    mesh.add_face({4, 6, 7, 5});                  // valid quad
+    mesh.add_face({0, 2, 4, 6});                  // collinear quad
+    mesh.add_triangle(2, 4, 3);
+    mesh.add_triangle(6, 8, 6);                   // repeated index
+    
+    auto stats = algorithms::processing::remove_degenerate_faces(mesh);
+    assert(stats.zero_area_faces == 2);
+    assert(stats.repeated_index_faces == 2);
+    assert(stats.non_finite_faces == 1);
+    assert(stats.removed_faces == 5);
+    assert(stats.removed_vertices == 0);
+    assert(mesh.face_count() == 23);
+    assert(mesh.vertex_count() == 25);
+    
+    // Order is preserved and ids are reassigned
+    assert(mesh.faces()[20].vertices == std::vector<VertexId>({0, far_vertex, 1}));
+    assert(mesh.faces()[21].vertices.size() == 4);
+    for (std::size_t f = 0; f < mesh.face_count(); ++f) {
+        assert(mesh.faces()[f].id == f);
+    }
+    
+    // Second pass drops the NaN and the unreferenced vertex and remaps indices
+    stats = algorithms::processing::remove_degenerate_faces(mesh, 1e-8f, true);
+    assert(stats.removed_faces == 0);
+    assert(stats.removed_vertices == 2);
+    assert(mesh.vertex_count() == 23);
+    assert(mesh.face_count() == 23);
+    assert(mesh.faces()[20].vertices == std::vector<VertexId>({0, 22, 1}));
+    assert(mesh.vertices()[22].position == math::Vector3f(30.0f, 0.0f, 0.0f));
+    assert(mesh.vertices()[22].id == 22);
+    assert(mesh.bounding_box().max_point.x == 30.0f);
+    
+    // A large min_area removes everything
+    stats = algorithms::processing::remove_degenerate_faces(mesh, 100.0f, true);
+    assert(stats.zero_area_faces == 23);
+    assert(mesh.face_count() == 0 && mesh.vertex_count() == 0);
+    
+    std::cout << "Degenerate face removal tests passed!" << std::endl;
+}
+
+// Flat (n+1) x (n+1) vertex grid in the xy plane, two triangles per cell
+core::Meshf make_grid(int n) {
+    core::Meshf mesh;
+    for (int y = 0; y <= n; ++y) {
+        for (int x = 0; x <= n; ++x) {
+            mesh.add_vertex(math::Vector3f(float(x), float(y), 0.0f));
+        }
+    }
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            VertexId v = VertexId(y * (n + 1) + x);
+            mesh.add_triangle(v, v + 1, v + VertexId(n) + 2);
+            mesh.add_triangle(v, v + VertexId(n) + 2, v + VertexId(n) + 1);
+        }
+    }
+    return mesh;
+}
+
+void test_laplacian_smoothing() {
+    std::cout << "Testing Laplacian smoothing..." << std::endl;
+    
+    const int n = 8;
+    auto mesh = make_grid(n);
+    const VertexId center = VertexId((n / 2) * (n + 1) + n / 2);
+    mesh.get_vertex(center).position.z = 1.0f;
+    
+    auto adjacency = algorithms::build_vertex_adjacency(mesh);
+    assert(adjacency.vertex_count() == mesh.vertex_count());
+    assert(adjacency.degree(center) == 6);
+    assert(adjacency.degree(0) == 3);
+    assert(adjacency.boundary[0] == 1 && adjacency.boundary[center] == 0);
+    assert(std::is_sorted(adjacency.neighbors.begin() + adjacency.offsets[center],
+                          adjacency.neighbors.begin() + adjacency.offsets[center + 1]));
+    
+    // One uniform step against a direct evaluation
+    auto once = mesh;
+    algorithms::processing::laplacian_smoothing(once, 1, 0.5f);
+    assert(std::abs(once.vertices()[center].position.z - 0.5f) < 1e-6f);
+    for (std::size_t k = adjacency.offsets[center]; k < adjacency.offsets[center + 1]; ++k) {
+        assert(std::abs(once.vertices()[adjacency.neighbors[k]].position.z - 0.5f / 6.0f) < 1e-6f);
+    }
+    assert(once.vertices()[0].position == mesh.vertices()[0].position);
+    assert(once.position_version() != mesh.position_version());
+    
+    // Many iterations flatten the bump while the pinned boundary stays put
+    algorithms::SmoothingConfig config;
+    config.iterations = 200;
+    for (auto weighting : {algorithms::SmoothingConfig::UNIFORM, algorithms::SmoothingConfig::COTANGENT}) {
+        config.weighting = weighting;
+        auto smoothed = mesh;
+        algorithms::processing::laplacian_smoothing(smoothed, config);
+        for (std::size_t v = 0; v < smoothed.vertex_count(); ++v) {
+            assert(std::abs(smoothed.vertices()[v].position.z) < 1e-3f);
+            if (adjacency.boundary[v]) {
+                assert(smoothed.vertices()[v].position == mesh.vertices()[v].position);
+            }
+        }
+    }
+    
+    // Cotangent rows are normalized
+    auto cotangent = algorithms::build_vertex_adjacency(mesh, algorithms::AdjacencyWeighting::COTANGENT);
+    assert(cotangent.weights.size() == cotangent.neighbors.size());
+    float row_sum = 0.0f;
+    for (std::size_t k = cotangent.offsets[center]; k < cotangent.offsets[center + 1]; ++k) {
+        row_sum += cotangent.weights[k];
+    }
+    assert(std::abs(row_sum - 1.0f) < 1e-5f);
+    
+    // Without pinning the boundary shrinks inwards
+    config.weighting = algorithms::SmoothingConfig::UNIFORM;
+    config.pin_boundaries = false;
+    config.iterations = 10;
+    auto shrunk = mesh;
+    algorithms::processing::laplacian_smoothing(shrunk, config);
+    assert(shrunk.vertices()[0].position.x > 0.0f);
+    
+    std::cout << "Laplacian smoothing tests passed!" << std::endl;
+}
+
+void test_taubin_smoothing() {
+    std::cout << "Testing Taubin smoothing..." << std::endl;
+    
+    const int n = 8;
+    auto mesh = make_grid(n);
+    for (std::size_t v = 0; v < mesh.vertex_count(); ++v) {
+        mesh.get_vertex(VertexId(v)).position.z = float((v * 7) % 5) * 0.1f;
+    }
+    
+    // The fused pass matches alternating lambda / mu Laplacian steps
+    algorithms::SmoothingConfig config;
+    config.type = algorithms::SmoothingConfig::TAUBIN;
+    config.iterations = 3;
+    for (bool pin : {true, false}) {
+        for (auto weighting : {algorithms::SmoothingConfig::UNIFORM, algorithms::SmoothingConfig::COTANGENT}) {
+            config.pin_boundaries = pin;
+            config.weighting = weighting;
+            
+            auto fused = mesh;
+            algorithms::processing::smooth(fused, config);
+            
+            auto reference = mesh;
+            algorithms::SmoothingConfig step = config;
+            step.type = algorithms::SmoothingConfig::LAPLACIAN;
+            step.iterations = 1;
+            for (std::size_t i = 0; i < config.iterations; ++i) {
+                step.lambda = config.lambda;
+                algorithms::processing::laplacian_smoothing(reference, step);
+                step.lambda = config.mu;
+                algorithms::processing::laplacian_smoothing(reference, step);
+            }
+            
+            // Separate runs rebuild cotangent weights from the moved positions, so
+            // only uniform runs agree exactly
+            if (weighting == algorithms::SmoothingConfig::UNIFORM) {
+                for (std::size_t v = 0; v < mesh.vertex_count(); ++v) {
+                    assert((fused.vertices()[v].position - reference.vertices()[v].position).length() < 1e-5f);
+                }
+            }
+            assert(fused.position_version() != mesh.position_version());
+        }
+    }
+    
+    // Unlike plain Laplacian smoothing, Taubin barely shrinks a free boundary
+    config.weighting = algorithms::SmoothingConfig::UNIFORM;
+    config.pin_boundaries = false;
+    config.iterations = 10;
+    auto taubin = mesh;
+    algorithms::processing::taubin_smoothing(taubin, config);
+    auto laplacian = mesh;
+    config.type = algorithms::SmoothingConfig::LAPLACIAN;
+    algorithms::processing::laplacian_smoothing(laplacian, config);
+    assert(taubin.vertices()[0].position.x < laplacian.vertices()[0].position.x);
+    
+    std::cout << "Taubin smoothing tests passed!" << std::endl;
+}
+
+// Closed latitude-longitude sphere
+core::Meshf make_sphere(int rings, int segments, float radius) {
+    const float pi = 3.14159265f;
+    core::Meshf mesh;
+    mesh.add_vertex(math::Vector3f(0.0f, 0.0f, radius));
+    for (int r = 1; r < rings; ++r) {
+        const float theta = pi * float(r) / float(rings);
+        for (int s = 0; s < segments; ++s) {
+            const float phi = 2.0f * pi * float(s) / float(segments);
+            mesh.add_vertex(math::Vector3f(radius * std::sin(theta) * std::cos(phi),
+                                           radius * std::sin(theta) * std::sin(phi),
+                                           radius * std::cos(theta)));
+        }
+    }
+    const VertexId south = mesh.add_vertex(math::Vector3f(0.0f, 0.0f, -radius));
+    auto ring_vertex = [&](int r, int s) { return VertexId(1 + (r - 1) * segments + (s % segments)); };
+    for (int s = 0; s < segments; ++s) {
+        mesh.add_triangle(0, ring_vertex(1, s), ring_vertex(1, s + 1));
+        for (int r = 1; r + 1 < rings; ++r) {
+            mesh.add_triangle(ring_vertex(r, s), ring_vertex(r + 1, s), ring_vertex(r + 1, s + 1));
+            mesh.add_triangle(ring_vertex(r, s), ring_vertex(r + 1, s + 1), ring_vertex(r, s + 1));
+        }
+        mesh.add_triangle(south, ring_vertex(rings - 1, s + 1), ring_vertex(rings - 1, s));
+    }
+    return mesh;
+}
+
+// Number of faces using each undirected edge, and whether every face is a proper triangle
+bool edge_uses(const core::Meshf& mesh, std::vector<int>& counts) {
+    std::vector<std::pair<VertexId, VertexId>> edges;
+    for (const auto& face : mesh.faces()) {
+        const auto& ids = face.vertices;
+        if (ids.size() != 3 || ids[0] == ids[1] || ids[1] == ids[2] || ids[0] == ids[2]) return false;
+        for (std::size_t i = 0; i < 3; ++i) {
+            edges.emplace_back(std::min(ids[i], ids[(i + 1) % 3]), std::max(ids[i], ids[(i + 1) % 3]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    counts.clear();
+    for (std::size_t i = 0; i < edges.size();) {
+        std::size_t j = i;
+        while (j < edges.size() && edges[j] == edges[i]) ++j;
+        counts.push_back(int(j - i));
+        i = j;
+    }
+    return true;
+}
+
+void test_quadric_decimation() {
+    std::cout << "Testing quadric decimation..." << std::endl;
+    
+    assert(features::has_mesh_decimation());
+    
+    // Closed sphere: stays closed and close to the surface
+    auto sphere = make_sphere(24, 48, 2.0f);
+    const std::size_t original = sphere.face_count();
+    algorithms::processing::quadric_decimation(sphere, 0.9f);
+    assert(sphere.face_count() <= original / 10 + 1);
+    assert(sphere.face_count() >= original / 10 - 1);
+    std::vector<int> counts;
+    assert(edge_uses(sphere, counts));
+    for (int c : counts) assert(c == 2);
+    for (const auto& v : sphere.vertices()) {
+        assert(std::abs(v.position.length() - 2.0f) < 0.15f);
+    }
+    for (const auto& face : sphere.faces()) {
+        const auto& p = sphere.vertices()[face.vertices[0]].position;
+        assert(face.normal.dot(p) > 0.0f);  // still facing outwards
+    }
+    
+    // Flat grid with preserved boundaries: stays flat, boundary vertices untouched
+    auto grid = make_grid(20);
+    std::vector<math::Vector3f> boundary;
+    auto adjacency = algorithms::build_vertex_adjacency(grid);
+    for (std::size_t v = 0; v < grid.vertex_count(); ++v) {
+        if (adjacency.boundary[v]) boundary.push_back(grid.vertices()[v].position);
+    }
+    
+    algorithms::DecimationConfig config;
+    config.target_triangles = 200;
+    algorithms::processing::quadric_decimation(grid, config);
+    assert(grid.face_count() <= 200 && grid.face_count() >= 150);
+    assert(edge_uses(grid, counts));
+    for (int c : counts) assert(c == 1 || c == 2);
+    for (const auto& v : grid.vertices()) assert(v.position.z == 0.0f);
+    for (const auto& p : boundary) {
+        bool found = false;
+        for (const auto& v : grid.vertices()) found = found || v.position == p;
+        assert(found);
+    }
+    
+    // Without preserve_boundaries the outline can be simplified too
+    auto open = make_grid(20);
+    config.preserve_boundaries = false;
+    config.target_triangles = 8;
+    algorithms::processing::quadric_decimation(open, config);
+    assert(open.face_count() <= 8);
+    assert(open.bounding_box().max_point.x > 19.9f && open.bounding_box().min_point.y < 0.1f);
+    
+    std::cout << "Quadric decimation tests passed!" << std::endl;
+}
+
+// Largest distance from a vertex of either mesh to the surface of the other
+float surface_distance(const core::Meshf& a, const core::Meshf& b) {
+    float largest = 0.0f;
+    for (int pass = 0; pass < 2; ++pass) {
+        const core::Meshf& from = pass == 0 ? a : b;
+        const algorithms::spatial::BVH<float> bvh(pass == 0 ? b : a);
+        for (const auto& v : from.vertices()) {
+            largest = std::max(largest, algorithms::spatial::closest_point(bvh, v.position).distance);
+        }
+    }
+    return largest;
+}
+
+void test_partitioned_decimation() {
+    std::cout << "Testing partitioned decimation..." << std::endl;
+    
+    // Same guarantees as the serial path, with clusters far smaller than the mesh
+    auto sphere = make_sphere(40, 80, 2.0f);
+    const std::size_t original = sphere.face_count();
+    algorithms::DecimationConfig config;
+    config.reduction_ratio = 0.9f;
+    config.partitions = 16;
+    algorithms::processing::quadric_decimation(sphere, config);
+    assert(sphere.face_count() <= original / 10 + 1);
+    assert(sphere.face_count() >= original / 10 - 1);
+    std::vector<int> counts;
+    assert(edge_uses(sphere, counts));
+    for (int c : counts) assert(c == 2);
+    for (const auto& v : sphere.vertices()) {
+        assert(std::abs(v.position.length() - 2.0f) < 0.15f);
+    }
+    for (const auto& face : sphere.faces()) {
+        const auto& p = sphere.vertices()[face.vertices[0]].position;
+        assert(face.normal.dot(p) > 0.0f);
+    }
+    
+    // Seams cross the grid; the outline and the plane still hold
+    auto grid = make_grid(40);
+    std::vector<math::Vector3f> boundary;
+    auto adjacency = algorithms::build_vertex_adjacency(grid);
+    for (std::size_t v = 0; v < grid.vertex_count(); ++v) {
+        if (adjacency.boundary[v]) boundary.push_back(grid.vertices()[v].position);
+    }
+    config.reduction_ratio = 0.8f;
+    config.partitions = 7;
+    algorithms::processing::quadric_decimation(grid, config);
+    assert(grid.face_count() <= 640 && grid.face_count() >= 600);
+    assert(edge_uses(grid, counts));
+    for (int c : counts) assert(c == 1 || c == 2);
+    for (const auto& v : grid.vertices()) assert(v.position.z == 0.0f);
+    for (const auto& p : boundary) {
+        bool found = false;
+        for (const auto& v : grid.vertices()) found = found || v.position == p;
+        assert(found);
+    }
+    
+    // More partitions than triangles leaves most clusters empty
+    auto small = make_sphere(4, 8, 1.0f);
+    config.partitions = 1000;
+    config.reduction_ratio = 0.5f;
+    algorithms::processing::quadric_decimation(small, config);
+    assert(small.face_count() > 0 && small.face_count() <= 24);
+    assert(edge_uses(small, counts));
+    for (int c : counts) assert(c == 2);
+    
+    // Clusters hemmed in by their seams must not give up accuracy: on a wavy height
+    // field the error stays close to that of the serial path
+    auto terrain = make_grid(120);
+    for (std::size_t v = 0; v < terrain.vertex_count(); ++v) {
+        auto& p = terrain.get_vertex(VertexId(v)).position;
+        p.z = 3.0f * std::sin(p.x * 0.08f) * std::cos(p.y * 0.11f) + 0.5f * std::sin(p.x * 0.5f + p.y * 0.3f);
+    }
+    config.reduction_ratio = 0.95f;
+    config.partitions = 0;
+    auto serial = terrain;
+    algorithms::processing::quadric_decimation(serial, config);
+    const float serial_error = surface_distance(terrain, serial);
+    for (std::size_t partitions : {4, 16, 64}) {
+        auto partitioned = terrain;
+        config.partitions = partitions;
+        algorithms::processing::quadric_decimation(partitioned, config);
+        assert(partitioned.face_count() == serial.face_count());
+        assert(surface_distance(terrain, partitioned) < 2.0f * serial_error);
+    }
+    
+    std::cout << "Partitioned decimation tests passed!" << std::endl;
+}
+
+void test_edge_collapse_decimation() {
+    std::cout << "Testing edge collapse decimation..." << std::endl;
+    
+    // Exact budget on a closed sphere, which stays closed and outward facing
+    auto sphere = make_sphere(24, 48, 2.0f);
+    const std::size_t original = sphere.face_count();
+    auto result = algorithms::processing::edge_collapse_decimation(sphere, 500);
+    assert(sphere.face_count() == 500);
+    assert(result.initial_triangles == original && result.final_triangles == 500 && !result.cancelled);
+    assert(result.collapses == (original - 500) / 2);
+    std::vector<int> counts;
+    assert(edge_uses(sphere, counts));
+    for (int c : counts) assert(c == 2);
+    for (const auto& face : sphere.faces()) {
+        const auto& p = sphere.vertices()[face.vertices[0]].position;
+        assert(face.normal.dot(p) > 0.0f);
+    }
+    
+    // A closed surface has an even triangle count, so an odd budget ends one above
+    auto odd = make_sphere(24, 48, 2.0f);
+    algorithms::processing::edge_collapse_decimation(odd, 501);
+    assert(odd.face_count() == 502);
+    
+    // A closed surface cannot go below a tetrahedron
+    auto tetrahedron = make_sphere(8, 16, 1.0f);
+    algorithms::processing::edge_collapse_decimation(tetrahedron, 0);
+    assert(tetrahedron.face_count() == 4);
+    assert(edge_uses(tetrahedron, counts));
+    for (int c : counts) assert(c == 2);
+    
+    // With movable boundaries single-triangle collapses make any budget reachable
+    auto grid = make_grid(20);
+    algorithms::DecimationConfig config;
+    config.target_triangles = 333;
+    config.preserve_boundaries = false;
+    algorithms::processing::edge_collapse_decimation(grid, config);
+    assert(grid.face_count() == 333);
+    assert(edge_uses(grid, counts));
+    for (int c : counts) assert(c == 1 || c == 2);
+    
+    // A short rung across a strip joins two boundary vertices; collapsing it would
+    // leave two triangles meeting at a single vertex
+    core::Meshf strip;
+    for (int i = 0; i < 3; ++i) strip.add_vertex(math::Vector3f(float(i), 0.0f, 0.0f));
+    for (int i = 0; i < 3; ++i) strip.add_vertex(math::Vector3f(float(i), i == 1 ? 0.1f : 1.0f, 0.0f));
+    strip.add_triangle(0, 1, 4);
+    strip.add_triangle(0, 4, 3);
+    strip.add_triangle(1, 2, 5);
+    strip.add_triangle(1, 5, 4);
+    config = algorithms::DecimationConfig();
+    config.target_triangles = 2;
+    config.preserve_boundaries = false;
+    algorithms::processing::edge_collapse_decimation(strip, config);
+    assert(strip.face_count() >= 2);
+    std::vector<std::pair<VertexId, VertexId>> strip_edges;
+    for (const auto& face : strip.faces()) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            const VertexId a = face.vertices[i], b = face.vertices[(i + 1) % 3];
+            strip_edges.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+    std::sort(strip_edges.begin(), strip_edges.end());
+    std::vector<int> boundary_edges(strip.vertex_count(), 0);
+    for (std::size_t i = 0; i < strip_edges.size(); ++i) {
+        const bool single = (i == 0 || strip_edges[i - 1] != strip_edges[i]) &&
+                            (i + 1 == strip_edges.size() || strip_edges[i + 1] != strip_edges[i]);
+        if (!single) continue;
+        ++boundary_edges[strip_edges[i].first];
+        ++boundary_edges[strip_edges[i].second];
+    }
+    for (int count : boundary_edges) assert(count == 0 || count == 2);
+    
+    // Custom cost: edges on the -x side are cheap, so that side is simplified first
+    auto lopsided = make_grid(20);
+    auto cheap_left = [](const math::Vector3f& a, const math::Vector3f& b, math::Vector3f& target) {
+        target = (a + b) * 0.5f;
+        return target.x < 10.0f ? (a - b).length_squared() : 1000.0f + (a - b).length_squared();
+    };
+    algorithms::processing::edge_collapse_decimation(lopsided, 500, cheap_left);
+    assert(lopsided.face_count() == 500);
+    std::size_t left = 0, right = 0;
+    for (const auto& v : lopsided.vertices()) {
+        if (v.position.x < 9.5f) ++left;
+        if (v.position.x > 10.5f) ++right;
+    }
+    assert(left < right);
+    
+    // A raised cancel flag stops the run and leaves the mesh alone
+    auto cancelled = make_sphere(24, 48, 2.0f);
+    std::atomic<bool> cancel(true);
+    result = algorithms::processing::edge_collapse_decimation(cancelled, 100, algorithms::processing::ShortestEdgeCost(), &cancel);
+    assert(result.cancelled && result.collapses == 0);
+    assert(cancelled.face_count() == original);
+    
+    std::cout << "Edge collapse decimation tests passed!" << std::endl;
+}
+
+// Closed cube [-1, 1]^3 with n x n quads (split into triangles) per side; vertices along
+// the edges are repeated per side
+core::Meshf make_box(int n) {
+    core::Meshf mesh;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = -1; side <= 1; side += 2) {
+            const VertexId base = VertexId(mesh.vertex_count());
+            for (int j = 0; j <= n; ++j) {
+                for (int i = 0; i <= n; ++i) {
+                    float p[3];
+                    p[axis] = float(side);
+                    p[(axis + 1) % 3] = -1.0f + 2.0f * float(i) / float(n);
+                    p[(axis + 2) % 3] = -1.0f + 2.0f * float(j) / float(n);
+                    mesh.add_vertex(math::Vector3f(p[0], p[1], p[2]));
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                for (int i = 0; i < n; ++i) {
+                    const VertexId v = base + VertexId(j * (n + 1) + i);
+                    const VertexId right = v + 1, up = v + VertexId(n) + 1, diagonal = v + VertexId(n) + 2;
+                    if (side > 0) {
+                        mesh.add_triangle(v, right, diagonal);
+                        mesh.add_triangle(v, diagonal, up);
+                    } else {
+                        mesh.add_triangle(v, diagonal, right);
+                        mesh.add_triangle(v, up, diagonal);
+                    }
+                }
+            }
+        }
+    }
+    return mesh;
+}
+
+void test_cluster_decimation() {
+    std::cout << "Testing cluster decimation..." << std::endl;
+    
+    using algorithms::processing::ClusterRepresentative;
+    
+    // Far fewer vertices than cells on a coarse grid, every face a proper polygon
+    auto sphere = make_sphere(40, 80, 2.0f);
+    const std::size_t original = sphere.face_count();
+    auto mean = sphere;
+    algorithms::processing::cluster_decimation(sphere, 8);
+    algorithms::processing::cluster_decimation(mean, 8, ClusterRepresentative::MEAN);
+    assert(sphere.face_count() > 0 && sphere.face_count() < original / 10);
+    assert(sphere.vertex_count() <= 8 * 8 * 8);
+    assert(mean.vertex_count() == sphere.vertex_count());
+    for (const auto* mesh : {&sphere, &mean}) {
+        for (const auto& face : mesh->faces()) {
+            const auto& ids = face.vertices;
+            assert(ids.size() >= 3);
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                assert(ids[i] < mesh->vertex_count() && ids[i] != ids[(i + 1) % ids.size()]);
+            }
+        }
+    }
+    
+    // Quadric points snap to the edges and corners of a box; means round them off
+    auto box = make_box(30);
+    auto rounded = box;
+    algorithms::processing::cluster_decimation(box, 8);
+    algorithms::processing::cluster_decimation(rounded, 8, ClusterRepresentative::MEAN);
+    auto off_surface = [](const core::Meshf& mesh) {
+        float worst = 0.0f;
+        for (const auto& v : mesh.vertices()) {
+            const auto& p = v.position;
+            worst = std::max(worst, std::abs(std::max({std::abs(p.x), std::abs(p.y), std::abs(p.z)}) - 1.0f));
+        }
+        return worst;
+    };
+    assert(off_surface(box) < 1e-4f);
+    assert(off_surface(rounded) > 0.05f);
+    
+    // A plane is rank deficient everywhere, so cells fall back to their means and stay flat
+    auto grid = make_grid(40);
+    algorithms::processing::cluster_decimation(grid, 4);
+    assert(grid.vertex_count() <= 25 && grid.face_count() > 0);
+    for (const auto& v : grid.vertices()) assert(v.position.z == 0.0f);
+    
+    // Streaming the sphere in chunks finds the same cells, and merges repeated triangles
+    auto whole = make_sphere(40, 80, 2.0f);
+    auto copy = whole;
+    algorithms::processing::cluster_decimation(copy, 8);
+    algorithms::processing::ClusterDecimator<float> decimator(whole.bounding_box().min_point,
+                                                              whole.bounding_box().max_point, 8);
+    std::vector<math::Vector3f> soup;
+    for (std::size_t f = 0; f < whole.face_count(); ++f) {
+        for (auto id : whole.faces()[f].vertices) soup.push_back(whole.vertices()[id].position);
+        if (soup.size() >= 300 || f + 1 == whole.face_count()) {
+            decimator.add_triangles(soup);
+            soup.clear();
+        }
+    }
+    auto streamed = decimator.extract();
+    assert(streamed.vertex_count() == copy.vertex_count());
+    assert(streamed.face_count() > 0 && streamed.face_count() <= copy.face_count());
+    assert(streamed.face_count() == decimator.triangle_count());
+    
+    // Bad resolutions are rejected
+    bool threw = false;
+    try {
+        algorithms::processing::cluster_decimation(whole, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Cluster decimation tests passed!" << std::endl;
+}
+
+void test_loop_subdivision() {
+    std::cout << "Testing Loop subdivision..." << std::endl;
+    
+    assert(features::has_subdivision_surfaces());
+    
+    // Closed sphere: 4x the faces per level, still closed, Euler characteristic kept
+    auto sphere = make_sphere(8, 16, 1.0f);
+    std::vector<int> counts;
+    assert(edge_uses(sphere, counts));
+    const std::size_t v0 = sphere.vertex_count(), e0 = counts.size(), f0 = sphere.face_count();
+    algorithms::processing::loop_subdivision(sphere, 2);
+    assert(sphere.face_count() == f0 * 16);
+    assert(sphere.vertex_count() == v0 + e0 + (2 * e0 + 3 * f0));
+    assert(edge_uses(sphere, counts));
+    for (int c : counts) assert(c == 2);
+    assert(long(sphere.vertex_count()) - long(counts.size()) + long(sphere.face_count()) == 2);
+    for (const auto& v : sphere.vertices()) {
+        assert(std::abs(v.position.length() - 1.0f) < 0.1f);
+    }
+    
+    // Boundaries follow the curve rule, so a flat square keeps its outline
+    auto grid = make_grid(4);
+    algorithms::processing::loop_subdivision(grid, 2);
+    assert(grid.face_count() == 32 * 16);
+    const auto bounds = grid.bounding_box();
+    assert(bounds.min_point.x == 0.0f && bounds.max_point.x == 4.0f);
+    assert(bounds.min_point.y == 0.0f && bounds.max_point.y == 4.0f);
+    for (const auto& v : grid.vertices()) {
+        assert(v.position.z == 0.0f);
+    }
+    
+    // Welded cube of quads: smooth subdivision rounds it, creases along its edges keep it
+    core::Meshf cube;
+    for (int i = 0; i < 8; ++i) {
+        cube.add_vertex(math::Vector3f(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+    }
+    cube.add_quad(0, 2, 3, 1);
+    cube.add_quad(4, 5, 7, 6);
+    cube.add_quad(0, 1, 5, 4);
+    cube.add_quad(2, 6, 7, 3);
+    cube.add_quad(0, 4, 6, 2);
+    cube.add_quad(1, 3, 7, 5);
+    auto off_cube = [](const core::Meshf& mesh) {
+        float worst = 0.0f;
+        for (const auto& v : mesh.vertices()) {
+            const auto& p = v.position;
+            worst = std::max(worst, std::abs(std::max({std::abs(p.x), std::abs(p.y), std::abs(p.z)}) - 1.0f));
+        }
+        return worst;
+    };
+    
+    algorithms::SubdivisionConfig config;
+    config.levels = 3;
+    auto rounded = cube;
+    algorithms::processing::loop_subdivision(rounded, config);
+    assert(rounded.face_count() == 12 * 64);
+    assert(off_cube(rounded) > 0.1f);
+    
+    config.crease_angle = 30.0f;
+    auto creased = cube;
+    algorithms::processing::loop_subdivision(creased, config);
+    assert(off_cube(creased) < 1e-5f);
+    for (int i = 0; i < 8; ++i) {
+        assert(creased.vertices()[i].position == cube.vertices()[i].position);
+    }
+    
+    // Listing the same edges gives the same surface; limit positions stay on the cube too
+    config.crease_angle = 0.0f;
+    std::vector<std::pair<VertexId, VertexId>> creases;
+    for (VertexId a = 0; a < 8; ++a) {
+        for (VertexId b = a + 1; b < 8; ++b) {
+            const VertexId d = a ^ b;
+            if (d == 1 || d == 2 || d == 4) creases.emplace_back(a, b);
+        }
+    }
+    auto listed = cube;
+    algorithms::processing::loop_subdivision(listed, config, creases);
+    assert(listed.vertex_count() == creased.vertex_count());
+    for (std::size_t v = 0; v < listed.vertex_count(); ++v) {
+        assert(listed.vertices()[v].position == creased.vertices()[v].position);
+    }
+    config.limit_surface = true;
+    auto limit = cube;
+    algorithms::processing::loop_subdivision(limit, config, creases);
+    assert(limit.vertex_count() == creased.vertex_count());
+    assert(off_cube(limit) < 1e-5f);
+    
+    // Crease vertices must exist
+    bool threw = false;
+    try {
+        algorithms::processing::loop_subdivision(limit, config, {{0, VertexId(limit.vertex_count())}});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Loop subdivision tests passed!" << std::endl;
+}
+
+void test_catmull_clark_subdivision() {
+    std::cout << "Testing Catmull-Clark subdivision..." << std::endl;
+    
+    using algorithms::processing::CatmullClarkRefiner;
+    
+    core::Meshf cube;
+    for (int i = 0; i < 8; ++i) {
+        cube.add_vertex(math::Vector3f(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+    }
+    cube.add_quad(0, 2, 3, 1);
+    cube.add_quad(4, 5, 7, 6);
+    cube.add_quad(0, 1, 5, 4);
+    cube.add_quad(2, 6, 7, 3);
+    cube.add_quad(0, 4, 6, 2);
+    cube.add_quad(1, 3, 7, 5);
+    auto near = [](const math::Vector3f& a, const math::Vector3f& b, float tolerance) {
+        return (a - b).length() < tolerance;
+    };
+    
+    // One level: vertex, edge and face points, every face split into quads, corner at 5/9
+    auto once = cube;
+    algorithms::processing::catmull_clark_subdivision(once, 1);
+    assert(once.vertex_count() == 8 + 12 + 6 && once.face_count() == 24);
+    assert(near(once.vertices()[7].position, math::Vector3f(5.0f / 9.0f), 1e-6f));
+    auto twice = cube;
+    algorithms::processing::catmull_clark_subdivision(twice, 2);
+    assert(twice.vertex_count() == 98 && twice.face_count() == 96);
+    for (const auto& face : twice.faces()) assert(face.vertices.size() == 4);
+    
+    // subdivide() follows config.type
+    algorithms::SubdivisionConfig chosen;
+    chosen.type = algorithms::SubdivisionConfig::CATMULL_CLARK;
+    auto dispatched = cube;
+    algorithms::processing::subdivide(dispatched, chosen);
+    assert(dispatched.vertex_count() == once.vertex_count() && dispatched.face_count() == once.face_count());
+    for (std::size_t v = 0; v < once.vertex_count(); ++v) {
+        assert(dispatched.vertices()[v].position == once.vertices()[v].position);
+    }
+    chosen.type = algorithms::SubdivisionConfig::LOOP;
+    dispatched = cube;
+    algorithms::processing::subdivide(dispatched, chosen);
+    assert(dispatched.face_count() == 12 * 4);
+    for (const auto& face : dispatched.faces()) assert(face.vertices.size() == 3);
+    
+    // Limit points do not depend on the level they are taken from, and the levels converge to them
+    algorithms::SubdivisionConfig config;
+    config.levels = 0;
+    config.limit_surface = true;
+    const CatmullClarkRefiner<float> limit0(cube, config);
+    config.levels = 2;
+    const CatmullClarkRefiner<float> limit2(cube, config);
+    config.levels = 6;
+    config.limit_surface = false;
+    const CatmullClarkRefiner<float> deep(cube, config);
+    std::vector<math::Vector3f> control;
+    for (const auto& v : cube.vertices()) control.push_back(v.position);
+    std::vector<math::Vector3f> p0(limit0.vertex_count()), p2(limit2.vertex_count()), p6(deep.vertex_count());
+    limit0.evaluate(control.data(), p0.data());
+    limit2.evaluate(control.data(), p2.data());
+    deep.evaluate(control.data(), p6.data());
+    for (std::size_t v = 0; v < 8; ++v) {
+        assert(near(p0[v], p2[v], 1e-5f));
+        assert(near(p0[v], p6[v], 1e-3f));
+    }
+    
+    // Re-evaluation is the same linear map: moving the cage matches refining it again
+    config.levels = 2;
+    const CatmullClarkRefiner<float> refiner(cube, config);
+    assert(refiner.control_count() == 8 && refiner.vertex_count() == 98 && refiner.face_count() == 96);
+    core::Meshf refined;
+    refiner.refine(cube, refined);
+    auto moved = cube;
+    moved.update_vertices([](core::Vertex<float>* vertices, std::size_t n) {
+        for (std::size_t v = 0; v < n; ++v) vertices[v].position = vertices[v].position * 2.0f + math::Vector3f(1.0f, 0.0f, 0.0f);
+    });
+    refiner.update(moved, refined);
+    algorithms::processing::catmull_clark_subdivision(moved, config);
+    for (std::size_t v = 0; v < refined.vertex_count(); ++v) {
+        assert(near(refined.vertices()[v].position, moved.vertices()[v].position, 1e-5f));
+    }
+    
+    // Creases along the cube's edges keep it a cube, on the limit surface too
+    auto off_cube = [](const core::Meshf& mesh) {
+        float worst = 0.0f;
+        for (const auto& v : mesh.vertices()) {
+            const auto& p = v.position;
+            worst = std::max(worst, std::abs(std::max({std::abs(p.x), std::abs(p.y), std::abs(p.z)}) - 1.0f));
+        }
+        return worst;
+    };
+    config.crease_angle = 30.0f;
+    config.limit_surface = true;
+    auto creased = cube;
+    algorithms::processing::catmull_clark_subdivision(creased, config);
+    assert(off_cube(creased) < 1e-5f);
+    assert(off_cube(twice) > 0.1f);
+    
+    // Triangles become three quads each; a flat boundary stays flat and keeps its outline
+    auto grid = make_grid(4);
+    algorithms::processing::catmull_clark_subdivision(grid, 1);
+    assert(grid.face_count() == 32 * 3);
+    const auto bounds = grid.bounding_box();
+    assert(bounds.min_point.x == 0.0f && bounds.max_point.x == 4.0f);
+    for (const auto& v : grid.vertices()) assert(v.position.z == 0.0f);
+    
+    // Meshes that do not match the cage are rejected
+    bool threw = false;
+    try {
+        refiner.update(grid, refined);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Catmull-Clark subdivision tests passed!" << std::endl;
+}
+
+// Signed volume, and whether no directed edge is used twice (consistent winding)
+float signed_volume(const core::Meshf& mesh, bool& consistent) {
+    std::vector<std::pair<VertexId, VertexId>> sides;
+    float volume = 0.0f;
+    for (const auto& face : mesh.faces()) {
+        const auto& ids = face.vertices;
+        for (std::size_t i = 0; i < ids.size(); ++i) sides.emplace_back(ids[i], ids[(i + 1) % ids.size()]);
+        for (std::size_t i = 1; i + 1 < ids.size(); ++i) {
+            volume += mesh.vertices()[ids[0]].position.dot(
+                mesh.vertices()[ids[i]].position.cross(mesh.vertices()[ids[i + 1]].position)) / 6.0f;
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+    consistent = std::adjacent_find(sides.begin(), sides.end()) == sides.end();
+    return volume;
+}
+
+void test_make_normals_consistent() {
+    std::cout << "Testing normal orientation..." << std::endl;
+    
+    using algorithms::processing::make_normals_consistent;
+    
+    // A sphere with every third face reversed is restored and faces outward
+    auto sphere = make_sphere(16, 32, 1.0f);
+    bool consistent = false;
+    const float volume = signed_volume(sphere, consistent);
+    assert(consistent && volume > 0.0f);
+    std::size_t reversed = 0;
+    for (std::size_t f = 0; f < sphere.face_count(); f += 3, ++reversed) {
+        auto& ids = sphere.get_face(FaceId(f)).vertices;
+        std::swap(ids[1], ids[2]);
+    }
+    auto stats = make_normals_consistent(sphere);
+    assert(stats.components == 1 && stats.closed_components == 1);
+    assert(stats.flipped_faces == reversed && stats.inconsistent_edges == 0);
+    assert(std::abs(signed_volume(sphere, consistent) - volume) < 1e-4f && consistent);
+    assert(std::abs(sphere.volume() - volume) < 1e-4f);
+    
+    // Turned inside out entirely, it is turned back; flip_normals is its own inverse
+    algorithms::processing::flip_normals(sphere);
+    assert(signed_volume(sphere, consistent) < 0.0f && consistent);
+    stats = make_normals_consistent(sphere);
+    assert(stats.flipped_faces == sphere.face_count());
+    assert(signed_volume(sphere, consistent) > 0.0f && consistent);
+    
+    // Open parts keep the majority winding; separate parts are oriented separately
+    auto grid = make_grid(10);
+    for (std::size_t f = 0; f < grid.face_count(); f += 4) {
+        auto& ids = grid.get_face(FaceId(f)).vertices;
+        std::swap(ids[1], ids[2]);
+    }
+    auto both = grid;
+    const auto offset = VertexId(both.vertex_count());
+    for (const auto& v : sphere.vertices()) both.add_vertex(v.position + math::Vector3f(20.0f, 0.0f, 0.0f));
+    for (const auto& face : sphere.faces()) {
+        auto ids = face.vertices;
+        for (auto& id : ids) id += offset;
+        std::swap(ids[1], ids[2]);
+        both.add_face(ids);
+    }
+    stats = make_normals_consistent(both);
+    assert(stats.components == 2 && stats.closed_components == 1);
+    assert(stats.flipped_faces == 50 + sphere.face_count());
+    signed_volume(both, consistent);
+    assert(consistent);
+    for (std::size_t f = 0; f < 200; ++f) assert(both.faces()[f].vertices == make_grid(10).faces()[f].vertices);
+    
+    // A Moebius strip cannot be oriented: one edge stays mismatched
+    core::Meshf strip;
+    const int segments = 12;
+    for (int i = 0; i < segments; ++i) {
+        const float angle = 2.0f * 3.14159265f * float(i) / float(segments);
+        const float twist = 0.5f * angle;
+        for (int side = -1; side <= 1; side += 2) {
+            const float r = 2.0f + 0.5f * float(side) * std::cos(twist);
+            strip.add_vertex(math::Vector3f(r * std::cos(angle), r * std::sin(angle), 0.5f * float(side) * std::sin(twist)));
+        }
+    }
+    for (int i = 0; i < segments; ++i) {
+        const VertexId a = VertexId(2 * i), b = a + 1;
+        VertexId c = VertexId(2 * ((i + 1) % segments)), d = c + 1;
+        if (i + 1 == segments) std::swap(c, d);
+        strip.add_triangle(a, c, b);
+        strip.add_triangle(b, c, d);
+    }
+    stats = make_normals_consistent(strip);
+    assert(stats.components == 1 && stats.closed_components == 0 && stats.inconsistent_edges == 1);
+    
+    std::cout << "Normal orientation tests passed!" << std::endl;
+}
+
+void test_connected_components() {
+    std::cout << "Testing connected components..." << std::endl;
+    
+    using algorithms::analysis::ComponentAdjacency;
+    using algorithms::analysis::connected_components;
+    
+    // A grid, then a sphere off to the side, then a bowtie of two triangles that
+    // touch the grid at a corner and each other at one vertex
+    auto mesh = make_grid(10);
+    const auto sphere = make_sphere(8, 16, 1.0f);
+    const auto offset = VertexId(mesh.vertex_count());
+    for (const auto& v : sphere.vertices()) mesh.add_vertex(v.position + math::Vector3f(5.0f, 0.0f, 0.0f));
+    for (const auto& face : sphere.faces()) {
+        auto ids = face.vertices;
+        for (auto& id : ids) id += offset;
+        mesh.add_face(ids);
+    }
+    const VertexId apex = mesh.add_vertex(math::Vector3f(-1.0f, -1.0f, 0.0f));
+    const VertexId a = mesh.add_vertex(math::Vector3f(-2.0f, -1.0f, 0.0f));
+    const VertexId b = mesh.add_vertex(math::Vector3f(-2.0f, -2.0f, 0.0f));
+    const VertexId c = mesh.add_vertex(math::Vector3f(-1.0f, -3.0f, 0.0f));
+    mesh.add_triangle(apex, a, b);
+    mesh.add_triangle(b, c, VertexId(0));
+    mesh.add_vertex(math::Vector3f(100.0f, 100.0f, 100.0f));  // unused
+    const std::size_t grid_faces = 200;
+    
+    auto by_vertex = connected_components(mesh);
+    assert(by_vertex.size() == 2 && by_vertex.face_labels.size() == mesh.face_count());
+    assert(by_vertex.face_counts[0] == grid_faces + 2);
+    assert(by_vertex.face_counts[1] == sphere.face_count());
+    assert(by_vertex.face_labels[grid_faces] == 1 && by_vertex.face_labels.back() == 0);
+    assert(std::abs(by_vertex.bounding_boxes[0].min_point.x + 2.0f) < 1e-6f);
+    assert(std::abs(by_vertex.bounding_boxes[0].min_point.y + 3.0f) < 1e-6f);
+    assert(std::abs(by_vertex.bounding_boxes[1].center().x - 5.0f) < 1e-5f);
+    
+    // Across edges only, the bowtie falls apart into two single-triangle components
+    auto by_edge = connected_components(mesh, ComponentAdjacency::EDGE);
+    assert(by_edge.size() == 4);
+    assert(by_edge.face_counts[0] == grid_faces && by_edge.face_counts[1] == sphere.face_count());
+    assert(by_edge.face_counts[2] == 1 && by_edge.face_counts[3] == 1);
+    assert(by_edge.face_labels[mesh.face_count() - 2] == 2 && by_edge.face_labels.back() == 3);
+    
+    assert(connected_components(core::Meshf()).size() == 0);
+    
+    std::cout << "Connected components tests passed!" << std::endl;
+}
+
+void test_curvature() {
+    std::cout << "Testing curvature..." << std::endl;
+    
+    using algorithms::analysis::CurvatureOutput;
+    using algorithms::analysis::compute_curvature;
+    
+    // Sphere of radius 2: H = 1/2 and K = 1/4 away from the poles, and the angle
+    // defects add up to 4 pi exactly (Gauss-Bonnet)
+    auto sphere = make_sphere(32, 64, 2.0f);
+    const std::size_t n = sphere.vertex_count();
+    std::vector<float> mean(n), gaussian(n), k_max(n), k_min(n);
+    CurvatureOutput<float> output;
+    output.mean = mean;
+    output.gaussian = gaussian;
+    output.max_curvature = k_max;
+    output.min_curvature = k_min;
+    algorithms::CotangentLaplacian<float> laplacian;
+    compute_curvature(sphere, laplacian, output);
+    assert(laplacian.is_current(sphere));
+    
+    double defect = 0.0;
+    for (float d : laplacian.angle_defects()) defect += d;
+    assert(std::abs(defect - 4.0 * 3.14159265358979) < 1e-3);
+    const std::size_t equator = 1 + 15 * 64;
+    for (std::size_t v = equator; v < equator + 64 * 2; ++v) {
+        assert(std::abs(mean[v] - 0.5f) < 0.01f);
+        assert(std::abs(gaussian[v] - 0.25f) < 0.01f);
+        assert(k_max[v] >= k_min[v] && std::abs(k_max[v] - 0.5f) < 0.05f);
+    }
+    assert(algorithms::analysis::compute_mean_curvature(sphere)[equator] == mean[equator]);
+    assert(algorithms::analysis::compute_gaussian_curvature(sphere)[equator] == gaussian[equator]);
+    
+    // Scaling moves the position version, so the cached operator is rebuilt
+    sphere.update_vertices([](core::Vertex<float>* vertices, std::size_t count) {
+        for (std::size_t v = 0; v < count; ++v) vertices[v].position = vertices[v].position * 2.0f;
+    });
+    assert(!laplacian.is_current(sphere));
+    compute_curvature(sphere, laplacian, output);
+    assert(std::abs(mean[equator] - 0.25f) < 0.005f);
+    
+    // So does assigning another mesh, built the same way, over the cached one
+    sphere = make_sphere(32, 64, 1.0f);
+    compute_curvature(sphere, laplacian, output);
+    sphere = make_sphere(32, 64, 0.5f);
+    assert(!laplacian.is_current(sphere));
+    compute_curvature(sphere, laplacian, output);
+    assert(std::abs(mean[equator] - 2.0f) < 0.04f);
+    
+    // Open cylinder of radius 1 along z: principal curvatures 1 and 0, with the
+    // direction of least curvature along the axis
+    core::Meshf cylinder;
+    const int segments = 48, rows = 20;
+    for (int r = 0; r <= rows; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            const float phi = 2.0f * 3.14159265f * float(s) / float(segments);
+            cylinder.add_vertex(math::Vector3f(std::cos(phi), std::sin(phi), 0.1f * float(r)));
+        }
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int s = 0; s < segments; ++s) {
+            const VertexId a = VertexId(r * segments + s), b = VertexId(r * segments + (s + 1) % segments);
+            cylinder.add_triangle(a, b, b + VertexId(segments));
+            cylinder.add_triangle(a, b + VertexId(segments), a + VertexId(segments));
+        }
+    }
+    const std::size_t m = cylinder.vertex_count();
+    std::vector<float> cyl_mean(m), cyl_gaussian(m);
+    std::vector<math::Vector3f> max_dir(m), min_dir(m);
+    CurvatureOutput<float> cyl_output;
+    cyl_output.mean = cyl_mean;
+    cyl_output.gaussian = cyl_gaussian;
+    cyl_output.max_direction = max_dir;
+    cyl_output.min_direction = min_dir;
+    compute_curvature(cylinder, cyl_output);
+    for (std::size_t v = segments; v < m - segments; ++v) {
+        assert(std::abs(cyl_mean[v] - 0.5f) < 0.01f && std::abs(cyl_gaussian[v]) < 0.01f);
+        assert(std::abs(min_dir[v].z) > 0.99f && std::abs(max_dir[v].z) < 0.01f);
+    }
+    
+    // Spans must be empty or sized to the vertex count; only triangles are accepted
+    std::vector<float> short_output(3);
+    CurvatureOutput<float> bad;
+    bad.mean = short_output;
+    bool threw = false;
+    try { compute_curvature(cylinder, bad); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    core::Meshf quad;
+    for (int i = 0; i < 4; ++i) quad.add_vertex(math::Vector3f(float(i & 1), float(i >> 1), 0.0f));
+    quad.add_face({0, 1, 3, 2});
+    threw = false;
+    try { algorithms::analysis::compute_mean_curvature(quad); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    
+    std::cout << "Curvature tests passed!" << std::endl;
+}
+
+void test_mesh_statistics() {
+    std::cout << "Testing mesh statistics..." << std::endl;
+    
+    using algorithms::analysis::compute_mesh_statistics;
+    
+    // Closed box of 2 x 2 split quads per side; vertices are repeated per side, so
+    // each side has its own 16 edges: 12 of unit length and 4 diagonals
+    auto box = make_box(2);
+    auto stats = compute_mesh_statistics(box);
+    assert(stats.vertex_count == 54 && stats.face_count == 48);
+    assert(stats.triangle_count == 48 && stats.quad_count == 0 && stats.ngon_count == 0);
+    assert(stats.edge_count == 6 * 16);
+    assert(std::abs(stats.min_edge_length - 1.0f) < 1e-6f);
+    assert(std::abs(stats.max_edge_length - std::sqrt(2.0f)) < 1e-6f);
+    assert(std::abs(stats.avg_edge_length - (12.0f + 4.0f * std::sqrt(2.0f)) / 16.0f) < 1e-5f);
+    assert(std::abs(stats.min_triangle_area - 0.5f) < 1e-6f && std::abs(stats.max_triangle_area - 0.5f) < 1e-6f);
+    assert(std::abs(stats.total_surface_area - 24.0f) < 1e-4f);
+    assert(std::abs(stats.volume - 8.0f) < 1e-4f);
+    assert(std::abs(stats.volume - box.volume()) < 1e-4f);
+    assert(stats.bounding_box.min_point == math::Vector3f(-1.0f) && stats.bounding_box.max_point == math::Vector3f(1.0f));
+    assert(std::abs(algorithms::analysis::compute_surface_area(box) - 24.0f) < 1e-4f);
+    assert(std::abs(algorithms::analysis::compute_volume(box) - 8.0f) < 1e-4f);
+    
+    // Mixed faces share edges across kinds; degenerate sides are not edges
+    core::Meshf mixed;
+    for (int i = 0; i < 6; ++i) mixed.add_vertex(math::Vector3f(float(i % 3), float(i / 3), 0.0f));
+    mixed.add_face({0, 1, 4, 3});
+    mixed.add_face({1, 2, 5});
+    mixed.add_face({1, 5, 4});
+    mixed.add_face({0, 3, 3});
+    stats = compute_mesh_statistics(mixed);
+    assert(stats.triangle_count == 3 && stats.quad_count == 1);
+    assert(stats.edge_count == 8);
+    assert(std::abs(stats.total_surface_area - 2.0f) < 1e-6f);
+    assert(stats.min_triangle_area == 0.0f && std::abs(stats.max_triangle_area - 0.5f) < 1e-6f);
+    
+    stats = compute_mesh_statistics(core::Meshf());
+    assert(stats.edge_count == 0 && stats.min_edge_length == 0.0f && stats.avg_triangle_area == 0.0f);
+    
+    std::cout << "Mesh statistics tests passed!" << std::endl;
+}
+
+void test_topology() {
+    std::cout << "Testing surface topology..." << std::endl;
+    
+    using algorithms::analysis::analyze_topology;
+    
+    // Torus from an n x m grid wrapped both ways
+    auto make_torus = [](int n, int m) {
+        core::Meshf torus;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < m; ++j) {
+                const float u = 2.0f * 3.14159265f * float(i) / float(n);
+                const float v = 2.0f * 3.14159265f * float(j) / float(m);
+                torus.add_vertex(math::Vector3f((2.0f + std::cos(v)) * std::cos(u), (2.0f + std::cos(v)) * std::sin(u),
+                                                std::sin(v)));
+            }
+        }
+        auto id = [&](int i, int j) { return VertexId((i % n) * m + (j % m)); };
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < m; ++j) {
+                torus.add_triangle(id(i, j), id(i + 1, j), id(i + 1, j + 1));
+                torus.add_triangle(id(i, j), id(i + 1, j + 1), id(i, j + 1));
+            }
+        }
+        return torus;
+    };
+    
+    auto sphere = make_sphere(8, 16, 1.0f);
+    auto report = analyze_topology(sphere);
+    assert(report.components.size() == 1);
+    assert(report.total.euler_characteristic == 2 && report.total.genus == 0 && report.total.boundary_loops == 0);
+    assert(report.total.vertices == sphere.vertex_count() && report.total.faces == sphere.face_count());
+    
+    auto torus = make_torus(12, 8);
+    report = analyze_topology(torus);
+    assert(report.total.euler_characteristic == 0 && report.total.genus == 1);
+    assert(report.total.edges == 3 * 12 * 8);
+    
+    // A disk has one boundary loop; an unused vertex does not count
+    auto grid = make_grid(6);
+    grid.add_vertex(math::Vector3f(50.0f));
+    report = analyze_topology(grid);
+    assert(report.total.vertices == 49 && report.total.euler_characteristic == 1);
+    assert(report.total.boundary_loops == 1 && report.total.genus == 0);
+    
+    // Two holes touching at one vertex are still two loops
+    core::Meshf holes;
+    for (const auto& v : make_grid(6).vertices()) holes.add_vertex(v.position);
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 6; ++x) {
+            if ((x == 2 && y == 2) || (x == 3 && y == 3)) continue;
+            VertexId v = VertexId(y * 7 + x);
+            holes.add_triangle(v, v + 1, v + 8);
+            holes.add_triangle(v, v + 8, v + 7);
+        }
+    }
+    report = analyze_topology(holes);
+    assert(report.total.euler_characteristic == -1);
+    assert(report.total.boundary_loops == 3 && report.total.genus == 0);
+    
+    // Components are reported separately, numbered as by connected_components
+    auto both = torus;
+    const auto offset = VertexId(both.vertex_count());
+    for (const auto& v : grid.vertices()) both.add_vertex(v.position + math::Vector3f(10.0f, 0.0f, 0.0f));
+    for (const auto& face : grid.faces()) {
+        auto ids = face.vertices;
+        for (auto& vid : ids) vid += offset;
+        both.add_face(ids);
+    }
+    report = analyze_topology(both);
+    assert(report.components.size() == 2);
+    assert(report.components[0].genus == 1 && report.components[0].boundary_loops == 0);
+    assert(report.components[1].euler_characteristic == 1 && report.components[1].boundary_loops == 1);
+    assert(report.total.euler_characteristic == 1);
+    assert(algorithms::analysis::compute_genus(both) == 1);
+    assert(algorithms::analysis::compute_genus(core::Meshf()) == 0);
+    
+    std::cout << "Surface topology tests passed!" << std::endl;
+}
+
+void test_triangle_quality() {
+    std::cout << "Testing triangle quality..." << std::endl;
+    
+    using namespace algorithms::analysis;
+    const float pi = 3.14159265f;
+    
+    // Right isosceles triangles with unit legs; 200 faces fill whole SIMD batches
+    auto grid = make_grid(10);
+    const float right_ratio = (std::sqrt(2.0f) + 1.0f) / std::sqrt(3.0f);
+    const auto areas = compute_triangle_areas(grid);
+    const auto ratios = compute_aspect_ratios(grid);
+    const auto angles = compute_triangle_angles(grid);
+    assert(areas.size() == 200 && ratios.size() == 200 && angles.size() == 600);
+    for (std::size_t f = 0; f < 200; ++f) {
+        assert(std::abs(areas[f] - 0.5f) < 1e-6f && std::abs(ratios[f] - right_ratio) < 1e-5f);
+        float corner[3] = {angles[f * 3], angles[f * 3 + 1], angles[f * 3 + 2]};
+        std::sort(corner, corner + 3);
+        assert(std::abs(corner[0] - pi / 4) < 1e-5f && std::abs(corner[1] - pi / 4) < 1e-5f);
+        assert(std::abs(corner[2] - pi / 2) < 1e-5f);
+    }
+    
+    // Polygons, degenerate triangles and partial batches take the scalar path
+    core::Meshf mixed;
+    mixed.add_vertex(math::Vector3f(0.0f, 0.0f, 0.0f));
+    mixed.add_vertex(math::Vector3f(1.0f, 0.0f, 0.0f));
+    mixed.add_vertex(math::Vector3f(0.5f, std::sqrt(3.0f) / 2.0f, 0.0f));
+    mixed.add_vertex(math::Vector3f(2.0f, 0.0f, 0.0f));
+    mixed.add_vertex(math::Vector3f(1.0f, 1.0f, 0.0f));
+    mixed.add_vertex(math::Vector3f(0.0f, 1.0f, 0.0f));
+    mixed.add_triangle(0, 1, 2);
+    mixed.add_face({0, 1, 4, 5});
+    mixed.add_triangle(0, 1, 3);
+    std::vector<float> mixed_ratios(3), mixed_areas(3), mixed_angles(9);
+    compute_aspect_ratios(mixed, utils::Span<float>(mixed_ratios));
+    compute_triangle_areas(mixed, utils::Span<float>(mixed_areas));
+    compute_triangle_angles(mixed, utils::Span<float>(mixed_angles));
+    assert(std::abs(mixed_ratios[0] - 1.0f) < 1e-5f && std::abs(mixed_angles[0] - pi / 3) < 1e-5f);
+    assert(mixed_ratios[1] == 0.0f && std::abs(mixed_areas[1] - 1.0f) < 1e-6f && mixed_angles[4] == 0.0f);
+    assert(std::isinf(mixed_ratios[2]) && mixed_areas[2] == 0.0f);
+    
+    bool threw = false;
+    try { compute_triangle_angles(mixed, utils::Span<float>(mixed_areas)); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    
+    // The report bins everything in one pass: 45 degree angles fall in bin 1 of 7 and
+    // right angles in bin 3; the auto area range ends at the largest area
+    algorithms::QualityConfig config;
+    config.bins = 7;
+    auto report = triangle_quality_report(grid, config);
+    assert(report.triangles == 200 && report.degenerate_triangles == 0);
+    assert(report.angles.bins[1] == 400 && report.angles.bins[3] == 200);
+    assert(std::abs(report.angles.mean - pi / 3) < 1e-5f);
+    assert(report.areas.upper == 0.5f && report.areas.bins[6] == 200);
+    assert(std::abs(report.aspect_ratios.minimum - right_ratio) < 1e-5f);
+    assert(std::abs(report.aspect_ratios.maximum - right_ratio) < 1e-5f);
+    
+    report = triangle_quality_report(mixed);
+    assert(report.triangles == 2 && report.degenerate_triangles == 1);
+    assert(report.aspect_ratios.bins.size() == 32 && report.aspect_ratios.bins[0] == 1);
+    
+    std::cout << "Triangle quality tests passed!" << std::endl;
+}
+
+void test_bvh() {
+    std::cout << "Testing BVH..." << std::endl;
+    
+    using algorithms::spatial::BVH;
+    using algorithms::spatial::ray_mesh_intersection;
+    static_assert(sizeof(BVH<float>::Node) == 32, "float BVH nodes are 32 bytes");
+    
+    // A sphere around a grid, with a quad to exercise fan triangles
+    auto mesh = make_sphere(24, 48, 3.0f);
+    auto grid = make_grid(8);
+    const auto offset = VertexId(mesh.vertex_count());
+    for (const auto& v : grid.vertices()) mesh.add_vertex(v.position - math::Vector3f(4.0f, 4.0f, 0.5f));
+    for (const auto& face : grid.faces()) {
+        auto ids = face.vertices;
+        for (auto& vid : ids) vid += offset;
+        mesh.add_face(ids);
+    }
+    const VertexId q = mesh.add_vertex(math::Vector3f(-1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, 1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(-1.0f, 1.0f, 1.0f));
+    mesh.add_face({q, q + 1, q + 2, q + 3});
+    const std::size_t triangles = mesh.face_count() + 1;
+    
+    algorithms::BVHConfig morton_config;
+    morton_config.build = algorithms::BVHConfig::MORTON;
+    BVH<float> sah(mesh);
+    BVH<float> morton(mesh, morton_config);
+    
+    // Leaves cover every triangle once, in leaf order
+    for (const BVH<float>* bvh : {&sah, &morton}) {
+        assert(bvh->triangle_count() == triangles && bvh->mesh() == &mesh);
+        std::vector<int> covered(triangles, 0);
+        for (const auto& node : bvh->nodes()) {
+            if (!node.is_leaf()) continue;
+            assert(node.count <= 4);
+            for (std::size_t i = node.offset; i < node.offset + node.count; ++i) ++covered[i];
+        }
+        assert(std::all_of(covered.begin(), covered.end(), [](int c) { return c == 1; }));
+    }
+    assert(sah.sah_cost() <= morton.sah_cost());
+    
+    // Rays from inside the sphere agree with the brute-force scan
+    std::uint32_t state = 12345u;
+    auto random = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return float(state >> 8) / float(1u << 24) * 2.0f - 1.0f;
+    };
+    for (int i = 0; i < 500; ++i) {
+        const math::Vector3f origin(random() * 1.5f, random() * 1.5f, random() * 1.5f);
+        const math::Vector3f direction(random(), random(), random());
+        const auto expected = ray_mesh_intersection(origin, direction, mesh);
+        assert(expected.hit);
+        for (const BVH<float>* bvh : {&sah, &morton}) {
+            const auto hit = bvh->ray_intersection(origin, direction);
+            assert(hit.hit && std::abs(hit.distance - expected.distance) < 1e-5f);
+            assert((hit.point - expected.point).length() < 1e-4f);
+            assert(std::abs(hit.barycentric.x + hit.barycentric.y + hit.barycentric.z - 1.0f) < 1e-5f);
+        }
+    }
+    
+    // Straight up from the origin hits the quad first, on its second fan triangle
+    auto hit = sah.ray_intersection(math::Vector3f(0.2f, 0.4f, 0.0f), math::Vector3f(0.0f, 0.0f, 2.0f));
+    assert(hit.hit && hit.face_id == mesh.face_count() - 1 && std::abs(hit.distance - 0.5f) < 1e-6f);
+    assert(std::abs(std::abs(hit.normal.z) - 1.0f) < 1e-6f);
+    assert(std::abs(hit.barycentric.y - 0.6f) < 1e-5f && std::abs(hit.barycentric.z - 0.1f) < 1e-5f);
+    
+    // Rays leaving the sphere miss, as does everything against an empty hierarchy
+    assert(!sah.ray_intersection(math::Vector3f(10.0f, 0.0f, 0.0f), math::Vector3f(1.0f, 0.0f, 0.0f)).hit);
+    assert(!BVH<float>(core::Meshf()).ray_intersection(math::Vector3f(0.0f), math::Vector3f(1.0f, 0.0f, 0.0f)).hit);
+    
+    algorithms::BVHConfig bad;
+    bad.bins = 1;
+    bool threw = false;
+    try { BVH<float> invalid(mesh, bad); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    
+    std::cout << "BVH tests passed!" << std::endl;
+}
+
+void test_wide_bvh() {
+    std::cout << "Testing wide BVH..." << std::endl;
+    
+    using algorithms::spatial::BVH;
+    using algorithms::spatial::BVH4;
+    using algorithms::spatial::BVH8;
+    
+    auto mesh = make_sphere(24, 48, 3.0f);
+    const VertexId q = mesh.add_vertex(math::Vector3f(-1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, 1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(-1.0f, 1.0f, 1.0f));
+    mesh.add_face({q, q + 1, q + 2, q + 3});
+    
+    const BVH<float> binary(mesh);
+    const BVH4<float> bvh4(binary);
+    const BVH8<float> bvh8(mesh);
+    assert(bvh4.triangle_count() == binary.triangle_count() && bvh8.triangle_count() == binary.triangle_count());
+    assert(bvh8.nodes().size() < bvh4.nodes().size() && bvh4.nodes().size() < binary.nodes().size());
+    
+    // Every triangle sits in exactly one leaf slot
+    auto check_leaves = [&](const auto& bvh, std::size_t width) {
+        std::vector<int> covered(bvh.triangle_count(), 0);
+        for (const auto& node : bvh.nodes()) {
+            for (std::size_t i = 0; i < width; ++i) {
+                assert(node.count[i] <= width);
+                for (std::size_t t = node.child[i]; t < node.child[i] + node.count[i]; ++t) ++covered[t];
+            }
+        }
+        assert(std::all_of(covered.begin(), covered.end(), [](int c) { return c == 1; }));
+    };
+    check_leaves(bvh4, 4);
+    check_leaves(bvh8, 8);
+    
+    // Same closest hits as the binary tree, including axis-aligned directions
+    std::uint32_t state = 777u;
+    auto random = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return float(state >> 8) / float(1u << 24) * 2.0f - 1.0f;
+    };
+    for (int i = 0; i < 500; ++i) {
+        const math::Vector3f origin(random() * 1.5f, random() * 1.5f, random() * 1.5f);
+        math::Vector3f direction(random(), random(), random());
+        if (i % 5 == 0) direction = math::Vector3f(0.0f, i % 10 == 0 ? 1.0f : -1.0f, 0.0f);
+        const auto expected = binary.ray_intersection(origin, direction);
+        for (const auto& hit : {bvh4.ray_intersection(origin, direction), bvh8.ray_intersection(origin, direction)}) {
+            assert(hit.hit == expected.hit && std::abs(hit.distance - expected.distance) < 1e-6f);
+            assert((hit.point - expected.point).length() < 1e-5f);
+        }
+    }
+    
+    auto hit = bvh8.ray_intersection(math::Vector3f(0.2f, 0.4f, 0.0f), math::Vector3f(0.0f, 0.0f, 2.0f));
+    assert(hit.hit && hit.face_id == mesh.face_count() - 1 && std::abs(hit.distance - 0.5f) < 1e-6f);
+    assert(!bvh4.ray_intersection(math::Vector3f(10.0f, 0.0f, 0.0f), math::Vector3f(1.0f, 0.0f, 0.0f)).hit);
+    
+    // A single leaf root, and no root at all
+    core::Meshf triangle;
+    triangle.add_vertex(math::Vector3f(0.0f, 0.0f, 0.0f));
+    triangle.add_vertex(math::Vector3f(1.0f, 0.0f, 0.0f));
+    triangle.add_vertex(math::Vector3f(0.0f, 1.0f, 0.0f));
+    triangle.add_triangle(0, 1, 2);
+    const BVH4<float> single(triangle);
+    assert(single.nodes().size() == 1 && single.nodes()[0].count[0] == 1);
+    hit = single.ray_intersection(math::Vector3f(0.25f, 0.25f, 1.0f), math::Vector3f(0.0f, 0.0f, -1.0f));
+    assert(hit.hit && hit.face_id == 0 && std::abs(hit.distance - 1.0f) < 1e-6f);
+    assert(!BVH8<float>(core::Meshf()).ray_intersection(math::Vector3f(0.0f), math::Vector3f(1.0f, 0.0f, 0.0f)).hit);
+    
+    std::cout << "Wide BVH tests passed!" << std::endl;
+}
+
+void test_ray_queries() {
+    std::cout << "Testing batched ray queries..." << std::endl;
+    
+    using algorithms::RayQueryConfig;
+    using algorithms::spatial::BVH;
+    using algorithms::spatial::Ray;
+    using algorithms::spatial::RayHit;
+    
+    const auto mesh = make_sphere(24, 48, 3.0f);
+    const BVH<float> bvh(mesh);
+    
+    // A coherent fan of rays from one point followed by scattered ones, some of them
+    // axis-aligned and some ending before the sphere
+    std::uint32_t state = 4242u;
+    auto random = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return float(state >> 8) / float(1u << 24) * 2.0f - 1.0f;
+    };
+    std::vector<Ray<float>> rays;
+    for (int i = 0; i < 300; ++i) {
+        Ray<float> ray;
+        ray.origin = math::Vector3f(0.5f, -0.25f, 0.0f);
+        ray.direction = math::Vector3f(1.0f, float(i % 20) * 0.05f - 0.5f, float(i / 20) * 0.05f - 0.4f);
+        rays.push_back(ray);
+    }
+    for (int i = 0; i < 700; ++i) {
+        Ray<float> ray;
+        ray.origin = math::Vector3f(random() * 4.0f, random() * 4.0f, random() * 4.0f);
+        ray.direction = math::Vector3f(random(), random(), random());
+        if (i % 7 == 0) ray.direction = math::Vector3f(0.0f, 0.0f, i % 14 == 0 ? 1.0f : -1.0f);
+        if (i % 3 == 0) ray.t_max = 1.5f;
+        rays.push_back(ray);
+    }
+    
+    std::vector<RayHit<float>> expected;
+    std::vector<std::uint8_t> expected_occluded;
+    for (const auto& ray : rays) {
+        auto hit = bvh.ray_intersection(ray.origin, ray.direction);
+        hit.hit = hit.hit && hit.distance < ray.t_max;
+        expected.push_back(hit);
+        expected_occluded.push_back(hit.hit ? 1 : 0);
+    }
+    
+    // Every packet size and order gives the single-ray result
+    for (auto order : {RayQueryConfig::COHERENT, RayQueryConfig::INCOHERENT}) {
+        for (std::size_t packet_size : {std::size_t(8), std::size_t(16)}) {
+            RayQueryConfig config;
+            config.order = order;
+            config.packet_size = packet_size;
+            std::vector<RayHit<float>> hits(rays.size());
+            std::vector<std::uint8_t> occluded(rays.size(), 2);
+            algorithms::spatial::intersect_rays(bvh, utils::Span<const Ray<float>>(rays),
+                                                utils::Span<RayHit<float>>(hits), config);
+            algorithms::spatial::occluded_rays(bvh, utils::Span<const Ray<float>>(rays),
+                                               utils::Span<std::uint8_t>(occluded), config);
+            for (std::size_t i = 0; i < rays.size(); ++i) {
+                assert(hits[i].hit == expected[i].hit && occluded[i] == expected_occluded[i]);
+                if (!hits[i].hit) continue;
+                assert(hits[i].face_id == expected[i].face_id);
+                assert(std::abs(hits[i].distance - expected[i].distance) < 1e-5f);
+                assert((hits[i].point - expected[i].point).length() < 1e-5f);
+            }
+        }
+    }
+    assert(std::count(expected_occluded.begin(), expected_occluded.end(), 1) > 300);
+    assert(std::count(expected_occluded.begin(), expected_occluded.end(), 0) > 100);
+    
+    // An empty hierarchy misses everything
+    const BVH<float> empty{core::Meshf()};
+    std::vector<RayHit<float>> hits(rays.size());
+    std::vector<std::uint8_t> occluded(rays.size(), 1);
+    algorithms::spatial::intersect_rays(empty, utils::Span<const Ray<float>>(rays), utils::Span<RayHit<float>>(hits));
+    algorithms::spatial::occluded_rays(empty, utils::Span<const Ray<float>>(rays),
+                                       utils::Span<std::uint8_t>(occluded));
+    assert(std::none_of(hits.begin(), hits.end(), [](const RayHit<float>& hit) { return hit.hit; }));
+    assert(std::count(occluded.begin(), occluded.end(), 0) == std::ptrdiff_t(rays.size()));
+    
+    // Mismatched spans and unsupported packet sizes are rejected
+    bool threw = false;
+    try {
+        algorithms::spatial::intersect_rays(bvh, utils::Span<const Ray<float>>(rays),
+                                            utils::Span<RayHit<float>>(hits.data(), 3));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        RayQueryConfig config;
+        config.packet_size = 12;
+        algorithms::spatial::occluded_rays(bvh, utils::Span<const Ray<float>>(rays),
+                                           utils::Span<std::uint8_t>(occluded), config);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Batched ray query tests passed!" << std::endl;
+}
+
+void test_bvh_refit() {
+    std::cout << "Testing BVH refit..." << std::endl;
+    
+    using algorithms::spatial::BVH;
+    using algorithms::spatial::ray_mesh_intersection;
+    
+    auto mesh = make_sphere(24, 48, 3.0f);
+    algorithms::BVHConfig no_rotations;
+    no_rotations.refit_rotation_threshold = 0.0f;
+    BVH<float> bvh(mesh);
+    BVH<float> plain(mesh, no_rotations);
+    assert(!bvh.refit() && !BVH<float>().refit());
+    
+    std::uint32_t state = 2024u;
+    auto random = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return float(state >> 8) / float(1u << 24) * 2.0f - 1.0f;
+    };
+    auto check_rays = [&](const BVH<float>& tree) {
+        std::vector<int> covered(tree.triangle_count(), 0);
+        for (const auto& node : tree.nodes()) {
+            if (node.is_leaf()) {
+                for (std::size_t i = node.offset; i < node.offset + node.count; ++i) ++covered[i];
+            }
+        }
+        assert(std::all_of(covered.begin(), covered.end(), [](int c) { return c == 1; }));
+        const algorithms::spatial::BVH4<float> wide(tree);
+        for (int i = 0; i < 200; ++i) {
+            const math::Vector3f origin(random() * 2.0f, random() * 2.0f, random() * 2.0f);
+            const math::Vector3f direction(random(), random(), random());
+            const auto expected = ray_mesh_intersection(origin, direction, mesh);
+            for (const auto& hit : {tree.ray_intersection(origin, direction), wide.ray_intersection(origin, direction)}) {
+                assert(hit.hit == expected.hit);
+                assert(!hit.hit || std::abs(hit.distance - expected.distance) < 1e-4f);
+            }
+        }
+    };
+    
+    // Moving and scaling keeps the tree and its relative cost
+    const float cost = bvh.sah_cost();
+    const auto nodes = bvh.nodes();
+    mesh.transform(math::Matrix4f::translation(math::Vector3f(1.0f, -2.0f, 0.5f)) * math::Matrix4f::scaling(2.0f));
+    assert(bvh.refit() && !bvh.refit());
+    assert(bvh.nodes().size() == nodes.size() && std::abs(bvh.sah_cost() - cost) < 1e-3f * cost);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        assert(bvh.nodes()[i].offset == nodes[i].offset && bvh.nodes()[i].count == nodes[i].count);
+        assert((bvh.nodes()[i].min_point - (nodes[i].min_point * 2.0f + math::Vector3f(1.0f, -2.0f, 0.5f))).length() < 1e-4f);
+    }
+    check_rays(bvh);
+    
+    // A rotation grows the axis-aligned boxes past the threshold, so the tree is rotated
+    mesh.transform(math::Matrix4f::rotation_axis(math::Vector3f(0.3f, 1.0f, -0.2f), 0.8f));
+    assert(bvh.refit() && plain.refit());
+    assert(bvh.sah_cost() < plain.sah_cost());
+    check_rays(bvh);
+    
+    // Scrambled positions degrade the tree; rotations recover part of the cost and
+    // keep every subtree's triangles contiguous
+    mesh.update_vertices([&](core::Vertex<float>* vertices, std::size_t count) {
+        for (std::size_t i = count - 1; i > 0; --i) {
+            const std::size_t j = std::size_t((random() * 0.5f + 0.5f) * float(i));
+            std::swap(vertices[i].position, vertices[j].position);
+        }
+    });
+    assert(bvh.refit() && plain.refit());
+    assert(bvh.sah_cost() < plain.sah_cost());
+    assert(bvh.nodes().size() == plain.nodes().size());
+    check_rays(bvh);
+    check_rays(plain);
+    const float rotated = bvh.sah_cost();
+    mesh.update_vertices([](core::Vertex<float>*, std::size_t) {});
+    assert(bvh.refit() && bvh.sah_cost() <= rotated);
+    
+    // New faces rebuild the hierarchy
+    const VertexId q = mesh.add_vertex(math::Vector3f(10.0f, 0.0f, 0.0f));
+    mesh.add_vertex(math::Vector3f(11.0f, 0.0f, 0.0f));
+    mesh.add_vertex(math::Vector3f(10.0f, 1.0f, 0.0f));
+    mesh.add_triangle(q, q + 1, q + 2);
+    assert(bvh.refit() && bvh.triangle_count() == mesh.face_count());
+    auto hit = bvh.ray_intersection(math::Vector3f(10.2f, 0.2f, 1.0f), math::Vector3f(0.0f, 0.0f, -1.0f));
+    assert(hit.hit && hit.face_id == mesh.face_count() - 1);
+    check_rays(bvh);
+    
+    // Assigning another mesh over the indexed one is never mistaken for no change
+    mesh = make_sphere(24, 48, 1.5f);
+    assert(bvh.refit() && bvh.triangle_count() == mesh.face_count());
+    check_rays(bvh);
+    core::Meshf other = make_sphere(24, 48, 2.5f);
+    mesh = std::move(other);
+    assert(bvh.refit());
+    check_rays(bvh);
+    
+    std::cout << "BVH refit tests passed!" << std::endl;
+}
+
+void test_closest_points() {
+    std::cout << "Testing closest point queries..." << std::endl;
+    
+    using algorithms::ClosestPointConfig;
+    using algorithms::spatial::BVH;
+    using algorithms::spatial::ClosestPoint;
+    
+    std::uint32_t state = 99u;
+    auto random = [&]() {
+        state = state * 1664525u + 1013904223u;
+        return float(state >> 8) / float(1u << 24) * 2.0f - 1.0f;
+    };
+    
+    // The packet kernel picks the same region as the scalar test on every lane
+    for (int i = 0; i < 200; ++i) {
+        math::Vector3f a[4], ab[4], ac[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            a[lane] = math::Vector3f(random(), random(), random());
+            ab[lane] = math::Vector3f(random(), random(), random());
+            ac[lane] = lane == 3 && i % 2 ? ab[lane] * 0.5f : math::Vector3f(random(), random(), random());
+        }
+        const math::Vector3f p(random() * 2.0f, random() * 2.0f, random() * 2.0f);
+        math::Packet<float, 4> v, w;
+        const auto distances = algorithms::spatial::detail::closest_point_packet(
+            math::Vector3xN<float, 4>(p), math::Vector3xN<float, 4>::generate([&](std::size_t k) { return a[k]; }),
+            math::Vector3xN<float, 4>::generate([&](std::size_t k) { return ab[k]; }),
+            math::Vector3xN<float, 4>::generate([&](std::size_t k) { return ac[k]; }), v, w);
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            float sv, sw;
+            const float expected = algorithms::spatial::detail::closest_point_on_triangle(p, a[lane], ab[lane], ac[lane], sv, sw);
+            assert(distances[lane] == expected || std::abs(distances[lane] - expected) <= 1e-5f * (1.0f + expected));
+            assert(std::abs(v[lane] - sv) < 1e-4f && std::abs(w[lane] - sw) < 1e-4f);
+            assert(sv >= 0.0f && sw >= 0.0f && sv + sw <= 1.0f + 1e-5f);
+        }
+        
+        // A collinear triangle is never closer than its segment
+        if (i % 2) {
+            const float t = std::min(std::max((p - a[3]).dot(ab[3]) / ab[3].dot(ab[3]), 0.0f), 1.0f);
+            const float segment = (p - a[3] - ab[3] * t).length();
+            assert(distances[3] >= segment * segment * (1.0f - 1e-4f));
+        }
+    }
+    
+    // A sphere with a quad inside it
+    auto mesh = make_sphere(24, 48, 3.0f);
+    const VertexId q = mesh.add_vertex(math::Vector3f(-1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, -1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(1.0f, 1.0f, 1.0f));
+    mesh.add_vertex(math::Vector3f(-1.0f, 1.0f, 1.0f));
+    mesh.add_face({q, q + 1, q + 2, q + 3});
+    const BVH<float> bvh(mesh);
+    
+    // Scattered points and a scan line agree with the brute-force scan
+    std::vector<math::Vector3f> points;
+    for (int i = 0; i < 300; ++i) points.emplace_back(random() * 5.0f, random() * 5.0f, random() * 5.0f);
+    for (int i = 0; i < 200; ++i) points.emplace_back(-4.0f + 0.04f * float(i), 0.3f, 1.2f);
+    points.push_back(mesh.get_vertex(0).position);
+    points.emplace_back(0.25f, 0.5f, 1.0f);
+    std::vector<ClosestPoint<float>> results(points.size());
+    algorithms::spatial::closest_points(bvh, utils::Span<const math::Vector3f>(points),
+                                        utils::Span<ClosestPoint<float>>(results));
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const float expected = algorithms::spatial::point_to_mesh_distance(points[i], mesh);
+        const auto single = algorithms::spatial::closest_point(bvh, points[i]);
+        for (const auto& result : {results[i], single}) {
+            assert(result.face_id != core::INVALID_FACE_ID);
+            assert(std::abs(result.distance - expected) < 1e-5f);
+            assert(std::abs((result.point - points[i]).length() - result.distance) < 1e-4f);
+            assert(std::abs(result.barycentric.x + result.barycentric.y + result.barycentric.z - 1.0f) < 1e-5f);
+        }
+        assert(((algorithms::spatial::closest_point_on_mesh(points[i], mesh) - points[i]).length() - expected) < 1e-5f);
+    }
+    assert(results[points.size() - 2].distance < 1e-6f);
+    const auto& on_quad = results.back();
+    assert(on_quad.face_id == mesh.face_count() - 1 && on_quad.distance < 1e-6f);
+    assert(std::abs(on_quad.barycentric.y - 0.625f) < 1e-5f && std::abs(on_quad.barycentric.z - 0.125f) < 1e-5f);
+    
+    // Points farther than max_distance find nothing, with or without a neighbor to reuse
+    ClosestPointConfig config;
+    config.max_distance = 1.0f;
+    config.reuse_neighbors = false;
+    algorithms::spatial::closest_points(bvh, utils::Span<const math::Vector3f>(points),
+                                        utils::Span<ClosestPoint<float>>(results), config);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const float expected = algorithms::spatial::point_to_mesh_distance(points[i], mesh);
+        assert((results[i].face_id != core::INVALID_FACE_ID) == (expected < 1.0f));
+        assert(results[i].face_id == core::INVALID_FACE_ID ? std::isinf(results[i].distance)
+                                                           : std::abs(results[i].distance - expected) < 1e-5f);
+    }
+    
+    // Nothing to be close to
+    core::Meshf empty;
+    const BVH<float> empty_bvh(empty);
+    assert(algorithms::spatial::closest_point(empty_bvh, math::Vector3f(1.0f)).face_id == core::INVALID_FACE_ID);
+    assert(std::isinf(algorithms::spatial::point_to_mesh_distance(math::Vector3f(1.0f), empty)));
+    bool threw = false;
+    try {
+        algorithms::spatial::closest_point_on_mesh(math::Vector3f(1.0f), empty);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    threw = false;
+    try {
+        algorithms::spatial::closest_points(bvh, utils::Span<const math::Vector3f>(points),
+                                            utils::Span<ClosestPoint<float>>(results.data(), 2));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Closest point tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Polygon Mesh Library - Algorithm Test Suite ===" << std::endl;
+    
+    try {
+        test_mesh_transform();
+        test_matrix_inverse();
+        test_simd_packets();
+        test_normalize_all();
+        test_remove_degenerate_faces();
+        test_laplacian_smoothing();
+        test_taubin_smoothing();
+        test_quadric_decimation();
+        test_partitioned_decimation();
+        test_edge_collapse_decimation();
+        test_cluster_decimation();
+        test_loop_subdivision();
+        test_catmull_clark_subdivision();
+        test_make_normals_consistent();
+        test_connected_components();
+        test_curvature();
+        test_mesh_statistics();
+        test_topology();
+        test_triangle_quality();
+        test_bvh();
+        test_wide_bvh();
+        test_ray_queries();
+        test_bvh_refit();
+        test_closest_points();
+        
+        std::cout << "\n=== All algorithm tests passed successfully! ===" << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,239 @@
+// The asserts are the checks, so they stay on in every build type
+#undef NDEBUG
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <polygon_mesh/polygon_mesh.hpp>
+#include <polygon_mesh/kernels/kernels.hpp>
+
+using namespace polygon_mesh;
+
+namespace {
+
+std::vector<kernels::Isa> available_isas() {
+    std::vector<kernels::Isa> isas;
+    for (auto isa : {kernels::Isa::SCALAR, kernels::Isa::SSE2, kernels::Isa::AVX2}) {
+        if (kernels::table_for(isa)) isas.push_back(isa);
+    }
+    return isas;
+}
+
+std::vector<math::Vector3f> random_vectors(std::size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<math::Vector3f> vectors(count);
+    for (auto& v : vectors) {
+        v = math::Vector3f(dist(gen), dist(gen), dist(gen));
+    }
+    return vectors;
+}
+
+bool close(const math::Vector3f& a, const math::Vector3f& b, float tolerance) {
+    return (a - b).length() <= tolerance * std::max(1.0f, b.length());
+}
+
+} // namespace
+
+void test_dispatch() {
+    std::cout << "Testing kernel dispatch..." << std::endl;
+
+    std::cout << "  Detected ISA: " << kernels::isa_name(kernels::detected_isa()) << std::endl;
+    std::cout << "  Active ISA: " << kernels::isa_name(kernels::active_isa()) << std::endl;
+
+    // Scalar is always available and active never exceeds what the CPU supports
+    assert(kernels::table_for(kernels::Isa::SCALAR) != nullptr);
+    assert(static_cast<int>(kernels::active_isa()) <= static_cast<int>(kernels::detected_isa()));
+
+    const kernels::Isa original = kernels::active_isa();
+    assert(kernels::set_active_isa(kernels::Isa::SCALAR));
+    assert(kernels::active_isa() == kernels::Isa::SCALAR);
+    assert(kernels::set_active_isa(original));
+
+    std::cout << "Kernel dispatch tests passed!" << std::endl;
+}
+
+void test_kernels_against_reference() {
+    std::cout << "Testing kernels against scalar reference..." << std::endl;
+
+    // Odd count so every table exercises its tail handling
+    const auto input = random_vectors(1037, 3);
+    const auto matrix = math::Matrix4f::translation(math::Vector3f(1.0f, -2.0f, 0.5f)) *
+                        math::Matrix4f::rotation_axis(math::Vector3f(0.3f, 1.0f, 0.2f), 0.7f) *
+                        math::Matrix4f::scaling(math::Vector3f(2.0f, 1.0f, 0.5f));
+    const auto projection = math::Matrix4f::perspective(1.0f, 1.5f, 0.1f, 100.0f);
+
+    for (auto isa : available_isas()) {
+        const kernels::KernelTable& table = *kernels::table_for(isa);
+        assert(table.isa == isa);
+
+        // normalize (fast and exact)
+        for (bool fast : {true, false}) {
+            auto vectors = input;
+            vectors[4] = math::Vector3f(0.0f);
+            table.normalize(&vectors[0].x, sizeof(math::Vector3f), vectors.size(), fast);
+            for (std::size_t i = 0; i < vectors.size(); ++i) {
+                if (i == 4) {
+                    assert(vectors[i] == math::Vector3f(0.0f));
+                } else {
+                    assert(close(vectors[i], input[i].normalize(), 1e-6f));
+                }
+            }
+        }
+
+        // bounds
+        float lo[3], hi[3];
+        table.bounds(&input[0].x, sizeof(math::Vector3f), input.size(), lo, hi);
+        core::BoundingBox<float> box;
+        for (const auto& v : input) box.expand(v);
+        assert(lo[0] == box.min_point.x && lo[1] == box.min_point.y && lo[2] == box.min_point.z);
+        assert(hi[0] == box.max_point.x && hi[1] == box.max_point.y && hi[2] == box.max_point.z);
+
+        // transform (affine with bounds, projective)
+        for (const auto& m : {matrix, projection}) {
+            float rows[16];
+            for (std::size_t r = 0; r < 4; ++r) {
+                for (std::size_t c = 0; c < 4; ++c) rows[r * 4 + c] = m(r, c);
+            }
+            std::vector<math::Vector3f> out(input.size());
+            float bounds[6];
+            table.transform(rows, !m.is_affine(), false, &input[0].x, sizeof(math::Vector3f),
+                            &out[0].x, sizeof(math::Vector3f), input.size(), bounds);
+            core::BoundingBox<float> out_box;
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                assert(close(out[i], m.transform_point(input[i]), 1e-5f));
+                out_box.expand(out[i]);
+            }
+            assert(bounds[0] == out_box.min_point.x && bounds[5] == out_box.max_point.z);
+        }
+    }
+
+    std::cout << "Kernel reference tests passed!" << std::endl;
+}
+
+void test_ray_triangle_kernel() {
+    std::cout << "Testing ray-triangle kernel..." << std::endl;
+
+    using Triangle = algorithms::spatial::BVH<float>::Triangle;
+
+    // A stack of triangles at z = 10 down to 0, all crossing the z axis
+    std::vector<Triangle> stack;
+    for (int layer = 10; layer >= 0; --layer) {
+        stack.push_back(Triangle{math::Vector3f(-1.0f, -1.0f, float(layer)), math::Vector3f(3.0f, 0.0f, 0.0f),
+                                 math::Vector3f(0.0f, 3.0f, 0.0f)});
+    }
+    const float origin[3] = {0.0f, 0.0f, -5.0f};
+    const float direction[3] = {0.0f, 0.0f, 1.0f};
+    const float away[3] = {0.0f, 0.0f, -1.0f};
+
+    // Random triangles and rays, against the scalar test the BVH uses without kernels
+    const auto corners = random_vectors(3 * 301, 11);
+    std::vector<Triangle> triangles;
+    for (std::size_t i = 0; i < corners.size(); i += 3) {
+        triangles.push_back(Triangle{corners[i], corners[i + 1] - corners[i], corners[i + 2] - corners[i]});
+    }
+    const auto ray_points = random_vectors(400, 12);
+
+    for (auto isa : available_isas()) {
+        const kernels::KernelTable& table = *kernels::table_for(isa);
+
+        kernels::RayTriangleHit hit{};
+        bool found = table.intersect_ray_triangles(origin, direction, 1e30f, &stack[0].vertex.x, sizeof(Triangle),
+                                                   stack.size(), &hit);
+        assert(found);
+        assert(hit.triangle == 10);  // layer z = 0 is listed last
+        assert(std::abs(hit.t - 5.0f) < 1e-5f);
+        assert(std::abs(hit.u - 1.0f / 3.0f) < 1e-5f && std::abs(hit.v - 1.0f / 3.0f) < 1e-5f);
+
+        // t_max cuts off every layer, and nothing lies behind the origin
+        assert(!table.intersect_ray_triangles(origin, direction, 4.0f, &stack[0].vertex.x, sizeof(Triangle),
+                                              stack.size(), &hit));
+        assert(!table.intersect_ray_triangles(origin, away, 1e30f, &stack[0].vertex.x, sizeof(Triangle),
+                                              stack.size(), &hit));
+
+        for (std::size_t r = 0; r + 1 < ray_points.size(); r += 2) {
+            const math::Vector3f from = ray_points[r];
+            const math::Vector3f dir = ray_points[r + 1] - from;
+            float best = std::numeric_limits<float>::infinity();
+            for (const auto& triangle : triangles) {
+                float t, u, v;
+                if (algorithms::spatial::detail::intersect_triangle(from, dir, triangle.vertex, triangle.edge1,
+                                                                    triangle.edge2, best, t, u, v)) {
+                    best = t;
+                }
+            }
+            found = table.intersect_ray_triangles(&from.x, &dir.x, std::numeric_limits<float>::infinity(),
+                                                  &triangles[0].vertex.x, sizeof(Triangle), triangles.size(), &hit);
+            assert(found == (best != std::numeric_limits<float>::infinity()));
+            if (found) assert(std::abs(hit.t - best) <= 1e-4f * std::max(1.0f, best));
+        }
+    }
+
+    std::cout << "Ray-triangle kernel tests passed!" << std::endl;
+}
+
+void test_mesh_uses_kernels() {
+    std::cout << "Testing mesh paths through kernels..." << std::endl;
+
+    auto mesh = generators::create_cube<float>(4.0f);
+    for (const auto& p : random_vectors(5000, 9)) {
+        mesh.add_vertex(p * 0.1f);
+    }
+    mesh.compute_normals();
+
+    const auto& box = mesh.bounding_box();
+    assert(box.max_point.x == 2.0f && box.min_point.z == -2.0f);
+    for (std::size_t i = 0; i < 8; ++i) {
+        assert(std::abs(mesh.vertices()[i].normal.length() - 1.0f) < 1e-5f);
+    }
+
+    auto moved = mesh;
+    moved.transform(math::Matrix4f::translation(math::Vector3f(3.0f, 0.0f, 0.0f)));
+    assert(std::abs(moved.bounding_box().max_point.x - 5.0f) < 1e-4f);
+    assert(close(moved.vertices()[7].position, mesh.vertices()[7].position + math::Vector3f(3.0f, 0.0f, 0.0f), 1e-6f));
+
+    // BVH leaves go through the ray-triangle kernel under every instruction set
+    auto sphere = generators::create_cube<float>(2.0f);
+    algorithms::processing::loop_subdivision(sphere, 3);
+    const algorithms::spatial::BVH<float> bvh(sphere);
+    const algorithms::spatial::WideBVH<float, 4> wide(bvh);
+    const auto targets = random_vectors(64, 10);
+    const kernels::Isa selected = kernels::active_isa();
+    for (auto isa : available_isas()) {
+        assert(kernels::set_active_isa(isa));
+        for (const auto& target : targets) {
+            const math::Vector3f from(0.0f, 0.0f, 0.0f);
+            const auto expected = algorithms::spatial::ray_mesh_intersection(from, target, sphere);
+            const auto binary = bvh.ray_intersection(from, target);
+            const auto wide_hit = wide.ray_intersection(from, target);
+            assert(expected.hit && binary.hit && wide_hit.hit);
+            assert(std::abs(binary.distance - expected.distance) < 1e-5f);
+            assert(std::abs(wide_hit.distance - expected.distance) < 1e-5f);
+        }
+    }
+    kernels::set_active_isa(selected);
+
+    std::cout << "Mesh kernel path tests passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Polygon Mesh Library - Kernel Dispatch Tests ===" << std::endl;
+
+    try {
+        test_dispatch();
+        test_kernels_against_reference();
+        test_ray_triangle_kernel();
+        test_mesh_uses_kernels();
+
+        std::cout << "\n=== All kernel tests passed! ===" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -138,6 +138,36 @@ void test_normal_computation_performance() {
     
     std::cout << "  Computed normals in " << normal_time << " ms" << std::endl;
     std::cout << "  Average per vertex: " << (normal_time / mesh.vertex_count() * 1000.0) << " μs" << std::endl;
+    
+    // Array-wide normalize against the per-vector loop
+    const size_t num_vectors = 1000000;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> dist(-5.0f, 5.0f);
+    std::vector<math::Vector3f> vectors(num_vectors);
+    for (auto& v : vectors) {
+        v = math::Vector3f(dist(gen), dist(gen), dist(gen));
+    }
+    
+    auto scalar = vectors;
+    timer.start();
+    for (auto& v : scalar) {
+        v.normalize_in_place();
+    }
+    double scalar_time = timer.elapsed_ms();
+    
+    auto exact = vectors;
+    timer.start();
+    math::normalize_all(exact, math::NormalizePrecision::EXACT);
+    double exact_time = timer.elapsed_ms();
+    
+    auto fast = vectors;
+    timer.start();
+    math::normalize_all(fast, math::NormalizePrecision::FAST);
+    double fast_time = timer.elapsed_ms();
+    
+    std::cout << "  normalize_in_place loop (" << num_vectors << " vectors): " << scalar_time << " ms" << std::endl;
+    std::cout << "  normalize_all EXACT: " << exact_time << " ms" << std::endl;
+    std::cout << "  normalize_all FAST: " << fast_time << " ms" << std::endl;
 }
 
 void test_bounding_box_performance() {
@@ -170,6 +200,90 @@ void test_bounding_box_performance() {
     std::cout << "  Volume: " << bbox.volume() << std::endl;
 }
 
+void test_transform_performance() {
+    std::cout << "\nTesting mesh transform performance..." << std::endl;
+    
+    const size_t num_vertices = 200000;
+    core::Meshf mesh;
+    mesh.reserve_vertices(num_vertices);
+    
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        mesh.add_vertex(math::Vector3f(dist(gen), dist(gen), dist(gen)),
+                        math::Vector3f(0.0f, 0.0f, 1.0f));
+    }
+    
+    auto matrix = math::Matrix4f::translation(math::Vector3f(1.0f, 2.0f, 3.0f)) *
+                  math::Matrix4f::rotation_axis(math::Vector3f(1.0f, 1.0f, 0.0f), 0.3f);
+    
+    // Scalar reference: one Matrix4 call per vertex
+    std::vector<math::Vector3f> positions;
+    positions.reserve(num_vertices);
+    for (const auto& v : mesh.vertices()) {
+        positions.push_back(v.position);
+    }
+    
+    Timer timer;
+    timer.start();
+    for (auto& p : positions) {
+        p = matrix.transform_point(p);
+    }
+    double scalar_time = timer.elapsed_ms();
+    
+    timer.start();
+    mesh.transform(matrix);
+    double batch_time = timer.elapsed_ms();
+    
+    std::cout << "  Scalar transform_point loop: " << scalar_time << " ms" << std::endl;
+    std::cout << "  Mesh::transform (positions, normals, bbox): " << batch_time << " ms" << std::endl;
+    std::cout << "  Bounding box: min" << mesh.bounding_box().min_point
+              << " max" << mesh.bounding_box().max_point << std::endl;
+}
+
+void test_matrix_batch_performance() {
+    std::cout << "\nTesting batched matrix performance..." << std::endl;
+    
+    const size_t num_matrices = 100000;
+    std::vector<math::Matrix4f> lhs, rhs;
+    lhs.reserve(num_matrices);
+    rhs.reserve(num_matrices);
+    
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t i = 0; i < num_matrices; ++i) {
+        lhs.push_back(math::Matrix4f::rotation_axis(math::Vector3f(dist(gen), dist(gen), 1.0f), dist(gen)) *
+                      math::Matrix4f::translation(math::Vector3f(dist(gen), dist(gen), dist(gen))));
+        rhs.push_back(math::Matrix4f::scaling(1.5f + dist(gen)));
+    }
+    
+    std::vector<math::Matrix4f> out(num_matrices);
+    
+    Timer timer;
+    timer.start();
+    for (size_t i = 0; i < num_matrices; ++i) {
+        out[i] = lhs[i] * rhs[i];
+    }
+    double scalar_time = timer.elapsed_ms();
+    
+    timer.start();
+    math::multiply_many(lhs, rhs, out);
+    double batch_time = timer.elapsed_ms();
+    
+    timer.start();
+    std::size_t singular = math::inverse_many(lhs, out);
+    double inverse_time = timer.elapsed_ms();
+    
+    timer.start();
+    math::inverse_many(lhs, out, true);
+    double affine_inverse_time = timer.elapsed_ms();
+    
+    std::cout << "  operator* loop: " << scalar_time << " ms for " << num_matrices << " products" << std::endl;
+    std::cout << "  multiply_many: " << batch_time << " ms" << std::endl;
+    std::cout << "  inverse_many: " << inverse_time << " ms (" << singular << " singular)" << std::endl;
+    std::cout << "  inverse_many (affine): " << affine_inverse_time << " ms" << std::endl;
+}
+
 void test_memory_usage() {
     std::cout << "\nTesting memory usage..." << std::endl;
     
@@ -226,6 +340,8 @@ int main() {
         test_large_mesh_creation();
         test_normal_computation_performance();
         test_bounding_box_performance();
+        test_transform_performance();
+        test_matrix_batch_performance();
         test_memory_usage();
         
         std::cout << "\n=== All performance tests completed! ===" << std::endl;